@@ -139,9 +139,12 @@ int main(int argc, const char** argv) {
       "min_connections", thread::hardware_concurrency()));
     auto maxConnections = static_cast<std::size_t>(Extract<int>(config,
       "max_connections", 10 * minConnections));
+    auto conflationThreshold = static_cast<std::size_t>(Extract<int>(config,
+      "conflation_threshold", static_cast<int>(
+        BaseMarketDataRelayServlet::DEFAULT_CONFLATION_THRESHOLD)));
     auto baseRegistryServlet = BaseMarketDataRelayServlet(clientTimeout,
       marketDataClientBuilder, minConnections, maxConnections,
-      administrationClient.Get());
+      administrationClient.Get(), conflationThreshold);
     auto server = MarketDataRelayServletContainer(Initialize(
       serviceLocatorClient.Get(), &baseRegistryServlet),
       Initialize(serviceConfig.m_interface),
@@ -1,8 +1,10 @@
+#include <iostream>
 #include <Beam/Codecs/SizeDeclarativeDecoder.hpp>
 #include <Beam/Codecs/SizeDeclarativeEncoder.hpp>
 #include <Beam/Codecs/ZLibDecoder.hpp>
 #include <Beam/Codecs/ZLibEncoder.hpp>
 #include <Beam/IO/SharedBuffer.hpp>
+#include <Beam/Queues/RoutineTaskQueue.hpp>
 #include <Beam/Sql/MySqlConfig.hpp>
 #include <Beam/Sql/SqlConnection.hpp>
 #include <Beam/Network/TcpServerSocket.hpp>
@@ -25,6 +27,7 @@
 #include "Nexus/MarketDataService/MarketDataFeedServlet.hpp"
 #include "Nexus/MarketDataService/MarketDataRegistry.hpp"
 #include "Nexus/MarketDataService/MarketDataRegistryServlet.hpp"
+#include "Nexus/MarketDataService/SecurityEntryCheckpoint.hpp"
 #include "Nexus/MarketDataService/SessionCachedHistoricalDataStore.hpp"
 #include "Nexus/MarketDataService/SqlHistoricalDataStore.hpp"
 #include "Version.hpp"
@@ -122,17 +125,44 @@ int main(int argc, const char** argv) {
     auto mySqlConfig = TryOrNest([&] {
       return MySqlConfig::Parse(GetNode(config, "data_store"));
     }, std::runtime_error("Error parsing section 'data_store'."));
+    auto dataStoreWriters = TryOrNest([&] {
+      return Extract<int>(GetNode(config, "data_store"), "writers", 1);
+    }, std::runtime_error("Error parsing section 'data_store'."));
     auto historicalDataStore = SqlDataStore([=] {
       return SqlConnection(MySql::Connection(mySqlConfig.m_address.GetHost(),
         mySqlConfig.m_address.GetPort(), mySqlConfig.m_username,
         mySqlConfig.m_password, mySqlConfig.m_schema));
-    });
+    }, dataStoreWriters);
+    auto metricsInterval = Extract<time_duration>(config, "metrics_interval",
+      seconds(0));
+    auto metricsTasks = RoutineTaskQueue();
+    auto metricsTimer = LiveTimer(metricsInterval);
+    metricsTimer.GetPublisher().Monitor(metricsTasks.GetSlot<Timer::Result>(
+      [&] (auto result) {
+        if(result != Timer::Result::EXPIRED) {
+          return;
+        }
+        std::cout << "Historical data store: " <<
+          historicalDataStore.GetMetrics() << std::endl;
+        metricsTimer.Start();
+      }));
+    if(metricsInterval > seconds(0)) {
+      metricsTimer.Start();
+    }
     auto asyncDataStore = AsyncHistoricalDataStore<SqlDataStore*>(
       &historicalDataStore);
     auto cacheBlockSize = Extract<int>(config, "cache_block_size", 1000);
-    auto marketDataRegistry = MarketDataRegistry();
+    auto registryShards = Extract<int>(config, "registry_shards",
+      static_cast<int>(std::thread::hardware_concurrency()));
+    auto recentTickCount = Extract<int>(config, "recent_tick_count",
+      MarketDataRegistry::DEFAULT_RECENT_TICK_COUNT);
+    auto marketDataRegistry = MarketDataRegistry(registryShards,
+      recentTickCount);
+    auto checkpointPath = Extract<std::string>(config, "checkpoint_path",
+      "security_entries.dat");
     auto baseRegistryServlet = BaseRegistryServlet(&*administrationClient,
       &marketDataRegistry, Initialize(&asyncDataStore, cacheBlockSize));
+    marketDataRegistry.Preload(LoadSecurityEntryCheckpoints(checkpointPath));
     auto registryServer = RegistryServletContainer(Initialize(
       serviceLocatorClient.Get(), &baseRegistryServlet),
       Initialize(registryServiceConfig.m_interface),
@@ -144,6 +174,12 @@ int main(int argc, const char** argv) {
       std::bind(factory<std::shared_ptr<LiveTimer>>(), seconds(10)));
     Register(*serviceLocatorClient, feedServiceConfig);
     WaitForKillEvent();
+    feedServer.Close();
+    registryServer.Close();
+    asyncDataStore.Close();
+    StoreSecurityEntryCheckpoints(checkpointPath,
+      marketDataRegistry.MakeCheckpoints());
+    metricsTimer.Cancel();
     serviceLocatorClient->Close();
   } catch(...) {
     ReportCurrentException();
@@ -76,6 +76,7 @@ namespace {
       LiveNtpTimeClient* timeClient) {
     return TryOrNest([&] {
       auto sampling = Extract<time_duration>(config, "sampling");
+      auto isPacked = Extract<bool>(config, "packed", false);
       auto startTime = Extract<ptime>(config, "start_time");
       auto clientCount = Extract<int>(config, "client_count");
       auto chunks = static_cast<int>(securities.size()) / clientCount;
@@ -96,8 +97,8 @@ namespace {
           ApplicationMarketDataFeedClient>(std::move(securitySubset), startTime,
             Initialize(Initialize(addresses),
               SessionAuthenticator(serviceLocatorClient.Get()),
-              Initialize(sampling), Initialize(seconds(10))), dataStore,
-            timeClient, timerBuilder));
+              Initialize(sampling), Initialize(seconds(10)), isPacked),
+            dataStore, timeClient, timerBuilder));
       }
       return replayClients;
     }, std::runtime_error("Failed to build replay clients."));
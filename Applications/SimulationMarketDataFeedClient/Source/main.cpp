@@ -85,6 +85,7 @@ namespace {
       auto timeAndSalesPeriod = Extract<time_duration>(config,
         "time_and_sales_period");
       auto sampling = Extract<time_duration>(config, "sampling");
+      auto isPacked = Extract<bool>(config, "packed", false);
       for(auto i = 0; i < feedCount; ++i) {
         auto feedSecurities = std::vector<Security>();
         if(i < feedCount - 1) {
@@ -99,8 +100,8 @@ namespace {
           std::make_unique<ApplicationMarketDataFeedClient>(feedSecurities,
             marketDatabase, *marketDataClient, Initialize(Initialize(addresses),
               SessionAuthenticator(serviceLocatorClient.Get()),
-              Initialize(sampling), Initialize(seconds(10))), &timeClient,
-            Initialize(bboPeriod), Initialize(marketQuotePeriod),
+              Initialize(sampling), Initialize(seconds(10)), isPacked),
+            &timeClient, Initialize(bboPeriod), Initialize(marketQuotePeriod),
             Initialize(timeAndSalesPeriod));
         feedClients.push_back(std::move(applicationMarketDataFeed));
       }
@@ -1,6 +1,9 @@
+#include <iostream>
+#include <sstream>
 #include <Beam/IO/SharedBuffer.hpp>
 #include <Beam/Network/TcpServerSocket.hpp>
 #include <Beam/Network/UdpSocketChannel.hpp>
+#include <Beam/Queues/RoutineTaskQueue.hpp>
 #include <Beam/Serialization/BinaryReceiver.hpp>
 #include <Beam/Serialization/BinarySender.hpp>
 #include <Beam/ServiceLocator/ApplicationDefinitions.hpp>
@@ -25,6 +28,7 @@
 #include "Nexus/InternalMatcher/InternalMatchingOrderExecutionDriver.hpp"
 #include "Nexus/InternalMatcher/NullMatchReportBuilder.hpp"
 #include "Nexus/MarketDataService/ApplicationDefinitions.hpp"
+#include "Nexus/MarketDataService/BboQuoteCache.hpp"
 #include "Nexus/OrderExecutionService/BoardLotCheck.hpp"
 #include "Nexus/OrderExecutionService/BuyingPowerCheck.hpp"
 #include "Nexus/OrderExecutionService/OrderExecutionServlet.hpp"
@@ -61,6 +65,8 @@ using namespace Viper;
 namespace {
   using SqlDataStore = SqlOrderExecutionDataStore<
     SqlConnection<MySql::Connection>>;
+  using ApplicationBboQuoteCache =
+    BboQuoteCache<ApplicationMarketDataClient::Client*>;
   using ApplicationSimulationOrderExecutionDriver =
     SimulationOrderExecutionDriver<ApplicationMarketDataClient::Client*,
       LiveNtpTimeClient*>;
@@ -85,6 +91,25 @@ namespace {
       ApplicationOrderExecutionDriver*, ReplicatedOrderExecutionDataStore*>,
     ApplicationServiceLocatorClient::Client*>, TcpServerSocket,
     BinarySender<SharedBuffer>, NullEncoder, std::shared_ptr<LiveTimer>>;
+
+  std::vector<Security> ParseWatchList(const YAML::Node& config,
+      const MarketDatabase& marketDatabase) {
+    return TryOrNest([&] {
+      auto securities = std::vector<Security>();
+      if(!config) {
+        return securities;
+      }
+      for(auto& item : config) {
+        auto symbol = item.as<std::string>();
+        auto security = ParseSecurity(symbol, marketDatabase);
+        if(security == Security()) {
+          throw std::runtime_error("Invalid security: " + symbol);
+        }
+        securities.push_back(security);
+      }
+      return securities;
+    }, std::runtime_error("Error parsing section 'bbo_watch_list'."));
+  }
 }
 
 int main(int argc, const char** argv) {
@@ -109,6 +134,9 @@ int main(int argc, const char** argv) {
       serviceLocatorClient.Get());
     auto complianceClient = ApplicationComplianceClient(
       serviceLocatorClient.Get());
+    auto bboQuotes = std::make_shared<ApplicationBboQuoteCache>(
+      marketDataClient.Get(), ParseWatchList(config["bbo_watch_list"],
+        definitionsClient->LoadMarketDatabase()));
     auto simulationOrderExecutionDriver =
       ApplicationSimulationOrderExecutionDriver(marketDataClient.Get(),
         timeClient.get());
@@ -116,27 +144,51 @@ int main(int argc, const char** argv) {
       ApplicationInternalMatchingOrderExecutionDriver(
         serviceLocatorClient->GetAccount(), Initialize(),
         marketDataClient.Get(), timeClient.get(), uidClient.Get(),
-        &simulationOrderExecutionDriver);
+        &simulationOrderExecutionDriver, bboQuotes);
     auto checks = std::vector<std::unique_ptr<OrderSubmissionCheck>>();
     TryOrNest([&] {
       checks.emplace_back(MakeBoardLotCheck(marketDataClient.Get(),
         definitionsClient->LoadMarketDatabase(),
-        definitionsClient->LoadTimeZoneDatabase()));
+        definitionsClient->LoadTimeZoneDatabase(), bboQuotes));
       checks.emplace_back(std::make_unique<
         BuyingPowerCheck<ApplicationAdministrationClient::Client*,
           ApplicationMarketDataClient::Client*>>(
             definitionsClient->LoadExchangeRates(), administrationClient.Get(),
-            marketDataClient.Get()));
+            marketDataClient.Get(), bboQuotes));
       checks.emplace_back(std::make_unique<
         RiskStateCheck<ApplicationAdministrationClient::Client*>>(
           administrationClient.Get()));
     }, std::runtime_error("Unable to initialize order submission checks"));
+    auto checkNames = std::vector<std::string>();
+    for(auto& check : checks) {
+      checkNames.push_back(check->GetName());
+    }
     auto orderSubmissionCheckDriver = ApplicationOrderSubmissionCheckDriver(
       &internalMatchingOrderExecutionDriver, std::move(checks));
+    auto metricsInterval = Extract<time_duration>(config, "metrics_interval",
+      minutes(1));
+    auto metricsTasks = RoutineTaskQueue();
+    auto metricsTimer = LiveTimer(metricsInterval);
+    metricsTimer.GetPublisher().Monitor(metricsTasks.GetSlot<Timer::Result>(
+      [&] (auto result) {
+        if(result != Timer::Result::EXPIRED) {
+          return;
+        }
+        auto metrics = orderSubmissionCheckDriver.GetMetrics();
+        auto report = std::ostringstream();
+        report << "Order submission checks: " << metrics.m_submission << '\n';
+        for(auto i = std::size_t(0); i != metrics.m_checks.size(); ++i) {
+          report << "  " << checkNames[i] << ": " << metrics.m_checks[i] <<
+            '\n';
+        }
+        std::cout << report.str() << std::flush;
+        metricsTimer.Start();
+      }));
+    metricsTimer.Start();
     auto complianceRuleSet = ComplianceRuleSet(complianceClient.Get(),
       serviceLocatorClient.Get(), [&] (const auto& entry) {
         return MakeComplianceRule(entry.GetSchema(), *marketDataClient,
-          *definitionsClient, *timeClient);
+          *definitionsClient, *timeClient, bboQuotes);
       });
     auto complianceCheckOrderExecutionDriver =
       ApplicationComplianceCheckOrderExecutionDriver(
@@ -169,6 +221,8 @@ int main(int argc, const char** argv) {
       std::bind(factory<std::shared_ptr<LiveTimer>>(), seconds(10)));
     Register(*serviceLocatorClient, serviceConfig);
     WaitForKillEvent();
+    metricsTasks.Break();
+    metricsTasks.Wait();
     serviceLocatorClient->Close();
     complianceClient->Close();
     marketDataClient->Close();
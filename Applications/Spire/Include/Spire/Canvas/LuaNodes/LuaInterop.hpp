@@ -31,30 +31,31 @@ namespace Spire {
   struct PopLuaValue<Nexus::Money> {
     Nexus::Money operator ()(lua_State& state) const {
       return Nexus::Money{Nexus::Quantity::FromRepresentation(
-        lua_tonumber(&state, -1))};
+        Nexus::Details::ToRepresentation(lua_tonumber(&state, -1)))};
     }
   };
 
   template<>
   struct PushLuaValue<Nexus::Money> {
     void operator ()(lua_State& state, Nexus::Money value) const {
-      lua_pushnumber(&state,
-        static_cast<Nexus::Quantity>(value).GetRepresentation());
+      lua_pushnumber(&state, static_cast<boost::float64_t>(
+        static_cast<Nexus::Quantity>(value).GetRepresentation()));
     }
   };
 
   template<>
   struct PopLuaValue<Nexus::Quantity> {
     Nexus::Quantity operator ()(lua_State& state) const {
-      return Nexus::Quantity::FromRepresentation(lua_tonumber(&state, -1));
+      return Nexus::Quantity::FromRepresentation(
+        Nexus::Details::ToRepresentation(lua_tonumber(&state, -1)));
     }
   };
 
   template<>
   struct PushLuaValue<Nexus::Quantity> {
     void operator ()(lua_State& state, Nexus::Quantity value) const {
-      lua_pushnumber(&state,
-        static_cast<Nexus::Quantity>(value).GetRepresentation());
+      lua_pushnumber(&state, static_cast<boost::float64_t>(
+        static_cast<Nexus::Quantity>(value).GetRepresentation()));
     }
   };
 
@@ -1,7 +1,8 @@
 #ifndef WEB_PORTAL_PORTFOLIO_MODEL_HPP
 #define WEB_PORTAL_PORTFOLIO_MODEL_HPP
-#include <memory>
+#include <cstddef>
 #include <unordered_map>
+#include <vector>
 #include <Beam/Queues/QueueWriterPublisher.hpp>
 #include <Beam/Queues/RoutineTaskQueue.hpp>
 #include <Beam/Serialization/ShuttleOptional.hpp>
@@ -63,17 +64,29 @@ namespace Nexus::WebPortal {
       void Close();
 
     private:
+
+      /**
+       * Stores every position as a row spread across parallel columns, so that
+       * revaluing all positions in a Security only touches the inventory and
+       * unrealized profit and loss of its rows.
+       */
+      struct Positions {
+        std::vector<Beam::ServiceLocator::DirectoryEntry> m_accounts;
+        std::vector<RiskService::RiskInventory> m_inventories;
+        std::vector<boost::optional<Money>> m_unrealizedProfitAndLosses;
+      };
       ServiceClientsBox m_serviceClients;
-      std::unordered_map<RiskService::RiskPortfolioKey, std::shared_ptr<Entry>>
-        m_entries;
-      std::unordered_map<Security, std::vector<std::shared_ptr<Entry>>>
-        m_securityToEntries;
+      Positions m_positions;
+      std::unordered_map<RiskService::RiskPortfolioKey, std::size_t> m_rows;
+      std::unordered_map<Security, std::vector<std::size_t>> m_securityRows;
       Beam::QueueWriterPublisher<Entry> m_publisher;
       std::unordered_map<Security, Accounting::SecurityValuation> m_valuations;
       Beam::RoutineTaskQueue m_tasks;
 
       PortfolioModel(const PortfolioModel&) = delete;
       PortfolioModel& operator =(const PortfolioModel&) = delete;
+      std::size_t InsertRow(const RiskService::RiskInventoryEntry& inventory);
+      Entry MakeEntry(std::size_t row) const;
       void OnRiskPortfolioInventoryUpdate(
         const RiskService::RiskInventoryEntry& inventory);
       void OnBboQuote(const Security& security,
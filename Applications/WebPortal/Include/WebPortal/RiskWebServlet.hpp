@@ -1,6 +1,9 @@
 #ifndef NEXUS_RISK_WEB_SERVLET_HPP
 #define NEXUS_RISK_WEB_SERVLET_HPP
+#include <cstddef>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 #include <Beam/IO/OpenState.hpp>
 #include <Beam/Network/TcpSocketChannel.hpp>
 #include <Beam/Pointers/Ref.hpp>
@@ -63,15 +66,19 @@ namespace Nexus::WebPortal {
         StompServer m_client;
         std::string m_subscriptionId;
         PortfolioFilter m_filter;
+        std::vector<bool> m_visibleRows;
 
         PortfolioSubscriber(Beam::ServiceLocator::DirectoryEntry account,
           std::unique_ptr<WebSocketChannel> channel);
       };
       ServiceClientsBox m_serviceClients;
       Beam::WebServices::SessionStore<WebPortalSession>* m_sessions;
-      std::unordered_map<RiskService::RiskPortfolioKey, PortfolioModel::Entry>
-        m_portfolioEntries;
-      std::unordered_set<PortfolioModel::Entry> m_updatedPortfolioEntries;
+      std::vector<PortfolioModel::Entry> m_portfolioEntries;
+      std::vector<Beam::ServiceLocator::DirectoryEntry> m_portfolioGroups;
+      std::unordered_map<RiskService::RiskPortfolioKey, std::size_t>
+        m_portfolioRows;
+      std::vector<bool> m_isPortfolioRowDirty;
+      std::vector<std::size_t> m_dirtyPortfolioRows;
       std::vector<std::shared_ptr<PortfolioSubscriber>> m_porfolioSubscribers;
       PortfolioModel m_portfolioModel;
       Beam::Threading::TimerBox m_portfolioTimer;
@@ -84,9 +91,12 @@ namespace Nexus::WebPortal {
       RiskWebServlet& operator =(const RiskWebServlet&) = delete;
       const Beam::ServiceLocator::DirectoryEntry& FindTradingGroup(
         const Beam::ServiceLocator::DirectoryEntry& trader);
+      void AppendVisibleRows(const PortfolioFilter& filter,
+        std::vector<bool>& visibleRows) const;
       void SendPortfolioEntry(const PortfolioModel::Entry& entry,
-        const Beam::ServiceLocator::DirectoryEntry& group,
-        PortfolioSubscriber& subscriber, bool checkFilter);
+        PortfolioSubscriber& subscriber);
+      void SendPortfolioEntry(const Beam::IO::SharedBuffer& entry,
+        PortfolioSubscriber& subscriber);
       void OnPortfolioUpgrade(const Beam::WebServices::HttpRequest& request,
         std::unique_ptr<WebSocketChannel> channel);
       void OnPortfolioRequest(
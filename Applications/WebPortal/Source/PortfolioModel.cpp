@@ -39,17 +39,36 @@ const Publisher<PortfolioModel::Entry>& PortfolioModel::GetPublisher() const {
 
 void PortfolioModel::Close() {}
 
+std::size_t PortfolioModel::InsertRow(const RiskInventoryEntry& inventory) {
+  auto row = m_positions.m_inventories.size();
+  m_positions.m_accounts.push_back(inventory.m_key.m_account);
+  m_positions.m_unrealizedProfitAndLosses.push_back(none);
+  m_positions.m_inventories.emplace_back(inventory.m_value.m_position.m_key);
+  m_rows.insert(std::pair(inventory.m_key, row));
+  m_securityRows[inventory.m_key.m_security].push_back(row);
+  return row;
+}
+
+PortfolioModel::Entry PortfolioModel::MakeEntry(std::size_t row) const {
+  auto& inventory = m_positions.m_inventories[row];
+  auto entry = Entry(m_positions.m_accounts[row],
+    inventory.m_position.m_key.m_index, inventory.m_position.m_key.m_currency);
+  entry.m_inventory = inventory;
+  entry.m_unrealizedProfitAndLoss =
+    m_positions.m_unrealizedProfitAndLosses[row];
+  return entry;
+}
+
 void PortfolioModel::OnRiskPortfolioInventoryUpdate(
     const RiskInventoryEntry& inventory) {
   auto& security = inventory.m_key.m_security;
-  auto entryIterator = m_entries.find(inventory.m_key);
-  if(entryIterator == m_entries.end()) {
-    auto entry = std::make_shared<Entry>(inventory.m_key.m_account,
-      inventory.m_key.m_security,
-      inventory.m_value.m_position.m_key.m_currency);
-    entryIterator = m_entries.insert(std::pair(inventory.m_key, entry)).first;
-    m_securityToEntries[security].push_back(entry);
-  }
+  auto row = [&] {
+    auto rowIterator = m_rows.find(inventory.m_key);
+    if(rowIterator == m_rows.end()) {
+      return InsertRow(inventory);
+    }
+    return rowIterator->second;
+  }();
   auto& valuation =
     [&] () -> SecurityValuation& {
       auto valuationIterator = m_valuations.find(security);
@@ -65,11 +84,10 @@ void PortfolioModel::OnRiskPortfolioInventoryUpdate(
       }
       return valuationIterator->second;
     }();
-  auto entry = entryIterator->second;
-  entry->m_inventory = inventory.m_value;
-  entry->m_unrealizedProfitAndLoss = GetUnrealizedProfitAndLoss(
-    entry->m_inventory, valuation);
-  m_publisher.Push(*entry);
+  m_positions.m_inventories[row] = inventory.m_value;
+  m_positions.m_unrealizedProfitAndLosses[row] =
+    GetUnrealizedProfitAndLoss(inventory.m_value, valuation);
+  m_publisher.Push(MakeEntry(row));
 }
 
 void PortfolioModel::OnBboQuote(const Security& security,
@@ -80,10 +98,23 @@ void PortfolioModel::OnBboQuote(const Security& security,
   }
   valuation.m_bidValue = quote.m_bid.m_price;
   valuation.m_askValue = quote.m_ask.m_price;
-  for(auto& entry : m_securityToEntries[security]) {
-    entry->m_unrealizedProfitAndLoss = GetUnrealizedProfitAndLoss(
-      entry->m_inventory, valuation);
-    m_publisher.Push(*entry);
+  auto rowsIterator = m_securityRows.find(security);
+  if(rowsIterator == m_securityRows.end()) {
+    return;
+  }
+  auto& rows = rowsIterator->second;
+  auto updatedRows = std::vector<std::size_t>();
+  for(auto row : rows) {
+    auto unrealizedProfitAndLoss = GetUnrealizedProfitAndLoss(
+      m_positions.m_inventories[row], valuation);
+    auto& previous = m_positions.m_unrealizedProfitAndLosses[row];
+    if(unrealizedProfitAndLoss != previous) {
+      previous = unrealizedProfitAndLoss;
+      updatedRows.push_back(row);
+    }
+  }
+  for(auto row : updatedRows) {
+    m_publisher.Push(MakeEntry(row));
   }
 }
 
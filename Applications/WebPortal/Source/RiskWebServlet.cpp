@@ -114,21 +114,28 @@ const DirectoryEntry& RiskWebServlet::FindTradingGroup(
   return FindTradingGroup(trader);
 }
 
-void RiskWebServlet::SendPortfolioEntry(const PortfolioModel::Entry& entry,
-    const DirectoryEntry& group, PortfolioSubscriber& subscriber,
-    bool checkFilter) {
-  if(checkFilter) {
-    if(subscriber.m_filter.IsFiltered(entry, group)) {
-      return;
-    }
+void RiskWebServlet::AppendVisibleRows(const PortfolioFilter& filter,
+    std::vector<bool>& visibleRows) const {
+  visibleRows.reserve(m_portfolioEntries.size());
+  for(auto row = visibleRows.size(); row < m_portfolioEntries.size(); ++row) {
+    visibleRows.push_back(!filter.IsFiltered(m_portfolioEntries[row],
+      m_portfolioGroups[row]));
   }
+}
+
+void RiskWebServlet::SendPortfolioEntry(const PortfolioModel::Entry& entry,
+    PortfolioSubscriber& subscriber) {
   auto sender = JsonSender<SharedBuffer>();
+  SendPortfolioEntry(Encode<SharedBuffer>(sender, entry), subscriber);
+}
+
+void RiskWebServlet::SendPortfolioEntry(const SharedBuffer& entry,
+    PortfolioSubscriber& subscriber) {
   auto entryFrame = StompFrame(StompCommand::MESSAGE);
   entryFrame.AddHeader({"subscription", subscriber.m_subscriptionId});
   entryFrame.AddHeader({"destination", "/api/risk_service/portfolio"});
   entryFrame.AddHeader({"content-type", "application/json"});
-  auto buffer = Encode<SharedBuffer>(sender, entry);
-  entryFrame.SetBody(std::move(buffer));
+  entryFrame.SetBody(entry);
   subscriber.m_client.Write(entryFrame);
 }
 
@@ -196,12 +203,14 @@ void RiskWebServlet::OnPortfolioRequest(
       for(auto& market : marketDatabase.GetEntries()) {
         subscriber->m_filter.m_markets.insert(market.m_code);
       }
-      for(auto& entry : m_portfolioEntries) {
-        auto& group = FindTradingGroup(entry.second.m_account);
-        try {
-          SendPortfolioEntry(entry.second, group, *subscriber, true);
-        } catch(const std::exception&) {
-          return;
+      AppendVisibleRows(subscriber->m_filter, subscriber->m_visibleRows);
+      for(auto row = std::size_t(0); row != m_portfolioEntries.size(); ++row) {
+        if(subscriber->m_visibleRows[row]) {
+          try {
+            SendPortfolioEntry(m_portfolioEntries[row], *subscriber);
+          } catch(const std::exception&) {
+            return;
+          }
         }
       }
       m_porfolioSubscribers.push_back(subscriber);
@@ -257,67 +266,87 @@ void RiskWebServlet::OnPortfolioFilterRequest(
   std::move(parameters.m_currencies.begin(), parameters.m_currencies.end(),
     std::inserter(updatedFilter.m_currencies,
     updatedFilter.m_currencies.end()));
-  for(auto& entry : m_portfolioEntries) {
-    auto& group = FindTradingGroup(entry.second.m_account);
-    if(!subscriber->m_filter.IsFiltered(entry.second, group) &&
-        updatedFilter.IsFiltered(entry.second, group)) {
-      auto emptyEntry = entry.second;
-      emptyEntry.m_unrealizedProfitAndLoss = Money::ZERO;
-      emptyEntry.m_inventory.m_volume = 0;
-      emptyEntry.m_inventory.m_transactionCount = 0;
-      try {
-        SendPortfolioEntry(emptyEntry, group, *subscriber, false);
-      } catch(const std::exception&) {
-        return;
-      }
-    } else if(subscriber->m_filter.IsFiltered(entry.second, group) &&
-        !updatedFilter.IsFiltered(entry.second, group)) {
-      try {
-        SendPortfolioEntry(entry.second, group, *subscriber, false);
-      } catch(const std::exception&) {
-        return;
+  m_tasks.Push(
+    [=] {
+      auto visibleRows = std::vector<bool>();
+      AppendVisibleRows(updatedFilter, visibleRows);
+      AppendVisibleRows(subscriber->m_filter, subscriber->m_visibleRows);
+      for(auto row = std::size_t(0); row != m_portfolioEntries.size(); ++row) {
+        if(subscriber->m_visibleRows[row] && !visibleRows[row]) {
+          auto emptyEntry = m_portfolioEntries[row];
+          emptyEntry.m_unrealizedProfitAndLoss = Money::ZERO;
+          emptyEntry.m_inventory.m_volume = 0;
+          emptyEntry.m_inventory.m_transactionCount = 0;
+          try {
+            SendPortfolioEntry(emptyEntry, *subscriber);
+          } catch(const std::exception&) {
+            return;
+          }
+        } else if(!subscriber->m_visibleRows[row] && visibleRows[row]) {
+          try {
+            SendPortfolioEntry(m_portfolioEntries[row], *subscriber);
+          } catch(const std::exception&) {
+            return;
+          }
+        }
       }
-    }
-  }
-  subscriber->m_filter = std::move(updatedFilter);
+      subscriber->m_filter = updatedFilter;
+      subscriber->m_visibleRows = std::move(visibleRows);
+    });
 }
 
 void RiskWebServlet::OnPortfolioUpdate(
     const PortfolioModel::Entry& entry) {
-  m_updatedPortfolioEntries.insert(entry);
+  auto key = RiskPortfolioKey(entry.m_account,
+    entry.m_inventory.m_position.m_key.m_index);
+  auto rowIterator = m_portfolioRows.find(key);
+  if(rowIterator == m_portfolioRows.end()) {
+    rowIterator = m_portfolioRows.insert(
+      std::pair(key, m_portfolioEntries.size())).first;
+    m_portfolioGroups.push_back(FindTradingGroup(entry.m_account));
+    m_portfolioEntries.push_back(entry);
+    m_isPortfolioRowDirty.push_back(false);
+  } else {
+    m_portfolioEntries[rowIterator->second] = entry;
+  }
+  auto row = rowIterator->second;
+  if(!m_isPortfolioRowDirty[row]) {
+    m_isPortfolioRowDirty[row] = true;
+    m_dirtyPortfolioRows.push_back(row);
+  }
 }
 
 void RiskWebServlet::OnPortfolioTimerExpired(Timer::Result result) {
   if(result != Timer::Result::EXPIRED) {
     return;
   }
-  auto updatedEntries = std::vector<PortfolioModel::Entry>();
-  updatedEntries.reserve(m_updatedPortfolioEntries.size());
-  std::move(m_updatedPortfolioEntries.begin(), m_updatedPortfolioEntries.end(),
-    std::back_inserter(updatedEntries));
-  for(auto& updatedEntry : updatedEntries) {
-    auto key = RiskPortfolioKey(updatedEntry.m_account,
-      updatedEntry.m_inventory.m_position.m_key.m_index);
-    auto entryResult = m_portfolioEntries.insert(
-      std::make_pair(key, updatedEntry));
-    if(!entryResult.second) {
-      entryResult.first->second = updatedEntry;
+  auto updatedEntries = std::vector<SharedBuffer>();
+  if(!m_porfolioSubscribers.empty()) {
+    auto sender = JsonSender<SharedBuffer>();
+    updatedEntries.reserve(m_dirtyPortfolioRows.size());
+    for(auto row : m_dirtyPortfolioRows) {
+      updatedEntries.push_back(
+        Encode<SharedBuffer>(sender, m_portfolioEntries[row]));
     }
   }
-  m_updatedPortfolioEntries.clear();
-  auto sender = JsonSender<SharedBuffer>();
   auto i = m_porfolioSubscribers.begin();
   while(i != m_porfolioSubscribers.end()) {
     auto& subscriber = *i;
+    AppendVisibleRows(subscriber->m_filter, subscriber->m_visibleRows);
     try {
-      for(auto& entry : updatedEntries) {
-        auto& group = FindTradingGroup(entry.m_account);
-        SendPortfolioEntry(entry, group, *subscriber, true);
+      for(auto j = std::size_t(0); j != m_dirtyPortfolioRows.size(); ++j) {
+        if(subscriber->m_visibleRows[m_dirtyPortfolioRows[j]]) {
+          SendPortfolioEntry(updatedEntries[j], *subscriber);
+        }
       }
       ++i;
     } catch(const std::exception&) {
       i = m_porfolioSubscribers.erase(i);
     }
   }
+  for(auto row : m_dirtyPortfolioRows) {
+    m_isPortfolioRowDirty[row] = false;
+  }
+  m_dirtyPortfolioRows.clear();
   m_portfolioTimer.Start();
 }
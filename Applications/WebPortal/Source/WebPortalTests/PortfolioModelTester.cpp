@@ -0,0 +1,153 @@
+#include <Beam/Queues/Queue.hpp>
+#include <Beam/Queues/QueueWriterPublisher.hpp>
+#include <doctest/doctest.h>
+#include "Nexus/ServiceClients/TestEnvironment.hpp"
+#include "Nexus/ServiceClients/TestServiceClients.hpp"
+#include "WebPortal/PortfolioModel.hpp"
+
+using namespace Beam;
+using namespace Beam::ServiceLocator;
+using namespace boost;
+using namespace boost::posix_time;
+using namespace Nexus;
+using namespace Nexus::RiskService;
+using namespace Nexus::WebPortal;
+
+namespace {
+  const auto TST = Security("TST", DefaultMarkets::TSX(),
+    DefaultCountries::CA());
+
+  struct TestRiskClient {
+    QueueWriterPublisher<RiskInventoryEntry>* m_publisher;
+
+    InventorySnapshot LoadInventorySnapshot(const DirectoryEntry& account) {
+      return {};
+    }
+
+    void Reset(const Region& region) {}
+
+    const RiskPortfolioUpdatePublisher& GetRiskPortfolioUpdatePublisher() {
+      return *m_publisher;
+    }
+
+    void Close() {}
+  };
+
+  struct PortfolioServiceClients {
+    TestServiceClients* m_clients;
+    RiskClientBox m_riskClient;
+
+    auto& GetServiceLocatorClient() {
+      return m_clients->GetServiceLocatorClient();
+    }
+
+    auto& GetRegistryClient() {
+      return m_clients->GetRegistryClient();
+    }
+
+    auto& GetAdministrationClient() {
+      return m_clients->GetAdministrationClient();
+    }
+
+    auto& GetDefinitionsClient() {
+      return m_clients->GetDefinitionsClient();
+    }
+
+    auto& GetMarketDataClient() {
+      return m_clients->GetMarketDataClient();
+    }
+
+    auto& GetChartingClient() {
+      return m_clients->GetChartingClient();
+    }
+
+    auto& GetComplianceClient() {
+      return m_clients->GetComplianceClient();
+    }
+
+    auto& GetOrderExecutionClient() {
+      return m_clients->GetOrderExecutionClient();
+    }
+
+    auto& GetRiskClient() {
+      return m_riskClient;
+    }
+
+    auto& GetTimeClient() {
+      return m_clients->GetTimeClient();
+    }
+
+    auto MakeTimer(time_duration expiry) {
+      return m_clients->MakeTimer(expiry);
+    }
+
+    void Close() {}
+  };
+
+  struct Fixture {
+    TestEnvironment m_environment;
+    TestServiceClients m_serviceClients;
+    QueueWriterPublisher<RiskInventoryEntry> m_riskPublisher;
+    PortfolioModel m_model;
+    std::shared_ptr<Queue<PortfolioModel::Entry>> m_entries;
+
+    Fixture()
+        : m_serviceClients(Ref(m_environment)),
+          m_model(ServiceClientsBox(PortfolioServiceClients{&m_serviceClients,
+            RiskClientBox(TestRiskClient{&m_riskPublisher})})),
+          m_entries(std::make_shared<Queue<PortfolioModel::Entry>>()) {
+      m_model.GetPublisher().Monitor(m_entries);
+    }
+
+    void Publish(const DirectoryEntry& account, Quantity quantity,
+        Money costBasis) {
+      auto inventory = RiskInventory(
+        RiskPosition::Key(TST, DefaultCurrencies::CAD()));
+      inventory.m_position.m_quantity = quantity;
+      inventory.m_position.m_costBasis = costBasis;
+      m_riskPublisher.Push(
+        RiskInventoryEntry(RiskPortfolioKey(account, TST), inventory));
+    }
+
+    PortfolioModel::Entry PopValued() {
+      while(true) {
+        auto entry = m_entries->Pop();
+        if(entry.m_unrealizedProfitAndLoss) {
+          return entry;
+        }
+      }
+    }
+  };
+}
+
+TEST_SUITE("PortfolioModel") {
+  TEST_CASE_FIXTURE(Fixture, "revaluation") {
+    m_environment.UpdateBboPrice(TST, Money::ONE, Money::ONE + Money::CENT);
+    auto longAccount = DirectoryEntry::MakeAccount(100, "long");
+    auto shortAccount = DirectoryEntry::MakeAccount(101, "short");
+    Publish(longAccount, 100, 90 * Money::ONE);
+    auto entry = PopValued();
+    REQUIRE(entry.m_account == longAccount);
+    REQUIRE(entry.m_inventory.m_position.m_quantity == 100);
+    REQUIRE(*entry.m_unrealizedProfitAndLoss == 10 * Money::ONE);
+    Publish(shortAccount, -100, -100 * Money::ONE);
+    entry = m_entries->Pop();
+    REQUIRE(entry.m_account == shortAccount);
+    REQUIRE(*entry.m_unrealizedProfitAndLoss == -Money::ONE);
+    m_environment.UpdateBboPrice(TST, Money::ONE + Money::CENT,
+      Money::ONE + Money::CENT);
+    entry = m_entries->Pop();
+    REQUIRE(entry.m_account == longAccount);
+    REQUIRE(*entry.m_unrealizedProfitAndLoss == 11 * Money::ONE);
+    m_environment.UpdateBboPrice(TST, Money::ONE + Money::CENT,
+      Money::ONE + 2 * Money::CENT);
+    entry = m_entries->Pop();
+    REQUIRE(entry.m_account == shortAccount);
+    REQUIRE(*entry.m_unrealizedProfitAndLoss == -2 * Money::ONE);
+    Publish(longAccount, 0, Money::ZERO);
+    entry = m_entries->Pop();
+    REQUIRE(entry.m_account == longAccount);
+    REQUIRE(entry.m_inventory.m_position.m_quantity == 0);
+    REQUIRE(*entry.m_unrealizedProfitAndLoss == Money::ZERO);
+  }
+}
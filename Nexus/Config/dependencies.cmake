@@ -3,3 +3,8 @@ if(WIN32)
 else()
   include("${CMAKE_CURRENT_LIST_DIR}/dependencies.posix.cmake")
 endif()
+option(NEXUS_FIXED_POINT_QUANTITY
+  "Represent Quantity and Money as 64-bit fixed-point integers." OFF)
+if(NEXUS_FIXED_POINT_QUANTITY)
+  add_definitions(-DNEXUS_FIXED_POINT_QUANTITY)
+endif()
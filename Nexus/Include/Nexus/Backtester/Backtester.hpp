@@ -11,9 +11,11 @@ namespace Nexus {
   class BacktesterServiceClients;
   class BacktesterTimeClient;
   class BacktesterTimer;
+  class BacktesterTimeWindow;
   template<typename H> class CutoffHistoricalDataStore;
   template<typename I, typename T> class MarketDataEvent;
   template<typename T> class MarketDataLoadEvent;
+  template<typename T> class MarketDataPrefetcher;
   template<typename T> class MarketDataQueryEvent;
   class TimerBacktesterEvent;
 }
@@ -16,6 +16,7 @@
 #include "Nexus/ComplianceTests/ComplianceTestEnvironment.hpp"
 #include "Nexus/DefinitionsServiceTests/DefinitionsServiceTestEnvironment.hpp"
 #include "Nexus/MarketDataService/ClientHistoricalDataStore.hpp"
+#include "Nexus/MarketDataService/HistoricalDataStoreBox.hpp"
 #include "Nexus/MarketDataServiceTests/MarketDataServiceTestEnvironment.hpp"
 #include "Nexus/OrderExecutionServiceTests/OrderExecutionServiceTestEnvironment.hpp"
 #include "Nexus/RiskServiceTests/RiskServiceTestEnvironment.hpp"
@@ -47,6 +48,39 @@ namespace Nexus {
       BacktesterEnvironment(boost::posix_time::ptime startTime,
         boost::posix_time::ptime endTime, ServiceClientsBox serviceClients);
 
+      /**
+       * Constructs a BacktesterEnvironment whose clock is synchronized with
+       * other backtests run in parallel.
+       * @param startTime The backtester's starting time.
+       * @param endTime The backtester's ending time.
+       * @param serviceClients The ServiceClients connected to the historical
+       *        data source.
+       * @param participant The participant in the BacktesterTimeWindow, left
+       *        when this environment is closed.
+       */
+      BacktesterEnvironment(boost::posix_time::ptime startTime,
+        boost::posix_time::ptime endTime, ServiceClientsBox serviceClients,
+        std::shared_ptr<BacktesterTimeWindow::Participant> participant);
+
+      /**
+       * Constructs a BacktesterEnvironment whose historical market data is
+       * loaded from a HistoricalDataStore rather than the
+       * <i>serviceClients</i>, such as a ColumnarHistoricalDataStore reading
+       * local column files.
+       * @param startTime The backtester's starting time.
+       * @param endTime The backtester's ending time.
+       * @param serviceClients The ServiceClients connected to the historical
+       *        data source.
+       * @param dataStore The HistoricalDataStore to load historical market
+       *        data from, closed along with this environment.
+       * @param participant The participant in the BacktesterTimeWindow, left
+       *        when this environment is closed.
+       */
+      BacktesterEnvironment(boost::posix_time::ptime startTime,
+        boost::posix_time::ptime endTime, ServiceClientsBox serviceClients,
+        MarketDataService::HistoricalDataStoreBox dataStore,
+        std::shared_ptr<BacktesterTimeWindow::Participant> participant);
+
       ~BacktesterEnvironment();
 
       /** Returns the BacktesterEventHandler. */
@@ -141,11 +175,30 @@ namespace Nexus {
     : BacktesterEnvironment(startTime, boost::posix_time::pos_infin,
         std::move(serviceClients)) {}
 
+  inline BacktesterEnvironment::BacktesterEnvironment(
+    boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+    ServiceClientsBox serviceClients)
+    : BacktesterEnvironment(startTime, endTime, std::move(serviceClients),
+        std::shared_ptr<BacktesterTimeWindow::Participant>()) {}
+
+  inline BacktesterEnvironment::BacktesterEnvironment(
+    boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+    ServiceClientsBox serviceClients,
+    std::shared_ptr<BacktesterTimeWindow::Participant> participant)
+    : BacktesterEnvironment(startTime, endTime, serviceClients,
+        MarketDataService::HistoricalDataStoreBox(std::in_place_type<
+          MarketDataService::ClientHistoricalDataStore<
+            MarketDataService::MarketDataClientBox>>,
+          serviceClients.GetMarketDataClient()),
+        std::move(participant)) {}
+
   inline BacktesterEnvironment::BacktesterEnvironment(
       boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
-      ServiceClientsBox serviceClients)
+      ServiceClientsBox serviceClients,
+      MarketDataService::HistoricalDataStoreBox dataStore,
+      std::shared_ptr<BacktesterTimeWindow::Participant> participant)
       : m_serviceClients(std::move(serviceClients)),
-        m_eventHandler(startTime, endTime),
+        m_eventHandler(startTime, endTime, std::move(participant)),
         m_timeClient(std::in_place_type<BacktesterTimeClient>,
           Beam::Ref(m_eventHandler)),
         m_serviceLocatorClient(m_serviceLocatorEnvironment.MakeClient()),
@@ -158,13 +211,10 @@ namespace Nexus {
         m_marketDataEnvironment(m_serviceLocatorClient, m_administrationClient,
           MarketDataService::HistoricalDataStoreBox(
             std::in_place_type<BacktesterHistoricalDataStore<
-              MarketDataService::ClientHistoricalDataStore<
-                MarketDataService::MarketDataClientBox>>>,
-            m_serviceClients.GetMarketDataClient(),
+              MarketDataService::HistoricalDataStoreBox>>, dataStore,
             m_eventHandler.GetStartTime())),
         m_marketDataService(Beam::Ref(m_eventHandler),
-          Beam::Ref(m_marketDataEnvironment),
-          m_serviceClients.GetMarketDataClient()),
+          Beam::Ref(m_marketDataEnvironment), dataStore),
         m_marketDataClient(std::make_unique<BacktesterMarketDataClient>(
           Beam::Ref(m_marketDataService),
           m_marketDataEnvironment.MakeRegistryClient(m_serviceLocatorClient))),
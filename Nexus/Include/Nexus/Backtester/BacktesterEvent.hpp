@@ -1,5 +1,6 @@
 #ifndef NEXUS_BACKTESTER_EVENT_HPP
 #define NEXUS_BACKTESTER_EVENT_HPP
+#include <atomic>
 #include <Beam/Threading/ConditionVariable.hpp>
 #include <Beam/Threading/Mutex.hpp>
 #include "Nexus/Backtester/Backtester.hpp"
@@ -37,7 +38,8 @@ namespace Nexus {
     private:
       friend class BacktesterEventHandler;
       mutable Beam::Threading::Mutex m_mutex;
-      bool m_isComplete;
+      std::atomic_bool m_isComplete;
+      std::atomic_int m_waiterCount;
       Beam::Threading::ConditionVariable m_isCompleteCondition;
       boost::posix_time::ptime m_timestamp;
 
@@ -50,10 +52,15 @@ namespace Nexus {
   }
 
   inline void BacktesterEvent::Wait() {
+    if(m_isComplete) {
+      return;
+    }
     auto lock = boost::unique_lock(m_mutex);
+    ++m_waiterCount;
     while(!m_isComplete) {
       m_isCompleteCondition.wait(lock);
     }
+    --m_waiterCount;
   }
 
   inline bool BacktesterEvent::IsPassive() const {
@@ -62,15 +69,15 @@ namespace Nexus {
 
   inline BacktesterEvent::BacktesterEvent(boost::posix_time::ptime timestamp)
     : m_isComplete(false),
+      m_waiterCount(0),
       m_timestamp(timestamp) {}
 
   inline void BacktesterEvent::Complete() {
+    if(m_isComplete.exchange(true) || m_waiterCount == 0) {
+      return;
+    }
     {
       auto lock = boost::lock_guard(m_mutex);
-      if(m_isComplete) {
-        return;
-      }
-      m_isComplete = true;
     }
     m_isCompleteCondition.notify_one();
   }
@@ -1,10 +1,12 @@
 #ifndef NEXUS_BACKTESTER_EVENT_HANDLER_HPP
 #define NEXUS_BACKTESTER_EVENT_HANDLER_HPP
 #include <algorithm>
-#include <deque>
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <Beam/IO/OpenState.hpp>
 #include <Beam/Routines/RoutineHandler.hpp>
+#include <Beam/Routines/RoutineHandlerGroup.hpp>
 #include <Beam/Threading/ConditionVariable.hpp>
 #include <Beam/Threading/LockRelease.hpp>
 #include <Beam/Threading/Mutex.hpp>
@@ -14,10 +16,19 @@
 #include <boost/date_time/posix_time/posix_time_types.hpp>
 #include "Nexus/Backtester/Backtester.hpp"
 #include "Nexus/Backtester/BacktesterEvent.hpp"
+#include "Nexus/Backtester/BacktesterTimeWindow.hpp"
 
 namespace Nexus {
 
-  /** Implements an event loop to handle BacktesterEvents. */
+  /**
+   * Implements an event loop to handle BacktesterEvents. Events are handled
+   * in order of their timestamp, and events sharing a timestamp are handled
+   * in the order they were added. Each list of events added together is kept
+   * as a sorted run, and the event loop merges the runs through a min-heap so
+   * that adding a run of ticks costs the same as adding a single event.
+   * Routines spawned through the handler are settled after each event, so
+   * handlers run in parallel never wait on one another's routines.
+   */
   class BacktesterEventHandler {
     public:
 
@@ -35,6 +46,18 @@ namespace Nexus {
       BacktesterEventHandler(boost::posix_time::ptime startTime,
         boost::posix_time::ptime endTime);
 
+      /**
+       * Constructs a BacktesterEventHandler whose clock is synchronized with
+       * other backtests run in parallel.
+       * @param startTime The starting point of the backtester.
+       * @param endTime The time to stop backtesting.
+       * @param participant The participant in the BacktesterTimeWindow, left
+       *        when this handler is closed.
+       */
+      BacktesterEventHandler(boost::posix_time::ptime startTime,
+        boost::posix_time::ptime endTime,
+        std::shared_ptr<BacktesterTimeWindow::Participant> participant);
+
       ~BacktesterEventHandler();
 
       /** Returns the start time. */
@@ -58,36 +81,100 @@ namespace Nexus {
        */
       void Add(std::vector<std::shared_ptr<BacktesterEvent>> events);
 
+      /**
+       * Spawns a routine on behalf of the events being handled. The event
+       * loop does not advance past the current event until every routine
+       * spawned this way has completed.
+       * @param f The function to run within the routine.
+       */
+      template<typename F>
+      void Spawn(F&& f);
+
       void Close();
 
     private:
+      static constexpr auto MAX_FREE_RUNS = std::size_t(64);
+      struct Run {
+        std::vector<std::shared_ptr<BacktesterEvent>> m_events;
+        std::size_t m_position;
+        std::uint64_t m_sequence;
+
+        boost::posix_time::ptime GetTimestamp() const;
+        std::uint64_t GetSequence() const;
+      };
+      struct RunComparator {
+        bool operator ()(const Run& lhs, const Run& rhs) const;
+      };
       mutable Beam::Threading::Mutex m_mutex;
       boost::posix_time::ptime m_startTime;
       boost::posix_time::ptime m_endTime;
       Beam::TimeService::Tests::TimeServiceTestEnvironment m_timeEnvironment;
-      std::deque<std::shared_ptr<BacktesterEvent>> m_events;
-      std::size_t m_activeCount;
+      std::shared_ptr<BacktesterTimeWindow::Participant> m_participant;
+      std::uint64_t m_nextSequence;
+      std::vector<Run> m_pendingRuns;
+      std::vector<std::vector<std::shared_ptr<BacktesterEvent>>> m_freeRuns;
+      std::atomic_bool m_hasPendingRuns;
+      std::atomic<std::size_t> m_activeCount;
+      bool m_isWaiting;
+      std::size_t m_pendingRoutineCount;
+      std::vector<Run> m_runs;
       Beam::Threading::ConditionVariable m_eventAvailableCondition;
+      Beam::Threading::ConditionVariable m_routinesCompleteCondition;
+      Beam::Routines::RoutineHandlerGroup m_routines;
       Beam::Routines::RoutineHandler m_eventLoopRoutine;
       Beam::IO::OpenState m_openState;
 
       BacktesterEventHandler(const BacktesterEventHandler&) = delete;
       BacktesterEventHandler& operator =(
         const BacktesterEventHandler&) = delete;
+      void Add(std::vector<std::shared_ptr<BacktesterEvent>> events,
+        std::size_t activeCount);
+      void OnRoutineComplete();
+      void FlushRoutines();
       void EventLoop();
   };
 
+  inline boost::posix_time::ptime
+      BacktesterEventHandler::Run::GetTimestamp() const {
+    return m_events[m_position]->GetTimestamp();
+  }
+
+  inline std::uint64_t BacktesterEventHandler::Run::GetSequence() const {
+    return m_sequence + m_position;
+  }
+
+  inline bool BacktesterEventHandler::RunComparator::operator ()(
+      const Run& lhs, const Run& rhs) const {
+    auto lhsTimestamp = lhs.GetTimestamp();
+    auto rhsTimestamp = rhs.GetTimestamp();
+    if(lhsTimestamp != rhsTimestamp) {
+      return lhsTimestamp > rhsTimestamp;
+    }
+    return lhs.GetSequence() > rhs.GetSequence();
+  }
+
   inline BacktesterEventHandler::BacktesterEventHandler(
     boost::posix_time::ptime startTime)
     : BacktesterEventHandler(std::move(startTime),
         boost::posix_time::pos_infin) {}
 
   inline BacktesterEventHandler::BacktesterEventHandler(
-      boost::posix_time::ptime startTime, boost::posix_time::ptime endTime)
+    boost::posix_time::ptime startTime, boost::posix_time::ptime endTime)
+    : BacktesterEventHandler(std::move(startTime), std::move(endTime),
+        std::shared_ptr<BacktesterTimeWindow::Participant>()) {}
+
+  inline BacktesterEventHandler::BacktesterEventHandler(
+      boost::posix_time::ptime startTime, boost::posix_time::ptime endTime,
+      std::shared_ptr<BacktesterTimeWindow::Participant> participant)
       : m_startTime(std::move(startTime)),
         m_endTime(std::move(endTime)),
+        m_timeEnvironment(m_startTime),
+        m_participant(std::move(participant)),
+        m_nextSequence(0),
+        m_hasPendingRuns(false),
         m_activeCount(0),
-        m_timeEnvironment(m_startTime) {
+        m_isWaiting(false),
+        m_pendingRoutineCount(0) {
     try {
       m_eventLoopRoutine = Beam::Routines::Spawn(
         std::bind(&BacktesterEventHandler::EventLoop, this));
@@ -115,22 +202,18 @@ namespace Nexus {
 
   inline void BacktesterEventHandler::Add(
       std::shared_ptr<BacktesterEvent> event) {
-    auto isActive = !event->IsPassive();
-    {
+    auto activeCount = std::size_t(event->IsPassive() ? 0 : 1);
+    auto events = [&] {
       auto lock = boost::lock_guard(m_mutex);
-      auto insertIterator = std::lower_bound(m_events.begin(), m_events.end(),
-        event,
-        [] (auto& lhs, auto& rhs) {
-          return lhs->GetTimestamp() < rhs->GetTimestamp();
-        });
-      m_events.insert(insertIterator, std::move(event));
-      if(isActive) {
-        ++m_activeCount;
+      if(m_freeRuns.empty()) {
+        return std::vector<std::shared_ptr<BacktesterEvent>>();
       }
-    }
-    if(isActive) {
-      m_eventAvailableCondition.notify_one();
-    }
+      auto events = std::move(m_freeRuns.back());
+      m_freeRuns.pop_back();
+      return events;
+    }();
+    events.push_back(std::move(event));
+    Add(std::move(events), activeCount);
   }
 
   inline void BacktesterEventHandler::Add(
@@ -138,25 +221,34 @@ namespace Nexus {
     if(events.empty()) {
       return;
     }
-    auto isActive = false;
+    auto comparator = [] (auto& lhs, auto& rhs) {
+      return lhs->GetTimestamp() < rhs->GetTimestamp();
+    };
+    if(!std::is_sorted(events.begin(), events.end(), comparator)) {
+      std::stable_sort(events.begin(), events.end(), comparator);
+    }
+    auto activeCount = static_cast<std::size_t>(std::count_if(events.begin(),
+      events.end(), [] (auto& event) {
+        return !event->IsPassive();
+      }));
+    Add(std::move(events), activeCount);
+  }
+
+  template<typename F>
+  void BacktesterEventHandler::Spawn(F&& f) {
     {
       auto lock = boost::lock_guard(m_mutex);
-      for(auto& event : events) {
-        isActive |= !event->IsPassive();
-        auto insertIterator = std::lower_bound(m_events.begin(), m_events.end(),
-          event,
-          [] (auto& lhs, auto& rhs) {
-            return lhs->GetTimestamp() < rhs->GetTimestamp();
-          });
-        if(!event->IsPassive()) {
-          ++m_activeCount;
-        }
-        m_events.insert(insertIterator, std::move(event));
-      }
-    }
-    if(isActive) {
-      m_eventAvailableCondition.notify_one();
+      ++m_pendingRoutineCount;
     }
+    m_routines.Spawn([this, f = std::forward<F>(f)] () mutable {
+      try {
+        f();
+      } catch(...) {
+        OnRoutineComplete();
+        throw;
+      }
+      OnRoutineComplete();
+    });
   }
 
   inline void BacktesterEventHandler::Close() {
@@ -165,34 +257,108 @@ namespace Nexus {
     }
     m_eventAvailableCondition.notify_one();
     m_eventLoopRoutine.Wait();
+    m_routines.Wait();
+    if(m_participant) {
+      m_participant->Leave();
+    }
     m_timeEnvironment.Close();
     m_openState.Close();
-    Beam::Routines::FlushPendingRoutines();
+  }
+
+  inline void BacktesterEventHandler::Add(
+      std::vector<std::shared_ptr<BacktesterEvent>> events,
+      std::size_t activeCount) {
+    auto isWaiting = [&] {
+      auto lock = boost::lock_guard(m_mutex);
+      auto sequence = m_nextSequence;
+      m_nextSequence += events.size();
+      m_pendingRuns.push_back(Run{std::move(events), 0, sequence});
+      m_hasPendingRuns = true;
+      m_activeCount += activeCount;
+      return m_isWaiting && activeCount != 0;
+    }();
+    if(isWaiting) {
+      m_eventAvailableCondition.notify_one();
+    }
+  }
+
+  inline void BacktesterEventHandler::OnRoutineComplete() {
+    auto lock = boost::lock_guard(m_mutex);
+    --m_pendingRoutineCount;
+    if(m_pendingRoutineCount == 0) {
+      m_routinesCompleteCondition.notify_all();
+    }
+  }
+
+  inline void BacktesterEventHandler::FlushRoutines() {
+    auto lock = boost::unique_lock(m_mutex);
+    while(m_pendingRoutineCount != 0) {
+      m_routinesCompleteCondition.wait(lock);
+    }
   }
 
   inline void BacktesterEventHandler::EventLoop() {
+    auto pendingRuns = std::vector<Run>();
+    auto freeRuns =
+      std::vector<std::vector<std::shared_ptr<BacktesterEvent>>>();
+    auto time = boost::posix_time::ptime(boost::posix_time::not_a_date_time);
     while(true) {
-      auto event = std::shared_ptr<BacktesterEvent>();
-      {
+      if(m_activeCount == 0 || m_hasPendingRuns || !m_openState.IsOpen()) {
         auto lock = boost::unique_lock(m_mutex);
         while(m_openState.IsOpen() && m_activeCount == 0) {
+          m_isWaiting = true;
+          if(m_participant) {
+            m_participant->SetIdle(true);
+          }
           m_eventAvailableCondition.wait(lock);
+          if(m_participant) {
+            m_participant->SetIdle(false);
+          }
+          m_isWaiting = false;
         }
         if(!m_openState.IsOpen()) {
           return;
         }
-        event = std::move(m_events.front());
-        m_events.pop_front();
-        if(!event->IsPassive()) {
-          --m_activeCount;
+        pendingRuns.swap(m_pendingRuns);
+        m_hasPendingRuns = false;
+        for(auto& events : freeRuns) {
+          if(m_freeRuns.size() == MAX_FREE_RUNS) {
+            break;
+          }
+          m_freeRuns.push_back(std::move(events));
         }
+        freeRuns.clear();
+      }
+      for(auto& run : pendingRuns) {
+        m_runs.push_back(std::move(run));
+        std::push_heap(m_runs.begin(), m_runs.end(), RunComparator());
       }
-      if(event->GetTimestamp() != boost::posix_time::neg_infin) {
-        m_timeEnvironment.SetTime(event->GetTimestamp());
+      pendingRuns.clear();
+      std::pop_heap(m_runs.begin(), m_runs.end(), RunComparator());
+      auto& run = m_runs.back();
+      auto event = std::move(run.m_events[run.m_position]);
+      ++run.m_position;
+      if(run.m_position == run.m_events.size()) {
+        run.m_events.clear();
+        freeRuns.push_back(std::move(run.m_events));
+        m_runs.pop_back();
+      } else {
+        std::push_heap(m_runs.begin(), m_runs.end(), RunComparator());
+      }
+      if(!event->IsPassive()) {
+        --m_activeCount;
+      }
+      if(event->GetTimestamp() != boost::posix_time::neg_infin &&
+          event->GetTimestamp() != time) {
+        time = event->GetTimestamp();
+        if(m_participant) {
+          m_participant->Advance(time);
+        }
+        m_timeEnvironment.SetTime(time);
       }
       event->Execute();
       event->Complete();
-      Beam::Routines::FlushPendingRoutines();
+      FlushRoutines();
     }
   }
 }
@@ -1,15 +1,24 @@
 #ifndef NEXUS_BACKTESTER_MARKET_DATA_SERVICE_HPP
 #define NEXUS_BACKTESTER_MARKET_DATA_SERVICE_HPP
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <ostream>
 #include <unordered_map>
 #include <unordered_set>
 #include <Beam/Pointers/Ref.hpp>
 #include <Beam/Queries/Sequence.hpp>
 #include <Beam/Queues/Queue.hpp>
 #include <Beam/Utilities/HashTuple.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/variant/variant.hpp>
 #include "Nexus/Backtester/Backtester.hpp"
 #include "Nexus/Backtester/BacktesterEventHandler.hpp"
+#include "Nexus/Backtester/MarketDataPrefetcher.hpp"
+#include "Nexus/MarketDataService/ClientHistoricalDataStore.hpp"
+#include "Nexus/MarketDataService/HistoricalDataStoreBox.hpp"
 #include "Nexus/MarketDataService/MarketDataClientBox.hpp"
 #include "Nexus/MarketDataService/MarketDataClientUtilities.hpp"
 #include "Nexus/MarketDataService/MarketWideDataQuery.hpp"
@@ -19,7 +28,33 @@
 
 namespace Nexus {
 
-  /** Provides historical market data to the backtester. */
+  /** Reports how long a backtest waited on historical market data. */
+  struct BacktesterMarketDataMetrics {
+
+    /** The number of chunks of market data loaded. */
+    std::int64_t m_loadCount;
+
+    /** The number of loads that had to wait for their chunk to arrive. */
+    std::int64_t m_stallCount;
+
+    /** The total time spent waiting for chunks to arrive. */
+    boost::posix_time::time_duration m_stallTime;
+
+    /** The longest time spent waiting for a single chunk. */
+    boost::posix_time::time_duration m_maxStallTime;
+  };
+
+  inline std::ostream& operator <<(std::ostream& out,
+      const BacktesterMarketDataMetrics& value) {
+    return out << "(loads: " << value.m_loadCount << " stalls: " <<
+      value.m_stallCount << " stall_time: " << value.m_stallTime <<
+      " max_stall: " << value.m_maxStallTime << ")";
+  }
+
+  /**
+   * Provides historical market data to the backtester. Each subscription's
+   * market data is loaded ahead of the event loop by a MarketDataPrefetcher.
+   */
   class BacktesterMarketDataService {
     public:
 
@@ -38,6 +73,21 @@ namespace Nexus {
         marketDataEnvironment,
         MarketDataService::MarketDataClientBox marketDataClient);
 
+      /**
+       * Constructs a BacktesterMarketDataService.
+       * @param eventHandler The BacktesterEventHandler to push historical
+       *        market data events to.
+       * @param marketDataEnvironment The object to publish market data updates
+       *        to.
+       * @param dataStore The HistoricalDataStore to load historical market
+       *        data from, such as a ColumnarHistoricalDataStore.
+       */
+      BacktesterMarketDataService(
+        Beam::Ref<BacktesterEventHandler> eventHandler,
+        Beam::Ref<MarketDataService::Tests::MarketDataServiceTestEnvironment>
+        marketDataEnvironment,
+        MarketDataService::HistoricalDataStoreBox dataStore);
+
       /**
        * Submits a query for OrderImbalances.
        * @param query The query to submit.
@@ -73,6 +123,9 @@ namespace Nexus {
       void QueryTimeAndSales(
         const MarketDataService::SecurityMarketDataQuery& query);
 
+      /** Returns the time spent waiting on historical market data. */
+      BacktesterMarketDataMetrics GetMetrics() const;
+
     private:
       template<typename, typename> friend class MarketDataEvent;
       template<typename> friend class MarketDataLoadEvent;
@@ -80,13 +133,19 @@ namespace Nexus {
       BacktesterEventHandler* m_eventHandler;
       MarketDataService::Tests::MarketDataServiceTestEnvironment*
         m_marketDataEnvironment;
-      MarketDataService::MarketDataClientBox m_marketDataClient;
+      MarketDataService::HistoricalDataStoreBox m_dataStore;
       std::unordered_set<std::tuple<boost::variant<Security, MarketCode>,
         MarketDataService::MarketDataType>> m_queries;
+      std::atomic<std::int64_t> m_loadCount;
+      std::atomic<std::int64_t> m_stallCount;
+      std::atomic<std::int64_t> m_stallTime;
+      std::atomic<std::int64_t> m_maxStallTime;
 
       BacktesterMarketDataService(const BacktesterMarketDataService&) = delete;
       BacktesterMarketDataService& operator =(
         const BacktesterMarketDataService&) = delete;
+      void RecordLoad(bool isStalled,
+        std::chrono::steady_clock::duration latency);
   };
 
   template<typename T>
@@ -115,16 +174,15 @@ namespace Nexus {
       using Query = MarketDataService::GetMarketDataQueryType<
         Beam::Queries::SequencedValue<MarketDataType>>;
 
-      MarketDataLoadEvent(typename Query::Index index,
-        Beam::Queries::Range::Point startPoint,
+      MarketDataLoadEvent(
+        std::shared_ptr<MarketDataPrefetcher<MarketDataType>> prefetcher,
         boost::posix_time::ptime timestamp,
         Beam::Ref<BacktesterMarketDataService> service);
 
       void Execute() override;
 
     private:
-      typename Query::Index m_index;
-      Beam::Queries::Range::Point m_startPoint;
+      std::shared_ptr<MarketDataPrefetcher<MarketDataType>> m_prefetcher;
       BacktesterMarketDataService* m_service;
   };
 
@@ -152,9 +210,25 @@ namespace Nexus {
     Beam::Ref<MarketDataService::Tests::MarketDataServiceTestEnvironment>
       marketDataEnvironment,
     MarketDataService::MarketDataClientBox marketDataClient)
+    : BacktesterMarketDataService(std::move(eventHandler),
+        std::move(marketDataEnvironment),
+        MarketDataService::HistoricalDataStoreBox(std::in_place_type<
+          MarketDataService::ClientHistoricalDataStore<
+            MarketDataService::MarketDataClientBox>>,
+          std::move(marketDataClient))) {}
+
+  inline BacktesterMarketDataService::BacktesterMarketDataService(
+    Beam::Ref<BacktesterEventHandler> eventHandler,
+    Beam::Ref<MarketDataService::Tests::MarketDataServiceTestEnvironment>
+      marketDataEnvironment,
+    MarketDataService::HistoricalDataStoreBox dataStore)
     : m_eventHandler(eventHandler.Get()),
       m_marketDataEnvironment(marketDataEnvironment.Get()),
-      m_marketDataClient(std::move(marketDataClient)) {}
+      m_dataStore(std::move(dataStore)),
+      m_loadCount(0),
+      m_stallCount(0),
+      m_stallTime(0),
+      m_maxStallTime(0) {}
 
   inline void BacktesterMarketDataService::QueryOrderImbalances(
       const MarketDataService::MarketWideDataQuery& query) {
@@ -191,6 +265,32 @@ namespace Nexus {
     m_eventHandler->Add(event);
   }
 
+  inline BacktesterMarketDataMetrics
+      BacktesterMarketDataService::GetMetrics() const {
+    auto metrics = BacktesterMarketDataMetrics();
+    metrics.m_loadCount = m_loadCount.load();
+    metrics.m_stallCount = m_stallCount.load();
+    metrics.m_stallTime = boost::posix_time::microseconds(m_stallTime.load());
+    metrics.m_maxStallTime = boost::posix_time::microseconds(
+      m_maxStallTime.load());
+    return metrics;
+  }
+
+  inline void BacktesterMarketDataService::RecordLoad(bool isStalled,
+      std::chrono::steady_clock::duration latency) {
+    ++m_loadCount;
+    if(!isStalled) {
+      return;
+    }
+    ++m_stallCount;
+    auto microseconds = static_cast<std::int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+    m_stallTime += microseconds;
+    auto maxStallTime = m_maxStallTime.load();
+    while(microseconds > maxStallTime &&
+        !m_maxStallTime.compare_exchange_weak(maxStallTime, microseconds)) {}
+  }
+
   template<typename T>
   MarketDataQueryEvent<T>::MarketDataQueryEvent(Query query,
     Beam::Ref<BacktesterMarketDataService> service)
@@ -205,43 +305,40 @@ namespace Nexus {
           MarketDataService::GetMarketDataType<MarketDataType>())).second) {
       return;
     }
+    const auto CHUNK_SIZE = 1000;
+    const auto BUFFER_SIZE = 4;
     auto startTime = m_service->m_eventHandler->GetTime();
+    auto endPoint = [&] () -> Beam::Queries::Range::Point {
+      if(m_service->m_eventHandler->GetEndTime() ==
+          boost::posix_time::pos_infin) {
+        return Beam::Queries::Sequence::Present();
+      }
+      return m_service->m_eventHandler->GetEndTime();
+    }();
+    auto prefetcher = std::make_shared<MarketDataPrefetcher<MarketDataType>>(
+      m_service->m_dataStore, m_query.GetIndex(), startTime, endPoint,
+      CHUNK_SIZE, BUFFER_SIZE);
     auto event = std::make_shared<MarketDataLoadEvent<MarketDataType>>(
-      m_query.GetIndex(), startTime, boost::posix_time::neg_infin,
+      std::move(prefetcher), boost::posix_time::neg_infin,
       Beam::Ref(*m_service));
     m_service->m_eventHandler->Add(std::move(event));
   }
 
   template<typename T>
-  MarketDataLoadEvent<T>::MarketDataLoadEvent(typename Query::Index index,
-    Beam::Queries::Range::Point startPoint, boost::posix_time::ptime timestamp,
+  MarketDataLoadEvent<T>::MarketDataLoadEvent(
+    std::shared_ptr<MarketDataPrefetcher<MarketDataType>> prefetcher,
+    boost::posix_time::ptime timestamp,
     Beam::Ref<BacktesterMarketDataService> service)
     : BacktesterEvent(timestamp),
-      m_index(std::move(index)),
-      m_startPoint(startPoint),
+      m_prefetcher(std::move(prefetcher)),
       m_service(service.Get()) {}
 
   template<typename T>
   void MarketDataLoadEvent<T>::Execute() {
-    const auto QUERY_SIZE = 1000;
-    auto endPoint = [&] () -> Beam::Queries::Range::Point {
-      if(m_service->m_eventHandler->GetEndTime() ==
-          boost::posix_time::pos_infin) {
-        return Beam::Queries::Sequence::Present();
-      }
-      return m_service->m_eventHandler->GetEndTime();
-    }();
-    auto query = Query();
-    query.SetIndex(m_index);
-    query.SetRange(m_startPoint, endPoint);
-    query.SetSnapshotLimit(Beam::Queries::SnapshotLimit::Type::HEAD,
-      QUERY_SIZE);
-    auto queue = std::make_shared<Beam::Queue<
-      Beam::Queries::SequencedValue<MarketDataType>>>();
-    MarketDataService::QueryMarketDataClient(m_service->m_marketDataClient,
-      query, Beam::ScopedQueueWriter(queue));
-    auto data = std::vector<Beam::Queries::SequencedValue<MarketDataType>>();
-    Beam::Flush(queue, std::back_inserter(data));
+    auto isStalled = !m_prefetcher->IsReady();
+    auto start = std::chrono::steady_clock::now();
+    auto data = m_prefetcher->Next();
+    m_service->RecordLoad(isStalled, std::chrono::steady_clock::now() - start);
     if(data.empty()) {
       return;
     }
@@ -252,11 +349,10 @@ namespace Nexus {
         Beam::Queries::GetTimestamp(value.GetValue()));
       events.push_back(std::make_shared<
         MarketDataEvent<typename Query::Index, MarketDataType>>(
-          query.GetIndex(), std::move(value), timestamp,
+          m_prefetcher->GetIndex(), std::move(value), timestamp,
           Beam::Ref(*m_service)));
     }
-    auto reloadEvent = std::make_shared<MarketDataLoadEvent>(m_index,
-      Beam::Queries::Increment(data.back().GetSequence()),
+    auto reloadEvent = std::make_shared<MarketDataLoadEvent>(m_prefetcher,
       events.back()->GetTimestamp(), Beam::Ref(*m_service));
     events.push_back(std::move(reloadEvent));
     m_service->m_eventHandler->Add(std::move(events));
@@ -0,0 +1,193 @@
+#ifndef NEXUS_BACKTESTER_TIME_WINDOW_HPP
+#define NEXUS_BACKTESTER_TIME_WINDOW_HPP
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <Beam/Threading/ConditionVariable.hpp>
+#include <Beam/Threading/Mutex.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include "Nexus/Backtester/Backtester.hpp"
+
+namespace Nexus {
+
+  /**
+   * Synchronizes the clocks of backtests run in parallel, no participant
+   * handles an event past the end of the current window until every other
+   * participant has either reached the end of the window, is idle, or has
+   * left. Any event one participant adds to another must therefore be
+   * timestamped at least one window past the sender's current time.
+   */
+  class BacktesterTimeWindow {
+    public:
+
+      /**
+       * Represents a single backtest's participation in a
+       * BacktesterTimeWindow, leaving the window when destroyed so that a
+       * backtest that fails never holds back the others.
+       */
+      class Participant {
+        public:
+
+          /**
+           * Constructs a Participant.
+           * @param window The BacktesterTimeWindow participated in.
+           */
+          explicit Participant(std::shared_ptr<BacktesterTimeWindow> window);
+
+          ~Participant();
+
+          /** Returns the BacktesterTimeWindow participated in. */
+          const std::shared_ptr<BacktesterTimeWindow>& GetWindow() const;
+
+          /**
+           * Waits until an event can be handled.
+           * @param timestamp The timestamp of the event to handle.
+           */
+          void Advance(boost::posix_time::ptime timestamp);
+
+          /**
+           * Sets whether this participant is idle, idle participants never
+           * hold back the window.
+           * @param isIdle <code>true</code> iff the participant is idle.
+           */
+          void SetIdle(bool isIdle);
+
+          /** Leaves the window, subsequent calls have no effect. */
+          void Leave();
+
+        private:
+          std::shared_ptr<BacktesterTimeWindow> m_window;
+          std::atomic_bool m_hasLeft;
+
+          Participant(const Participant&) = delete;
+          Participant& operator =(const Participant&) = delete;
+      };
+
+      /**
+       * Constructs a BacktesterTimeWindow.
+       * @param startTime The start of the first window.
+       * @param window The length of each window.
+       * @param participantCount The number of backtests to synchronize.
+       */
+      BacktesterTimeWindow(boost::posix_time::ptime startTime,
+        boost::posix_time::time_duration window, int participantCount);
+
+      /** Returns the end of the current window. */
+      boost::posix_time::ptime GetWindowEnd() const;
+
+    private:
+      mutable Beam::Threading::Mutex m_mutex;
+      boost::posix_time::ptime m_startTime;
+      boost::posix_time::time_duration m_window;
+      boost::posix_time::ptime m_windowEnd;
+      boost::posix_time::ptime m_nextTimestamp;
+      int m_participantCount;
+      int m_waitingCount;
+      int m_idleCount;
+      std::uint64_t m_generation;
+      Beam::Threading::ConditionVariable m_windowCondition;
+
+      BacktesterTimeWindow(const BacktesterTimeWindow&) = delete;
+      BacktesterTimeWindow& operator =(const BacktesterTimeWindow&) = delete;
+      void Advance(boost::posix_time::ptime timestamp);
+      void SetIdle(bool isIdle);
+      void Leave();
+      void TryAdvance();
+  };
+
+  inline BacktesterTimeWindow::Participant::Participant(
+    std::shared_ptr<BacktesterTimeWindow> window)
+    : m_window(std::move(window)),
+      m_hasLeft(false) {}
+
+  inline BacktesterTimeWindow::Participant::~Participant() {
+    Leave();
+  }
+
+  inline const std::shared_ptr<BacktesterTimeWindow>&
+      BacktesterTimeWindow::Participant::GetWindow() const {
+    return m_window;
+  }
+
+  inline void BacktesterTimeWindow::Participant::Advance(
+      boost::posix_time::ptime timestamp) {
+    m_window->Advance(timestamp);
+  }
+
+  inline void BacktesterTimeWindow::Participant::SetIdle(bool isIdle) {
+    m_window->SetIdle(isIdle);
+  }
+
+  inline void BacktesterTimeWindow::Participant::Leave() {
+    if(!m_hasLeft.exchange(true)) {
+      m_window->Leave();
+    }
+  }
+
+  inline BacktesterTimeWindow::BacktesterTimeWindow(
+    boost::posix_time::ptime startTime,
+    boost::posix_time::time_duration window, int participantCount)
+    : m_startTime(startTime),
+      m_window(window),
+      m_windowEnd(startTime + window),
+      m_nextTimestamp(boost::posix_time::pos_infin),
+      m_participantCount(participantCount),
+      m_waitingCount(0),
+      m_idleCount(0),
+      m_generation(0) {}
+
+  inline boost::posix_time::ptime
+      BacktesterTimeWindow::GetWindowEnd() const {
+    auto lock = boost::lock_guard(m_mutex);
+    return m_windowEnd;
+  }
+
+  inline void BacktesterTimeWindow::Advance(
+      boost::posix_time::ptime timestamp) {
+    auto lock = boost::unique_lock(m_mutex);
+    while(timestamp >= m_windowEnd) {
+      ++m_waitingCount;
+      m_nextTimestamp = std::min(m_nextTimestamp, timestamp);
+      auto generation = m_generation;
+      TryAdvance();
+      while(generation == m_generation) {
+        m_windowCondition.wait(lock);
+      }
+    }
+  }
+
+  inline void BacktesterTimeWindow::SetIdle(bool isIdle) {
+    auto lock = boost::lock_guard(m_mutex);
+    if(isIdle) {
+      ++m_idleCount;
+      TryAdvance();
+    } else {
+      --m_idleCount;
+    }
+  }
+
+  inline void BacktesterTimeWindow::Leave() {
+    auto lock = boost::lock_guard(m_mutex);
+    --m_participantCount;
+    TryAdvance();
+  }
+
+  inline void BacktesterTimeWindow::TryAdvance() {
+    if(m_waitingCount == 0 ||
+        m_waitingCount + m_idleCount < m_participantCount) {
+      return;
+    }
+    auto windowCount = (m_nextTimestamp - m_startTime).ticks() /
+      m_window.ticks() + 1;
+    auto offset = boost::posix_time::time_duration(0, 0, 0,
+      m_window.ticks() * windowCount);
+    m_windowEnd = std::max(m_windowEnd + m_window, m_startTime + offset);
+    m_nextTimestamp = boost::posix_time::pos_infin;
+    m_waitingCount = 0;
+    ++m_generation;
+    m_windowCondition.notify_all();
+  }
+}
+
+#endif
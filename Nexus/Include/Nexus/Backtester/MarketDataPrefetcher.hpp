@@ -0,0 +1,205 @@
+#ifndef NEXUS_MARKET_DATA_PREFETCHER_HPP
+#define NEXUS_MARKET_DATA_PREFETCHER_HPP
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <Beam/IO/OpenState.hpp>
+#include <Beam/Queries/Range.hpp>
+#include <Beam/Queries/Sequence.hpp>
+#include <Beam/Queries/SequencedValue.hpp>
+#include <Beam/Routines/RoutineHandler.hpp>
+#include <Beam/Threading/ConditionVariable.hpp>
+#include <Beam/Threading/Mutex.hpp>
+#include <boost/thread/lock_types.hpp>
+#include "Nexus/Backtester/Backtester.hpp"
+#include "Nexus/MarketDataService/HistoricalDataStoreBox.hpp"
+#include "Nexus/MarketDataService/HistoricalDataStoreUtilities.hpp"
+#include "Nexus/MarketDataService/QueryTypes.hpp"
+
+namespace Nexus {
+
+  /**
+   * Loads historical market data for a single index ahead of its use, the
+   * next chunks being queried in a background routine into a bounded buffer.
+   * The market data is loaded from a HistoricalDataStore, such as a
+   * ColumnarHistoricalDataStore reading local column files or a
+   * ClientHistoricalDataStore querying a MarketDataClient.
+   * @param <T> The type of market data to load.
+   */
+  template<typename T>
+  class MarketDataPrefetcher {
+    public:
+
+      /** The type of market data to load. */
+      using MarketDataType = T;
+
+      /** The type of query used to load the market data. */
+      using Query = MarketDataService::GetMarketDataQueryType<
+        Beam::Queries::SequencedValue<MarketDataType>>;
+
+      /**
+       * Constructs a MarketDataPrefetcher and begins loading.
+       * @param dataStore The HistoricalDataStore to load from, it is not
+       *        closed by the prefetcher.
+       * @param index The index of the market data to load.
+       * @param startPoint The point to begin loading from.
+       * @param endPoint The point to stop loading at.
+       * @param chunkSize The number of values to load per query.
+       * @param bufferSize The maximum number of chunks to load ahead.
+       */
+      MarketDataPrefetcher(MarketDataService::HistoricalDataStoreBox dataStore,
+        typename Query::Index index, Beam::Queries::Range::Point startPoint,
+        Beam::Queries::Range::Point endPoint, int chunkSize, int bufferSize);
+
+      ~MarketDataPrefetcher();
+
+      /** Returns the index of the market data being loaded. */
+      const typename Query::Index& GetIndex() const;
+
+      /** Returns <code>true</code> iff calling Next won't block. */
+      bool IsReady() const;
+
+      /**
+       * Returns the next chunk of market data, waiting for it to load if
+       * needed.
+       * @return The next chunk, or an empty chunk once all market data has
+       *         been loaded.
+       */
+      std::vector<Beam::Queries::SequencedValue<MarketDataType>> Next();
+
+      void Close();
+
+    private:
+      mutable Beam::Threading::Mutex m_mutex;
+      MarketDataService::HistoricalDataStoreBox m_dataStore;
+      typename Query::Index m_index;
+      Beam::Queries::Range::Point m_startPoint;
+      Beam::Queries::Range::Point m_endPoint;
+      int m_chunkSize;
+      int m_bufferSize;
+      std::deque<std::vector<Beam::Queries::SequencedValue<MarketDataType>>>
+        m_chunks;
+      bool m_isComplete;
+      std::exception_ptr m_exception;
+      Beam::Threading::ConditionVariable m_chunkCondition;
+      Beam::Threading::ConditionVariable m_spaceCondition;
+      Beam::IO::OpenState m_openState;
+      Beam::Routines::RoutineHandler m_loadRoutine;
+
+      MarketDataPrefetcher(const MarketDataPrefetcher&) = delete;
+      MarketDataPrefetcher& operator =(const MarketDataPrefetcher&) = delete;
+      void LoadLoop();
+  };
+
+  template<typename T>
+  MarketDataPrefetcher<T>::MarketDataPrefetcher(
+      MarketDataService::HistoricalDataStoreBox dataStore,
+      typename Query::Index index, Beam::Queries::Range::Point startPoint,
+      Beam::Queries::Range::Point endPoint, int chunkSize, int bufferSize)
+      : m_dataStore(std::move(dataStore)),
+        m_index(std::move(index)),
+        m_startPoint(startPoint),
+        m_endPoint(endPoint),
+        m_chunkSize(chunkSize),
+        m_bufferSize(std::max(1, bufferSize)),
+        m_isComplete(false) {
+    m_loadRoutine = Beam::Routines::Spawn(
+      std::bind(&MarketDataPrefetcher::LoadLoop, this));
+  }
+
+  template<typename T>
+  MarketDataPrefetcher<T>::~MarketDataPrefetcher() {
+    Close();
+  }
+
+  template<typename T>
+  const typename MarketDataPrefetcher<T>::Query::Index&
+      MarketDataPrefetcher<T>::GetIndex() const {
+    return m_index;
+  }
+
+  template<typename T>
+  bool MarketDataPrefetcher<T>::IsReady() const {
+    auto lock = boost::lock_guard(m_mutex);
+    return !m_chunks.empty() || m_isComplete;
+  }
+
+  template<typename T>
+  std::vector<Beam::Queries::SequencedValue<T>>
+      MarketDataPrefetcher<T>::Next() {
+    auto lock = boost::unique_lock(m_mutex);
+    while(m_chunks.empty() && !m_isComplete) {
+      m_chunkCondition.wait(lock);
+    }
+    if(m_chunks.empty()) {
+      if(m_exception) {
+        std::rethrow_exception(m_exception);
+      }
+      return {};
+    }
+    auto chunk = std::move(m_chunks.front());
+    m_chunks.pop_front();
+    m_spaceCondition.notify_one();
+    return chunk;
+  }
+
+  template<typename T>
+  void MarketDataPrefetcher<T>::Close() {
+    if(m_openState.SetClosing()) {
+      return;
+    }
+    {
+      auto lock = boost::lock_guard(m_mutex);
+      m_isComplete = true;
+      m_chunkCondition.notify_all();
+      m_spaceCondition.notify_all();
+    }
+    m_loadRoutine.Wait();
+    m_openState.Close();
+  }
+
+  template<typename T>
+  void MarketDataPrefetcher<T>::LoadLoop() {
+    auto startPoint = m_startPoint;
+    try {
+      while(true) {
+        {
+          auto lock = boost::unique_lock(m_mutex);
+          while(static_cast<int>(m_chunks.size()) >= m_bufferSize &&
+              m_openState.IsOpen()) {
+            m_spaceCondition.wait(lock);
+          }
+          if(!m_openState.IsOpen()) {
+            return;
+          }
+        }
+        auto query = Query();
+        query.SetIndex(m_index);
+        query.SetRange(startPoint, m_endPoint);
+        query.SetSnapshotLimit(Beam::Queries::SnapshotLimit::Type::HEAD,
+          m_chunkSize);
+        auto data = MarketDataService::HistoricalDataStoreLoad<
+          Beam::Queries::SequencedValue<MarketDataType>>(m_dataStore, query);
+        auto lock = boost::lock_guard(m_mutex);
+        if(data.empty()) {
+          m_isComplete = true;
+          m_chunkCondition.notify_all();
+          return;
+        }
+        startPoint = Beam::Queries::Increment(data.back().GetSequence());
+        m_chunks.push_back(std::move(data));
+        m_chunkCondition.notify_all();
+      }
+    } catch(const std::exception&) {
+      auto lock = boost::lock_guard(m_mutex);
+      m_exception = std::current_exception();
+      m_isComplete = true;
+      m_chunkCondition.notify_all();
+    }
+  }
+}
+
+#endif
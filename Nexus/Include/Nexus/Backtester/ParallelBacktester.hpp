@@ -0,0 +1,162 @@
+#ifndef NEXUS_PARALLEL_BACKTESTER_HPP
+#define NEXUS_PARALLEL_BACKTESTER_HPP
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/optional/optional.hpp>
+#include <boost/throw_exception.hpp>
+#include "Nexus/Backtester/Backtester.hpp"
+#include "Nexus/Backtester/BacktesterTimeWindow.hpp"
+
+namespace Nexus {
+
+  /**
+   * Runs a list of independent backtests in parallel, each partition running
+   * on its own thread with its own BacktesterEnvironment. Results are
+   * returned in partition order regardless of the order the partitions
+   * complete in.
+   * @param partitionCount The number of partitions to run.
+   * @param backtest The callable running a single partition, invoked with the
+   *        index of the partition and returning its result.
+   * @param threadCount The maximum number of partitions to run at once.
+   * @return The result of each partition.
+   * @throws std::invalid_argument If the <i>partitionCount</i> is negative or
+   *         the <i>threadCount</i> is not positive.
+   * @throws The exception thrown by the lowest indexed partition that failed.
+   */
+  template<typename F>
+  auto RunParallelBacktests(int partitionCount, F&& backtest,
+      int threadCount) {
+    if(partitionCount < 0) {
+      BOOST_THROW_EXCEPTION(std::invalid_argument(
+        "Partition count is negative."));
+    }
+    if(threadCount < 1) {
+      BOOST_THROW_EXCEPTION(std::invalid_argument(
+        "Thread count is not positive."));
+    }
+    using Result = std::invoke_result_t<F, int>;
+    auto results = std::vector<boost::optional<Result>>(partitionCount);
+    auto errors = std::vector<std::exception_ptr>(partitionCount);
+    auto nextPartition = std::atomic_int(0);
+    auto threads = std::vector<std::thread>();
+    for(auto i = 0; i != std::min(partitionCount, threadCount); ++i) {
+      threads.emplace_back([&] {
+        while(true) {
+          auto partition = nextPartition++;
+          if(partition >= partitionCount) {
+            return;
+          }
+          try {
+            results[partition].emplace(backtest(partition));
+          } catch(...) {
+            errors[partition] = std::current_exception();
+          }
+        }
+      });
+    }
+    for(auto& thread : threads) {
+      thread.join();
+    }
+    for(auto& error : errors) {
+      if(error) {
+        std::rethrow_exception(error);
+      }
+    }
+    auto mergedResults = std::vector<Result>();
+    mergedResults.reserve(partitionCount);
+    for(auto& result : results) {
+      mergedResults.push_back(std::move(*result));
+    }
+    return mergedResults;
+  }
+
+  /**
+   * Runs a list of independent backtests in parallel, using one thread per
+   * hardware core.
+   * @param partitionCount The number of partitions to run.
+   * @param backtest The callable running a single partition, invoked with the
+   *        index of the partition and returning its result.
+   * @return The result of each partition.
+   */
+  template<typename F>
+  auto RunParallelBacktests(int partitionCount, F&& backtest) {
+    return RunParallelBacktests(partitionCount, std::forward<F>(backtest),
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+  }
+
+  /**
+   * Runs a list of backtests in parallel whose clocks are synchronized by a
+   * shared BacktesterTimeWindow. Each partition is given its own Participant
+   * in the window, which is left once the partition returns or throws so
+   * that a failed partition never holds back the others.
+   * @param startTime The start of the first window.
+   * @param window The length of each window.
+   * @param partitionCount The number of partitions to run.
+   * @param backtest The callable running a single partition, invoked with the
+   *        index of the partition and its Participant and returning its
+   *        result.
+   * @param threadCount The maximum number of partitions to run at once, since
+   *        every partition must advance through the window together this must
+   *        be at least the <i>partitionCount</i>.
+   * @return The result of each partition.
+   * @throws std::invalid_argument If the <i>threadCount</i> is less than the
+   *         <i>partitionCount</i>.
+   * @throws The exception thrown by the lowest indexed partition that failed.
+   */
+  template<typename F>
+  auto RunParallelBacktests(boost::posix_time::ptime startTime,
+      boost::posix_time::time_duration window, int partitionCount,
+      F&& backtest, int threadCount) {
+    if(threadCount < partitionCount) {
+      BOOST_THROW_EXCEPTION(std::invalid_argument(
+        "Thread count is less than the partition count."));
+    }
+    auto timeWindow = std::make_shared<BacktesterTimeWindow>(startTime,
+      window, partitionCount);
+    auto participants =
+      std::vector<std::shared_ptr<BacktesterTimeWindow::Participant>>();
+    for(auto i = 0; i < partitionCount; ++i) {
+      participants.push_back(
+        std::make_shared<BacktesterTimeWindow::Participant>(timeWindow));
+    }
+    return RunParallelBacktests(partitionCount, [&] (int partition) {
+      auto participant = std::move(participants[partition]);
+      try {
+        auto result = backtest(partition, participant);
+        participant->Leave();
+        return result;
+      } catch(...) {
+        participant->Leave();
+        throw;
+      }
+    }, threadCount);
+  }
+
+  /**
+   * Runs a list of backtests in parallel whose clocks are synchronized by a
+   * shared BacktesterTimeWindow, using one thread per partition.
+   * @param startTime The start of the first window.
+   * @param window The length of each window.
+   * @param partitionCount The number of partitions to run.
+   * @param backtest The callable running a single partition, invoked with the
+   *        index of the partition and its Participant and returning its
+   *        result.
+   * @return The result of each partition.
+   */
+  template<typename F>
+  auto RunParallelBacktests(boost::posix_time::ptime startTime,
+      boost::posix_time::time_duration window, int partitionCount,
+      F&& backtest) {
+    return RunParallelBacktests(startTime, window, partitionCount,
+      std::forward<F>(backtest), std::max(1, partitionCount));
+  }
+}
+
+#endif
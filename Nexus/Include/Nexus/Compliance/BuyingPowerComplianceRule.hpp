@@ -4,7 +4,6 @@
 #include <Beam/Pointers/Dereference.hpp>
 #include <Beam/Pointers/LocalPtr.hpp>
 #include <Beam/Queues/MultiQueueWriter.hpp>
-#include <Beam/Queues/StateQueue.hpp>
 #include <Beam/Threading/Sync.hpp>
 #include <Beam/Utilities/Algorithm.hpp>
 #include <boost/throw_exception.hpp>
@@ -19,6 +18,7 @@
 #include "Nexus/Compliance/ComplianceRuleSchema.hpp"
 #include "Nexus/Definitions/Currency.hpp"
 #include "Nexus/Definitions/Security.hpp"
+#include "Nexus/MarketDataService/BboQuoteCache.hpp"
 #include "Nexus/MarketDataService/MarketDataClient.hpp"
 #include "Nexus/OrderExecutionService/ExecutionReport.hpp"
 #include "Nexus/OrderExecutionService/Order.hpp"
@@ -42,6 +42,10 @@ namespace Nexus::Compliance {
        */
       using MarketDataClient = Beam::GetTryDereferenceType<C>;
 
+      /** The type of BboQuoteCache used to price Orders. */
+      using BboQuoteCache =
+        MarketDataService::BboQuoteCache<MarketDataClient*>;
+
       /**
        * Constructs a BuyingPowerComplianceRule.
        * @param parameters The list of buying power parameters.
@@ -55,6 +59,21 @@ namespace Nexus::Compliance {
         const std::vector<ExchangeRate>& exchangeRates,
         CF&& marketDataClient);
 
+      /**
+       * Constructs a BuyingPowerComplianceRule pricing Orders off of a shared
+       * BboQuoteCache.
+       * @param parameters The list of buying power parameters.
+       * @param exchangeRates The list of ExchangeRates.
+       * @param marketDataClient Initializes the MarketDataClient used to price
+       *        Orders.
+       * @param bboQuotes The BboQuoteCache used to price Orders.
+       */
+      template<typename CF>
+      BuyingPowerComplianceRule(
+        const std::vector<ComplianceParameter>& parameters,
+        const std::vector<ExchangeRate>& exchangeRates,
+        CF&& marketDataClient, std::shared_ptr<BboQuoteCache> bboQuotes);
+
       void Submit(const OrderExecutionService::Order& order) override;
 
       void Add(const OrderExecutionService::Order& order) override;
@@ -70,8 +89,9 @@ namespace Nexus::Compliance {
         m_executionReportQueue;
       std::unordered_map<OrderExecutionService::OrderId, CurrencyId>
         m_currencies;
-      Beam::SynchronizedUnorderedMap<Security,
-        std::shared_ptr<Beam::StateQueue<BboQuote>>> m_bboQuotes;
+      std::shared_ptr<BboQuoteCache> m_bboQuotes;
+      Beam::SynchronizedUnorderedMap<Security, typename BboQuoteCache::Handle>
+        m_bboQuoteHandles;
 
       BboQuote LoadBboQuote(const Security& security);
       Money GetExpectedPrice(
@@ -84,6 +104,12 @@ namespace Nexus::Compliance {
     const std::vector<ExchangeRate>&, MarketDataClient&&) ->
     BuyingPowerComplianceRule<std::decay_t<MarketDataClient>>;
 
+  template<typename MarketDataClient, typename BboQuoteCache>
+  BuyingPowerComplianceRule(const std::vector<ComplianceParameter>&,
+    const std::vector<ExchangeRate>&, MarketDataClient&&,
+    std::shared_ptr<BboQuoteCache>) ->
+    BuyingPowerComplianceRule<std::decay_t<MarketDataClient>>;
+
   /**
    * Returns a ComplianceRuleSchema representing a BuyingPowerComplianceRule.
    */
@@ -104,7 +130,20 @@ namespace Nexus::Compliance {
       const std::vector<ComplianceParameter>& parameters,
       const std::vector<ExchangeRate>& exchangeRates,
       CF&& marketDataClient)
-      : m_marketDataClient(std::forward<CF>(marketDataClient)) {
+      : BuyingPowerComplianceRule(parameters, exchangeRates,
+          std::forward<CF>(marketDataClient), nullptr) {}
+
+  template<typename C>
+  template<typename CF>
+  BuyingPowerComplianceRule<C>::BuyingPowerComplianceRule(
+      const std::vector<ComplianceParameter>& parameters,
+      const std::vector<ExchangeRate>& exchangeRates,
+      CF&& marketDataClient, std::shared_ptr<BboQuoteCache> bboQuotes)
+      : m_marketDataClient(std::forward<CF>(marketDataClient)),
+        m_bboQuotes(std::move(bboQuotes)) {
+    if(!m_bboQuotes) {
+      m_bboQuotes = std::make_shared<BboQuoteCache>(&*m_marketDataClient);
+    }
     for(auto& parameter : parameters) {
       if(parameter.m_name == "currency") {
         m_currency = boost::get<CurrencyId>(parameter.m_value);
@@ -216,16 +255,12 @@ namespace Nexus::Compliance {
   template<typename C>
   BboQuote BuyingPowerComplianceRule<C>::LoadBboQuote(
       const Security& security) {
-    auto publisher = m_bboQuotes.GetOrInsert(security, [&] {
-      auto publisher = std::make_shared<Beam::StateQueue<BboQuote>>();
-      MarketDataService::QueryRealTimeWithSnapshot(security,
-        *m_marketDataClient, publisher);
-      return publisher;
+    auto bboQuote = m_bboQuoteHandles.GetOrInsert(security, [&] {
+      return m_bboQuotes->GetHandle(security);
     });
     try {
-      return publisher->Peek();
+      return m_bboQuotes->Load(bboQuote);
     } catch(const Beam::PipeBrokenException&) {
-      m_bboQuotes.Erase(security);
       BOOST_THROW_EXCEPTION(ComplianceCheckException(
         "No BBO quote available."));
     }
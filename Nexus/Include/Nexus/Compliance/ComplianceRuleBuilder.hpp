@@ -16,17 +16,20 @@ namespace Nexus::Compliance {
   /**
    * Returns a ComplianceRule from a ComplianceRuleSchema.
    * @param schema The ComplianceRuleSchema to build the ComplianceRule from.
+   * @param bboQuotes The BboQuoteCache used by rules that price Orders.
    * @return The ComplianceRule represented by the <i>schema</i>.
    */
   template<typename MarketDataClient, typename DefinitionsClient,
     typename TimeClient>
   std::unique_ptr<ComplianceRule> MakeComplianceRule(
       const ComplianceRuleSchema& schema, MarketDataClient& marketDataClient,
-      DefinitionsClient& definitionsClient, TimeClient& timeClient) {
+      DefinitionsClient& definitionsClient, TimeClient& timeClient,
+      std::shared_ptr<MarketDataService::BboQuoteCache<MarketDataClient*>>
+        bboQuotes) {
     if(schema.GetName() == "buying_power") {
       return std::make_unique<BuyingPowerComplianceRule<MarketDataClient*>>(
         schema.GetParameters(), definitionsClient.LoadExchangeRates(),
-        &marketDataClient);
+        &marketDataClient, std::move(bboQuotes));
     } else if(schema.GetName() == "cancel_restriction_period") {
       return std::make_unique<
         CancelRestrictionPeriodComplianceRule<TimeClient*>>(
@@ -62,12 +65,30 @@ namespace Nexus::Compliance {
       auto perAccountSchema = ComplianceRuleSchema(std::move(name),
         std::move(parameters));
       return std::make_unique<PerAccountComplianceRule>(perAccountSchema,
-        std::bind(&MakeComplianceRule<MarketDataClient, DefinitionsClient,
-        TimeClient>, std::placeholders::_1, std::ref(marketDataClient),
-        std::ref(definitionsClient), std::ref(timeClient)));
+        [&marketDataClient, &definitionsClient, &timeClient, bboQuotes] (
+            const ComplianceRuleSchema& schema) {
+          return MakeComplianceRule(schema, marketDataClient,
+            definitionsClient, timeClient, bboQuotes);
+        });
     }
     return nullptr;
   }
+
+  /**
+   * Returns a ComplianceRule from a ComplianceRuleSchema.
+   * @param schema The ComplianceRuleSchema to build the ComplianceRule from.
+   * @return The ComplianceRule represented by the <i>schema</i>.
+   */
+  template<typename MarketDataClient, typename DefinitionsClient,
+    typename TimeClient>
+  std::unique_ptr<ComplianceRule> MakeComplianceRule(
+      const ComplianceRuleSchema& schema, MarketDataClient& marketDataClient,
+      DefinitionsClient& definitionsClient, TimeClient& timeClient) {
+    return MakeComplianceRule(schema, marketDataClient, definitionsClient,
+      timeClient, std::make_shared<
+        MarketDataService::BboQuoteCache<MarketDataClient*>>(
+          &marketDataClient));
+  }
 }
 
 #endif
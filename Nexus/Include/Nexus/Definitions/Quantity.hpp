@@ -17,12 +17,32 @@
 #include <boost/rational.hpp>
 #include "Nexus/Definitions/Definitions.hpp"
 
+#ifdef _MSC_VER
+  #ifdef NEXUS_FIXED_POINT_QUANTITY
+    #pragma detect_mismatch("NEXUS_FIXED_POINT_QUANTITY", "1")
+  #else
+    #pragma detect_mismatch("NEXUS_FIXED_POINT_QUANTITY", "0")
+  #endif
+#endif
+
 namespace Nexus {
 
-  /** Used to represent a quantity up to 15 significant decimal places. */
+  /**
+   * Used to represent a quantity up to 15 significant decimal places.
+   * By default the scaled value is stored as a double, defining
+   * NEXUS_FIXED_POINT_QUANTITY stores it as an exact 64-bit integer instead.
+   * Both representations serialize identically.
+   */
   class Quantity {
     public:
 
+      /** The type used to store the scaled value. */
+#ifdef NEXUS_FIXED_POINT_QUANTITY
+      using Representation = std::int64_t;
+#else
+      using Representation = boost::float64_t;
+#endif
+
       /** The number of decimal places that can be represented accurately. */
       static constexpr auto DECIMAL_PLACES = 6;
 
@@ -55,7 +75,7 @@ namespace Nexus {
       constexpr Quantity(double value);
 
       /** Returns a Quantity from its raw representation. */
-      static constexpr  Quantity FromRepresentation(boost::float64_t value);
+      static constexpr Quantity FromRepresentation(Representation value);
 
       /** Converts this Quantity into a float. */
       explicit constexpr operator boost::float64_t() const;
@@ -196,7 +216,7 @@ namespace Nexus {
       constexpr Quantity operator -() const;
 
       /** Returns the raw representation of this Quantity. */
-      constexpr boost::float64_t GetRepresentation() const;
+      constexpr Representation GetRepresentation() const;
 
     private:
       template<typename, typename> friend struct Beam::Serialization::Send;
@@ -205,9 +225,116 @@ namespace Nexus {
       friend Quantity operator %(Quantity lhs, Quantity rhs);
       friend Quantity Abs(Quantity);
       friend class std::numeric_limits<Nexus::Quantity>;
-      boost::float64_t m_value;
+      Representation m_value;
   };
 
+namespace Details {
+#ifdef NEXUS_FIXED_POINT_QUANTITY
+
+  /** Rounds a scaled double to the nearest fixed-point representation. */
+  constexpr std::int64_t ToFixedPoint(boost::float64_t value) {
+    if(value < 0) {
+      return static_cast<std::int64_t>(value - 0.5);
+    }
+    return static_cast<std::int64_t>(value + 0.5);
+  }
+
+  /**
+   * Multiplies two fixed-point values scaled by Quantity::MULTIPLIER, rounding
+   * half away from zero. Each operand is split into its integral and
+   * fractional parts so that no intermediate product exceeds 64 bits unless
+   * the result itself does.
+   */
+  constexpr std::int64_t FixedPointMultiply(std::int64_t lhs,
+      std::int64_t rhs) {
+    auto lhsIntegral = lhs / Quantity::MULTIPLIER;
+    auto lhsFraction = lhs % Quantity::MULTIPLIER;
+    auto rhsIntegral = rhs / Quantity::MULTIPLIER;
+    auto rhsFraction = rhs % Quantity::MULTIPLIER;
+    auto fractionProduct = lhsFraction * rhsFraction;
+    auto fraction = fractionProduct / Quantity::MULTIPLIER;
+    auto remainder = fractionProduct % Quantity::MULTIPLIER;
+    if(2 * remainder >= Quantity::MULTIPLIER) {
+      ++fraction;
+    } else if(2 * remainder <= -Quantity::MULTIPLIER) {
+      --fraction;
+    }
+    return lhsIntegral * rhsIntegral * Quantity::MULTIPLIER +
+      lhsIntegral * rhsFraction + lhsFraction * rhsIntegral + fraction;
+  }
+
+  /**
+   * Divides two fixed-point values scaled by Quantity::MULTIPLIER, rounding
+   * half away from zero. The quotient is produced one decimal digit at a time
+   * so that the dividend is never scaled up front, and divisors too large to
+   * scale the remainder by ten accumulate it modulo the divisor instead.
+   */
+  constexpr std::int64_t FixedPointDivide(std::int64_t lhs, std::int64_t rhs) {
+    auto isNegative = (lhs < 0) != (rhs < 0);
+    auto dividend = lhs < 0 ? -lhs : lhs;
+    auto divisor = rhs < 0 ? -rhs : rhs;
+    auto quotient = dividend / divisor;
+    auto remainder = dividend % divisor;
+    for(auto i = 0; i < Quantity::DECIMAL_PLACES; ++i) {
+      if(remainder <= std::numeric_limits<std::int64_t>::max() / 10) {
+        remainder *= 10;
+        quotient = 10 * quotient + remainder / divisor;
+        remainder %= divisor;
+      } else {
+        auto digit = std::int64_t(0);
+        auto next = std::int64_t(0);
+        for(auto j = 0; j < 10; ++j) {
+          if(next >= divisor - remainder) {
+            next -= divisor - remainder;
+            ++digit;
+          } else {
+            next += remainder;
+          }
+        }
+        quotient = 10 * quotient + digit;
+        remainder = next;
+      }
+    }
+    if(remainder >= divisor - remainder) {
+      ++quotient;
+    }
+    return isNegative ? -quotient : quotient;
+  }
+#endif
+
+  /**
+   * Converts a scaled double, as found on the wire and in Lua, into a
+   * Quantity's representation, rounding to the nearest unit when the
+   * representation is fixed-point.
+   */
+  constexpr Quantity::Representation ToRepresentation(boost::float64_t value) {
+#ifdef NEXUS_FIXED_POINT_QUANTITY
+    return ToFixedPoint(value);
+#else
+    return value;
+#endif
+  }
+}
+
+#ifdef NEXUS_FIXED_POINT_QUANTITY
+  inline std::ostream& operator <<(std::ostream& out, Quantity value) {
+    auto integerPart = value.m_value / Quantity::MULTIPLIER;
+    auto fraction = value.m_value % Quantity::MULTIPLIER;
+    if(fraction == 0) {
+      return out << integerPart;
+    }
+    char buffer[Quantity::DECIMAL_PLACES + 1] = {};
+    auto digits = fraction < 0 ? -fraction : fraction;
+    for(auto i = Quantity::DECIMAL_PLACES - 1; i >= 0; --i) {
+      buffer[i] = static_cast<char>('0' + digits % 10);
+      digits /= 10;
+    }
+    if(value.m_value < 0 && integerPart == 0) {
+      out << '-';
+    }
+    return out << integerPart << '.' << buffer;
+  }
+#else
   inline std::ostream& operator <<(std::ostream& out, Quantity value) {
     auto unscaledValue = value.m_value / Quantity::MULTIPLIER;
     auto integerPart = boost::float64_t();
@@ -220,6 +347,7 @@ namespace Nexus {
     out << unscaledValue;
     return out;
   }
+#endif
 
   inline std::istream& operator >>(std::istream& in, Quantity& value) {
     auto symbol = std::string();
@@ -305,7 +433,11 @@ namespace Nexus {
    * @return <i>lhs</i> % <i>rhs</i>
    */
   inline Quantity operator %(Quantity lhs, Quantity rhs) {
+#ifdef NEXUS_FIXED_POINT_QUANTITY
+    return Quantity::FromRepresentation(lhs.m_value % rhs.m_value);
+#else
     return Quantity::FromRepresentation(std::fmod(lhs.m_value, rhs.m_value));
+#endif
   }
 
   /**
@@ -322,6 +454,11 @@ namespace Nexus {
    * @param decimalPlaces The decimal place to floor to.
    */
   inline Quantity Floor(Quantity value, int decimalPlaces) {
+#ifdef NEXUS_FIXED_POINT_QUANTITY
+    if(decimalPlaces >= Quantity::DECIMAL_PLACES) {
+      return value;
+    }
+#endif
     if(decimalPlaces > 0) {
       auto multiplier = Beam::PowerOfTen(decimalPlaces);
       auto remainder = value % (Quantity(1) / multiplier);
@@ -369,6 +506,11 @@ namespace Nexus {
    * @param decimalPlaces The decimal place to round to.
    */
   inline Quantity Round(Quantity value, int decimalPlaces) {
+#ifdef NEXUS_FIXED_POINT_QUANTITY
+    if(decimalPlaces >= Quantity::DECIMAL_PLACES) {
+      return value;
+    }
+#endif
     if(decimalPlaces >= 0) {
       auto multiplier = Beam::PowerOfTen(decimalPlaces + 1);
       return Floor(value + Quantity(5) / multiplier, decimalPlaces);
@@ -427,12 +569,29 @@ namespace Nexus {
         }
       }
     }
+#ifdef NEXUS_FIXED_POINT_QUANTITY
+    auto lhs = MULTIPLIER * leftHand;
+    auto rhs = rightHand;
+    while(exponent < -DECIMAL_PLACES - 1) {
+      rhs /= 10;
+      ++exponent;
+    }
+    if(exponent < -DECIMAL_PLACES) {
+      rhs = (rhs + 5) / 10;
+      ++exponent;
+    }
+    while(exponent > -DECIMAL_PLACES) {
+      rhs *= 10;
+      --exponent;
+    }
+#else
     auto lhs = MULTIPLIER * static_cast<boost::float64_t>(leftHand);
     auto rhs = MULTIPLIER * static_cast<boost::float64_t>(rightHand);
     while(exponent != 0) {
       rhs /= 10;
       ++exponent;
     }
+#endif
     return Quantity::FromRepresentation(sign * (lhs + rhs));
   }
 
@@ -440,29 +599,34 @@ namespace Nexus {
     : m_value(0) {}
 
   inline constexpr Quantity::Quantity(std::int32_t value)
-    : m_value(static_cast<boost::float64_t>(MULTIPLIER * value)) {}
+    : m_value(static_cast<Representation>(MULTIPLIER * value)) {}
 
   inline constexpr Quantity::Quantity(std::uint32_t value)
-    : m_value(static_cast<boost::float64_t>(MULTIPLIER * value)) {}
+    : m_value(static_cast<Representation>(MULTIPLIER * value)) {}
 
   inline constexpr Quantity::Quantity(std::int64_t value)
-    : m_value(static_cast<boost::float64_t>(MULTIPLIER * value)) {}
+    : m_value(static_cast<Representation>(MULTIPLIER * value)) {}
 
   inline constexpr Quantity::Quantity(std::uint64_t value)
-    : m_value(static_cast<boost::float64_t>(MULTIPLIER * value)) {}
+    : m_value(static_cast<Representation>(MULTIPLIER * value)) {}
 
+#ifdef NEXUS_FIXED_POINT_QUANTITY
+  inline constexpr Quantity::Quantity(double value)
+    : m_value(Details::ToFixedPoint(MULTIPLIER * value)) {}
+#else
   inline constexpr Quantity::Quantity(double value)
     : m_value(static_cast<boost::float64_t>(MULTIPLIER * value)) {}
+#endif
 
   inline constexpr Quantity Quantity::FromRepresentation(
-      boost::float64_t value) {
+      Representation value) {
     auto q = Quantity();
     q.m_value = value;
     return q;
   }
 
   inline constexpr Quantity::operator boost::float64_t() const {
-    return m_value / MULTIPLIER;
+    return static_cast<boost::float64_t>(m_value) / MULTIPLIER;
   }
 
   inline constexpr Quantity::operator int() const {
@@ -553,6 +717,26 @@ namespace Nexus {
     return q;
   }
 
+#ifdef NEXUS_FIXED_POINT_QUANTITY
+  inline constexpr Quantity Quantity::operator *(Quantity rhs) const {
+    return FromRepresentation(
+      Details::FixedPointMultiply(m_value, rhs.m_value));
+  }
+
+  inline constexpr Quantity& Quantity::operator *=(Quantity rhs) {
+    m_value = Details::FixedPointMultiply(m_value, rhs.m_value);
+    return *this;
+  }
+
+  inline constexpr Quantity Quantity::operator /(Quantity rhs) const {
+    return FromRepresentation(Details::FixedPointDivide(m_value, rhs.m_value));
+  }
+
+  inline constexpr Quantity& Quantity::operator /=(Quantity rhs) {
+    m_value = Details::FixedPointDivide(m_value, rhs.m_value);
+    return *this;
+  }
+#else
   inline constexpr Quantity Quantity::operator *(Quantity rhs) const {
     return FromRepresentation(m_value * (rhs.m_value / MULTIPLIER));
   }
@@ -570,12 +754,14 @@ namespace Nexus {
     m_value = MULTIPLIER * (m_value / rhs.m_value);
     return *this;
   }
+#endif
 
   inline constexpr Quantity Quantity::operator -() const {
     return FromRepresentation(-m_value);
   }
 
-  inline constexpr boost::float64_t Quantity::GetRepresentation() const {
+  inline constexpr Quantity::Representation
+      Quantity::GetRepresentation() const {
     return m_value;
   }
 }
@@ -589,7 +775,7 @@ namespace Beam::Serialization {
     template<typename Shuttler>
     void operator ()(Shuttler& shuttle, const char* name,
         const Nexus::Quantity& value) const {
-      shuttle.Send(name, value.m_value);
+      shuttle.Send(name, static_cast<boost::float64_t>(value.m_value));
     }
   };
 
@@ -600,12 +786,94 @@ namespace Beam::Serialization {
         Nexus::Quantity& value) const {
       auto representation = boost::float64_t();
       shuttle.Shuttle(name, representation);
+#ifdef NEXUS_FIXED_POINT_QUANTITY
+      value = Nexus::Quantity::FromRepresentation(
+        Nexus::Details::ToFixedPoint(representation));
+#else
       value = Nexus::Quantity::FromRepresentation(representation);
+#endif
     }
   };
 }
 
 namespace std {
+#ifdef NEXUS_FIXED_POINT_QUANTITY
+  /**
+   * The fixed-point backend keeps the double backend's semantics by reserving
+   * the extremes of its range, the largest representation stands for
+   * infinity, its negation for negative infinity and the smallest for NaN.
+   * These sentinels order correctly against every finite value but, unlike
+   * a double, do not propagate through arithmetic.
+   */
+  template<>
+  class numeric_limits<Nexus::Quantity> {
+    public:
+      static constexpr bool is_specialized = true;
+      static constexpr bool is_signed = true;
+      static constexpr bool is_integer = false;
+      static constexpr bool is_exact = true;
+      static constexpr bool has_infinity = true;
+      static constexpr bool has_quiet_NaN = true;
+      static constexpr bool has_signaling_NaN = false;
+      static constexpr bool has_denorm = false;
+      static constexpr bool has_denorm_loss = false;
+      static constexpr std::float_round_style round_style = round_to_nearest;
+      static constexpr bool is_iec559 = false;
+      static constexpr bool is_bounded = true;
+      static constexpr bool is_modulo = false;
+      static constexpr int digits = numeric_limits<std::int64_t>::digits;
+      static constexpr int digits10 =
+        numeric_limits<std::int64_t>::digits10;
+      static constexpr int max_digits10 =
+        numeric_limits<std::int64_t>::max_digits10;
+      static constexpr int radix = numeric_limits<std::int64_t>::radix;
+      static constexpr int min_exponent = 0;
+      static constexpr int min_exponent10 = 0;
+      static constexpr int max_exponent = 0;
+      static constexpr int max_exponent10 = 0;
+      static constexpr bool traps = false;
+      static constexpr bool tinyness_before = false;
+
+      static constexpr Nexus::Quantity min() {
+        return Nexus::Quantity::FromRepresentation(1);
+      }
+
+      static constexpr Nexus::Quantity lowest() {
+        return -max();
+      }
+
+      static constexpr Nexus::Quantity max() {
+        return Nexus::Quantity::FromRepresentation(
+          numeric_limits<std::int64_t>::max() - 1);
+      }
+
+      static constexpr Nexus::Quantity epsilon() {
+        return Nexus::Quantity::FromRepresentation(1);
+      }
+
+      static constexpr Nexus::Quantity round_error() {
+        return Nexus::Quantity::FromRepresentation(1);
+      }
+
+      static constexpr Nexus::Quantity infinity() {
+        return Nexus::Quantity::FromRepresentation(
+          numeric_limits<std::int64_t>::max());
+      }
+
+      static constexpr Nexus::Quantity quiet_NaN() {
+        return Nexus::Quantity::FromRepresentation(
+          numeric_limits<std::int64_t>::min());
+      }
+
+      static constexpr Nexus::Quantity signaling_NaN() {
+        return quiet_NaN();
+      }
+
+      static constexpr Nexus::Quantity denorm_min() {
+        return min();
+      }
+  };
+#else
   template<>
   class numeric_limits<Nexus::Quantity> {
     public:
@@ -698,6 +966,7 @@ namespace std {
           numeric_limits<boost::float64_t>::denorm_min());
       }
   };
+#endif
 }
 
 #endif
@@ -13,7 +13,12 @@
 
 namespace Nexus {
 
-  /** Identifies a tradeable instrument. */
+  /**
+   * Identifies a tradeable instrument. The hash of the symbol and country is
+   * computed once on construction so that lookups in hashed containers and
+   * equality tests between distinct securities avoid rehashing or comparing
+   * the symbol.
+   */
   class Security {
     public:
 
@@ -74,6 +79,10 @@ namespace Nexus {
       std::string m_symbol;
       MarketCode m_market;
       CountryCode m_country;
+      std::size_t m_hash;
+
+      static std::size_t ComputeHash(const std::string& symbol,
+        CountryCode country);
   };
 
   /**
@@ -149,24 +158,24 @@ namespace Nexus {
   }
 
   inline std::size_t hash_value(const Security& security) {
-    auto seed = std::size_t(0);
-    boost::hash_combine(seed, security.GetSymbol());
-    boost::hash_combine(seed, security.GetCountry());
-    return seed;
+    return security.m_hash;
   }
 
   inline Security::Security()
-    : m_country(CountryCode::NONE) {}
+    : m_country(CountryCode::NONE),
+      m_hash(ComputeHash(m_symbol, m_country)) {}
 
   inline Security::Security(std::string symbol, MarketCode market,
     CountryCode country)
     : m_symbol(std::move(symbol)),
       m_market(market),
-      m_country(country) {}
+      m_country(country),
+      m_hash(ComputeHash(m_symbol, m_country)) {}
 
   inline Security::Security(std::string symbol, CountryCode country)
     : m_symbol(std::move(symbol)),
-      m_country(country) {}
+      m_country(country),
+      m_hash(ComputeHash(m_symbol, m_country)) {}
 
   inline bool Security::operator <(const Security& rhs) const {
     return std::tie(m_symbol, m_country) <
@@ -174,7 +183,8 @@ namespace Nexus {
   }
 
   inline bool Security::operator ==(const Security& rhs) const {
-    return m_symbol == rhs.m_symbol && m_country == rhs.m_country;
+    return m_hash == rhs.m_hash && m_country == rhs.m_country &&
+      m_symbol == rhs.m_symbol;
   }
 
   inline bool Security::operator !=(const Security& rhs) const {
@@ -192,6 +202,14 @@ namespace Nexus {
   inline CountryCode Security::GetCountry() const {
     return m_country;
   }
+
+  inline std::size_t Security::ComputeHash(const std::string& symbol,
+      CountryCode country) {
+    auto seed = std::size_t(0);
+    boost::hash_combine(seed, symbol);
+    boost::hash_combine(seed, country);
+    return seed;
+  }
 }
 
 namespace Beam::Serialization {
@@ -203,6 +221,10 @@ namespace Beam::Serialization {
       shuttle.Shuttle("symbol", value.m_symbol);
       shuttle.Shuttle("market", value.m_market);
       shuttle.Shuttle("country", value.m_country);
+      if(IsReceiver<Shuttler>::value) {
+        value.m_hash = Nexus::Security::ComputeHash(value.m_symbol,
+          value.m_country);
+      }
     }
   };
 }
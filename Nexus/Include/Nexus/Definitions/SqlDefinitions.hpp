@@ -52,15 +52,20 @@ namespace Viper {
   template<>
   struct ToSql<Nexus::Quantity> {
     void operator ()(Nexus::Quantity value, std::string& column) const {
-      to_sql(value.GetRepresentation(), column);
+      to_sql(static_cast<boost::float64_t>(value.GetRepresentation()), column);
     }
   };
 
   template<>
   struct FromSql<Nexus::Quantity> {
     auto operator ()(const RawColumn& column) const {
+#ifdef NEXUS_FIXED_POINT_QUANTITY
+      return Nexus::Quantity::FromRepresentation(
+        Nexus::Details::ToFixedPoint(from_sql<boost::float64_t>(column)));
+#else
       return Nexus::Quantity::FromRepresentation(
         from_sql<boost::float64_t>(column));
+#endif
     }
   };
 
@@ -7,7 +7,6 @@
 #include <Beam/Pointers/Out.hpp>
 #include <Beam/Pointers/Ref.hpp>
 #include <Beam/Queues/RoutineTaskQueue.hpp>
-#include <Beam/Queues/StateQueue.hpp>
 #include <Beam/Threading/TimedConditionVariable.hpp>
 #include <Beam/Threading/Sync.hpp>
 #include <Beam/Utilities/Algorithm.hpp>
@@ -16,7 +15,7 @@
 #include "Nexus/Definitions/BboQuote.hpp"
 #include "Nexus/Definitions/OrderStatus.hpp"
 #include "Nexus/InternalMatcher/InternalMatcher.hpp"
-#include "Nexus/MarketDataService/SecurityMarketDataQuery.hpp"
+#include "Nexus/MarketDataService/BboQuoteCache.hpp"
 #include "Nexus/OrderExecutionService/AccountQuery.hpp"
 #include "Nexus/OrderExecutionService/ExecutionReport.hpp"
 #include "Nexus/OrderExecutionService/OrderExecutionSession.hpp"
@@ -70,6 +69,10 @@ namespace Details {
        */
       using OrderExecutionDriver = Beam::GetTryDereferenceType<D>;
 
+      /** The type of BboQuoteCache used to price internally matched orders. */
+      using BboQuoteCache =
+        MarketDataService::BboQuoteCache<MarketDataClient*>;
+
       /**
        * Constructs an InternalMatchingOrderExecutionDriver.
        * @param matchReportBuilder Initializes the MatchReportBuilder.
@@ -84,6 +87,23 @@ namespace Details {
         BF&& matchReportBuilder, MF&& marketDataClient, TF&& timeClient,
         UF&& uidClient, DF&& orderExecutionDriver);
 
+      /**
+       * Constructs an InternalMatchingOrderExecutionDriver pricing orders off
+       * of a shared BboQuoteCache.
+       * @param matchReportBuilder Initializes the MatchReportBuilder.
+       * @param marketDataClient Initializes the MarketDataClient.
+       * @param timeClient Initializes the TimeClient.
+       * @param uidClient Initializes the UidClient.
+       * @param orderExecutionDriver Initializes the OrderExecutionDriver.
+       * @param bboQuotes The BboQuoteCache used to price orders.
+       */
+      template<typename BF, typename MF, typename TF, typename UF, typename DF>
+      InternalMatchingOrderExecutionDriver(
+        const Beam::ServiceLocator::DirectoryEntry& rootSessionAccount,
+        BF&& matchReportBuilder, MF&& marketDataClient, TF&& timeClient,
+        UF&& uidClient, DF&& orderExecutionDriver,
+        std::shared_ptr<BboQuoteCache> bboQuotes);
+
       ~InternalMatchingOrderExecutionDriver();
 
       const OrderExecutionService::Order& Recover(
@@ -119,15 +139,16 @@ namespace Details {
       struct SecurityEntry {
         std::vector<std::shared_ptr<OrderEntry>> m_asks;
         std::vector<std::shared_ptr<OrderEntry>> m_bids;
-        std::shared_ptr<Beam::StateQueue<BboQuote>> m_bboQuote;
+        typename BboQuoteCache::Handle m_bboQuote;
 
-        SecurityEntry();
+        explicit SecurityEntry(typename BboQuoteCache::Handle bboQuote);
       };
       Beam::GetOptionalLocalPtr<B> m_matchReportBuilder;
       Beam::GetOptionalLocalPtr<M> m_marketDataClient;
       Beam::GetOptionalLocalPtr<T> m_timeClient;
       Beam::GetOptionalLocalPtr<U> m_uidClient;
       Beam::GetOptionalLocalPtr<D> m_orderExecutionDriver;
+      std::shared_ptr<BboQuoteCache> m_bboQuotes;
       OrderExecutionService::OrderExecutionSession m_rootSession;
       Beam::SynchronizedUnorderedMap<OrderExecutionService::OrderId,
         OrderExecutionService::OrderId> m_orderIds;
@@ -171,8 +192,8 @@ namespace Details {
 
   template<typename B, typename M, typename T, typename U, typename D>
   InternalMatchingOrderExecutionDriver<B, M, T, U, D>::
-    SecurityEntry::SecurityEntry()
-    : m_bboQuote(std::make_shared<Beam::StateQueue<BboQuote>>()) {}
+    SecurityEntry::SecurityEntry(typename BboQuoteCache::Handle bboQuote)
+    : m_bboQuote(std::move(bboQuote)) {}
 
   template<typename B, typename M, typename T, typename U, typename D>
   template<typename BF, typename MF, typename TF, typename UF, typename DF>
@@ -181,11 +202,29 @@ namespace Details {
       const Beam::ServiceLocator::DirectoryEntry& rootSessionAccount,
       BF&& matchReportBuilder, MF&& marketDataClient, TF&& timeClient,
       UF&& uidClient, DF&& orderExecutionDriver)
+      : InternalMatchingOrderExecutionDriver(rootSessionAccount,
+          std::forward<BF>(matchReportBuilder),
+          std::forward<MF>(marketDataClient), std::forward<TF>(timeClient),
+          std::forward<UF>(uidClient), std::forward<DF>(orderExecutionDriver),
+          nullptr) {}
+
+  template<typename B, typename M, typename T, typename U, typename D>
+  template<typename BF, typename MF, typename TF, typename UF, typename DF>
+  InternalMatchingOrderExecutionDriver<B, M, T, U, D>::
+      InternalMatchingOrderExecutionDriver(
+      const Beam::ServiceLocator::DirectoryEntry& rootSessionAccount,
+      BF&& matchReportBuilder, MF&& marketDataClient, TF&& timeClient,
+      UF&& uidClient, DF&& orderExecutionDriver,
+      std::shared_ptr<BboQuoteCache> bboQuotes)
       : m_matchReportBuilder(std::forward<BF>(matchReportBuilder)),
         m_marketDataClient(std::forward<MF>(marketDataClient)),
         m_timeClient(std::forward<TF>(timeClient)),
         m_uidClient(std::forward<UF>(uidClient)),
-        m_orderExecutionDriver(std::forward<DF>(orderExecutionDriver)) {
+        m_orderExecutionDriver(std::forward<DF>(orderExecutionDriver)),
+        m_bboQuotes(std::move(bboQuotes)) {
+    if(!m_bboQuotes) {
+      m_bboQuotes = std::make_shared<BboQuoteCache>(&*m_marketDataClient);
+    }
     m_rootSession.SetAccount(rootSessionAccount);
   }
 
@@ -277,16 +316,13 @@ namespace Details {
     auto& fields = orderEntry->m_order->GetInfo().m_fields;
     auto securityEntry = Beam::GetOrInsert(m_securityEntries, fields.m_security,
       [&] {
-        auto securityEntry = std::make_shared<SecurityEntry>();
-        MarketDataService::QueryRealTimeWithSnapshot(fields.m_security,
-          *m_marketDataClient, securityEntry->m_bboQuote);
-        return securityEntry;
+        return std::make_shared<SecurityEntry>(
+          m_bboQuotes->GetHandle(fields.m_security));
       });
     auto bboQuote = [&] () -> boost::optional<BboQuote> {
       try {
-        return securityEntry->m_bboQuote->Peek();
+        return m_bboQuotes->Load(securityEntry->m_bboQuote);
       } catch(const Beam::PipeBrokenException&) {
-        m_securityEntries.erase(fields.m_security);
         return boost::none;
       }
     }();
@@ -0,0 +1,436 @@
+#ifndef NEXUS_MARKET_DATA_BBO_QUOTE_CACHE_HPP
+#define NEXUS_MARKET_DATA_BBO_QUOTE_CACHE_HPP
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include <Beam/Collections/SynchronizedMap.hpp>
+#include <Beam/Pointers/Dereference.hpp>
+#include <Beam/Pointers/LocalPtr.hpp>
+#include <Beam/Queues/CallbackQueueWriter.hpp>
+#include <Beam/Queues/PipeBrokenException.hpp>
+#include <Beam/Threading/ConditionVariable.hpp>
+#include <Beam/Threading/Mutex.hpp>
+#include <boost/optional/optional.hpp>
+#include <boost/thread/locks.hpp>
+#include "Nexus/Definitions/BboQuote.hpp"
+#include "Nexus/Definitions/Security.hpp"
+#include "Nexus/MarketDataService/MarketDataClient.hpp"
+#include "Nexus/MarketDataService/SecurityMarketDataQuery.hpp"
+
+namespace Nexus::MarketDataService {
+namespace Details {
+
+  /**
+   * Stores a BboQuote behind a sequence counter so that it can be read without
+   * acquiring a lock, writes must be serialized by the caller.
+   */
+  class AtomicBboQuote {
+    public:
+
+      /** Constructs an empty AtomicBboQuote. */
+      AtomicBboQuote();
+
+      /** Returns the stored BboQuote, or <code>none</code> if empty. */
+      boost::optional<BboQuote> Load() const;
+
+      /** Stores a BboQuote. */
+      void Store(const BboQuote& bboQuote);
+
+      /** Clears the stored BboQuote. */
+      void Reset();
+
+    private:
+      std::atomic<std::uint64_t> m_sequence;
+      std::atomic<bool> m_isSet;
+      std::atomic<Quantity::Representation> m_bidPrice;
+      std::atomic<Quantity::Representation> m_bidSize;
+      std::atomic<Quantity::Representation> m_askPrice;
+      std::atomic<Quantity::Representation> m_askSize;
+      std::atomic<std::int64_t> m_timestamp;
+
+      template<typename F>
+      void Write(F&& f);
+      static std::int64_t ToRepresentation(boost::posix_time::ptime timestamp);
+      static boost::posix_time::ptime FromRepresentation(std::int64_t value);
+  };
+
+  inline AtomicBboQuote::AtomicBboQuote()
+    : m_sequence(0),
+      m_isSet(false),
+      m_bidPrice(0),
+      m_bidSize(0),
+      m_askPrice(0),
+      m_askSize(0),
+      m_timestamp(0) {}
+
+  inline boost::optional<BboQuote> AtomicBboQuote::Load() const {
+    while(true) {
+      auto sequence = m_sequence.load(std::memory_order_acquire);
+      if(sequence % 2 != 0) {
+        continue;
+      }
+      auto isSet = m_isSet.load(std::memory_order_relaxed);
+      auto bidPrice = m_bidPrice.load(std::memory_order_relaxed);
+      auto bidSize = m_bidSize.load(std::memory_order_relaxed);
+      auto askPrice = m_askPrice.load(std::memory_order_relaxed);
+      auto askSize = m_askSize.load(std::memory_order_relaxed);
+      auto timestamp = m_timestamp.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if(m_sequence.load(std::memory_order_relaxed) != sequence) {
+        continue;
+      }
+      if(!isSet) {
+        return boost::none;
+      }
+      return BboQuote(
+        Quote(Money(Quantity::FromRepresentation(bidPrice)),
+          Quantity::FromRepresentation(bidSize), Side::BID),
+        Quote(Money(Quantity::FromRepresentation(askPrice)),
+          Quantity::FromRepresentation(askSize), Side::ASK),
+        FromRepresentation(timestamp));
+    }
+  }
+
+  inline void AtomicBboQuote::Store(const BboQuote& bboQuote) {
+    Write([&] {
+      m_isSet.store(true, std::memory_order_relaxed);
+      m_bidPrice.store(static_cast<Quantity>(
+        bboQuote.m_bid.m_price).GetRepresentation(), std::memory_order_relaxed);
+      m_bidSize.store(bboQuote.m_bid.m_size.GetRepresentation(),
+        std::memory_order_relaxed);
+      m_askPrice.store(static_cast<Quantity>(
+        bboQuote.m_ask.m_price).GetRepresentation(), std::memory_order_relaxed);
+      m_askSize.store(bboQuote.m_ask.m_size.GetRepresentation(),
+        std::memory_order_relaxed);
+      m_timestamp.store(ToRepresentation(bboQuote.m_timestamp),
+        std::memory_order_relaxed);
+    });
+  }
+
+  inline void AtomicBboQuote::Reset() {
+    Write([&] {
+      m_isSet.store(false, std::memory_order_relaxed);
+    });
+  }
+
+  template<typename F>
+  void AtomicBboQuote::Write(F&& f) {
+    auto sequence = m_sequence.load(std::memory_order_relaxed);
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    f();
+    m_sequence.store(sequence + 2, std::memory_order_release);
+  }
+
+  inline std::int64_t AtomicBboQuote::ToRepresentation(
+      boost::posix_time::ptime timestamp) {
+    if(timestamp.is_neg_infinity()) {
+      return std::numeric_limits<std::int64_t>::min();
+    } else if(timestamp.is_pos_infinity()) {
+      return std::numeric_limits<std::int64_t>::max();
+    } else if(timestamp.is_special()) {
+      return std::numeric_limits<std::int64_t>::min() + 1;
+    }
+    return (timestamp - boost::posix_time::ptime(
+      boost::gregorian::date(1970, 1, 1))).total_microseconds();
+  }
+
+  inline boost::posix_time::ptime AtomicBboQuote::FromRepresentation(
+      std::int64_t value) {
+    if(value == std::numeric_limits<std::int64_t>::min()) {
+      return boost::posix_time::neg_infin;
+    } else if(value == std::numeric_limits<std::int64_t>::max()) {
+      return boost::posix_time::pos_infin;
+    } else if(value == std::numeric_limits<std::int64_t>::min() + 1) {
+      return boost::posix_time::not_a_date_time;
+    }
+    return boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1)) +
+      boost::posix_time::microseconds(value);
+  }
+}
+
+  /**
+   * Keeps the latest BboQuote of every Security requested of it, so that any
+   * number of components can price Orders off of a single real time
+   * subscription per Security. A Security's subscription is renewed by the
+   * next Load after it breaks.
+   * @param <C> The type of MarketDataClient used to subscribe to BboQuotes.
+   */
+  template<typename C>
+  class BboQuoteCache {
+    private:
+      enum class State {
+        NONE,
+        SUBSCRIBING,
+        SUBSCRIBED,
+        BROKEN
+      };
+      struct Entry {
+        Security m_security;
+        Details::AtomicBboQuote m_bboQuote;
+        std::atomic<bool> m_isBroken;
+        Beam::Threading::Mutex m_mutex;
+        State m_state;
+        int m_generation;
+        std::exception_ptr m_exception;
+        Beam::Threading::ConditionVariable m_condition;
+
+        explicit Entry(Security security);
+      };
+
+    public:
+
+      /** The type of MarketDataClient used to subscribe to BboQuotes. */
+      using MarketDataClient = Beam::GetTryDereferenceType<C>;
+
+      /**
+       * Refers to a Security's entry in the cache. A Handle remains valid for
+       * the lifetime of the cache, including across resubscriptions, and
+       * reading a received BboQuote through it acquires no locks.
+       */
+      class Handle {
+        public:
+
+          /** Constructs an invalid Handle. */
+          Handle() = default;
+
+          /** Returns the Security referred to. */
+          const Security& GetSecurity() const;
+
+        private:
+          friend class BboQuoteCache;
+          std::shared_ptr<Entry> m_entry;
+
+          explicit Handle(std::shared_ptr<Entry> entry);
+      };
+
+      /**
+       * Constructs an empty BboQuoteCache.
+       * @param marketDataClient Initializes the MarketDataClient.
+       */
+      template<typename CF>
+      explicit BboQuoteCache(CF&& marketDataClient);
+
+      /**
+       * Constructs a BboQuoteCache subscribed to a list of Securities.
+       * @param marketDataClient Initializes the MarketDataClient.
+       * @param watchList The Securities to subscribe to up front.
+       */
+      template<typename CF>
+      BboQuoteCache(CF&& marketDataClient,
+        const std::vector<Security>& watchList);
+
+      /**
+       * Returns the Handle to a Security, subscribing to its BboQuotes if this
+       * is the first request for it. Components pricing Orders repeatedly
+       * should keep the Handle rather than look the Security up each time.
+       * @param security The Security to get.
+       * @return The Handle to the <i>security</i>.
+       */
+      Handle GetHandle(const Security& security);
+
+      /**
+       * Returns the latest BboQuote received for a Security without waiting.
+       * @param handle The Handle to the Security.
+       * @return The latest BboQuote, or <code>none</code> if none has been
+       *         received or the subscription is broken.
+       */
+      boost::optional<BboQuote> Find(const Handle& handle) const;
+
+      /**
+       * Returns the latest BboQuote of a Security, resubscribing if its
+       * subscription is broken and waiting for the first BboQuote to be
+       * received if needed.
+       * @param handle The Handle to the Security.
+       * @return The latest BboQuote.
+       * @throws PipeBrokenException if the subscription broke again before a
+       *         BboQuote was received.
+       */
+      BboQuote Load(const Handle& handle);
+
+      /**
+       * Returns the latest BboQuote of a Security, waiting for the first
+       * BboQuote to be received if needed.
+       * @param security The Security to load.
+       * @return The latest BboQuote.
+       * @throws PipeBrokenException if no BboQuote is available.
+       */
+      BboQuote Load(const Security& security);
+
+    private:
+      Beam::GetOptionalLocalPtr<C> m_marketDataClient;
+      Beam::SynchronizedUnorderedMap<Security, std::shared_ptr<Entry>>
+        m_entries;
+
+      BboQuoteCache(const BboQuoteCache&) = delete;
+      BboQuoteCache& operator =(const BboQuoteCache&) = delete;
+      void Subscribe(const std::shared_ptr<Entry>& entry);
+      static void OnBboQuote(Entry& entry, int generation,
+        const BboQuote& bboQuote);
+      static void OnBreak(Entry& entry, int generation,
+        const std::exception_ptr& exception);
+  };
+
+  template<typename MarketDataClient>
+  BboQuoteCache(MarketDataClient&&) ->
+    BboQuoteCache<std::remove_reference_t<MarketDataClient>>;
+
+  template<typename MarketDataClient>
+  BboQuoteCache(MarketDataClient&&, const std::vector<Security>&) ->
+    BboQuoteCache<std::remove_reference_t<MarketDataClient>>;
+
+  template<typename C>
+  BboQuoteCache<C>::Entry::Entry(Security security)
+    : m_security(std::move(security)),
+      m_isBroken(false),
+      m_state(State::NONE),
+      m_generation(0) {}
+
+  template<typename C>
+  BboQuoteCache<C>::Handle::Handle(std::shared_ptr<Entry> entry)
+    : m_entry(std::move(entry)) {}
+
+  template<typename C>
+  const Security& BboQuoteCache<C>::Handle::GetSecurity() const {
+    return m_entry->m_security;
+  }
+
+  template<typename C>
+  template<typename CF>
+  BboQuoteCache<C>::BboQuoteCache(CF&& marketDataClient)
+    : m_marketDataClient(std::forward<CF>(marketDataClient)) {}
+
+  template<typename C>
+  template<typename CF>
+  BboQuoteCache<C>::BboQuoteCache(CF&& marketDataClient,
+      const std::vector<Security>& watchList)
+      : BboQuoteCache(std::forward<CF>(marketDataClient)) {
+    for(auto& security : watchList) {
+      GetHandle(security);
+    }
+  }
+
+  template<typename C>
+  typename BboQuoteCache<C>::Handle BboQuoteCache<C>::GetHandle(
+      const Security& security) {
+    auto isInserted = false;
+    auto entry = m_entries.GetOrInsert(security, [&] {
+      isInserted = true;
+      return std::make_shared<Entry>(security);
+    });
+    if(isInserted) {
+      Subscribe(entry);
+    }
+    return Handle(std::move(entry));
+  }
+
+  template<typename C>
+  boost::optional<BboQuote> BboQuoteCache<C>::Find(const Handle& handle) const {
+    if(handle.m_entry->m_isBroken.load(std::memory_order_acquire)) {
+      return boost::none;
+    }
+    return handle.m_entry->m_bboQuote.Load();
+  }
+
+  template<typename C>
+  BboQuote BboQuoteCache<C>::Load(const Handle& handle) {
+    if(auto bboQuote = Find(handle)) {
+      return *bboQuote;
+    }
+    auto& entry = *handle.m_entry;
+    auto isResubscribed = false;
+    auto lock = boost::unique_lock(entry.m_mutex);
+    while(true) {
+      if(entry.m_state == State::BROKEN) {
+        if(isResubscribed) {
+          std::rethrow_exception(entry.m_exception);
+        }
+        lock.unlock();
+        Subscribe(handle.m_entry);
+        isResubscribed = true;
+        lock.lock();
+      } else if(auto bboQuote = entry.m_bboQuote.Load()) {
+        return *bboQuote;
+      } else {
+        entry.m_condition.wait(lock);
+      }
+    }
+  }
+
+  template<typename C>
+  BboQuote BboQuoteCache<C>::Load(const Security& security) {
+    return Load(GetHandle(security));
+  }
+
+  template<typename C>
+  void BboQuoteCache<C>::Subscribe(const std::shared_ptr<Entry>& entry) {
+    auto generation = [&] {
+      auto lock = boost::lock_guard(entry->m_mutex);
+      if(entry->m_state == State::SUBSCRIBING ||
+          entry->m_state == State::SUBSCRIBED) {
+        return -1;
+      }
+      entry->m_state = State::SUBSCRIBING;
+      entry->m_exception = nullptr;
+      entry->m_bboQuote.Reset();
+      entry->m_isBroken.store(false, std::memory_order_release);
+      return ++entry->m_generation;
+    }();
+    if(generation == -1) {
+      return;
+    }
+    try {
+      QueryRealTimeWithSnapshot(entry->m_security, *m_marketDataClient,
+        Beam::MakeCallbackQueueWriter<BboQuote>(
+          [=] (const BboQuote& bboQuote) {
+            OnBboQuote(*entry, generation, bboQuote);
+          },
+          [=] (const std::exception_ptr& exception) {
+            OnBreak(*entry, generation, exception);
+          }));
+    } catch(const std::exception&) {
+      OnBreak(*entry, generation, std::current_exception());
+      return;
+    }
+    auto lock = boost::lock_guard(entry->m_mutex);
+    if(entry->m_generation == generation &&
+        entry->m_state == State::SUBSCRIBING) {
+      entry->m_state = State::SUBSCRIBED;
+    }
+  }
+
+  template<typename C>
+  void BboQuoteCache<C>::OnBboQuote(Entry& entry, int generation,
+      const BboQuote& bboQuote) {
+    auto lock = boost::lock_guard(entry.m_mutex);
+    if(entry.m_generation != generation) {
+      return;
+    }
+    entry.m_bboQuote.Store(bboQuote);
+    entry.m_condition.notify_all();
+  }
+
+  template<typename C>
+  void BboQuoteCache<C>::OnBreak(Entry& entry, int generation,
+      const std::exception_ptr& exception) {
+    auto lock = boost::lock_guard(entry.m_mutex);
+    if(entry.m_generation != generation ||
+        entry.m_state == State::BROKEN) {
+      return;
+    }
+    entry.m_state = State::BROKEN;
+    if(exception) {
+      entry.m_exception = exception;
+    } else {
+      entry.m_exception = std::make_exception_ptr(Beam::PipeBrokenException());
+    }
+    entry.m_isBroken.store(true, std::memory_order_release);
+    entry.m_condition.notify_all();
+  }
+}
+
+#endif
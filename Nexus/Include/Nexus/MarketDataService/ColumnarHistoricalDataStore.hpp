@@ -0,0 +1,1236 @@
+#ifndef NEXUS_COLUMNAR_HISTORICAL_DATA_STORE_HPP
+#define NEXUS_COLUMNAR_HISTORICAL_DATA_STORE_HPP
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <Beam/Collections/SynchronizedMap.hpp>
+#include <Beam/IO/OpenState.hpp>
+#include <Beam/IO/SharedBuffer.hpp>
+#include <Beam/Queries/Range.hpp>
+#include <Beam/Serialization/BinaryReceiver.hpp>
+#include <Beam/Serialization/BinarySender.hpp>
+#include <boost/date_time/gregorian/gregorian.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/optional/optional.hpp>
+#include <boost/throw_exception.hpp>
+#include "Nexus/MarketDataService/HistoricalDataStore.hpp"
+#include "Nexus/MarketDataService/HistoricalDataStoreException.hpp"
+#include "Nexus/MarketDataService/HistoricalDataStoreUtilities.hpp"
+#include "Nexus/MarketDataService/LocalHistoricalDataStore.hpp"
+#include "Nexus/MarketDataService/MarketDataService.hpp"
+#include "Nexus/Queries/EvaluatorTranslator.hpp"
+
+namespace Nexus::MarketDataService {
+namespace Details {
+
+  /** Identifies the start of a block within a column file. */
+  constexpr auto COLUMNAR_BLOCK_MAGIC = std::uint32_t(0x4243584E);
+
+  /** The number of columns common to every block (sequence, timestamp). */
+  constexpr auto COLUMNAR_HEADER_COLUMNS = 2;
+
+  /** The fixed size header written in front of every block. */
+  struct ColumnarBlockHeader {
+
+    /** Must equal COLUMNAR_BLOCK_MAGIC. */
+    std::uint32_t m_magic;
+
+    /** The number of rows in the block. */
+    std::uint32_t m_count;
+
+    /** The number of columns in the block. */
+    std::uint32_t m_columnCount;
+
+    /** The size of the payload following this header. */
+    std::uint32_t m_payloadSize;
+
+    /** The sequence of the first row. */
+    std::uint64_t m_firstSequence;
+
+    /** The sequence of the last row. */
+    std::uint64_t m_lastSequence;
+
+    /** The smallest timestamp in the block, in microseconds. */
+    std::int64_t m_minTimestamp;
+
+    /** The largest timestamp in the block, in microseconds. */
+    std::int64_t m_maxTimestamp;
+  };
+
+  /** An entry in the sparse index kept for every column file. */
+  struct ColumnarBlock {
+
+    /** The block's header. */
+    ColumnarBlockHeader m_header;
+
+    /** The offset of the block's payload within its file. */
+    std::uint64_t m_offset;
+  };
+
+  /** Stores the index of a single day's column file. */
+  struct ColumnarFile {
+
+    /** The day stored, formatted as YYYYMMDD. */
+    std::string m_day;
+
+    /** The path to the file. */
+    std::filesystem::path m_path;
+
+    /** The index of the blocks contained in the file. */
+    std::vector<ColumnarBlock> m_blocks;
+
+    /** The number of valid bytes in the file. */
+    std::uint64_t m_size;
+  };
+
+  /**
+   * Stores all of the data of a single type for a single index.
+   * @param <T> The type of data stored.
+   */
+  template<typename T>
+  struct ColumnarPartition {
+
+    /** The directory containing the partition's column files. */
+    std::filesystem::path m_directory;
+
+    /** Whether the column files have been indexed. */
+    bool m_isLoaded;
+
+    /** The indexed column files, ordered by day. */
+    std::vector<ColumnarFile> m_files;
+
+    /** The sequence of the last row written to a block. */
+    boost::optional<std::uint64_t> m_lastSequence;
+
+    /** The values not yet written to a block, ordered by sequence. */
+    std::vector<Beam::Queries::SequencedValue<T>> m_pending;
+
+    /** Synchronizes access to this partition. */
+    std::mutex m_mutex;
+
+    /**
+     * Constructs a ColumnarPartition.
+     * @param directory The directory containing the column files.
+     */
+    explicit ColumnarPartition(std::filesystem::path directory)
+      : m_directory(std::move(directory)),
+        m_isLoaded(false) {}
+  };
+
+  inline void AppendVarint(std::string& out, std::uint64_t value) {
+    while(value >= 0x80) {
+      out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+  }
+
+  inline std::uint64_t ReadVarint(const char*& cursor, const char* end) {
+    auto value = std::uint64_t(0);
+    auto shift = 0;
+    while(cursor != end && shift < 64) {
+      auto byte = static_cast<std::uint8_t>(*cursor);
+      ++cursor;
+      value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+      if((byte & 0x80) == 0) {
+        return value;
+      }
+      shift += 7;
+    }
+    BOOST_THROW_EXCEPTION(HistoricalDataStoreException("Corrupt column."));
+  }
+
+  inline std::uint64_t ZigZag(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^
+      static_cast<std::uint64_t>(value >> 63);
+  }
+
+  inline std::int64_t UnZigZag(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^
+      -static_cast<std::int64_t>(value & 1);
+  }
+
+  /** Appends a double in little-endian byte order. */
+  inline void AppendDouble(std::string& out, double value) {
+    auto bits = std::uint64_t();
+    std::memcpy(&bits, &value, sizeof(bits));
+    for(auto i = 0; i != 8; ++i) {
+      out.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+    }
+  }
+
+  /** Reads a double written by AppendDouble. */
+  inline double ReadDouble(const char*& cursor, const char* end) {
+    if(end - cursor < 8) {
+      BOOST_THROW_EXCEPTION(HistoricalDataStoreException("Corrupt column."));
+    }
+    auto bits = std::uint64_t(0);
+    for(auto i = 0; i != 8; ++i) {
+      bits |= static_cast<std::uint64_t>(
+        static_cast<std::uint8_t>(cursor[i])) << (8 * i);
+    }
+    cursor += 8;
+    auto value = double();
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  /**
+   * Encodes a single column of a block. Integers are stored as zig-zag varint
+   * deltas from the previous row, strings are stored as varint indices into a
+   * dictionary written at the front of the column.
+   */
+  class ColumnWriter {
+    public:
+
+      /** Appends an integer. */
+      void Append(std::int64_t value);
+
+      /**
+       * Appends a Quantity as its scaled integer representation, falling back
+       * to the raw floating point value when it has no exact integer form.
+       */
+      void Append(Quantity value);
+
+      /** Appends a string. */
+      void Append(std::string_view value);
+
+      /** Appends this column's encoding, prefixed by its size, to a block. */
+      void Serialize(std::string& out) const;
+
+    private:
+      std::string m_data;
+      std::int64_t m_previous = 0;
+      std::vector<std::string> m_dictionary;
+      std::unordered_map<std::string, std::uint64_t> m_ids;
+  };
+
+  /** Decodes a single column encoded by a ColumnWriter, in place. */
+  class ColumnReader {
+    public:
+
+      /**
+       * Constructs a ColumnReader.
+       * @param begin The beginning of the column.
+       * @param end One past the end of the column.
+       */
+      ColumnReader(const char* begin, const char* end);
+
+      /** Reads an integer. */
+      std::int64_t ReadInteger();
+
+      /** Reads a Quantity. */
+      Quantity ReadQuantity();
+
+      /** Reads a string, the view refers to the underlying column. */
+      std::string_view ReadString();
+
+    private:
+      const char* m_cursor;
+      const char* m_end;
+      std::int64_t m_previous;
+      std::vector<std::string_view> m_dictionary;
+  };
+
+  /**
+   * Specifies how a type of market data is split into columns, excluding its
+   * sequence and timestamp which are common to all types.
+   * @param <T> The type of market data.
+   */
+  template<typename T>
+  struct ColumnarCodec;
+
+  template<>
+  struct ColumnarCodec<OrderImbalance> {
+    static constexpr auto COLUMNS = 6;
+
+    static void Encode(const OrderImbalance& value, ColumnWriter* columns) {
+      columns[0].Append(std::string_view(value.m_security.GetSymbol()));
+      columns[1].Append(std::string_view(
+        value.m_security.GetMarket().GetData()));
+      columns[2].Append(static_cast<std::int64_t>(
+        static_cast<std::uint16_t>(value.m_security.GetCountry())));
+      columns[3].Append(static_cast<std::int64_t>(static_cast<int>(
+        value.m_side)));
+      columns[4].Append(value.m_size);
+      columns[5].Append(static_cast<Quantity>(value.m_referencePrice));
+    }
+
+    static OrderImbalance Decode(ColumnReader* columns) {
+      auto value = OrderImbalance();
+      auto symbol = std::string(columns[0].ReadString());
+      auto market = std::string(columns[1].ReadString());
+      auto country = CountryCode(
+        static_cast<std::uint16_t>(columns[2].ReadInteger()));
+      value.m_security = Security(std::move(symbol), market.c_str(), country);
+      value.m_side = static_cast<Side::Type>(columns[3].ReadInteger());
+      value.m_size = columns[4].ReadQuantity();
+      value.m_referencePrice = Money(columns[5].ReadQuantity());
+      return value;
+    }
+  };
+
+  template<>
+  struct ColumnarCodec<BboQuote> {
+    static constexpr auto COLUMNS = 4;
+
+    static void Encode(const BboQuote& value, ColumnWriter* columns) {
+      columns[0].Append(static_cast<Quantity>(value.m_bid.m_price));
+      columns[1].Append(value.m_bid.m_size);
+      columns[2].Append(static_cast<Quantity>(value.m_ask.m_price));
+      columns[3].Append(value.m_ask.m_size);
+    }
+
+    static BboQuote Decode(ColumnReader* columns) {
+      auto value = BboQuote();
+      value.m_bid.m_price = Money(columns[0].ReadQuantity());
+      value.m_bid.m_size = columns[1].ReadQuantity();
+      value.m_bid.m_side = Side::BID;
+      value.m_ask.m_price = Money(columns[2].ReadQuantity());
+      value.m_ask.m_size = columns[3].ReadQuantity();
+      value.m_ask.m_side = Side::ASK;
+      return value;
+    }
+  };
+
+  template<>
+  struct ColumnarCodec<MarketQuote> {
+    static constexpr auto COLUMNS = 5;
+
+    static void Encode(const MarketQuote& value, ColumnWriter* columns) {
+      columns[0].Append(std::string_view(value.m_market.GetData()));
+      columns[1].Append(static_cast<Quantity>(value.m_bid.m_price));
+      columns[2].Append(value.m_bid.m_size);
+      columns[3].Append(static_cast<Quantity>(value.m_ask.m_price));
+      columns[4].Append(value.m_ask.m_size);
+    }
+
+    static MarketQuote Decode(ColumnReader* columns) {
+      auto value = MarketQuote();
+      value.m_market = std::string(columns[0].ReadString()).c_str();
+      value.m_bid.m_price = Money(columns[1].ReadQuantity());
+      value.m_bid.m_size = columns[2].ReadQuantity();
+      value.m_bid.m_side = Side::BID;
+      value.m_ask.m_price = Money(columns[3].ReadQuantity());
+      value.m_ask.m_size = columns[4].ReadQuantity();
+      value.m_ask.m_side = Side::ASK;
+      return value;
+    }
+  };
+
+  template<>
+  struct ColumnarCodec<BookQuote> {
+    static constexpr auto COLUMNS = 6;
+
+    static void Encode(const BookQuote& value, ColumnWriter* columns) {
+      columns[0].Append(std::string_view(value.m_mpid));
+      columns[1].Append(static_cast<std::int64_t>(value.m_isPrimaryMpid));
+      columns[2].Append(std::string_view(value.m_market.GetData()));
+      columns[3].Append(static_cast<Quantity>(value.m_quote.m_price));
+      columns[4].Append(value.m_quote.m_size);
+      columns[5].Append(static_cast<std::int64_t>(static_cast<int>(
+        value.m_quote.m_side)));
+    }
+
+    static BookQuote Decode(ColumnReader* columns) {
+      auto value = BookQuote();
+      value.m_mpid = std::string(columns[0].ReadString());
+      value.m_isPrimaryMpid = columns[1].ReadInteger() != 0;
+      value.m_market = std::string(columns[2].ReadString()).c_str();
+      value.m_quote.m_price = Money(columns[3].ReadQuantity());
+      value.m_quote.m_size = columns[4].ReadQuantity();
+      value.m_quote.m_side = static_cast<Side::Type>(columns[5].ReadInteger());
+      return value;
+    }
+  };
+
+  template<>
+  struct ColumnarCodec<TimeAndSale> {
+    static constexpr auto COLUMNS = 5;
+
+    static void Encode(const TimeAndSale& value, ColumnWriter* columns) {
+      columns[0].Append(static_cast<Quantity>(value.m_price));
+      columns[1].Append(value.m_size);
+      columns[2].Append(static_cast<std::int64_t>(static_cast<int>(
+        value.m_condition.m_type)));
+      columns[3].Append(std::string_view(value.m_condition.m_code));
+      columns[4].Append(std::string_view(value.m_marketCenter));
+    }
+
+    static TimeAndSale Decode(ColumnReader* columns) {
+      auto value = TimeAndSale();
+      value.m_price = Money(columns[0].ReadQuantity());
+      value.m_size = columns[1].ReadQuantity();
+      value.m_condition.m_type =
+        static_cast<TimeAndSale::Condition::Type::Type>(
+          columns[2].ReadInteger());
+      value.m_condition.m_code = std::string(columns[3].ReadString());
+      value.m_marketCenter = std::string(columns[4].ReadString());
+      return value;
+    }
+  };
+
+  inline void ColumnWriter::Append(std::int64_t value) {
+    AppendVarint(m_data, ZigZag(static_cast<std::int64_t>(
+      static_cast<std::uint64_t>(value) -
+      static_cast<std::uint64_t>(m_previous))));
+    m_previous = value;
+  }
+
+  inline void ColumnWriter::Append(Quantity value) {
+    auto representation = value.GetRepresentation();
+#ifdef NEXUS_FIXED_POINT_QUANTITY
+    auto integer = static_cast<std::int64_t>(representation);
+    auto isExact = true;
+#else
+    auto integer = m_previous;
+    auto isExact = false;
+    if(std::abs(representation) < 9e18) {
+      integer = static_cast<std::int64_t>(std::llround(representation));
+      isExact = static_cast<Quantity::Representation>(integer) ==
+        representation;
+    }
+#endif
+    AppendVarint(m_data, (ZigZag(static_cast<std::int64_t>(
+      static_cast<std::uint64_t>(integer) -
+      static_cast<std::uint64_t>(m_previous))) << 1) | (isExact ? 0 : 1));
+    m_previous = integer;
+    if(!isExact) {
+      AppendDouble(m_data, static_cast<double>(representation));
+    }
+  }
+
+  inline void ColumnWriter::Append(std::string_view value) {
+    auto id = m_ids.find(std::string(value));
+    if(id == m_ids.end()) {
+      id = m_ids.emplace(std::string(value), m_dictionary.size()).first;
+      m_dictionary.emplace_back(value);
+    }
+    AppendVarint(m_data, id->second);
+  }
+
+  inline void ColumnWriter::Serialize(std::string& out) const {
+    auto dictionary = std::string();
+    AppendVarint(dictionary, m_dictionary.size());
+    for(auto& entry : m_dictionary) {
+      AppendVarint(dictionary, entry.size());
+      dictionary += entry;
+    }
+    AppendVarint(out, dictionary.size() + m_data.size());
+    out += dictionary;
+    out += m_data;
+  }
+
+  inline ColumnReader::ColumnReader(const char* begin, const char* end)
+      : m_cursor(begin),
+        m_end(end),
+        m_previous(0) {
+    auto size = ReadVarint(m_cursor, m_end);
+    m_dictionary.reserve(static_cast<std::size_t>(
+      std::min<std::uint64_t>(size, m_end - m_cursor)));
+    for(auto i = std::uint64_t(0); i != size; ++i) {
+      auto length = ReadVarint(m_cursor, m_end);
+      if(length > static_cast<std::uint64_t>(m_end - m_cursor)) {
+        BOOST_THROW_EXCEPTION(HistoricalDataStoreException("Corrupt column."));
+      }
+      m_dictionary.emplace_back(m_cursor, static_cast<std::size_t>(length));
+      m_cursor += length;
+    }
+  }
+
+  inline std::int64_t ColumnReader::ReadInteger() {
+    m_previous = static_cast<std::int64_t>(
+      static_cast<std::uint64_t>(m_previous) +
+      static_cast<std::uint64_t>(UnZigZag(ReadVarint(m_cursor, m_end))));
+    return m_previous;
+  }
+
+  inline Quantity ColumnReader::ReadQuantity() {
+    auto encoding = ReadVarint(m_cursor, m_end);
+    m_previous = static_cast<std::int64_t>(
+      static_cast<std::uint64_t>(m_previous) +
+      static_cast<std::uint64_t>(UnZigZag(encoding >> 1)));
+    if((encoding & 1) == 0) {
+      return Quantity::FromRepresentation(
+        static_cast<Quantity::Representation>(m_previous));
+    }
+    return Quantity::FromRepresentation(
+      Nexus::Details::ToRepresentation(ReadDouble(m_cursor, m_end)));
+  }
+
+  inline std::string_view ColumnReader::ReadString() {
+    auto id = ReadVarint(m_cursor, m_end);
+    if(id >= m_dictionary.size()) {
+      BOOST_THROW_EXCEPTION(HistoricalDataStoreException("Corrupt column."));
+    }
+    return m_dictionary[static_cast<std::size_t>(id)];
+  }
+
+  /** Returns a string safe to use as a single path component. */
+  inline std::string ToPathComponent(std::string_view value) {
+    constexpr auto DIGITS = "0123456789ABCDEF";
+    auto component = std::string();
+    for(auto c : value) {
+      if(std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_') {
+        component.push_back(c);
+      } else {
+        component.push_back('%');
+        component.push_back(DIGITS[static_cast<unsigned char>(c) >> 4]);
+        component.push_back(DIGITS[static_cast<unsigned char>(c) & 0xF]);
+      }
+    }
+    return component;
+  }
+
+  /**
+   * Returns the path component for a Security, the market is left out to
+   * match Security's equality, same as the SQL store's index.
+   */
+  inline std::string ToPathComponent(const Security& security) {
+    return ToPathComponent(security.GetSymbol()) + "." +
+      std::to_string(static_cast<std::uint16_t>(security.GetCountry()));
+  }
+
+  inline std::string ToPathComponent(MarketCode market) {
+    return ToPathComponent(market.GetData());
+  }
+
+  /** Tests whether any row of a block can fall within a Range. */
+  inline bool Overlaps(const ColumnarBlockHeader& header,
+      const Beam::Queries::Range& range) {
+    const auto& start = range.GetStart();
+    const auto& end = range.GetEnd();
+    if(auto startSequence = boost::get<Beam::Queries::Sequence>(&start)) {
+      if(header.m_lastSequence < startSequence->GetOrdinal()) {
+        return false;
+      }
+    } else if(header.m_maxTimestamp < ToColumnTimestamp(
+        boost::get<boost::posix_time::ptime>(start))) {
+      return false;
+    }
+    if(auto endSequence = boost::get<Beam::Queries::Sequence>(&end)) {
+      if(header.m_firstSequence > endSequence->GetOrdinal()) {
+        return false;
+      }
+    } else if(header.m_minTimestamp > ToColumnTimestamp(
+        boost::get<boost::posix_time::ptime>(end))) {
+      return false;
+    }
+    return true;
+  }
+}
+
+  /**
+   * Stores historical market data in per-index, per-day column files. Each
+   * file is a sequence of blocks whose columns are delta and varint encoded,
+   * the block headers form a sparse index on sequence and timestamp and
+   * queries decode the blocks they touch directly out of a memory mapping.
+   * Rows are buffered per index until a full block is available, every
+   * buffer is written out early once the total number of buffered rows
+   * reaches a limit or the flush interval elapses.
+   */
+  class ColumnarHistoricalDataStore {
+    public:
+
+      /** The default number of rows written per block. */
+      static constexpr auto DEFAULT_BLOCK_SIZE = 4096;
+
+      /** The default number of rows buffered across all indices. */
+      static constexpr auto DEFAULT_PENDING_LIMIT = 262144;
+
+      /** Returns the default interval between writes of partial blocks. */
+      static boost::posix_time::time_duration GetDefaultFlushInterval();
+
+      /**
+       * Constructs a ColumnarHistoricalDataStore.
+       * @param root The directory to store the column files in.
+       */
+      explicit ColumnarHistoricalDataStore(std::filesystem::path root);
+
+      /**
+       * Constructs a ColumnarHistoricalDataStore.
+       * @param root The directory to store the column files in.
+       * @param blockSize The number of rows buffered before a block is
+       *        written.
+       */
+      ColumnarHistoricalDataStore(std::filesystem::path root, int blockSize);
+
+      /**
+       * Constructs a ColumnarHistoricalDataStore.
+       * @param root The directory to store the column files in.
+       * @param blockSize The number of rows buffered before a block is
+       *        written.
+       * @param pendingLimit The number of rows buffered across all indices
+       *        before every buffer is written.
+       * @param flushInterval The maximum amount of time a row is buffered
+       *        for while rows continue to be stored.
+       */
+      ColumnarHistoricalDataStore(std::filesystem::path root, int blockSize,
+        int pendingLimit, boost::posix_time::time_duration flushInterval);
+
+      ~ColumnarHistoricalDataStore();
+
+      std::vector<SecurityInfo> LoadSecurityInfo(
+        const SecurityInfoQuery& query);
+
+      std::vector<SequencedOrderImbalance> LoadOrderImbalances(
+        const MarketWideDataQuery& query);
+
+      std::vector<SequencedBboQuote> LoadBboQuotes(
+        const SecurityMarketDataQuery& query);
+
+      std::vector<SequencedBookQuote> LoadBookQuotes(
+        const SecurityMarketDataQuery& query);
+
+      std::vector<SequencedMarketQuote> LoadMarketQuotes(
+        const SecurityMarketDataQuery& query);
+
+      std::vector<SequencedTimeAndSale> LoadTimeAndSales(
+        const SecurityMarketDataQuery& query);
+
+      void Store(const SecurityInfo& info);
+
+      void Store(const SequencedMarketOrderImbalance& orderImbalance);
+
+      void Store(const std::vector<SequencedMarketOrderImbalance>&
+        orderImbalances);
+
+      void Store(const SequencedSecurityBboQuote& bboQuote);
+
+      void Store(const std::vector<SequencedSecurityBboQuote>& bboQuotes);
+
+      void Store(const SequencedSecurityMarketQuote& marketQuote);
+
+      void Store(const std::vector<SequencedSecurityMarketQuote>& marketQuotes);
+
+      void Store(const SequencedSecurityBookQuote& bookQuote);
+
+      void Store(const std::vector<SequencedSecurityBookQuote>& bookQuotes);
+
+      void Store(const SequencedSecurityTimeAndSale& timeAndSale);
+
+      void Store(const std::vector<SequencedSecurityTimeAndSale>& timeAndSales);
+
+      /** Writes all buffered rows and SecurityInfo to disk. */
+      void Flush();
+
+      void Close();
+
+    private:
+      template<typename T, typename I>
+      using Partitions = Beam::SynchronizedUnorderedMap<I,
+        std::shared_ptr<Details::ColumnarPartition<T>>>;
+      std::filesystem::path m_root;
+      int m_blockSize;
+      int m_pendingLimit;
+      boost::posix_time::time_duration m_flushInterval;
+      std::atomic_int m_pendingCount;
+      std::mutex m_flushMutex;
+      boost::posix_time::ptime m_lastFlush;
+      std::mutex m_securityInfoMutex;
+      std::vector<SecurityInfo> m_persistedSecurityInfo;
+      bool m_isSecurityInfoDirty;
+      LocalHistoricalDataStore m_securityInfo;
+      Partitions<OrderImbalance, MarketCode> m_orderImbalances;
+      Partitions<BboQuote, Security> m_bboQuotes;
+      Partitions<MarketQuote, Security> m_marketQuotes;
+      Partitions<BookQuote, Security> m_bookQuotes;
+      Partitions<TimeAndSale, Security> m_timeAndSales;
+      Beam::IO::OpenState m_openState;
+
+      ColumnarHistoricalDataStore(const ColumnarHistoricalDataStore&) = delete;
+      ColumnarHistoricalDataStore& operator =(
+        const ColumnarHistoricalDataStore&) = delete;
+      std::filesystem::path GetSecurityInfoPath() const;
+      void LoadSecurityInfo();
+      void PersistSecurityInfo();
+      template<typename T, typename I>
+      Details::ColumnarPartition<T>& GetPartition(Partitions<T, I>& partitions,
+        const char* category, const I& index);
+      template<typename T>
+      void Index(Details::ColumnarPartition<T>& partition);
+      template<typename T>
+      void Write(Details::ColumnarPartition<T>& partition, bool flushAll);
+      template<typename T>
+      void Decode(const char* payload, const Details::ColumnarBlock& block,
+        std::vector<Beam::Queries::SequencedValue<T>>& rows);
+      template<typename T, typename I, typename Query>
+      std::vector<Beam::Queries::SequencedValue<T>> Load(
+        Partitions<T, I>& partitions, const char* category,
+        const Query& query);
+      template<typename T, typename I, typename Iterator>
+      void Store(Partitions<T, I>& partitions, const char* category,
+        Iterator begin, Iterator end);
+      template<typename T, typename I>
+      void Flush(Partitions<T, I>& partitions);
+      void FlushIfDue();
+  };
+
+  inline boost::posix_time::time_duration
+      ColumnarHistoricalDataStore::GetDefaultFlushInterval() {
+    return boost::posix_time::seconds(5);
+  }
+
+  inline ColumnarHistoricalDataStore::ColumnarHistoricalDataStore(
+    std::filesystem::path root)
+    : ColumnarHistoricalDataStore(std::move(root), DEFAULT_BLOCK_SIZE) {}
+
+  inline ColumnarHistoricalDataStore::ColumnarHistoricalDataStore(
+    std::filesystem::path root, int blockSize)
+    : ColumnarHistoricalDataStore(std::move(root), blockSize,
+        DEFAULT_PENDING_LIMIT, GetDefaultFlushInterval()) {}
+
+  inline ColumnarHistoricalDataStore::ColumnarHistoricalDataStore(
+      std::filesystem::path root, int blockSize, int pendingLimit,
+      boost::posix_time::time_duration flushInterval)
+      : m_root(std::move(root)),
+        m_blockSize(std::max(1, blockSize)),
+        m_pendingLimit(std::max(1, pendingLimit)),
+        m_flushInterval(flushInterval),
+        m_pendingCount(0),
+        m_lastFlush(boost::posix_time::microsec_clock::universal_time()),
+        m_isSecurityInfoDirty(false) {
+    try {
+      std::filesystem::create_directories(m_root);
+      LoadSecurityInfo();
+    } catch(const std::exception&) {
+      Close();
+      BOOST_RETHROW;
+    }
+  }
+
+  inline ColumnarHistoricalDataStore::~ColumnarHistoricalDataStore() {
+    Close();
+  }
+
+  inline std::vector<SecurityInfo> ColumnarHistoricalDataStore::
+      LoadSecurityInfo(const SecurityInfoQuery& query) {
+    return m_securityInfo.LoadSecurityInfo(query);
+  }
+
+  inline std::vector<SequencedOrderImbalance> ColumnarHistoricalDataStore::
+      LoadOrderImbalances(const MarketWideDataQuery& query) {
+    return Load(m_orderImbalances, "order_imbalances", query);
+  }
+
+  inline std::vector<SequencedBboQuote> ColumnarHistoricalDataStore::
+      LoadBboQuotes(const SecurityMarketDataQuery& query) {
+    return Load(m_bboQuotes, "bbo_quotes", query);
+  }
+
+  inline std::vector<SequencedBookQuote> ColumnarHistoricalDataStore::
+      LoadBookQuotes(const SecurityMarketDataQuery& query) {
+    return Load(m_bookQuotes, "book_quotes", query);
+  }
+
+  inline std::vector<SequencedMarketQuote> ColumnarHistoricalDataStore::
+      LoadMarketQuotes(const SecurityMarketDataQuery& query) {
+    return Load(m_marketQuotes, "market_quotes", query);
+  }
+
+  inline std::vector<SequencedTimeAndSale> ColumnarHistoricalDataStore::
+      LoadTimeAndSales(const SecurityMarketDataQuery& query) {
+    return Load(m_timeAndSales, "time_and_sales", query);
+  }
+
+  inline void ColumnarHistoricalDataStore::Store(const SecurityInfo& info) {
+    auto lock = std::lock_guard(m_securityInfoMutex);
+    m_securityInfo.Store(info);
+    auto i = std::lower_bound(m_persistedSecurityInfo.begin(),
+      m_persistedSecurityInfo.end(), info,
+      [] (const auto& left, const auto& right) {
+        return left.m_security < right.m_security;
+      });
+    if(i == m_persistedSecurityInfo.end() || i->m_security != info.m_security) {
+      m_persistedSecurityInfo.insert(i, info);
+    } else {
+      *i = info;
+    }
+    m_isSecurityInfoDirty = true;
+  }
+
+  inline void ColumnarHistoricalDataStore::Store(
+      const SequencedMarketOrderImbalance& orderImbalance) {
+    Store(m_orderImbalances, "order_imbalances", &orderImbalance,
+      &orderImbalance + 1);
+  }
+
+  inline void ColumnarHistoricalDataStore::Store(
+      const std::vector<SequencedMarketOrderImbalance>& orderImbalances) {
+    Store(m_orderImbalances, "order_imbalances", orderImbalances.begin(),
+      orderImbalances.end());
+  }
+
+  inline void ColumnarHistoricalDataStore::Store(
+      const SequencedSecurityBboQuote& bboQuote) {
+    Store(m_bboQuotes, "bbo_quotes", &bboQuote, &bboQuote + 1);
+  }
+
+  inline void ColumnarHistoricalDataStore::Store(
+      const std::vector<SequencedSecurityBboQuote>& bboQuotes) {
+    Store(m_bboQuotes, "bbo_quotes", bboQuotes.begin(), bboQuotes.end());
+  }
+
+  inline void ColumnarHistoricalDataStore::Store(
+      const SequencedSecurityMarketQuote& marketQuote) {
+    Store(m_marketQuotes, "market_quotes", &marketQuote, &marketQuote + 1);
+  }
+
+  inline void ColumnarHistoricalDataStore::Store(
+      const std::vector<SequencedSecurityMarketQuote>& marketQuotes) {
+    Store(m_marketQuotes, "market_quotes", marketQuotes.begin(),
+      marketQuotes.end());
+  }
+
+  inline void ColumnarHistoricalDataStore::Store(
+      const SequencedSecurityBookQuote& bookQuote) {
+    Store(m_bookQuotes, "book_quotes", &bookQuote, &bookQuote + 1);
+  }
+
+  inline void ColumnarHistoricalDataStore::Store(
+      const std::vector<SequencedSecurityBookQuote>& bookQuotes) {
+    Store(m_bookQuotes, "book_quotes", bookQuotes.begin(), bookQuotes.end());
+  }
+
+  inline void ColumnarHistoricalDataStore::Store(
+      const SequencedSecurityTimeAndSale& timeAndSale) {
+    Store(m_timeAndSales, "time_and_sales", &timeAndSale, &timeAndSale + 1);
+  }
+
+  inline void ColumnarHistoricalDataStore::Store(
+      const std::vector<SequencedSecurityTimeAndSale>& timeAndSales) {
+    Store(m_timeAndSales, "time_and_sales", timeAndSales.begin(),
+      timeAndSales.end());
+  }
+
+  inline void ColumnarHistoricalDataStore::Flush() {
+    auto lock = std::lock_guard(m_flushMutex);
+    m_lastFlush = boost::posix_time::microsec_clock::universal_time();
+    Flush(m_orderImbalances);
+    Flush(m_bboQuotes);
+    Flush(m_marketQuotes);
+    Flush(m_bookQuotes);
+    Flush(m_timeAndSales);
+    auto securityInfoLock = std::lock_guard(m_securityInfoMutex);
+    if(m_isSecurityInfoDirty) {
+      PersistSecurityInfo();
+      m_isSecurityInfoDirty = false;
+    }
+  }
+
+  inline void ColumnarHistoricalDataStore::Close() {
+    if(m_openState.SetClosing()) {
+      return;
+    }
+    try {
+      Flush();
+    } catch(const std::exception&) {
+      m_openState.Close();
+      BOOST_RETHROW;
+    }
+    m_openState.Close();
+  }
+
+  inline std::filesystem::path ColumnarHistoricalDataStore::
+      GetSecurityInfoPath() const {
+    return m_root / "security_info.dat";
+  }
+
+  inline void ColumnarHistoricalDataStore::LoadSecurityInfo() {
+    auto file = std::ifstream(GetSecurityInfoPath(), std::ios::binary);
+    if(!file) {
+      return;
+    }
+    auto contents = std::string((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+    auto buffer = Beam::IO::SharedBuffer();
+    buffer.Append(contents.data(), contents.size());
+    auto securityInfo = std::vector<SecurityInfo>();
+    auto receiver = Beam::Serialization::BinaryReceiver<
+      Beam::IO::SharedBuffer>();
+    receiver.SetSource(Beam::Ref(buffer));
+    try {
+      receiver.Shuttle(securityInfo);
+    } catch(const Beam::Serialization::SerializationException&) {
+      BOOST_THROW_EXCEPTION(HistoricalDataStoreException(
+        "Unable to load security info."));
+    }
+    for(auto& info : securityInfo) {
+      m_securityInfo.Store(info);
+    }
+    m_persistedSecurityInfo = std::move(securityInfo);
+  }
+
+  inline void ColumnarHistoricalDataStore::PersistSecurityInfo() {
+    auto buffer = Beam::IO::SharedBuffer();
+    auto sender = Beam::Serialization::BinarySender<Beam::IO::SharedBuffer>();
+    sender.SetSink(Beam::Ref(buffer));
+    try {
+      sender.Shuttle(m_persistedSecurityInfo);
+    } catch(const Beam::Serialization::SerializationException&) {
+      BOOST_THROW_EXCEPTION(HistoricalDataStoreException(
+        "Unable to store security info."));
+    }
+    auto path = GetSecurityInfoPath();
+    auto staging = path;
+    staging += ".tmp";
+    {
+      auto file = std::ofstream(staging, std::ios::binary | std::ios::trunc);
+      file.write(buffer.GetData(), buffer.GetSize());
+      if(!file) {
+        BOOST_THROW_EXCEPTION(HistoricalDataStoreException(
+          "Unable to store security info."));
+      }
+    }
+    std::filesystem::rename(staging, path);
+  }
+
+  template<typename T, typename I>
+  Details::ColumnarPartition<T>& ColumnarHistoricalDataStore::GetPartition(
+      Partitions<T, I>& partitions, const char* category, const I& index) {
+    return *partitions.GetOrInsert(index, [&] {
+      return std::make_shared<Details::ColumnarPartition<T>>(
+        m_root / category / Details::ToPathComponent(index));
+    });
+  }
+
+  template<typename T>
+  void ColumnarHistoricalDataStore::Index(
+      Details::ColumnarPartition<T>& partition) {
+    if(partition.m_isLoaded) {
+      return;
+    }
+    partition.m_isLoaded = true;
+    auto error = std::error_code();
+    if(!std::filesystem::is_directory(partition.m_directory, error)) {
+      return;
+    }
+    for(auto& entry :
+        std::filesystem::directory_iterator(partition.m_directory)) {
+      if(!entry.is_regular_file() || entry.path().extension() != ".col") {
+        continue;
+      }
+      auto file = Details::ColumnarFile();
+      file.m_day = entry.path().stem().string();
+      file.m_path = entry.path();
+      file.m_size = 0;
+      auto size = static_cast<std::uint64_t>(entry.file_size());
+      auto stream = std::ifstream(file.m_path, std::ios::binary);
+      auto block = Details::ColumnarBlock();
+      while(file.m_size + sizeof(block.m_header) <= size) {
+        stream.seekg(static_cast<std::streamoff>(file.m_size));
+        if(!stream.read(reinterpret_cast<char*>(&block.m_header),
+            sizeof(block.m_header)) ||
+            block.m_header.m_magic != Details::COLUMNAR_BLOCK_MAGIC) {
+          break;
+        }
+        block.m_offset = file.m_size + sizeof(block.m_header);
+        if(block.m_offset + block.m_header.m_payloadSize > size) {
+          break;
+        }
+        file.m_blocks.push_back(block);
+        file.m_size = block.m_offset + block.m_header.m_payloadSize;
+        partition.m_lastSequence = std::max(
+          partition.m_lastSequence.get_value_or(0),
+          block.m_header.m_lastSequence);
+      }
+      stream.close();
+      if(file.m_size != size) {
+
+        /** Drop a block left partially written by an interrupted store. */
+        std::filesystem::resize_file(file.m_path, file.m_size);
+      }
+      partition.m_files.push_back(std::move(file));
+    }
+    std::sort(partition.m_files.begin(), partition.m_files.end(),
+      [] (const auto& left, const auto& right) {
+        return left.m_day < right.m_day;
+      });
+  }
+
+  template<typename T>
+  void ColumnarHistoricalDataStore::Write(
+      Details::ColumnarPartition<T>& partition, bool flushAll) {
+    auto& pending = partition.m_pending;
+    auto begin = pending.begin();
+    while(begin != pending.end()) {
+      auto day = [&] (const auto& value) {
+        auto& timestamp = value.GetValue().m_timestamp;
+        if(timestamp.is_special()) {
+          return std::string("00000000");
+        }
+        return boost::gregorian::to_iso_string(timestamp.date());
+      };
+      auto blockDay = day(*begin);
+      auto end = begin;
+      while(end != pending.end() && end - begin < m_blockSize &&
+          day(*end) == blockDay) {
+        ++end;
+      }
+      if(end == pending.end() && end - begin < m_blockSize && !flushAll) {
+        break;
+      }
+      auto header = Details::ColumnarBlockHeader();
+      header.m_magic = Details::COLUMNAR_BLOCK_MAGIC;
+      header.m_count = static_cast<std::uint32_t>(end - begin);
+      header.m_columnCount = Details::COLUMNAR_HEADER_COLUMNS +
+        Details::ColumnarCodec<T>::COLUMNS;
+      header.m_firstSequence = begin->GetSequence().GetOrdinal();
+      header.m_lastSequence = (end - 1)->GetSequence().GetOrdinal();
+      header.m_minTimestamp = std::numeric_limits<std::int64_t>::max();
+      header.m_maxTimestamp = std::numeric_limits<std::int64_t>::min();
+      auto columns = std::vector<Details::ColumnWriter>(header.m_columnCount);
+      for(auto i = begin; i != end; ++i) {
+        auto timestamp = Details::ToColumnTimestamp(
+          i->GetValue().m_timestamp);
+        header.m_minTimestamp = std::min(header.m_minTimestamp, timestamp);
+        header.m_maxTimestamp = std::max(header.m_maxTimestamp, timestamp);
+        columns[0].Append(static_cast<std::int64_t>(
+          i->GetSequence().GetOrdinal()));
+        columns[1].Append(timestamp);
+        Details::ColumnarCodec<T>::Encode(i->GetValue(),
+          columns.data() + Details::COLUMNAR_HEADER_COLUMNS);
+      }
+      auto payload = std::string();
+      for(auto& column : columns) {
+        column.Serialize(payload);
+      }
+      header.m_payloadSize = static_cast<std::uint32_t>(payload.size());
+      auto file = std::find_if(partition.m_files.begin(),
+        partition.m_files.end(), [&] (const auto& file) {
+          return file.m_day >= blockDay;
+        });
+      if(file == partition.m_files.end() || file->m_day != blockDay) {
+        auto entry = Details::ColumnarFile();
+        entry.m_day = blockDay;
+        entry.m_path = partition.m_directory / (blockDay + ".col");
+        entry.m_size = 0;
+        file = partition.m_files.insert(file, std::move(entry));
+        std::filesystem::create_directories(partition.m_directory);
+      }
+      auto stream = std::ofstream(file->m_path,
+        std::ios::binary | std::ios::app);
+      stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      stream.write(payload.data(), payload.size());
+      stream.flush();
+      if(!stream) {
+        BOOST_THROW_EXCEPTION(HistoricalDataStoreException(
+          "Unable to write column file: " + file->m_path.string()));
+      }
+      auto block = Details::ColumnarBlock();
+      block.m_header = header;
+      block.m_offset = file->m_size + sizeof(header);
+      file->m_blocks.push_back(block);
+      file->m_size = block.m_offset + header.m_payloadSize;
+      partition.m_lastSequence = header.m_lastSequence;
+      begin = end;
+    }
+    m_pendingCount -= static_cast<int>(begin - pending.begin());
+    pending.erase(pending.begin(), begin);
+  }
+
+  template<typename T>
+  void ColumnarHistoricalDataStore::Decode(const char* payload,
+      const Details::ColumnarBlock& block,
+      std::vector<Beam::Queries::SequencedValue<T>>& rows) {
+    auto& header = block.m_header;
+    if(header.m_columnCount != Details::COLUMNAR_HEADER_COLUMNS +
+        Details::ColumnarCodec<T>::COLUMNS) {
+      BOOST_THROW_EXCEPTION(HistoricalDataStoreException("Corrupt block."));
+    }
+    auto cursor = payload;
+    auto end = payload + header.m_payloadSize;
+    auto columns = std::vector<Details::ColumnReader>();
+    columns.reserve(header.m_columnCount);
+    for(auto i = std::uint32_t(0); i != header.m_columnCount; ++i) {
+      auto size = Details::ReadVarint(cursor, end);
+      if(size > static_cast<std::uint64_t>(end - cursor)) {
+        BOOST_THROW_EXCEPTION(HistoricalDataStoreException("Corrupt block."));
+      }
+      columns.emplace_back(cursor, cursor + size);
+      cursor += size;
+    }
+    rows.reserve(rows.size() + header.m_count);
+    for(auto i = std::uint32_t(0); i != header.m_count; ++i) {
+      auto sequence = Beam::Queries::Sequence(
+        static_cast<std::uint64_t>(columns[0].ReadInteger()));
+      auto timestamp = Details::FromColumnTimestamp(columns[1].ReadInteger());
+      auto value = Details::ColumnarCodec<T>::Decode(
+        columns.data() + Details::COLUMNAR_HEADER_COLUMNS);
+      value.m_timestamp = timestamp;
+      rows.emplace_back(std::move(value), sequence);
+    }
+  }
+
+  template<typename T, typename I, typename Query>
+  std::vector<Beam::Queries::SequencedValue<T>>
+      ColumnarHistoricalDataStore::Load(Partitions<T, I>& partitions,
+        const char* category, const Query& query) {
+    auto evaluator = Beam::Queries::Translate<Queries::EvaluatorTranslator>(
+      query.GetFilter());
+    const auto& range = query.GetRange();
+    const auto& limit = query.GetSnapshotLimit();
+    auto isHead = limit.GetType() == Beam::Queries::SnapshotLimit::Type::HEAD;
+    auto matches = std::vector<Beam::Queries::SequencedValue<T>>();
+    if(limit.GetSize() <= 0) {
+      return matches;
+    }
+    auto& partition = GetPartition(partitions, category, query.GetIndex());
+    auto lock = std::lock_guard(partition.m_mutex);
+    Index(partition);
+    auto candidates = std::vector<std::pair<const Details::ColumnarFile*,
+      const Details::ColumnarBlock*>>();
+    for(auto& file : partition.m_files) {
+      for(auto& block : file.m_blocks) {
+        if(Details::Overlaps(block.m_header, range)) {
+          candidates.emplace_back(&file, &block);
+        }
+      }
+    }
+    auto test = [&] (const Beam::Queries::SequencedValue<T>& value) {
+      auto& timestamp = value.GetValue().m_timestamp;
+      return Details::IsAfterStart(range.GetStart(), value.GetSequence(),
+        timestamp) && Details::IsBeforeEnd(range.GetEnd(),
+        value.GetSequence(), timestamp) &&
+        Beam::Queries::TestFilter(*evaluator, value.GetValue());
+    };
+    auto isFull = [&] {
+      return static_cast<int>(matches.size()) >= limit.GetSize();
+    };
+    auto collect = [&] (auto begin, auto end) {
+      for(auto i = begin; i != end && !isFull(); ++i) {
+        if(test(*i)) {
+          matches.push_back(*i);
+        }
+      }
+    };
+    auto mappedFile = static_cast<const Details::ColumnarFile*>(nullptr);
+    auto region = boost::interprocess::mapped_region();
+    auto rows = std::vector<Beam::Queries::SequencedValue<T>>();
+    auto decode = [&] (const Details::ColumnarFile& file,
+        const Details::ColumnarBlock& block) {
+      if(mappedFile != &file) {
+        auto mapping = boost::interprocess::file_mapping(
+          file.m_path.string().c_str(), boost::interprocess::read_only);
+        region = boost::interprocess::mapped_region(mapping,
+          boost::interprocess::read_only, 0,
+          static_cast<std::size_t>(file.m_size));
+        mappedFile = &file;
+      }
+      rows.clear();
+      Decode(static_cast<const char*>(region.get_address()) + block.m_offset,
+        block, rows);
+    };
+    if(isHead) {
+      for(auto& candidate : candidates) {
+        decode(*candidate.first, *candidate.second);
+        collect(std::make_move_iterator(rows.begin()),
+          std::make_move_iterator(rows.end()));
+        if(isFull()) {
+          return matches;
+        }
+      }
+      collect(partition.m_pending.begin(), partition.m_pending.end());
+    } else {
+      collect(partition.m_pending.rbegin(), partition.m_pending.rend());
+      for(auto i = candidates.rbegin(); i != candidates.rend() && !isFull();
+          ++i) {
+        decode(*i->first, *i->second);
+        collect(std::make_move_iterator(rows.rbegin()),
+          std::make_move_iterator(rows.rend()));
+      }
+      std::reverse(matches.begin(), matches.end());
+    }
+    return matches;
+  }
+
+  template<typename T, typename I, typename Iterator>
+  void ColumnarHistoricalDataStore::Store(Partitions<T, I>& partitions,
+      const char* category, Iterator begin, Iterator end) {
+    while(begin != end) {
+      auto& index = begin->GetValue().GetIndex();
+      auto& partition = GetPartition(partitions, category, index);
+      auto lock = std::lock_guard(partition.m_mutex);
+      Index(partition);
+      auto& pending = partition.m_pending;
+      auto initialSize = pending.size();
+      while(begin != end && begin->GetValue().GetIndex() == index) {
+        auto sequence = begin->GetSequence();
+        if(partition.m_lastSequence &&
+            sequence.GetOrdinal() <= *partition.m_lastSequence) {
+
+          /** Rows already written to a block are immutable, drop replays. */
+          ++begin;
+          continue;
+        }
+        if(pending.empty() || pending.back().GetSequence() < sequence) {
+          pending.emplace_back(begin->GetValue().GetValue(), sequence);
+        } else {
+          auto i = std::lower_bound(pending.begin(), pending.end(), sequence,
+            [] (const auto& value, const auto& sequence) {
+              return value.GetSequence() < sequence;
+            });
+          if(i->GetSequence() == sequence) {
+            *i = Beam::Queries::SequencedValue<T>(begin->GetValue().GetValue(),
+              sequence);
+          } else {
+            pending.emplace(i, begin->GetValue().GetValue(), sequence);
+          }
+        }
+        ++begin;
+      }
+      m_pendingCount += static_cast<int>(pending.size() - initialSize);
+      if(static_cast<int>(pending.size()) >= m_blockSize) {
+        Write(partition, false);
+      }
+    }
+    FlushIfDue();
+  }
+
+  template<typename T, typename I>
+  void ColumnarHistoricalDataStore::Flush(Partitions<T, I>& partitions) {
+    auto snapshot = std::vector<std::shared_ptr<
+      Details::ColumnarPartition<T>>>();
+    partitions.With([&] (auto& partitions) {
+      for(auto& partition : partitions) {
+        snapshot.push_back(partition.second);
+      }
+    });
+    for(auto& partition : snapshot) {
+      auto lock = std::lock_guard(partition->m_mutex);
+      Write(*partition, true);
+    }
+  }
+
+  inline void ColumnarHistoricalDataStore::FlushIfDue() {
+    if(m_pendingCount == 0) {
+      return;
+    }
+    auto lock = std::unique_lock(m_flushMutex, std::try_to_lock);
+    if(!lock.owns_lock()) {
+      return;
+    }
+    auto now = boost::posix_time::microsec_clock::universal_time();
+    if(m_pendingCount < m_pendingLimit && now - m_lastFlush < m_flushInterval) {
+      return;
+    }
+    lock.unlock();
+    Flush();
+  }
+}
+
+#endif
@@ -0,0 +1,251 @@
+#ifndef NEXUS_MARKET_DATA_CONFLATION_QUEUE_HPP
+#define NEXUS_MARKET_DATA_CONFLATION_QUEUE_HPP
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <boost/optional/optional.hpp>
+#include <boost/variant/variant.hpp>
+#include "Nexus/Definitions/BboQuote.hpp"
+#include "Nexus/Definitions/BookQuote.hpp"
+#include "Nexus/Definitions/Security.hpp"
+#include "Nexus/MarketDataService/MarketDataService.hpp"
+
+namespace Nexus::MarketDataService {
+
+  /**
+   * Buffers the BboQuotes and BookQuotes pending delivery to a single client.
+   * Once the number of pending updates reaches a threshold, a newly pushed
+   * BboQuote replaces the pending BboQuote for the same Security and a newly
+   * pushed BookQuote replaces the pending BookQuote for the same Security,
+   * MPID and price level. Replaced updates are moved to the back of the queue
+   * so that each Security's updates are always popped in Sequence order.
+   */
+  class ConflationQueue {
+    public:
+
+      /** The type of update stored. */
+      using Update =
+        boost::variant<SequencedSecurityBboQuote, SequencedSecurityBookQuote>;
+
+      /**
+       * Constructs an empty ConflationQueue.
+       * @param threshold The number of pending updates at which conflation
+       *        begins.
+       */
+      explicit ConflationQueue(std::size_t threshold);
+
+      /** Returns the number of pending updates. */
+      std::size_t GetSize() const;
+
+      /**
+       * Returns <code>true</code> iff updates have been conflated since the
+       * queue last drained below half of its threshold.
+       */
+      bool IsConflating() const;
+
+      /**
+       * Pushes a BboQuote.
+       * @param bboQuote The BboQuote to push.
+       */
+      void Push(const SequencedSecurityBboQuote& bboQuote);
+
+      /**
+       * Pushes a BookQuote.
+       * @param bookQuote The BookQuote to push.
+       */
+      void Push(const SequencedSecurityBookQuote& bookQuote);
+
+      /**
+       * Pops the oldest pending update.
+       * @return The oldest pending update or <code>boost::none</code> if the
+       *         queue is empty.
+       */
+      boost::optional<Update> Pop();
+
+      /**
+       * Removes the pending BboQuotes for a Security.
+       * @param security The Security whose BboQuotes are removed.
+       * @return The removed BboQuotes in the order they were pending.
+       */
+      std::vector<SequencedSecurityBboQuote> RemoveBboQuotes(
+        const Security& security);
+
+      /**
+       * Removes the pending BookQuotes for a Security.
+       * @param security The Security whose BookQuotes are removed.
+       * @return The removed BookQuotes in the order they were pending.
+       */
+      std::vector<SequencedSecurityBookQuote> RemoveBookQuotes(
+        const Security& security);
+
+    private:
+      using BookQuoteKey = std::tuple<Security, std::string, int, Money>;
+      std::size_t m_threshold;
+      std::deque<boost::optional<Update>> m_updates;
+      std::uint64_t m_head;
+      std::size_t m_size;
+      bool m_isConflating;
+      std::unordered_map<Security, std::uint64_t> m_bboQuotes;
+      std::map<BookQuoteKey, std::uint64_t> m_bookQuotes;
+
+      static BookQuoteKey GetKey(const SequencedSecurityBookQuote& bookQuote);
+      template<typename K, typename Index, typename T>
+      void Push(K&& key, Index& index, const T& value);
+      template<typename T>
+      std::vector<T> Remove(const Security& security);
+      void Compact();
+  };
+
+  inline ConflationQueue::ConflationQueue(std::size_t threshold)
+    : m_threshold(std::max<std::size_t>(1, threshold)),
+      m_head(0),
+      m_size(0),
+      m_isConflating(false) {}
+
+  inline std::size_t ConflationQueue::GetSize() const {
+    return m_size;
+  }
+
+  inline bool ConflationQueue::IsConflating() const {
+    return m_isConflating;
+  }
+
+  inline void ConflationQueue::Push(
+      const SequencedSecurityBboQuote& bboQuote) {
+    Push(bboQuote->GetIndex(), m_bboQuotes, bboQuote);
+  }
+
+  inline void ConflationQueue::Push(
+      const SequencedSecurityBookQuote& bookQuote) {
+    Push(GetKey(bookQuote), m_bookQuotes, bookQuote);
+  }
+
+  inline boost::optional<ConflationQueue::Update> ConflationQueue::Pop() {
+    while(!m_updates.empty()) {
+      auto update = std::move(m_updates.front());
+      m_updates.pop_front();
+      auto position = m_head;
+      ++m_head;
+      if(!update) {
+        continue;
+      }
+      --m_size;
+      if(auto bboQuote = boost::get<SequencedSecurityBboQuote>(&*update)) {
+        auto entry = m_bboQuotes.find((*bboQuote)->GetIndex());
+        if(entry != m_bboQuotes.end() && entry->second == position) {
+          m_bboQuotes.erase(entry);
+        }
+      } else {
+        auto entry = m_bookQuotes.find(
+          GetKey(boost::get<SequencedSecurityBookQuote>(*update)));
+        if(entry != m_bookQuotes.end() && entry->second == position) {
+          m_bookQuotes.erase(entry);
+        }
+      }
+      if(m_size <= m_threshold / 2) {
+        m_isConflating = false;
+      }
+      return update;
+    }
+    return boost::none;
+  }
+
+  inline std::vector<SequencedSecurityBboQuote>
+      ConflationQueue::RemoveBboQuotes(const Security& security) {
+    return Remove<SequencedSecurityBboQuote>(security);
+  }
+
+  inline std::vector<SequencedSecurityBookQuote>
+      ConflationQueue::RemoveBookQuotes(const Security& security) {
+    return Remove<SequencedSecurityBookQuote>(security);
+  }
+
+  inline ConflationQueue::BookQuoteKey ConflationQueue::GetKey(
+      const SequencedSecurityBookQuote& bookQuote) {
+    auto& quote = bookQuote->GetValue();
+    return BookQuoteKey(bookQuote->GetIndex(), quote.m_mpid,
+      static_cast<int>(quote.m_quote.m_side), quote.m_quote.m_price);
+  }
+
+  template<typename K, typename Index, typename T>
+  void ConflationQueue::Push(K&& key, Index& index, const T& value) {
+    auto position = m_head + m_updates.size();
+    if(m_size >= m_threshold) {
+      auto entry = index.find(key);
+      if(entry != index.end()) {
+        m_updates[entry->second - m_head] = boost::none;
+        entry->second = position;
+        m_updates.push_back(Update(value));
+        m_isConflating = true;
+        if(m_updates.size() > 2 * m_size + m_threshold) {
+          Compact();
+        }
+        return;
+      }
+    }
+    index[std::forward<K>(key)] = position;
+    m_updates.push_back(Update(value));
+    ++m_size;
+  }
+
+  template<typename T>
+  std::vector<T> ConflationQueue::Remove(const Security& security) {
+    auto removed = std::vector<T>();
+    for(auto& update : m_updates) {
+      if(!update) {
+        continue;
+      }
+      auto value = boost::get<T>(&*update);
+      if(!value || (*value)->GetIndex() != security) {
+        continue;
+      }
+      removed.push_back(std::move(*value));
+      update = boost::none;
+      --m_size;
+    }
+    if(removed.empty()) {
+      return removed;
+    }
+    if constexpr(std::is_same_v<T, SequencedSecurityBboQuote>) {
+      m_bboQuotes.erase(security);
+    } else {
+      for(auto i = m_bookQuotes.begin(); i != m_bookQuotes.end();) {
+        if(std::get<0>(i->first) == security) {
+          i = m_bookQuotes.erase(i);
+        } else {
+          ++i;
+        }
+      }
+    }
+    if(m_size <= m_threshold / 2) {
+      m_isConflating = false;
+    }
+    return removed;
+  }
+
+  inline void ConflationQueue::Compact() {
+    auto updates = std::deque<boost::optional<Update>>();
+    for(auto& update : m_updates) {
+      if(!update) {
+        continue;
+      }
+      auto position = m_head + updates.size();
+      if(auto bboQuote = boost::get<SequencedSecurityBboQuote>(&*update)) {
+        m_bboQuotes[(*bboQuote)->GetIndex()] = position;
+      } else {
+        m_bookQuotes[GetKey(boost::get<SequencedSecurityBookQuote>(
+          *update))] = position;
+      }
+      updates.push_back(std::move(update));
+    }
+    m_updates = std::move(updates);
+  }
+}
+
+#endif
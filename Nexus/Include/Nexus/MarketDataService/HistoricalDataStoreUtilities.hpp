@@ -1,11 +1,55 @@
 #ifndef NEXUS_MARKET_DATA_HISTORICAL_DATA_STORE_UTILITIES_HPP
 #define NEXUS_MARKET_DATA_HISTORICAL_DATA_STORE_UTILITIES_HPP
+#include <cstdint>
+#include <limits>
 #include <vector>
+#include <Beam/Queries/Range.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include "Nexus/MarketDataService/MarketDataService.hpp"
 #include "Nexus/MarketDataService/QueryTypes.hpp"
 
 namespace Nexus::MarketDataService {
 namespace Details {
+
+  /**
+   * Converts a timestamp to microseconds since the epoch, special timestamps
+   * map to the smallest integer.
+   */
+  inline std::int64_t ToColumnTimestamp(boost::posix_time::ptime timestamp) {
+    if(timestamp.is_special()) {
+      return std::numeric_limits<std::int64_t>::min();
+    }
+    return (timestamp - boost::posix_time::ptime(
+      boost::gregorian::date(1970, 1, 1))).total_microseconds();
+  }
+
+  /** Converts microseconds since the epoch back into a timestamp. */
+  inline boost::posix_time::ptime FromColumnTimestamp(std::int64_t timestamp) {
+    if(timestamp == std::numeric_limits<std::int64_t>::min()) {
+      return boost::posix_time::not_a_date_time;
+    }
+    return boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1)) +
+      boost::posix_time::microseconds(timestamp);
+  }
+
+  /** Tests whether a value falls on or after the start of a Range. */
+  inline bool IsAfterStart(const Beam::Queries::Range::Point& start,
+      Beam::Queries::Sequence sequence, boost::posix_time::ptime timestamp) {
+    if(auto startSequence = boost::get<Beam::Queries::Sequence>(&start)) {
+      return sequence >= *startSequence;
+    }
+    return timestamp >= boost::get<boost::posix_time::ptime>(start);
+  }
+
+  /** Tests whether a value falls on or before the end of a Range. */
+  inline bool IsBeforeEnd(const Beam::Queries::Range::Point& end,
+      Beam::Queries::Sequence sequence, boost::posix_time::ptime timestamp) {
+    if(auto endSequence = boost::get<Beam::Queries::Sequence>(&end)) {
+      return sequence <= *endSequence;
+    }
+    return timestamp <= boost::get<boost::posix_time::ptime>(end);
+  }
+
   template<typename T, typename D>
   struct HistoricalDataStoreLoader {};
 
@@ -1,6 +1,8 @@
 #ifndef NEXUS_MARKET_DATA_CLIENT_HPP
 #define NEXUS_MARKET_DATA_CLIENT_HPP
+#include <atomic>
 #include <vector>
+#include <Beam/Collections/SynchronizedSet.hpp>
 #include <Beam/IO/ConnectException.hpp>
 #include <Beam/IO/Connection.hpp>
 #include <Beam/IO/OpenState.hpp>
@@ -148,6 +150,28 @@ namespace Nexus::MarketDataService {
       std::vector<SecurityInfo> LoadSecurityInfoFromPrefix(
         const std::string& prefix);
 
+      /**
+       * Sets whether the server may conflate a Security's real-time BboQuotes
+       * while this client falls behind.
+       * @param security The Security whose BboQuotes are to be conflated.
+       * @param isConflated Whether the BboQuotes may be conflated.
+       */
+      void SetBboQuoteConflation(const Security& security, bool isConflated);
+
+      /**
+       * Sets whether the server may conflate a Security's real-time
+       * BookQuotes while this client falls behind.
+       * @param security The Security whose BookQuotes are to be conflated.
+       * @param isConflated Whether the BookQuotes may be conflated.
+       */
+      void SetBookQuoteConflation(const Security& security, bool isConflated);
+
+      /**
+       * Returns <code>true</code> iff the server is conflating the updates
+       * sent to this client.
+       */
+      bool IsConflated() const;
+
       void Close();
 
     private:
@@ -173,11 +197,19 @@ namespace Nexus::MarketDataService {
       QueryClientPublisher<TimeAndSale, SecurityMarketDataQuery,
         QueryTimeAndSalesService, EndTimeAndSaleQueryMessage>
         m_timeAndSalePublisher;
+      Beam::SynchronizedUnorderedSet<Security> m_conflatedBboQuotes;
+      Beam::SynchronizedUnorderedSet<Security> m_conflatedBookQuotes;
+      std::atomic_bool m_isConflated;
       Beam::IO::OpenState m_openState;
 
       MarketDataClient(const MarketDataClient&) = delete;
       MarketDataClient& operator =(const MarketDataClient&) = delete;
+      template<typename Message>
+      void SetConflation(const Security& security, bool isConflated,
+        Beam::SynchronizedUnorderedSet<Security>& securities);
       void OnReconnect(const std::shared_ptr<ServiceProtocolClient>& client);
+      void OnConflationMessage(ServiceProtocolClient& client,
+        bool isConflated);
   };
 
   template<typename B>
@@ -191,7 +223,8 @@ BEAM_SUPPRESS_THIS_INITIALIZER()
             m_bboQuotePublisher(Beam::Ref(m_clientHandler)),
             m_bookQuotePublisher(Beam::Ref(m_clientHandler)),
             m_marketQuotePublisher(Beam::Ref(m_clientHandler)),
-            m_timeAndSalePublisher(Beam::Ref(m_clientHandler)) {
+            m_timeAndSalePublisher(Beam::Ref(m_clientHandler)),
+            m_isConflated(false) {
 BEAM_UNSUPPRESS_THIS_INITIALIZER()
     Queries::RegisterQueryTypes(
       Beam::Store(m_clientHandler.GetSlots().GetRegistry()));
@@ -203,6 +236,10 @@ BEAM_UNSUPPRESS_THIS_INITIALIZER()
     m_bookQuotePublisher.template AddMessageHandler<BookQuoteMessage>();
     m_marketQuotePublisher.template AddMessageHandler<MarketQuoteMessage>();
     m_timeAndSalePublisher.template AddMessageHandler<TimeAndSaleMessage>();
+    Beam::Services::AddMessageSlot<ConflationMessage>(
+      Beam::Store(m_clientHandler.GetSlots()),
+      std::bind(&MarketDataClient::OnConflationMessage, this,
+      std::placeholders::_1, std::placeholders::_2));
   } catch(const std::exception&) {
     std::throw_with_nested(Beam::IO::ConnectException(
       "Failed to connect to the market data server."));
@@ -323,6 +360,25 @@ BEAM_UNSUPPRESS_THIS_INITIALIZER()
     }, "Failed to load security info from prefix: \"" + prefix + "\"");
   }
 
+  template<typename B>
+  void MarketDataClient<B>::SetBboQuoteConflation(const Security& security,
+      bool isConflated) {
+    SetConflation<ConflateBboQuoteQueryMessage>(security, isConflated,
+      m_conflatedBboQuotes);
+  }
+
+  template<typename B>
+  void MarketDataClient<B>::SetBookQuoteConflation(const Security& security,
+      bool isConflated) {
+    SetConflation<ConflateBookQuoteQueryMessage>(security, isConflated,
+      m_conflatedBookQuotes);
+  }
+
+  template<typename B>
+  bool MarketDataClient<B>::IsConflated() const {
+    return m_isConflated;
+  }
+
   template<typename B>
   void MarketDataClient<B>::Close() {
     if(m_openState.SetClosing()) {
@@ -345,6 +401,42 @@ BEAM_UNSUPPRESS_THIS_INITIALIZER()
     m_bookQuotePublisher.Recover(*client);
     m_marketQuotePublisher.Recover(*client);
     m_timeAndSalePublisher.Recover(*client);
+    m_isConflated = false;
+    m_conflatedBboQuotes.With([&] (auto& securities) {
+      for(auto& security : securities) {
+        Beam::Services::SendRecordMessage<ConflateBboQuoteQueryMessage>(
+          *client, security, true);
+      }
+    });
+    m_conflatedBookQuotes.With([&] (auto& securities) {
+      for(auto& security : securities) {
+        Beam::Services::SendRecordMessage<ConflateBookQuoteQueryMessage>(
+          *client, security, true);
+      }
+    });
+  }
+
+  template<typename B>
+  template<typename Message>
+  void MarketDataClient<B>::SetConflation(const Security& security,
+      bool isConflated, Beam::SynchronizedUnorderedSet<Security>& securities) {
+    Beam::Services::ServiceOrThrowWithNested([&] {
+      if(isConflated) {
+        securities.Update(security);
+      } else {
+        securities.Erase(security);
+      }
+      auto client = m_clientHandler.GetClient();
+      Beam::Services::SendRecordMessage<Message>(*client, security,
+        isConflated);
+    }, "Failed to set conflation: " +
+      boost::lexical_cast<std::string>(security));
+  }
+
+  template<typename B>
+  void MarketDataClient<B>::OnConflationMessage(ServiceProtocolClient& client,
+      bool isConflated) {
+    m_isConflated = isConflated;
   }
 }
 
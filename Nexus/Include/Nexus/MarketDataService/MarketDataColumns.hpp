@@ -0,0 +1,123 @@
+#ifndef NEXUS_MARKET_DATA_COLUMNS_HPP
+#define NEXUS_MARKET_DATA_COLUMNS_HPP
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Nexus/MarketDataService/HistoricalDataStoreUtilities.hpp"
+#include "Nexus/MarketDataService/MarketDataService.hpp"
+
+namespace Nexus::MarketDataService {
+
+  /**
+   * Stores a list of BboQuotes as one contiguous array per field, suitable for
+   * vectorized processing. Timestamps are microseconds since the epoch and
+   * prices and sizes are floating point.
+   */
+  struct BboQuoteColumns {
+
+    /** The ordinal of each value's Sequence. */
+    std::vector<std::uint64_t> m_sequences;
+
+    /** The timestamps. */
+    std::vector<std::int64_t> m_timestamps;
+
+    /** The bid prices. */
+    std::vector<double> m_bidPrices;
+
+    /** The bid sizes. */
+    std::vector<double> m_bidSizes;
+
+    /** The ask prices. */
+    std::vector<double> m_askPrices;
+
+    /** The ask sizes. */
+    std::vector<double> m_askSizes;
+  };
+
+  /**
+   * Stores a list of TimeAndSales as one contiguous array per field, suitable
+   * for vectorized processing. Market centers are interned, each stored as an
+   * index into a list of distinct names.
+   */
+  struct TimeAndSaleColumns {
+
+    /** The ordinal of each value's Sequence. */
+    std::vector<std::uint64_t> m_sequences;
+
+    /** The timestamps. */
+    std::vector<std::int64_t> m_timestamps;
+
+    /** The prices. */
+    std::vector<double> m_prices;
+
+    /** The sizes. */
+    std::vector<double> m_sizes;
+
+    /** The index of each value's market center. */
+    std::vector<std::int32_t> m_marketCenters;
+
+    /** The distinct market centers, indexed by m_marketCenters. */
+    std::vector<std::string> m_marketCenterNames;
+  };
+
+  /**
+   * Splits a list of BboQuotes into columns.
+   * @param bboQuotes The BboQuotes to split.
+   * @return The columns of the <i>bboQuotes</i>.
+   */
+  inline BboQuoteColumns MakeBboQuoteColumns(
+      const std::vector<SequencedBboQuote>& bboQuotes) {
+    auto columns = BboQuoteColumns();
+    columns.m_sequences.reserve(bboQuotes.size());
+    columns.m_timestamps.reserve(bboQuotes.size());
+    columns.m_bidPrices.reserve(bboQuotes.size());
+    columns.m_bidSizes.reserve(bboQuotes.size());
+    columns.m_askPrices.reserve(bboQuotes.size());
+    columns.m_askSizes.reserve(bboQuotes.size());
+    for(auto& bboQuote : bboQuotes) {
+      columns.m_sequences.push_back(bboQuote.GetSequence().GetOrdinal());
+      columns.m_timestamps.push_back(
+        Details::ToColumnTimestamp(bboQuote->m_timestamp));
+      columns.m_bidPrices.push_back(
+        static_cast<double>(bboQuote->m_bid.m_price));
+      columns.m_bidSizes.push_back(static_cast<double>(bboQuote->m_bid.m_size));
+      columns.m_askPrices.push_back(
+        static_cast<double>(bboQuote->m_ask.m_price));
+      columns.m_askSizes.push_back(static_cast<double>(bboQuote->m_ask.m_size));
+    }
+    return columns;
+  }
+
+  /**
+   * Splits a list of TimeAndSales into columns.
+   * @param timeAndSales The TimeAndSales to split.
+   * @return The columns of the <i>timeAndSales</i>.
+   */
+  inline TimeAndSaleColumns MakeTimeAndSaleColumns(
+      const std::vector<SequencedTimeAndSale>& timeAndSales) {
+    auto columns = TimeAndSaleColumns();
+    columns.m_sequences.reserve(timeAndSales.size());
+    columns.m_timestamps.reserve(timeAndSales.size());
+    columns.m_prices.reserve(timeAndSales.size());
+    columns.m_sizes.reserve(timeAndSales.size());
+    columns.m_marketCenters.reserve(timeAndSales.size());
+    auto marketCenters = std::unordered_map<std::string, std::int32_t>();
+    for(auto& timeAndSale : timeAndSales) {
+      columns.m_sequences.push_back(timeAndSale.GetSequence().GetOrdinal());
+      columns.m_timestamps.push_back(
+        Details::ToColumnTimestamp(timeAndSale->m_timestamp));
+      columns.m_prices.push_back(static_cast<double>(timeAndSale->m_price));
+      columns.m_sizes.push_back(static_cast<double>(timeAndSale->m_size));
+      auto marketCenter = marketCenters.try_emplace(timeAndSale->m_marketCenter,
+        static_cast<std::int32_t>(columns.m_marketCenterNames.size()));
+      if(marketCenter.second) {
+        columns.m_marketCenterNames.push_back(timeAndSale->m_marketCenter);
+      }
+      columns.m_marketCenters.push_back(marketCenter.first->second);
+    }
+    return columns;
+  }
+}
+
+#endif
@@ -1,5 +1,7 @@
 #ifndef NEXUS_MARKET_DATA_FEED_CLIENT_HPP
 #define NEXUS_MARKET_DATA_FEED_CLIENT_HPP
+#include <atomic>
+#include <unordered_map>
 #include <vector>
 #include <Beam/IO/Connection.hpp>
 #include <Beam/IO/OpenState.hpp>
@@ -9,15 +11,20 @@
 #include <Beam/Services/ServiceProtocolClient.hpp>
 #include <Beam/Threading/Timer.hpp>
 #include <Beam/Utilities/AssertionException.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/optional/optional.hpp>
 #include <boost/thread/mutex.hpp>
 #include "Nexus/MarketDataService/MarketDataFeedServices.hpp"
+#include "Nexus/MarketDataService/PackedMarketDataCodec.hpp"
 
 namespace Nexus::MarketDataService {
 
   /**
-   * Client used to access the MarketDataFeedServlet.
+   * Client used to access the MarketDataFeedServlet. If enabled, upon
+   * connecting the client requests the packed encoding, and market data is
+   * sent using the PackedMarketDataEncoder once the servlet accepts it,
+   * otherwise the generic encoding is used.
    * @param <O> The type used to represent order ids.
    * @param <S> The type of Timer used to sample market data sent to the
    *        servlet.
@@ -58,6 +65,19 @@ namespace Nexus::MarketDataService {
       MarketDataFeedClient(CF&& channel, const Authenticator& authenticator,
         SF&& samplingTimer, HF&& heartbeatTimer);
 
+      /**
+       * Constructs a MarketDataFeedClient.
+       * @param channel Initializes the Channel to the ServiceProtocol server.
+       * @param authenticator The Authenticator to use.
+       * @param samplingTimer Initializes the SamplingTimer.
+       * @param heartbeatTimer Initializes the Timer used for heartbeats.
+       * @param isPackedRequested Whether to request the packed encoding, only
+       *        servlets that support it may be sent the request.
+       */
+      template<typename CF, typename SF, typename HF>
+      MarketDataFeedClient(CF&& channel, const Authenticator& authenticator,
+        SF&& samplingTimer, HF&& heartbeatTimer, bool isPackedRequested);
+
       ~MarketDataFeedClient();
 
       /**
@@ -164,24 +184,54 @@ namespace Nexus::MarketDataService {
           const std::string& mpid, bool isPrimaryMpid, Side side, Money price,
           Quantity size);
       };
+      struct BookQuoteKey {
+        Security m_security;
+        std::string m_mpid;
+        Side m_side;
+        Money m_price;
+
+        bool operator ==(const BookQuoteKey& rhs) const;
+      };
+      struct BookQuoteKeyHash {
+        std::size_t operator ()(const BookQuoteKey& key) const;
+      };
+      struct BookQuoteLevel {
+        MarketCode m_market;
+        bool m_isPrimaryMpid;
+        Quantity m_size;
+      };
       struct QuoteUpdates {
         boost::optional<SecurityBboQuote> m_bboQuote;
         std::unordered_map<MarketCode, SecurityMarketQuote> m_marketQuotes;
         std::vector<SecurityBookQuote> m_askBook;
         std::vector<SecurityBookQuote> m_bidBook;
         std::vector<SecurityTimeAndSale> m_timeAndSales;
+        bool m_isDirty = false;
+
+        void Clear();
       };
       mutable boost::mutex m_mutex;
       ServiceProtocolClient m_client;
       Beam::GetOptionalLocalPtr<S> m_samplingTimer;
       std::unordered_map<Security, QuoteUpdates> m_quoteUpdates;
+      std::vector<Security> m_dirtySecurities;
       std::vector<MarketOrderImbalance> m_orderImbalances;
       std::unordered_map<OrderId, OrderEntry> m_orders;
+      std::unordered_map<BookQuoteKey, BookQuoteLevel, BookQuoteKeyHash>
+        m_bookQuoteLevels;
+      std::unordered_map<Security, QuoteUpdates> m_sampledQuoteUpdates;
+      std::vector<Security> m_sampledDirtySecurities;
+      std::vector<MarketOrderImbalance> m_sampledOrderImbalances;
+      std::vector<MarketDataFeedMessage> m_messages;
+      std::atomic_bool m_isPacked;
+      PackedMarketDataEncoder m_encoder;
+      std::string m_packedMessages;
       Beam::IO::OpenState m_openState;
       Beam::RoutineTaskQueue m_tasks;
 
       MarketDataFeedClient(const MarketDataFeedClient&) = delete;
       MarketDataFeedClient& operator =(const MarketDataFeedClient&) = delete;
+      QuoteUpdates& LockedLoadQuoteUpdates(const Security& security);
       void UpdateBookSampling(const SecurityBookQuote& bookQuote);
       void LockedAddOrder(const Security& security, MarketCode market,
         const std::string& mpid, bool isPrimaryMpid, const OrderId& id,
@@ -190,6 +240,7 @@ namespace Nexus::MarketDataService {
       void LockedDeleteOrder(
         typename std::unordered_map<OrderId, OrderEntry>::iterator&
         orderIterator, boost::posix_time::ptime timestamp);
+      void OnAcceptPackedMessage(ServiceProtocolClient& client, int version);
       void OnTimerExpired(Beam::Threading::Timer::Result result);
   };
 
@@ -241,17 +292,63 @@ namespace Nexus::MarketDataService {
       m_price(price),
       m_size(size) {}
 
+  template<typename O, typename S, typename P, typename H>
+  bool MarketDataFeedClient<O, S, P, H>::BookQuoteKey::operator ==(
+      const BookQuoteKey& rhs) const {
+    return m_price == rhs.m_price && m_side == rhs.m_side &&
+      m_security == rhs.m_security && m_mpid == rhs.m_mpid;
+  }
+
+  template<typename O, typename S, typename P, typename H>
+  std::size_t MarketDataFeedClient<O, S, P, H>::BookQuoteKeyHash::operator ()(
+      const BookQuoteKey& key) const {
+    auto seed = std::hash<Security>()(key.m_security);
+    boost::hash_combine(seed, key.m_mpid);
+    boost::hash_combine(seed, static_cast<int>(key.m_side));
+    boost::hash_combine(seed,
+      static_cast<Quantity>(key.m_price).GetRepresentation());
+    return seed;
+  }
+
+  template<typename O, typename S, typename P, typename H>
+  void MarketDataFeedClient<O, S, P, H>::QuoteUpdates::Clear() {
+    m_bboQuote = boost::none;
+    m_marketQuotes.clear();
+    m_askBook.clear();
+    m_bidBook.clear();
+    m_timeAndSales.clear();
+    m_isDirty = false;
+  }
+
+  template<typename O, typename S, typename P, typename H>
+  template<typename CF, typename SF, typename HF>
+  MarketDataFeedClient<O, S, P, H>::MarketDataFeedClient(CF&& channel,
+    const Authenticator& authenticator, SF&& samplingTimer,
+    HF&& heartbeatTimer)
+    : MarketDataFeedClient(std::forward<CF>(channel), authenticator,
+        std::forward<SF>(samplingTimer), std::forward<HF>(heartbeatTimer),
+        false) {}
+
   template<typename O, typename S, typename P, typename H>
   template<typename CF, typename SF, typename HF>
   MarketDataFeedClient<O, S, P, H>::MarketDataFeedClient(CF&& channel,
       const Authenticator& authenticator, SF&& samplingTimer,
-      HF&& heartbeatTimer)
+      HF&& heartbeatTimer, bool isPackedRequested)
       try : m_client(std::forward<CF>(channel),
               std::forward<HF>(heartbeatTimer)),
-            m_samplingTimer(std::forward<SF>(samplingTimer)) {
+            m_samplingTimer(std::forward<SF>(samplingTimer)),
+            m_isPacked(false) {
     RegisterMarketDataFeedMessages(Beam::Store(m_client.GetSlots()));
+    Beam::Services::AddMessageSlot<AcceptPackedMarketDataFeedMessage>(
+      Beam::Store(m_client.GetSlots()), std::bind(
+        &MarketDataFeedClient::OnAcceptPackedMessage, this,
+        std::placeholders::_1, std::placeholders::_2));
     try {
       Beam::ServiceLocator::Authenticate(authenticator, m_client);
+      if(isPackedRequested) {
+        Beam::Services::SendRecordMessage<RequestPackedMarketDataFeedMessage>(
+          m_client, PackedMarketDataEncoder::VERSION);
+      }
       m_samplingTimer->GetPublisher().Monitor(
         m_tasks.GetSlot<Beam::Threading::Timer::Result>(
         std::bind(&MarketDataFeedClient::OnTimerExpired, this,
@@ -290,7 +387,7 @@ namespace Nexus::MarketDataService {
   void MarketDataFeedClient<O, S, P, H>::Publish(
       const SecurityBboQuote& bboQuote) {
     auto lock = boost::lock_guard(m_mutex);
-    auto& updates = m_quoteUpdates[bboQuote.GetIndex()];
+    auto& updates = LockedLoadQuoteUpdates(bboQuote.GetIndex());
     updates.m_bboQuote = bboQuote;
   }
 
@@ -298,41 +395,49 @@ namespace Nexus::MarketDataService {
   void MarketDataFeedClient<O, S, P, H>::Publish(
       const SecurityMarketQuote& marketQuote) {
     auto lock = boost::lock_guard(m_mutex);
-    m_quoteUpdates[marketQuote.GetIndex()].m_marketQuotes[
+    LockedLoadQuoteUpdates(marketQuote.GetIndex()).m_marketQuotes[
       marketQuote->m_market] = marketQuote;
   }
 
   template<typename O, typename S, typename P, typename H>
   void MarketDataFeedClient<O, S, P, H>::Publish(
       const SecurityBookQuote& bookQuote) {
-    auto id = bookQuote.GetIndex().GetSymbol() + '-' +
-      boost::lexical_cast<std::string>(bookQuote.GetIndex().GetCountry()) +
-      bookQuote->m_mpid + '-' +
-      boost::lexical_cast<std::string>(bookQuote->m_quote.m_price) +
-      ToChar(bookQuote->m_quote.m_side);
+    auto key = BookQuoteKey{bookQuote.GetIndex(), bookQuote->m_mpid,
+      bookQuote->m_quote.m_side, bookQuote->m_quote.m_price};
+    auto size = std::max<Quantity>(0, bookQuote->m_quote.m_size);
     auto lock = boost::lock_guard(m_mutex);
-    auto orderIterator = m_orders.find(id);
-    if(orderIterator == m_orders.end()) {
-      LockedAddOrder(bookQuote.GetIndex(), bookQuote->m_market,
-        bookQuote->m_mpid, bookQuote->m_isPrimaryMpid, id,
-        bookQuote->m_quote.m_side, bookQuote->m_quote.m_price,
-        bookQuote->m_quote.m_size, bookQuote->m_timestamp);
-    } else {
-      LockedDeleteOrder(orderIterator, bookQuote->m_timestamp);
-      if(bookQuote->m_quote.m_size != 0) {
-        LockedAddOrder(bookQuote.GetIndex(), bookQuote->m_market,
-          bookQuote->m_mpid, bookQuote->m_isPrimaryMpid, id,
-          bookQuote->m_quote.m_side, bookQuote->m_quote.m_price,
-          bookQuote->m_quote.m_size, bookQuote->m_timestamp);
+    auto levelIterator = m_bookQuoteLevels.find(key);
+    auto delta = [&] {
+      if(levelIterator == m_bookQuoteLevels.end()) {
+        if(size == 0) {
+          return Quantity(0);
+        }
+        m_bookQuoteLevels.insert(std::pair(std::move(key), BookQuoteLevel{
+          bookQuote->m_market, bookQuote->m_isPrimaryMpid, size}));
+        return size;
       }
+      auto delta = size - levelIterator->second.m_size;
+      if(size == 0) {
+        m_bookQuoteLevels.erase(levelIterator);
+      } else {
+        levelIterator->second.m_size = size;
+      }
+      return delta;
+    }();
+    if(delta == 0) {
+      return;
     }
+    UpdateBookSampling(Beam::Queries::IndexedValue(BookQuote(bookQuote->m_mpid,
+      bookQuote->m_isPrimaryMpid, bookQuote->m_market,
+      Quote(bookQuote->m_quote.m_price, delta, bookQuote->m_quote.m_side),
+      bookQuote->m_timestamp), bookQuote.GetIndex()));
   }
 
   template<typename O, typename S, typename P, typename H>
   void MarketDataFeedClient<O, S, P, H>::Publish(
       const SecurityTimeAndSale& timeAndSale) {
     auto lock = boost::lock_guard(m_mutex);
-    auto& updates = m_quoteUpdates[timeAndSale.GetIndex()];
+    auto& updates = LockedLoadQuoteUpdates(timeAndSale.GetIndex());
     updates.m_timeAndSales.push_back(timeAndSale);
   }
 
@@ -412,15 +517,28 @@ namespace Nexus::MarketDataService {
     m_openState.Close();
   }
 
+  template<typename O, typename S, typename P, typename H>
+  typename MarketDataFeedClient<O, S, P, H>::QuoteUpdates&
+      MarketDataFeedClient<O, S, P, H>::LockedLoadQuoteUpdates(
+        const Security& security) {
+    auto& updates = m_quoteUpdates[security];
+    if(!updates.m_isDirty) {
+      updates.m_isDirty = true;
+      m_dirtySecurities.push_back(security);
+    }
+    return updates;
+  }
+
   template<typename O, typename S, typename P, typename H>
   void MarketDataFeedClient<O, S, P, H>::UpdateBookSampling(
       const SecurityBookQuote& bookQuote) {
+    auto& updates = LockedLoadQuoteUpdates(bookQuote.GetIndex());
     auto book = [&] {
       if(bookQuote->m_quote.m_side == Side::ASK) {
-        return &(m_quoteUpdates[bookQuote.GetIndex()].m_askBook);
+        return &updates.m_askBook;
       } else {
         BEAM_ASSERT(bookQuote->m_quote.m_side == Side::BID);
-        return &(m_quoteUpdates[bookQuote.GetIndex()].m_bidBook);
+        return &updates.m_bidBook;
       }
     }();
     auto quoteIterator = std::lower_bound(book->begin(), book->end(), bookQuote,
@@ -469,46 +587,64 @@ namespace Nexus::MarketDataService {
     m_orders.erase(orderIterator);
   }
 
+  template<typename O, typename S, typename P, typename H>
+  void MarketDataFeedClient<O, S, P, H>::OnAcceptPackedMessage(
+      ServiceProtocolClient& client, int version) {
+    if(version == PackedMarketDataEncoder::VERSION) {
+      m_isPacked = true;
+    }
+  }
+
   template<typename O, typename S, typename P, typename H>
   void MarketDataFeedClient<O, S, P, H>::OnTimerExpired(
       Beam::Threading::Timer::Result result) {
-    auto messages = std::vector<MarketDataFeedMessage>();
-    auto quoteUpdates = std::unordered_map<Security, QuoteUpdates>();
-    auto orderImbalances = std::vector<MarketOrderImbalance>();
     {
       auto lock = boost::lock_guard(m_mutex);
-      quoteUpdates.swap(m_quoteUpdates);
-      orderImbalances.swap(m_orderImbalances);
+      m_quoteUpdates.swap(m_sampledQuoteUpdates);
+      m_dirtySecurities.swap(m_sampledDirtySecurities);
+      m_orderImbalances.swap(m_sampledOrderImbalances);
     }
-    for(auto& [security, updates] : quoteUpdates) {
+    for(auto& security : m_sampledDirtySecurities) {
+      auto& updates = m_sampledQuoteUpdates[security];
       if(updates.m_bboQuote.is_initialized()) {
-        messages.push_back(std::move(*updates.m_bboQuote));
+        m_messages.push_back(std::move(*updates.m_bboQuote));
       }
       std::transform(updates.m_marketQuotes.begin(),
-        updates.m_marketQuotes.end(), std::back_inserter(messages),
+        updates.m_marketQuotes.end(), std::back_inserter(m_messages),
         [] (const auto& quote) -> decltype(auto) {
           return std::move(quote.second);
         });
       std::copy_if(std::make_move_iterator(updates.m_askBook.begin()),
         std::make_move_iterator(updates.m_askBook.end()),
-        std::back_inserter(messages),
+        std::back_inserter(m_messages),
         [] (const auto& quote) {
           return quote->m_quote.m_size != 0;
         });
       std::copy_if(std::make_move_iterator(updates.m_bidBook.begin()),
         std::make_move_iterator(updates.m_bidBook.end()),
-        std::back_inserter(messages),
+        std::back_inserter(m_messages),
         [] (const auto& quote) {
           return quote->m_quote.m_size != 0;
         });
       std::move(updates.m_timeAndSales.begin(), updates.m_timeAndSales.end(),
-        std::back_inserter(messages));
+        std::back_inserter(m_messages));
+      updates.Clear();
     }
-    std::move(orderImbalances.begin(), orderImbalances.end(),
-      std::back_inserter(messages));
-    if(!messages.empty()) {
-      Beam::Services::SendRecordMessage<SendMarketDataFeedMessages>(m_client,
-        messages);
+    m_sampledDirtySecurities.clear();
+    std::move(m_sampledOrderImbalances.begin(),
+      m_sampledOrderImbalances.end(), std::back_inserter(m_messages));
+    m_sampledOrderImbalances.clear();
+    if(!m_messages.empty()) {
+      if(m_isPacked) {
+        m_packedMessages.clear();
+        m_encoder.Encode(m_messages, m_packedMessages);
+        Beam::Services::SendRecordMessage<SendPackedMarketDataFeedMessages>(
+          m_client, m_packedMessages);
+      } else {
+        Beam::Services::SendRecordMessage<SendMarketDataFeedMessages>(
+          m_client, m_messages);
+      }
+      m_messages.clear();
     }
     m_samplingTimer->Start();
   }
@@ -1,5 +1,6 @@
 #ifndef NEXUS_MARKET_DATA_FEED_SERVICES_HPP
 #define NEXUS_MARKET_DATA_FEED_SERVICES_HPP
+#include <string>
 #include <Beam/Serialization/ShuttleVariant.hpp>
 #include <Beam/Serialization/ShuttleVector.hpp>
 #include <Beam/Services/RecordMessage.hpp>
@@ -29,7 +30,34 @@ namespace Nexus::MarketDataService {
      */
     (SendMarketDataFeedMessages,
       "Nexus.MarketDataService.SendMarketDataFeedMessages",
-      std::vector<MarketDataFeedMessage>, messages));
+      std::vector<MarketDataFeedMessage>, messages),
+
+    /**
+     * Sends a list of MarketDataFeedMessages encoded by a
+     * PackedMarketDataEncoder.
+     * @param messages The encoded list of MarketDataFeedMessages.
+     */
+    (SendPackedMarketDataFeedMessages,
+      "Nexus.MarketDataService.SendPackedMarketDataFeedMessages",
+      std::string, messages),
+
+    /**
+     * Sent by a client to indicate that it can send
+     * SendPackedMarketDataFeedMessages.
+     * @param version The version of the packed encoding supported.
+     */
+    (RequestPackedMarketDataFeedMessage,
+      "Nexus.MarketDataService.RequestPackedMarketDataFeedMessage", int,
+      version),
+
+    /**
+     * Sent by the servlet in reply to a RequestPackedMarketDataFeedMessage to
+     * indicate that it can decode SendPackedMarketDataFeedMessages.
+     * @param version The version of the packed encoding supported.
+     */
+    (AcceptPackedMarketDataFeedMessage,
+      "Nexus.MarketDataService.AcceptPackedMarketDataFeedMessage", int,
+      version));
 }
 
 #endif
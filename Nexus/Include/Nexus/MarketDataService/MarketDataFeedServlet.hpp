@@ -7,6 +7,7 @@
 #include <Beam/Utilities/ReportException.hpp>
 #include <Beam/Utilities/VariantLambdaVisitor.hpp>
 #include "Nexus/MarketDataService/MarketDataFeedServices.hpp"
+#include "Nexus/MarketDataService/PackedMarketDataCodec.hpp"
 
 namespace Nexus::MarketDataService {
 
@@ -49,14 +50,19 @@ namespace Nexus::MarketDataService {
 
       MarketDataFeedServlet(const MarketDataFeedServlet&) = delete;
       MarketDataFeedServlet& operator =(const MarketDataFeedServlet&) = delete;
+      void OnRequestPackedMessage(ServiceProtocolClient& client, int version);
       void OnSetSecurityInfoMessage(ServiceProtocolClient& client,
         const SecurityInfo& securityInfo);
       void OnSendMarketDataFeedMessages(ServiceProtocolClient& client,
         const std::vector<MarketDataFeedMessage>& messages);
+      void OnSendPackedMarketDataFeedMessages(ServiceProtocolClient& client,
+        const std::string& messages);
   };
 
   struct MarketDataFeedSession {
     int m_sourceId;
+    PackedMarketDataDecoder m_decoder;
+    std::vector<MarketDataFeedMessage> m_messages;
   };
 
   template<typename R>
@@ -85,6 +91,14 @@ namespace Nexus::MarketDataService {
       Beam::Store(slots), std::bind(
         &MarketDataFeedServlet::OnSendMarketDataFeedMessages, this,
         std::placeholders::_1, std::placeholders::_2));
+    Beam::Services::AddMessageSlot<SendPackedMarketDataFeedMessages>(
+      Beam::Store(slots), std::bind(
+        &MarketDataFeedServlet::OnSendPackedMarketDataFeedMessages, this,
+        std::placeholders::_1, std::placeholders::_2));
+    Beam::Services::AddMessageSlot<RequestPackedMarketDataFeedMessage>(
+      Beam::Store(slots), std::bind(
+        &MarketDataFeedServlet::OnRequestPackedMessage, this,
+        std::placeholders::_1, std::placeholders::_2));
   }
 
   template<typename C, typename R>
@@ -106,6 +120,15 @@ namespace Nexus::MarketDataService {
     m_openState.Close();
   }
 
+  template<typename C, typename R>
+  void MarketDataFeedServlet<C, R>::OnRequestPackedMessage(
+      ServiceProtocolClient& client, int version) {
+    if(version == PackedMarketDataEncoder::VERSION) {
+      Beam::Services::SendRecordMessage<AcceptPackedMarketDataFeedMessage>(
+        client, PackedMarketDataEncoder::VERSION);
+    }
+  }
+
   template<typename C, typename R>
   void MarketDataFeedServlet<C, R>::OnSetSecurityInfoMessage(
       ServiceProtocolClient& client, const SecurityInfo& securityInfo) {
@@ -141,6 +164,21 @@ namespace Nexus::MarketDataService {
       }
     }
   }
+
+  template<typename C, typename R>
+  void MarketDataFeedServlet<C, R>::OnSendPackedMarketDataFeedMessages(
+      ServiceProtocolClient& client, const std::string& messages) {
+    auto& session = client.GetSession();
+    session.m_messages.clear();
+    try {
+      session.m_decoder.Decode(messages, session.m_messages);
+    } catch(const std::exception&) {
+      std::cout << BEAM_REPORT_CURRENT_EXCEPTION() << std::flush;
+      client.Close();
+      return;
+    }
+    OnSendMarketDataFeedMessages(client, session.m_messages);
+  }
 }
 
 #endif
@@ -1,21 +1,24 @@
 #ifndef NEXUS_MARKET_DATA_REGISTRY_HPP
 #define NEXUS_MARKET_DATA_REGISTRY_HPP
+#include <algorithm>
 #include <memory>
-#include <unordered_set>
+#include <thread>
+#include <vector>
 #include <Beam/Collections/SynchronizedMap.hpp>
 #include <Beam/Collections/SynchronizedSet.hpp>
-#include <Beam/Collections/Trie.hpp>
 #include <Beam/Threading/Sync.hpp>
 #include <Beam/Utilities/AssertionException.hpp>
 #include <Beam/Utilities/Remote.hpp>
 #include <boost/optional/optional.hpp>
-#include <boost/range/adaptor/map.hpp>
 #include "Nexus/Definitions/DefaultCountryDatabase.hpp"
 #include "Nexus/Definitions/DefaultMarketDatabase.hpp"
 #include "Nexus/Definitions/SecurityInfo.hpp"
 #include "Nexus/MarketDataService/MarketDataService.hpp"
 #include "Nexus/MarketDataService/MarketEntry.hpp"
 #include "Nexus/MarketDataService/SecurityEntry.hpp"
+#include "Nexus/MarketDataService/SecurityEntryCheckpoint.hpp"
+#include "Nexus/MarketDataService/SecuritySearchIndex.hpp"
+#include "Nexus/Queries/EvaluatorTranslator.hpp"
 #include "Nexus/TechnicalAnalysis/StandardSecurityQueries.hpp"
 
 namespace Nexus::MarketDataService {
@@ -59,13 +62,50 @@ namespace Details {
   }
 }
 
-  /** Keeps and updates the registry of market data. */
+  /**
+   * Keeps and updates the registry of market data.
+   * Securities are partitioned by hash across a set of shards, each guarded by
+   * its own lock, so that publishing to unrelated securities does not contend
+   * on a single map.
+   */
   class MarketDataRegistry {
     public:
 
-      /** Constructs a MarketDataRegistry. */
+      /**
+       * The default number of recently published values of each type kept in
+       * memory per Security.
+       */
+      static constexpr auto DEFAULT_RECENT_TICK_COUNT = 128;
+
+      /**
+       * Constructs a MarketDataRegistry with one shard per hardware thread.
+       */
       MarketDataRegistry();
 
+      /**
+       * Constructs a MarketDataRegistry.
+       * @param shardCount The number of shards to partition Securities across.
+       */
+      explicit MarketDataRegistry(int shardCount);
+
+      /**
+       * Constructs a MarketDataRegistry.
+       * @param shardCount The number of shards to partition Securities across.
+       * @param recentTickCount The number of recently published values of each
+       *        type to keep in memory per Security.
+       */
+      MarketDataRegistry(int shardCount, int recentTickCount);
+
+      /** Returns the number of shards Securities are partitioned across. */
+      int GetShardCount() const;
+
+      /**
+       * Returns the index of the shard a Security is assigned to.
+       * @param security The Security to locate.
+       * @return The index of the shard storing the <i>security</i>.
+       */
+      int GetShard(const Security& security) const;
+
       /**
        * Adds or updates a SecurityInfo to this registry.
        * @param securityInfo The SecurityInfo to add or update.
@@ -158,26 +198,87 @@ namespace Details {
        */
       boost::optional<SecuritySnapshot> FindSnapshot(const Security& security);
 
+      /**
+       * Loads BboQuotes from the values recently published to a Security.
+       * @param security The Security to load.
+       * @param query The query to load.
+       * @return The result of the <i>query</i>, or <code>none</code> iff the
+       *         query reaches past the values kept in memory.
+       */
+      boost::optional<std::vector<SequencedBboQuote>> LoadRecentBboQuotes(
+        const Security& security, const SecurityMarketDataQuery& query);
+
+      /**
+       * Loads MarketQuotes from the values recently published to a Security.
+       * @param security The Security to load.
+       * @param query The query to load.
+       * @return The result of the <i>query</i>, or <code>none</code> iff the
+       *         query reaches past the values kept in memory.
+       */
+      boost::optional<std::vector<SequencedMarketQuote>>
+        LoadRecentMarketQuotes(const Security& security,
+          const SecurityMarketDataQuery& query);
+
+      /**
+       * Loads BookQuotes from the values recently published to a Security.
+       * @param security The Security to load.
+       * @param query The query to load.
+       * @return The result of the <i>query</i>, or <code>none</code> iff the
+       *         query reaches past the values kept in memory.
+       */
+      boost::optional<std::vector<SequencedBookQuote>> LoadRecentBookQuotes(
+        const Security& security, const SecurityMarketDataQuery& query);
+
+      /**
+       * Loads TimeAndSales from the values recently published to a Security.
+       * @param security The Security to load.
+       * @param query The query to load.
+       * @return The result of the <i>query</i>, or <code>none</code> iff the
+       *         query reaches past the values kept in memory.
+       */
+      boost::optional<std::vector<SequencedTimeAndSale>>
+        LoadRecentTimeAndSales(const Security& security,
+          const SecurityMarketDataQuery& query);
+
       /**
        * Clears market data that originated from a specified source.
        * @param sourceId The id of the source to clear.
        */
       void Clear(int sourceId);
 
+      /**
+       * Populates Security entries from checkpoints so that the first value
+       * published to each does not need to query a HistoricalDataStore.
+       * Securities that already have an entry are left unchanged.
+       * @param checkpoints The checkpoints to populate the entries from.
+       */
+      void Preload(const std::vector<SecurityEntryCheckpoint>& checkpoints);
+
+      /** Returns a checkpoint of every loaded Security entry. */
+      std::vector<SecurityEntryCheckpoint> MakeCheckpoints();
+
     private:
       using SyncMarketEntry = Beam::Threading::Sync<MarketEntry,
         Beam::Threading::Mutex>;
       using SyncSecurityEntry = Beam::Threading::Sync<SecurityEntry,
         Beam::Threading::Mutex>;
-      Beam::Threading::Sync<rtv::Trie<char, SecurityInfo>> m_securityDatabase;
+      using SecurityEntries = Beam::SynchronizedUnorderedMap<Security,
+        std::shared_ptr<Beam::Remote<SyncSecurityEntry,
+        Beam::Threading::Mutex>>>;
+      int m_recentTickCount;
+      SecuritySearchIndex m_searchIndex;
       Beam::SynchronizedUnorderedSet<Security> m_verifiedSecurities;
       Beam::SynchronizedUnorderedMap<MarketCode, std::shared_ptr<Beam::Remote<
         SyncMarketEntry, Beam::Threading::Mutex>>> m_marketEntries;
-      Beam::SynchronizedUnorderedMap<Security, std::shared_ptr<Beam::Remote<
-        SyncSecurityEntry, Beam::Threading::Mutex>>> m_securityEntries;
+      std::vector<SecurityEntries> m_securityEntries;
 
       MarketDataRegistry(const MarketDataRegistry&) = delete;
       MarketDataRegistry& operator =(const MarketDataRegistry&) = delete;
+      SecurityEntries& GetSecurityEntries(const Security& security);
+      template<typename T, typename F>
+      boost::optional<std::vector<Beam::Queries::SequencedValue<T>>>
+        LoadRecent(const Security& security,
+          const SecurityMarketDataQuery& query, F&& getBuffer);
       template<typename DataStore>
       boost::optional<SyncMarketEntry&> LoadMarketEntry(MarketCode market,
         DataStore& dataStore);
@@ -187,49 +288,35 @@ namespace Details {
   };
 
   inline MarketDataRegistry::MarketDataRegistry()
-    : m_securityDatabase('\0') {}
+    : MarketDataRegistry(
+        std::max(1, static_cast<int>(std::thread::hardware_concurrency()))) {}
+
+  inline MarketDataRegistry::MarketDataRegistry(int shardCount)
+    : MarketDataRegistry(shardCount, DEFAULT_RECENT_TICK_COUNT) {}
+
+  inline MarketDataRegistry::MarketDataRegistry(int shardCount,
+    int recentTickCount)
+    : m_recentTickCount(std::max(0, recentTickCount)),
+      m_securityEntries(std::max(1, shardCount)) {}
+
+  inline int MarketDataRegistry::GetShardCount() const {
+    return static_cast<int>(m_securityEntries.size());
+  }
+
+  inline int MarketDataRegistry::GetShard(const Security& security) const {
+    return static_cast<int>(
+      std::hash<Security>()(security) % m_securityEntries.size());
+  }
 
   inline void MarketDataRegistry::Add(const SecurityInfo& securityInfo) {
-    auto key = ToString(securityInfo.m_security);
-    auto name = boost::to_upper_copy(securityInfo.m_name);
-    Beam::Threading::With(m_securityDatabase, [&] (auto& securityDatabase) {
-      securityDatabase[key.c_str()] = securityInfo;
-      securityDatabase[name.c_str()] = securityInfo;
-    });
+    m_searchIndex.Add(securityInfo);
     m_verifiedSecurities.Update(securityInfo.m_security);
   }
 
   inline std::vector<SecurityInfo> MarketDataRegistry::SearchSecurityInfo(
       const std::string& prefix) {
-    static const auto MAX_MATCH_COUNT = 8;
-    auto matches = std::unordered_set<SecurityInfo>();
-    auto uppercasePrefix = boost::to_upper_copy(prefix);
-    Beam::Threading::With(m_securityDatabase, [&] (auto& securityDatabase) {
-      for(auto i = securityDatabase.startsWith(uppercasePrefix.c_str());
-          i != securityDatabase.end(); ++i) {
-        matches.insert(*i->second);
-      }
-    });
-    auto i = matches.begin();
-    while(i != matches.end()) {
-      auto entry = m_securityEntries.FindValue(i->m_security);
-      if(!entry || !(*entry)->IsAvailable()) {
-        i = matches.erase(i);
-      } else {
-        Beam::Threading::With(***entry, [&] (auto& entry) {
-          if((*entry.GetBboQuote())->m_ask.m_price == Money::ZERO) {
-            i = matches.erase(i);
-          } else {
-            ++i;
-          }
-        });
-      }
-    }
-    auto result = std::vector<SecurityInfo>(matches.begin(), matches.end());
-    if(result.size() > MAX_MATCH_COUNT) {
-      result.erase(result.begin() + MAX_MATCH_COUNT, result.end());
-    }
-    return result;
+    static const auto MAX_MATCH_COUNT = std::size_t(8);
+    return m_searchIndex.Search(prefix, MAX_MATCH_COUNT);
   }
 
   inline Security MarketDataRegistry::GetPrimaryListing(
@@ -241,7 +328,7 @@ namespace Details {
     if(auto verifiedSecurity = m_verifiedSecurities.FindValue(security)) {
       return std::move(*verifiedSecurity);
     }
-    auto entry = m_securityEntries.Find(security);
+    auto entry = GetSecurityEntries(security).Find(security);
     if(!entry || !(*entry)->IsAvailable()) {
       return Security(security.GetSymbol(), security.GetCountry());
     }
@@ -304,14 +391,19 @@ namespace Details {
         } else {
           entry.SetSecurity(bboQuote.GetIndex());
         }
-        auto key = ToString(entry.GetSecurity());
-        auto info = SecurityInfo(entry.GetSecurity(), key, "", 0);
-        Beam::Threading::With(m_securityDatabase, [&] (auto& securityDatabase) {
-          securityDatabase.insert(key.c_str(), info);
-        });
+      }
+      if(!entry.GetSearchRanking()) {
+        auto ranking = m_searchIndex.FindRanking(entry.GetSecurity());
+        if(!ranking) {
+          ranking = m_searchIndex.Add(SecurityInfo(entry.GetSecurity(),
+            ToString(entry.GetSecurity()), "", 0));
+        }
+        entry.SetSearchRanking(std::move(ranking));
       }
       if(auto sequencedBboQuote =
           entry.PublishBboQuote(std::move(bboQuote), sourceId)) {
+        entry.GetSearchRanking()->m_hasQuote =
+          bboQuote->m_ask.m_price != Money::ZERO;
         f(*sequencedBboQuote);
       }
     });
@@ -359,6 +451,14 @@ namespace Details {
     Beam::Threading::With(*entry, [&] (auto& entry) {
       if(auto sequencedTimeAndSale =
           entry.PublishTimeAndSale(std::move(timeAndSale), sourceId)) {
+        if(!entry.GetSearchRanking()) {
+          entry.SetSearchRanking(
+            m_searchIndex.FindRanking(entry.GetSecurity()));
+        }
+        if(auto& ranking = entry.GetSearchRanking()) {
+          ranking->m_volume =
+            static_cast<double>(entry.GetSecurityTechnicals().m_volume);
+        }
         f(*sequencedTimeAndSale);
       }
     });
@@ -366,7 +466,7 @@ namespace Details {
 
   inline boost::optional<SecurityTechnicals>
       MarketDataRegistry::FindSecurityTechnicals(const Security& security) {
-    auto entry = m_securityEntries.Find(security);
+    auto entry = GetSecurityEntries(security).Find(security);
     if(!entry || !(*entry)->IsAvailable()) {
       return boost::none;
     }
@@ -377,7 +477,7 @@ namespace Details {
 
   inline boost::optional<SecuritySnapshot> MarketDataRegistry::FindSnapshot(
       const Security& security) {
-    auto entry = m_securityEntries.Find(security);
+    auto entry = GetSecurityEntries(security).Find(security);
     if(!entry || !(*entry)->IsAvailable()) {
       return boost::none;
     }
@@ -386,21 +486,126 @@ namespace Details {
     });
   }
 
+  inline boost::optional<std::vector<SequencedBboQuote>>
+      MarketDataRegistry::LoadRecentBboQuotes(const Security& security,
+        const SecurityMarketDataQuery& query) {
+    return LoadRecent<BboQuote>(security, query, [] (auto& entry) -> auto& {
+      return entry.GetRecentBboQuotes();
+    });
+  }
+
+  inline boost::optional<std::vector<SequencedMarketQuote>>
+      MarketDataRegistry::LoadRecentMarketQuotes(const Security& security,
+        const SecurityMarketDataQuery& query) {
+    return LoadRecent<MarketQuote>(security, query, [] (auto& entry) -> auto& {
+      return entry.GetRecentMarketQuotes();
+    });
+  }
+
+  inline boost::optional<std::vector<SequencedBookQuote>>
+      MarketDataRegistry::LoadRecentBookQuotes(const Security& security,
+        const SecurityMarketDataQuery& query) {
+    return LoadRecent<BookQuote>(security, query, [] (auto& entry) -> auto& {
+      return entry.GetRecentBookQuotes();
+    });
+  }
+
+  inline boost::optional<std::vector<SequencedTimeAndSale>>
+      MarketDataRegistry::LoadRecentTimeAndSales(const Security& security,
+        const SecurityMarketDataQuery& query) {
+    return LoadRecent<TimeAndSale>(security, query, [] (auto& entry) -> auto& {
+      return entry.GetRecentTimeAndSales();
+    });
+  }
+
   inline void MarketDataRegistry::Clear(int sourceId) {
-    auto entries = std::vector<std::shared_ptr<
-      Beam::Remote<SyncSecurityEntry, Beam::Threading::Mutex>>>();
-    m_securityEntries.With([&] (auto& securityEntries) {
-      for(auto& entry : securityEntries | boost::adaptors::map_values) {
-        entries.push_back(entry);
+    auto entries = std::vector<std::pair<Security, std::shared_ptr<
+      Beam::Remote<SyncSecurityEntry, Beam::Threading::Mutex>>>>();
+    for(auto& shard : m_securityEntries) {
+      shard.With([&] (auto& securityEntries) {
+        entries.insert(entries.end(), securityEntries.begin(),
+          securityEntries.end());
+      });
+    }
+    for(auto& entry : entries) {
+      if(entry.second->IsAvailable()) {
+        Beam::Threading::With(**entry.second, [&] (auto& securityEntry) {
+          securityEntry.Clear(sourceId);
+          if(auto& ranking = securityEntry.GetSearchRanking()) {
+            ranking->m_hasQuote =
+              (*securityEntry.GetBboQuote())->m_ask.m_price != Money::ZERO;
+          }
+        });
       }
-    });
+    }
+  }
+
+  inline void MarketDataRegistry::Preload(
+      const std::vector<SecurityEntryCheckpoint>& checkpoints) {
+    for(auto& checkpoint : checkpoints) {
+      if(checkpoint.m_security.GetSymbol().empty() ||
+          checkpoint.m_security.GetCountry() == CountryCode::NONE) {
+        continue;
+      }
+      auto entry = GetSecurityEntries(checkpoint.m_security).GetOrInsert(
+        checkpoint.m_security, [&] {
+          return std::make_shared<
+            Beam::Remote<SyncSecurityEntry, Beam::Threading::Mutex>>(
+              [&] (auto& entry) {
+                entry.emplace(GetPrimaryListing(checkpoint.m_security),
+                  checkpoint.m_closePrice, checkpoint.m_initialSequences,
+                  m_recentTickCount);
+              });
+        });
+      **entry;
+    }
+  }
+
+  inline std::vector<SecurityEntryCheckpoint>
+      MarketDataRegistry::MakeCheckpoints() {
+    auto entries = std::vector<std::pair<Security, std::shared_ptr<
+      Beam::Remote<SyncSecurityEntry, Beam::Threading::Mutex>>>>();
+    for(auto& shard : m_securityEntries) {
+      shard.With([&] (auto& securityEntries) {
+        entries.insert(entries.end(), securityEntries.begin(),
+          securityEntries.end());
+      });
+    }
+    auto checkpoints = std::vector<SecurityEntryCheckpoint>();
+    checkpoints.reserve(entries.size());
     for(auto& entry : entries) {
-      if(entry->IsAvailable()) {
-        Beam::Threading::With(**entry, [&] (auto& entry) {
-          entry.Clear(sourceId);
+      if(entry.second->IsAvailable()) {
+        Beam::Threading::With(**entry.second, [&] (auto& securityEntry) {
+          checkpoints.push_back(SecurityEntryCheckpoint{
+            securityEntry.GetSecurity(), securityEntry.GetLastClosePrice(),
+            securityEntry.GetNextSequences()});
         });
       }
     }
+    return checkpoints;
+  }
+
+  inline MarketDataRegistry::SecurityEntries&
+      MarketDataRegistry::GetSecurityEntries(const Security& security) {
+    return m_securityEntries[GetShard(security)];
+  }
+
+  template<typename T, typename F>
+  boost::optional<std::vector<Beam::Queries::SequencedValue<T>>>
+      MarketDataRegistry::LoadRecent(const Security& security,
+        const SecurityMarketDataQuery& query, F&& getBuffer) {
+    if(m_recentTickCount == 0) {
+      return boost::none;
+    }
+    auto entry = GetSecurityEntries(security).Find(security);
+    if(!entry || !(*entry)->IsAvailable()) {
+      return boost::none;
+    }
+    auto filter = Beam::Queries::Translate<Queries::EvaluatorTranslator>(
+      query.GetFilter());
+    return Beam::Threading::With(***entry, [&] (auto& entry) {
+      return getBuffer(entry).Load(query, *filter);
+    });
   }
 
   template<typename DataStore>
@@ -428,7 +633,7 @@ namespace Details {
         security.GetCountry() == CountryCode::NONE) {
       return boost::none;
     }
-    auto entry = m_securityEntries.GetOrInsert(security, [&] {
+    auto entry = GetSecurityEntries(security).GetOrInsert(security, [&] {
       return std::make_shared<
         Beam::Remote<SyncSecurityEntry, Beam::Threading::Mutex>>(
           [&] (auto& entry) {
@@ -437,7 +642,8 @@ namespace Details {
               sanitizedSecurity);
             auto closePrice = Details::LoadClosePrice(sanitizedSecurity,
               dataStore);
-            entry.emplace(sanitizedSecurity, closePrice, initialSequences);
+            entry.emplace(sanitizedSecurity, closePrice, initialSequences,
+              m_recentTickCount);
           });
     });
     return **entry;
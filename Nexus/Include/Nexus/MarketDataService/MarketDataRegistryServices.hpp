@@ -180,7 +180,34 @@ namespace Nexus::MarketDataService {
      */
     (EndTimeAndSaleQueryMessage,
       "Nexus.MarketDataService.EndTimeAndSaleQueryMessage", Security, security,
-      int, id));
+      int, id),
+
+    /**
+     * Opts into or out of conflating a real-time BboQuote query's updates
+     * whenever the client falls behind.
+     * @param security The Security that was queried.
+     * @param is_conflated Whether the query's updates may be conflated.
+     */
+    (ConflateBboQuoteQueryMessage,
+      "Nexus.MarketDataService.ConflateBboQuoteQueryMessage", Security,
+      security, bool, is_conflated),
+
+    /**
+     * Opts into or out of conflating a real-time BookQuote query's updates
+     * whenever the client falls behind.
+     * @param security The Security that was queried.
+     * @param is_conflated Whether the query's updates may be conflated.
+     */
+    (ConflateBookQuoteQueryMessage,
+      "Nexus.MarketDataService.ConflateBookQuoteQueryMessage", Security,
+      security, bool, is_conflated),
+
+    /**
+     * Indicates whether the updates sent to a client are being conflated.
+     * @param is_conflated Whether subsequent updates may be conflated.
+     */
+    (ConflationMessage, "Nexus.MarketDataService.ConflationMessage", bool,
+      is_conflated));
 
   /**
    * Returns the type of Service Message used to publish an update to a market
@@ -412,7 +412,11 @@ namespace Nexus::MarketDataService {
     auto result = BboQuoteQueryResult();
     result.m_queryId = m_bboQuoteSubscriptions.Initialize(security,
       request.GetClient(), query.GetRange(), std::move(filter));
-    result.m_snapshot = m_dataStore->LoadBboQuotes(query);
+    if(auto recent = m_registry->LoadRecentBboQuotes(security, query)) {
+      result.m_snapshot = std::move(*recent);
+    } else {
+      result.m_snapshot = m_dataStore->LoadBboQuotes(query);
+    }
     m_bboQuoteSubscriptions.Commit(security, std::move(result),
       [&] (const auto& result) {
         request.SetResult(result);
@@ -446,7 +450,11 @@ namespace Nexus::MarketDataService {
     auto result = BookQuoteQueryResult();
     result.m_queryId = m_bookQuoteSubscriptions.Initialize(security,
       request.GetClient(), query.GetRange(), std::move(filter));
-    result.m_snapshot = m_dataStore->LoadBookQuotes(query);
+    if(auto recent = m_registry->LoadRecentBookQuotes(security, query)) {
+      result.m_snapshot = std::move(*recent);
+    } else {
+      result.m_snapshot = m_dataStore->LoadBookQuotes(query);
+    }
     m_bookQuoteSubscriptions.Commit(security, std::move(result),
       [&] (const auto& result) {
         request.SetResult(result);
@@ -480,7 +488,11 @@ namespace Nexus::MarketDataService {
     auto result = MarketQuoteQueryResult();
     result.m_queryId = m_marketQuoteSubscriptions.Initialize(security,
       request.GetClient(), query.GetRange(), std::move(filter));
-    result.m_snapshot = m_dataStore->LoadMarketQuotes(query);
+    if(auto recent = m_registry->LoadRecentMarketQuotes(security, query)) {
+      result.m_snapshot = std::move(*recent);
+    } else {
+      result.m_snapshot = m_dataStore->LoadMarketQuotes(query);
+    }
     m_marketQuoteSubscriptions.Commit(security, std::move(result),
       [&] (const auto& result) {
         request.SetResult(result);
@@ -514,7 +526,11 @@ namespace Nexus::MarketDataService {
     auto result = TimeAndSaleQueryResult();
     result.m_queryId = m_timeAndSaleSubscriptions.Initialize(security,
       request.GetClient(), query.GetRange(), std::move(filter));
-    result.m_snapshot = m_dataStore->LoadTimeAndSales(query);
+    if(auto recent = m_registry->LoadRecentTimeAndSales(security, query)) {
+      result.m_snapshot = std::move(*recent);
+    } else {
+      result.m_snapshot = m_dataStore->LoadTimeAndSales(query);
+    }
     m_timeAndSaleSubscriptions.Commit(security, std::move(result),
       [&] (const auto& result) {
         request.SetResult(result);
@@ -1,7 +1,13 @@
 #ifndef NEXUS_MARKET_DATA_RELAY_SERVLET_HPP
 #define NEXUS_MARKET_DATA_RELAY_SERVLET_HPP
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <functional>
+#include <memory>
+#include <unordered_set>
 #include <vector>
+#include <Beam/Collections/SynchronizedMap.hpp>
 #include <Beam/Collections/SynchronizedSet.hpp>
 #include <Beam/IO/OpenState.hpp>
 #include <Beam/Pointers/Dereference.hpp>
@@ -10,8 +16,14 @@
 #include <Beam/Queues/RoutineTaskQueue.hpp>
 #include <Beam/Routines/RoutineHandlerGroup.hpp>
 #include <Beam/Services/ServiceProtocolServlet.hpp>
+#include <Beam/Threading/ConditionVariable.hpp>
+#include <Beam/Threading/Mutex.hpp>
 #include <Beam/Utilities/ResourcePool.hpp>
+#include <Beam/Utilities/VariantLambdaVisitor.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/variant/variant.hpp>
 #include "Nexus/AdministrationService/AdministrationClient.hpp"
+#include "Nexus/MarketDataService/ConflationQueue.hpp"
 #include "Nexus/MarketDataService/EntitlementDatabase.hpp"
 #include "Nexus/MarketDataService/MarketDataClientUtilities.hpp"
 #include "Nexus/MarketDataService/MarketDataRegistryServices.hpp"
@@ -24,7 +36,19 @@
 namespace Nexus::MarketDataService {
 
   /**
-   * Implements a relay servlet for querying market data.
+   * Implements a relay servlet for querying market data. Clients may opt into
+   * conflating their real-time BboQuote and BookQuote queries, in which case
+   * those updates are delivered through a per-client ConflationQueue that
+   * bounds the backlog of a client that falls behind. A query stops being
+   * conflated when the client opts out, ends the query or disconnects. On
+   * opting out, the query's pending updates are sent before any update is
+   * delivered directly, on ending the query they are discarded.
+   * SecuritySnapshots are loaded through a single upstream request shared by
+   * all concurrent requests for the same Security, and are cached for
+   * Securities whose real-time data is already relayed, in which case the
+   * cached snapshot is kept current by that real-time data. Other Securities
+   * are dropped from the cache once their load completes, so the cache never
+   * grows beyond the Securities being relayed.
    * @param C container instantiating this servlet.
    * @param M The type of MarketDataClient connected to the source providing
    *          market data queries.
@@ -50,7 +74,14 @@ namespace Nexus::MarketDataService {
         std::function<std::unique_ptr<MarketDataClient> ()>;
 
       /**
-       * Constructs a MarketDataRelayServlet.
+       * The default number of pending updates at which a client's conflated
+       * queries begin to be conflated.
+       */
+      static constexpr auto DEFAULT_CONFLATION_THRESHOLD = std::size_t(1000);
+
+      /**
+       * Constructs a MarketDataRelayServlet using the default conflation
+       * threshold.
        * @param clientTimeout The amount of time to wait before building another
        *        MarketDataClient.
        * @param marketDataClientBuilder Constructs MarketDataClients used to
@@ -67,6 +98,26 @@ namespace Nexus::MarketDataService {
         std::size_t minMarketDataClients, std::size_t maxMarketDataClients,
         AF&& administrationClient);
 
+      /**
+       * Constructs a MarketDataRelayServlet.
+       * @param clientTimeout The amount of time to wait before building another
+       *        MarketDataClient.
+       * @param marketDataClientBuilder Constructs MarketDataClients used to
+       *        distribute queries.
+       * @param minMarketDataClients The minimum number of MarketDataClients to
+       *        pool.
+       * @param maxMarketDataClients The maximum number of MarketDataClients to
+       *        pool.
+       * @param administrationClient Used to check for entitlements.
+       * @param conflationThreshold The number of pending updates at which a
+       *        client's conflated queries begin to be conflated.
+       */
+      template<typename AF>
+      MarketDataRelayServlet(boost::posix_time::time_duration clientTimeout,
+        MarketDataClientBuilder marketDataClientBuilder,
+        std::size_t minMarketDataClients, std::size_t maxMarketDataClients,
+        AF&& administrationClient, std::size_t conflationThreshold);
+
       void RegisterServices(
         Beam::Out<Beam::Services::ServiceSlots<ServiceProtocolClient>> slots);
 
@@ -83,6 +134,35 @@ namespace Nexus::MarketDataService {
 
         RealTimeQueryEntry(std::unique_ptr<MarketDataClient> marketDataClient);
       };
+      struct ConflatedClient {
+        Beam::Threading::Mutex m_sendMutex;
+        Beam::Threading::Mutex m_mutex;
+        ConflationQueue m_queue;
+        std::unordered_set<Security> m_bboQuotes;
+        std::unordered_set<Security> m_bookQuotes;
+        bool m_isDraining;
+        bool m_isConflated;
+        bool m_isClosed;
+        Beam::RoutineTaskQueue m_tasks;
+
+        ConflatedClient(std::size_t threshold);
+      };
+      using SnapshotUpdate = boost::variant<SequencedBboQuote,
+        SequencedBookQuote, SequencedMarketQuote, SequencedTimeAndSale>;
+      struct SnapshotLoad {
+        bool m_isDone;
+        SecuritySnapshot m_snapshot;
+        std::exception_ptr m_exception;
+        std::vector<SnapshotUpdate> m_updates;
+
+        SnapshotLoad();
+      };
+      struct SnapshotEntry {
+        Beam::Threading::Mutex m_mutex;
+        Beam::Threading::ConditionVariable m_isLoadedCondition;
+        boost::optional<SecuritySnapshot> m_snapshot;
+        std::shared_ptr<SnapshotLoad> m_load;
+      };
       template<typename T>
       using MarketSubscriptions = Beam::Queries::IndexedSubscriptions<
         T, MarketCode, ServiceProtocolClient>;
@@ -108,6 +188,12 @@ namespace Nexus::MarketDataService {
         m_marketDataClients;
       Beam::GetOptionalLocalPtr<A> m_administrationClient;
       EntitlementDatabase m_entitlementDatabase;
+      std::size_t m_conflationThreshold;
+      std::atomic_bool m_hasConflatedClients;
+      Beam::SynchronizedUnorderedMap<ServiceProtocolClient*,
+        std::shared_ptr<ConflatedClient>> m_conflatedClients;
+      Beam::SynchronizedUnorderedMap<Security, std::shared_ptr<SnapshotEntry>>
+        m_snapshots;
       Beam::IO::OpenState m_openState;
       std::vector<std::unique_ptr<RealTimeQueryEntry>> m_realTimeQueryEntries;
 
@@ -126,6 +212,12 @@ namespace Nexus::MarketDataService {
       void OnEndQuery(ServiceProtocolClient& client,
         const typename Subscriptions::Index& index, int id,
         Subscriptions& subscriptions);
+      bool IsSnapshotCurrent(const Security& security);
+      SecuritySnapshot LoadSecuritySnapshot(const Security& security);
+      void UpdateSnapshot(const Security& security,
+        const SnapshotUpdate& update);
+      static void Apply(SecuritySnapshot& snapshot,
+        const SnapshotUpdate& update);
       SecuritySnapshot OnLoadSecuritySnapshot(ServiceProtocolClient& client,
         const Security& security);
       SecurityTechnicals OnLoadSecurityTechnicals(ServiceProtocolClient& client,
@@ -134,6 +226,17 @@ namespace Nexus::MarketDataService {
         ServiceProtocolClient& client, const SecurityInfoQuery& query);
       std::vector<SecurityInfo> OnLoadSecurityInfoFromPrefix(
         ServiceProtocolClient& client, const std::string& prefix);
+      void OnConflateQuery(ServiceProtocolClient& client,
+        const Security& security, bool isConflated, MarketDataType type);
+      void RemoveConflation(ServiceProtocolClient& client,
+        const Security& security, MarketDataType type, bool isFlushed);
+      void Shutdown(ConflatedClient& conflatedClient);
+      template<typename Message, typename Clients, typename Value>
+      void Broadcast(const Clients& clients, const Value& value);
+      template<typename Value>
+      bool Conflate(ServiceProtocolClient& client, const Value& value);
+      void Drain(ServiceProtocolClient& client,
+        const std::shared_ptr<ConflatedClient>& conflatedClient);
       template<typename Index, typename Value, typename Subscriptions>
       std::enable_if_t<!std::is_same_v<Value, SequencedBookQuote>>
         OnRealTimeUpdate(const Index& index, const Value& value,
@@ -160,17 +263,43 @@ namespace Nexus::MarketDataService {
     std::unique_ptr<MarketDataClient> marketDataClient)
     : m_marketDataClient(std::move(marketDataClient)) {}
 
+  template<typename C, typename M, typename A>
+  MarketDataRelayServlet<C, M, A>::SnapshotLoad::SnapshotLoad()
+    : m_isDone(false) {}
+
+  template<typename C, typename M, typename A>
+  MarketDataRelayServlet<C, M, A>::ConflatedClient::ConflatedClient(
+    std::size_t threshold)
+    : m_queue(threshold),
+      m_isDraining(false),
+      m_isConflated(false),
+      m_isClosed(false) {}
+
+  template<typename C, typename M, typename A>
+  template<typename AF>
+  MarketDataRelayServlet<C, M, A>::MarketDataRelayServlet(
+    boost::posix_time::time_duration clientTimeout,
+    MarketDataClientBuilder marketDataClientBuilder,
+    std::size_t minMarketDataClients, std::size_t maxMarketDataClients,
+    AF&& administrationClient)
+    : MarketDataRelayServlet(clientTimeout, std::move(marketDataClientBuilder),
+        minMarketDataClients, maxMarketDataClients,
+        std::forward<AF>(administrationClient),
+        DEFAULT_CONFLATION_THRESHOLD) {}
+
   template<typename C, typename M, typename A>
   template<typename AF>
   MarketDataRelayServlet<C, M, A>::MarketDataRelayServlet(
       boost::posix_time::time_duration clientTimeout,
       MarketDataClientBuilder marketDataClientBuilder,
       std::size_t minMarketDataClients, std::size_t maxMarketDataClients,
-      AF&& administrationClient)
+      AF&& administrationClient, std::size_t conflationThreshold)
       : m_marketDataClients(clientTimeout, marketDataClientBuilder,
           minMarketDataClients, maxMarketDataClients),
         m_administrationClient(std::forward<AF>(administrationClient)),
-        m_entitlementDatabase(m_administrationClient->LoadEntitlements()) {
+        m_entitlementDatabase(m_administrationClient->LoadEntitlements()),
+        m_conflationThreshold(conflationThreshold),
+        m_hasConflatedClients(false) {
     for(auto i = std::size_t(0); i < boost::thread::hardware_concurrency();
         ++i) {
       m_realTimeQueryEntries.emplace_back(
@@ -239,6 +368,14 @@ namespace Nexus::MarketDataService {
         &MarketDataRelayServlet::OnEndQuery<SecuritySubscriptions<TimeAndSale>>,
         this, std::placeholders::_1, std::placeholders::_2,
         std::placeholders::_3, std::ref(m_timeAndSaleSubscriptions)));
+    Beam::Services::AddMessageSlot<ConflateBboQuoteQueryMessage>(Store(slots),
+      std::bind(&MarketDataRelayServlet::OnConflateQuery, this,
+        std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
+        MarketDataType::BBO_QUOTE));
+    Beam::Services::AddMessageSlot<ConflateBookQuoteQueryMessage>(Store(slots),
+      std::bind(&MarketDataRelayServlet::OnConflateQuery, this,
+        std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
+        MarketDataType::BOOK_QUOTE));
     LoadSecuritySnapshotService::AddSlot(Store(slots),
       std::bind(&MarketDataRelayServlet::OnLoadSecuritySnapshot, this,
         std::placeholders::_1, std::placeholders::_2));
@@ -282,6 +419,10 @@ namespace Nexus::MarketDataService {
     m_marketQuoteSubscriptions.RemoveAll(client);
     m_bookQuoteSubscriptions.RemoveAll(client);
     m_timeAndSaleSubscriptions.RemoveAll(client);
+    if(auto conflatedClient = m_conflatedClients.FindValue(&client)) {
+      m_conflatedClients.Erase(&client);
+      Shutdown(**conflatedClient);
+    }
   }
 
   template<typename C, typename M, typename A>
@@ -308,6 +449,11 @@ namespace Nexus::MarketDataService {
       });
     }
     closeGroup.Wait();
+    m_conflatedClients.With([&] (auto& conflatedClients) {
+      for(auto& conflatedClient : conflatedClients) {
+        Shutdown(*conflatedClient.second);
+      }
+    });
     m_openState.Close();
   }
 
@@ -419,14 +565,146 @@ namespace Nexus::MarketDataService {
       ServiceProtocolClient& client, const typename Subscriptions::Index& index,
       int id, Subscriptions& subscriptions) {
     subscriptions.End(index, id);
+    if constexpr(std::is_same_v<Subscriptions,
+        SecuritySubscriptions<BboQuote>>) {
+      RemoveConflation(client, index, MarketDataType::BBO_QUOTE, false);
+    } else if constexpr(std::is_same_v<Subscriptions,
+        SecuritySubscriptions<BookQuote>>) {
+      RemoveConflation(client, index, MarketDataType::BOOK_QUOTE, false);
+    }
+  }
+
+  template<typename C, typename M, typename A>
+  bool MarketDataRelayServlet<C, M, A>::IsSnapshotCurrent(
+      const Security& security) {
+    return m_bboQuoteRealTimeSubscriptions.Contains(security) &&
+      m_bookQuoteRealTimeSubscriptions.Contains(security) &&
+      m_marketQuoteRealTimeSubscriptions.Contains(security) &&
+      m_timeAndSaleRealTimeSubscriptions.Contains(security);
+  }
+
+  template<typename C, typename M, typename A>
+  SecuritySnapshot MarketDataRelayServlet<C, M, A>::LoadSecuritySnapshot(
+      const Security& security) {
+    auto entry = m_snapshots.GetOrInsert(security, [] {
+      return std::make_shared<SnapshotEntry>();
+    });
+    auto lock = boost::unique_lock(entry->m_mutex);
+    if(entry->m_snapshot) {
+      return *entry->m_snapshot;
+    }
+    if(auto load = entry->m_load) {
+      while(!load->m_isDone) {
+        entry->m_isLoadedCondition.wait(lock);
+      }
+      if(load->m_exception) {
+        std::rethrow_exception(load->m_exception);
+      }
+      return load->m_snapshot;
+    }
+    auto load = std::make_shared<SnapshotLoad>();
+    entry->m_load = load;
+    auto isCurrent = IsSnapshotCurrent(security);
+    lock.unlock();
+    try {
+      auto marketDataClient = m_marketDataClients.Acquire();
+      load->m_snapshot = marketDataClient->LoadSecuritySnapshot(security);
+    } catch(const std::exception&) {
+      load->m_exception = std::current_exception();
+    }
+    lock.lock();
+    if(!load->m_exception) {
+      for(auto& update : load->m_updates) {
+        Apply(load->m_snapshot, update);
+      }
+      if(isCurrent) {
+        entry->m_snapshot = load->m_snapshot;
+      }
+    }
+    load->m_updates.clear();
+    load->m_isDone = true;
+    entry->m_load = nullptr;
+    entry->m_isLoadedCondition.notify_all();
+    if(!entry->m_snapshot) {
+      m_snapshots.With([&] (auto& snapshots) {
+        auto i = snapshots.find(security);
+        if(i != snapshots.end() && i->second == entry) {
+          snapshots.erase(i);
+        }
+      });
+    }
+    if(load->m_exception) {
+      std::rethrow_exception(load->m_exception);
+    }
+    return load->m_snapshot;
+  }
+
+  template<typename C, typename M, typename A>
+  void MarketDataRelayServlet<C, M, A>::UpdateSnapshot(
+      const Security& security, const SnapshotUpdate& update) {
+    auto entry = m_snapshots.FindValue(security);
+    if(!entry) {
+      return;
+    }
+    auto lock = boost::lock_guard((*entry)->m_mutex);
+    if((*entry)->m_snapshot) {
+      Apply(*(*entry)->m_snapshot, update);
+    }
+    if((*entry)->m_load) {
+      (*entry)->m_load->m_updates.push_back(update);
+    }
+  }
+
+  template<typename C, typename M, typename A>
+  void MarketDataRelayServlet<C, M, A>::Apply(SecuritySnapshot& snapshot,
+      const SnapshotUpdate& update) {
+    auto visitor = Beam::MakeVariantLambdaVisitor<void>(
+      [&] (const SequencedBboQuote& bboQuote) {
+        if(bboQuote.GetSequence() > snapshot.m_bboQuote.GetSequence()) {
+          snapshot.m_bboQuote = bboQuote;
+        }
+      },
+      [&] (const SequencedBookQuote& bookQuote) {
+        auto& book = Pick(bookQuote->m_quote.m_side, snapshot.m_askBook,
+          snapshot.m_bidBook);
+        auto level = std::lower_bound(book.begin(), book.end(), bookQuote,
+          [] (const auto& lhs, const auto& rhs) {
+            return BookQuoteListingComparator(*lhs, *rhs);
+          });
+        auto isMatch = level != book.end() &&
+          (*level)->m_quote.m_price == bookQuote->m_quote.m_price &&
+          (*level)->m_mpid == bookQuote->m_mpid;
+        if(!isMatch) {
+          if(bookQuote->m_quote.m_size > 0) {
+            book.insert(level, bookQuote);
+          }
+        } else if(bookQuote.GetSequence() > level->GetSequence()) {
+          if(bookQuote->m_quote.m_size > 0) {
+            *level = bookQuote;
+          } else {
+            book.erase(level);
+          }
+        }
+      },
+      [&] (const SequencedMarketQuote& marketQuote) {
+        auto& entry = snapshot.m_marketQuotes[marketQuote->m_market];
+        if(marketQuote.GetSequence() > entry.GetSequence()) {
+          entry = marketQuote;
+        }
+      },
+      [&] (const SequencedTimeAndSale& timeAndSale) {
+        if(timeAndSale.GetSequence() > snapshot.m_timeAndSale.GetSequence()) {
+          snapshot.m_timeAndSale = timeAndSale;
+        }
+      });
+    boost::apply_visitor(visitor, update);
   }
 
   template<typename C, typename M, typename A>
   SecuritySnapshot MarketDataRelayServlet<C, M, A>::OnLoadSecuritySnapshot(
       ServiceProtocolClient& client, const Security& security) {
     auto& session = client.GetSession();
-    auto marketDataClient = m_marketDataClients.Acquire();
-    auto securitySnapshot = marketDataClient->LoadSecuritySnapshot(security);
+    auto securitySnapshot = LoadSecuritySnapshot(security);
     if(!HasEntitlement(session, security.GetMarket(),
         MarketDataType::BBO_QUOTE)) {
       securitySnapshot.m_bboQuote = SequencedBboQuote();
@@ -481,16 +759,196 @@ namespace Nexus::MarketDataService {
     return marketDataClient->LoadSecurityInfoFromPrefix(prefix);
   }
 
+  template<typename C, typename M, typename A>
+  void MarketDataRelayServlet<C, M, A>::OnConflateQuery(
+      ServiceProtocolClient& client, const Security& security,
+      bool isConflated, MarketDataType type) {
+    if(!isConflated) {
+      RemoveConflation(client, security, type, true);
+      return;
+    }
+    auto conflatedClient = m_conflatedClients.GetOrInsert(&client, [&] {
+      return std::make_shared<ConflatedClient>(m_conflationThreshold);
+    });
+    {
+      auto lock = boost::lock_guard(conflatedClient->m_mutex);
+      if(type == MarketDataType::BBO_QUOTE) {
+        conflatedClient->m_bboQuotes.insert(security);
+      } else {
+        conflatedClient->m_bookQuotes.insert(security);
+      }
+    }
+    m_hasConflatedClients = true;
+  }
+
+  template<typename C, typename M, typename A>
+  void MarketDataRelayServlet<C, M, A>::RemoveConflation(
+      ServiceProtocolClient& client, const Security& security,
+      MarketDataType type, bool isFlushed) {
+    auto conflatedClient = m_conflatedClients.FindValue(&client);
+    if(!conflatedClient) {
+      return;
+    }
+    {
+      auto sendLock = boost::lock_guard((*conflatedClient)->m_sendMutex);
+      auto lock = boost::lock_guard((*conflatedClient)->m_mutex);
+      auto& queue = (*conflatedClient)->m_queue;
+      auto bboQuotes = std::vector<SequencedSecurityBboQuote>();
+      auto bookQuotes = std::vector<SequencedSecurityBookQuote>();
+      if(type == MarketDataType::BBO_QUOTE) {
+        (*conflatedClient)->m_bboQuotes.erase(security);
+        bboQuotes = queue.RemoveBboQuotes(security);
+      } else {
+        (*conflatedClient)->m_bookQuotes.erase(security);
+        bookQuotes = queue.RemoveBookQuotes(security);
+      }
+      if(isFlushed) {
+        try {
+          for(auto& bboQuote : bboQuotes) {
+            Beam::Services::SendRecordMessage<BboQuoteMessage>(client,
+              bboQuote);
+          }
+          for(auto& bookQuote : bookQuotes) {
+            Beam::Services::SendRecordMessage<BookQuoteMessage>(client,
+              bookQuote);
+          }
+        } catch(const std::exception&) {}
+      }
+      if(!(*conflatedClient)->m_bboQuotes.empty() ||
+          !(*conflatedClient)->m_bookQuotes.empty()) {
+        return;
+      }
+    }
+    m_conflatedClients.Erase(&client);
+    Shutdown(**conflatedClient);
+  }
+
+  template<typename C, typename M, typename A>
+  void MarketDataRelayServlet<C, M, A>::Shutdown(
+      ConflatedClient& conflatedClient) {
+    {
+      auto lock = boost::lock_guard(conflatedClient.m_mutex);
+      conflatedClient.m_isClosed = true;
+    }
+    conflatedClient.m_tasks.Break();
+    conflatedClient.m_tasks.Wait();
+  }
+
+  template<typename C, typename M, typename A>
+  template<typename Message, typename Clients, typename Value>
+  void MarketDataRelayServlet<C, M, A>::Broadcast(const Clients& clients,
+      const Value& value) {
+    if(!m_hasConflatedClients) {
+      Beam::Services::BroadcastRecordMessage<Message>(clients, value);
+      return;
+    }
+    auto directClients = std::vector<ServiceProtocolClient*>();
+    for(auto& client : clients) {
+      if(!Conflate(*client, value)) {
+        directClients.push_back(client);
+      }
+    }
+    Beam::Services::BroadcastRecordMessage<Message>(directClients, value);
+  }
+
+  template<typename C, typename M, typename A>
+  template<typename Value>
+  bool MarketDataRelayServlet<C, M, A>::Conflate(
+      ServiceProtocolClient& client, const Value& value) {
+    auto conflatedClient = m_conflatedClients.FindValue(&client);
+    if(!conflatedClient) {
+      return false;
+    }
+    auto lock = boost::lock_guard((*conflatedClient)->m_mutex);
+    if((*conflatedClient)->m_isClosed) {
+      return false;
+    }
+    auto& securities = [&] () -> auto& {
+      if constexpr(std::is_same_v<Value, SequencedSecurityBookQuote>) {
+        return (*conflatedClient)->m_bookQuotes;
+      } else {
+        return (*conflatedClient)->m_bboQuotes;
+      }
+    }();
+    if(securities.count(value->GetIndex()) == 0) {
+      return false;
+    }
+    (*conflatedClient)->m_queue.Push(value);
+    if((*conflatedClient)->m_isDraining) {
+      return true;
+    }
+    (*conflatedClient)->m_isDraining = true;
+    (*conflatedClient)->m_tasks.Push(
+      [=, &client, conflatedClient = *conflatedClient] {
+        Drain(client, conflatedClient);
+      });
+    return true;
+  }
+
+  template<typename C, typename M, typename A>
+  void MarketDataRelayServlet<C, M, A>::Drain(ServiceProtocolClient& client,
+      const std::shared_ptr<ConflatedClient>& conflatedClient) {
+    auto visitor = Beam::MakeVariantLambdaVisitor<void>(
+      [&] (const SequencedSecurityBboQuote& bboQuote) {
+        Beam::Services::SendRecordMessage<BboQuoteMessage>(client, bboQuote);
+      },
+      [&] (const SequencedSecurityBookQuote& bookQuote) {
+        Beam::Services::SendRecordMessage<BookQuoteMessage>(client, bookQuote);
+      });
+    while(true) {
+      auto sendLock = boost::lock_guard(conflatedClient->m_sendMutex);
+      auto update = boost::optional<ConflationQueue::Update>();
+      auto isConflated = boost::optional<bool>();
+      {
+        auto lock = boost::lock_guard(conflatedClient->m_mutex);
+        if(conflatedClient->m_isClosed) {
+          return;
+        }
+        auto isConflating = conflatedClient->m_queue.IsConflating();
+        if(isConflating != conflatedClient->m_isConflated) {
+          conflatedClient->m_isConflated = isConflating;
+          isConflated = isConflating;
+        }
+        update = conflatedClient->m_queue.Pop();
+        if(!update && !isConflated) {
+          conflatedClient->m_isDraining = false;
+          return;
+        }
+      }
+      try {
+        if(isConflated) {
+          Beam::Services::SendRecordMessage<ConflationMessage>(client,
+            *isConflated);
+        }
+        if(update) {
+          boost::apply_visitor(visitor, *update);
+        }
+      } catch(const std::exception&) {
+        auto lock = boost::lock_guard(conflatedClient->m_mutex);
+        conflatedClient->m_isDraining = false;
+        return;
+      }
+    }
+  }
+
   template<typename C, typename M, typename A>
   template<typename Index, typename Value, typename Subscriptions>
   std::enable_if_t<!std::is_same_v<Value, SequencedBookQuote>>
       MarketDataRelayServlet<C, M, A>::OnRealTimeUpdate(const Index& index,
         const Value& value, Subscriptions& subscriptions) {
+    if constexpr(std::is_same_v<Index, Security>) {
+      UpdateSnapshot(index, value);
+    }
     auto indexedValue = Beam::Queries::SequencedValue(
       Beam::Queries::IndexedValue(*value, index), value.GetSequence());
     subscriptions.Publish(indexedValue, [&] (auto& clients) {
-      Beam::Services::BroadcastRecordMessage<
-        GetMarketDataMessageType<typename Value::Value>>(clients, indexedValue);
+      if constexpr(std::is_same_v<Value, SequencedBboQuote>) {
+        Broadcast<BboQuoteMessage>(clients, indexedValue);
+      } else {
+        Beam::Services::BroadcastRecordMessage<
+          GetMarketDataMessageType<typename Value::Value>>(clients,
+            indexedValue);
+      }
     });
   }
 
@@ -499,6 +957,7 @@ namespace Nexus::MarketDataService {
   std::enable_if_t<std::is_same_v<Value, SequencedBookQuote>>
       MarketDataRelayServlet<C, M, A>::OnRealTimeUpdate(const Index& index,
         const Value& value, Subscriptions& subscriptions) {
+    UpdateSnapshot(index, value);
     auto key = EntitlementKey{index.GetMarket(), value.GetValue().m_market};
     auto indexedValue = Beam::Queries::SequencedValue(
       Beam::Queries::IndexedValue(*value, index), value.GetSequence());
@@ -508,9 +967,7 @@ namespace Nexus::MarketDataService {
           MarketDataType::BOOK_QUOTE);
       },
       [&] (auto& clients) {
-        Beam::Services::BroadcastRecordMessage<
-          GetMarketDataMessageType<typename Value::Value>>(
-            clients, indexedValue);
+        Broadcast<BookQuoteMessage>(clients, indexedValue);
       });
   }
 }
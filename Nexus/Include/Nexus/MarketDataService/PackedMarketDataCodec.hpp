@@ -0,0 +1,563 @@
+#ifndef NEXUS_PACKED_MARKET_DATA_CODEC_HPP
+#define NEXUS_PACKED_MARKET_DATA_CODEC_HPP
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <Beam/Serialization/SerializationException.hpp>
+#include <Beam/Utilities/VariantLambdaVisitor.hpp>
+#include <boost/date_time/gregorian/gregorian.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/throw_exception.hpp>
+#include "Nexus/MarketDataService/MarketDataFeedServices.hpp"
+
+namespace Nexus::MarketDataService {
+namespace Details {
+  enum class PackedRecord : std::uint8_t {
+    STRING,
+    SECURITY,
+    BBO_QUOTE,
+    BOOK_QUOTE,
+    MARKET_QUOTE,
+    TIME_AND_SALE,
+    ORDER_IMBALANCE
+  };
+
+  inline void AppendPackedVarint(std::string& out, std::uint64_t value) {
+    while(value >= 0x80) {
+      out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+  }
+
+  inline std::uint64_t ReadPackedVarint(const char*& cursor, const char* end) {
+    auto value = std::uint64_t(0);
+    auto shift = 0;
+    while(cursor != end && shift < 64) {
+      auto byte = static_cast<std::uint8_t>(*cursor);
+      ++cursor;
+      value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+      if((byte & 0x80) == 0) {
+        return value;
+      }
+      shift += 7;
+    }
+    BOOST_THROW_EXCEPTION(Beam::Serialization::SerializationException(
+      "Malformed packed market data."));
+  }
+
+  inline std::uint64_t PackedZigZag(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^
+      static_cast<std::uint64_t>(value >> 63);
+  }
+
+  inline std::int64_t PackedUnZigZag(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^
+      -static_cast<std::int64_t>(value & 1);
+  }
+
+  inline bool ToPackedInteger(Quantity value, std::int64_t& integer) {
+    auto representation = value.GetRepresentation();
+#ifdef NEXUS_FIXED_POINT_QUANTITY
+    integer = representation;
+    return representation > -(std::int64_t(1) << 60) &&
+      representation < (std::int64_t(1) << 60);
+#else
+    if(!(std::abs(representation) < 1e18)) {
+      return false;
+    }
+    integer = static_cast<std::int64_t>(std::llround(representation));
+    return static_cast<Quantity::Representation>(integer) == representation;
+#endif
+  }
+
+  inline void AppendPackedRaw(std::string& out, Quantity value) {
+    auto raw = static_cast<double>(value.GetRepresentation());
+    auto bits = std::uint64_t();
+    std::memcpy(&bits, &raw, sizeof(bits));
+    for(auto i = 0; i != 8; ++i) {
+      out.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+    }
+  }
+
+  inline Quantity ReadPackedRaw(const char*& cursor, const char* end) {
+    if(end - cursor < 8) {
+      BOOST_THROW_EXCEPTION(Beam::Serialization::SerializationException(
+        "Malformed packed market data."));
+    }
+    auto bits = std::uint64_t(0);
+    for(auto i = 0; i != 8; ++i) {
+      bits |= static_cast<std::uint64_t>(
+        static_cast<std::uint8_t>(cursor[i])) << (8 * i);
+    }
+    cursor += 8;
+    auto raw = double();
+    std::memcpy(&raw, &bits, sizeof(raw));
+    return Quantity::FromRepresentation(Nexus::Details::ToRepresentation(raw));
+  }
+
+  template<typename T>
+  T ReadPackedEnum(const char*& cursor, const char* end,
+      std::initializer_list<T> values) {
+    auto value = static_cast<std::int64_t>(ReadPackedVarint(cursor, end)) - 1;
+    for(auto candidate : values) {
+      if(static_cast<int>(candidate) == value) {
+        return candidate;
+      }
+    }
+    BOOST_THROW_EXCEPTION(Beam::Serialization::SerializationException(
+      "Malformed packed market data."));
+  }
+}
+
+  /**
+   * Encodes batches of MarketDataFeedMessages into a compact binary stream.
+   * Securities, MPIDs, market codes and market centers are replaced by ids
+   * defined the first time they are encoded, timestamps are written as
+   * microsecond deltas, prices as scaled integer deltas from the previous
+   * price of the same Security, and sizes as scaled integers. Values that
+   * don't fit a scaled integer are written as little-endian doubles. The ids
+   * and deltas carry over from one batch to the next, so every batch produced
+   * by an encoder must be decoded, in order, by a single
+   * PackedMarketDataDecoder.
+   */
+  class PackedMarketDataEncoder {
+    public:
+
+      /** The version of the packed encoding. */
+      static constexpr auto VERSION = 1;
+
+      /** Constructs a PackedMarketDataEncoder. */
+      PackedMarketDataEncoder();
+
+      /**
+       * Encodes a batch of messages.
+       * @param messages The messages to encode.
+       * @return The encoded batch.
+       */
+      std::string Encode(const std::vector<MarketDataFeedMessage>& messages);
+
+      /**
+       * Encodes a batch of messages.
+       * @param messages The messages to encode.
+       * @param out The string to append the encoded batch to.
+       */
+      void Encode(const std::vector<MarketDataFeedMessage>& messages,
+        std::string& out);
+
+    private:
+      struct SecurityEntry {
+        std::uint64_t m_id;
+        std::int64_t m_price;
+      };
+      std::unordered_map<std::string, std::uint64_t> m_strings;
+      std::unordered_map<Security, SecurityEntry> m_securities;
+      std::int64_t m_timestamp;
+
+      std::uint64_t GetStringId(const std::string& value, std::string& out);
+      SecurityEntry& GetSecurity(const Security& security, std::string& out);
+      void AppendTimestamp(boost::posix_time::ptime timestamp,
+        std::string& out);
+      void AppendRecord(Details::PackedRecord record, std::string& out);
+      static void AppendSide(Side side, std::string& out);
+      static void AppendPrice(Money price, std::int64_t& reference,
+        std::string& out);
+      static void AppendQuantity(Quantity quantity, std::string& out);
+  };
+
+  /** Decodes the batches produced by a PackedMarketDataEncoder. */
+  class PackedMarketDataDecoder {
+    public:
+
+      /** Constructs a PackedMarketDataDecoder. */
+      PackedMarketDataDecoder();
+
+      /**
+       * Decodes a batch of messages.
+       * @param data The encoded batch.
+       * @return The decoded messages.
+       */
+      std::vector<MarketDataFeedMessage> Decode(const std::string& data);
+
+      /**
+       * Decodes a batch of messages.
+       * @param data The encoded batch.
+       * @param messages The list to append the decoded messages to.
+       */
+      void Decode(const std::string& data,
+        std::vector<MarketDataFeedMessage>& messages);
+
+    private:
+      struct SecurityEntry {
+        Security m_security;
+        std::int64_t m_price;
+      };
+      std::vector<std::string> m_strings;
+      std::vector<SecurityEntry> m_securities;
+      std::int64_t m_timestamp;
+
+      const std::string& ReadString(const char*& cursor, const char* end);
+      SecurityEntry& ReadSecurity(const char*& cursor, const char* end);
+      boost::posix_time::ptime ReadTimestamp(const char*& cursor,
+        const char* end);
+      static Side ReadSide(const char*& cursor, const char* end);
+      static Money ReadPrice(std::int64_t& reference, const char*& cursor,
+        const char* end);
+      static Quantity ReadQuantity(const char*& cursor, const char* end);
+  };
+
+  inline PackedMarketDataEncoder::PackedMarketDataEncoder()
+    : m_timestamp(0) {}
+
+  inline std::string PackedMarketDataEncoder::Encode(
+      const std::vector<MarketDataFeedMessage>& messages) {
+    auto out = std::string();
+    Encode(messages, out);
+    return out;
+  }
+
+  inline void PackedMarketDataEncoder::Encode(
+      const std::vector<MarketDataFeedMessage>& messages, std::string& out) {
+    auto visitor = Beam::MakeVariantLambdaVisitor<void>(
+      [&] (const SecurityBboQuote& bboQuote) {
+        auto& security = GetSecurity(bboQuote.GetIndex(), out);
+        AppendRecord(Details::PackedRecord::BBO_QUOTE, out);
+        Details::AppendPackedVarint(out, security.m_id);
+        AppendPrice(bboQuote->m_bid.m_price, security.m_price, out);
+        AppendQuantity(bboQuote->m_bid.m_size, out);
+        AppendSide(bboQuote->m_bid.m_side, out);
+        AppendPrice(bboQuote->m_ask.m_price, security.m_price, out);
+        AppendQuantity(bboQuote->m_ask.m_size, out);
+        AppendSide(bboQuote->m_ask.m_side, out);
+        AppendTimestamp(bboQuote->m_timestamp, out);
+      },
+      [&] (const SecurityBookQuote& bookQuote) {
+        auto& security = GetSecurity(bookQuote.GetIndex(), out);
+        auto mpid = GetStringId(bookQuote->m_mpid, out);
+        auto market = GetStringId(bookQuote->m_market.GetData(), out);
+        AppendRecord(Details::PackedRecord::BOOK_QUOTE, out);
+        Details::AppendPackedVarint(out, security.m_id);
+        Details::AppendPackedVarint(out, mpid);
+        Details::AppendPackedVarint(out, bookQuote->m_isPrimaryMpid);
+        Details::AppendPackedVarint(out, market);
+        AppendPrice(bookQuote->m_quote.m_price, security.m_price, out);
+        AppendQuantity(bookQuote->m_quote.m_size, out);
+        AppendSide(bookQuote->m_quote.m_side, out);
+        AppendTimestamp(bookQuote->m_timestamp, out);
+      },
+      [&] (const SecurityMarketQuote& marketQuote) {
+        auto& security = GetSecurity(marketQuote.GetIndex(), out);
+        auto market = GetStringId(marketQuote->m_market.GetData(), out);
+        AppendRecord(Details::PackedRecord::MARKET_QUOTE, out);
+        Details::AppendPackedVarint(out, security.m_id);
+        Details::AppendPackedVarint(out, market);
+        AppendPrice(marketQuote->m_bid.m_price, security.m_price, out);
+        AppendQuantity(marketQuote->m_bid.m_size, out);
+        AppendSide(marketQuote->m_bid.m_side, out);
+        AppendPrice(marketQuote->m_ask.m_price, security.m_price, out);
+        AppendQuantity(marketQuote->m_ask.m_size, out);
+        AppendSide(marketQuote->m_ask.m_side, out);
+        AppendTimestamp(marketQuote->m_timestamp, out);
+      },
+      [&] (const SecurityTimeAndSale& timeAndSale) {
+        auto& security = GetSecurity(timeAndSale.GetIndex(), out);
+        auto code = GetStringId(timeAndSale->m_condition.m_code, out);
+        auto marketCenter = GetStringId(timeAndSale->m_marketCenter, out);
+        AppendRecord(Details::PackedRecord::TIME_AND_SALE, out);
+        Details::AppendPackedVarint(out, security.m_id);
+        AppendPrice(timeAndSale->m_price, security.m_price, out);
+        AppendQuantity(timeAndSale->m_size, out);
+        Details::AppendPackedVarint(out, static_cast<std::uint64_t>(
+          static_cast<int>(timeAndSale->m_condition.m_type) + 1));
+        Details::AppendPackedVarint(out, code);
+        Details::AppendPackedVarint(out, marketCenter);
+        AppendTimestamp(timeAndSale->m_timestamp, out);
+      },
+      [&] (const MarketOrderImbalance& orderImbalance) {
+        auto market = GetStringId(orderImbalance.GetIndex().GetData(), out);
+        auto& security = GetSecurity(orderImbalance->m_security, out);
+        AppendRecord(Details::PackedRecord::ORDER_IMBALANCE, out);
+        Details::AppendPackedVarint(out, market);
+        Details::AppendPackedVarint(out, security.m_id);
+        AppendSide(orderImbalance->m_side, out);
+        AppendQuantity(orderImbalance->m_size, out);
+        AppendPrice(orderImbalance->m_referencePrice, security.m_price, out);
+        AppendTimestamp(orderImbalance->m_timestamp, out);
+      });
+    for(auto& message : messages) {
+      boost::apply_visitor(visitor, message);
+    }
+  }
+
+  inline std::uint64_t PackedMarketDataEncoder::GetStringId(
+      const std::string& value, std::string& out) {
+    auto id = m_strings.find(value);
+    if(id != m_strings.end()) {
+      return id->second;
+    }
+    AppendRecord(Details::PackedRecord::STRING, out);
+    Details::AppendPackedVarint(out, value.size());
+    out.append(value);
+    return m_strings.emplace(value, m_strings.size()).first->second;
+  }
+
+  inline PackedMarketDataEncoder::SecurityEntry&
+      PackedMarketDataEncoder::GetSecurity(const Security& security,
+        std::string& out) {
+    auto entry = m_securities.find(security);
+    if(entry != m_securities.end()) {
+      return entry->second;
+    }
+    auto symbol = GetStringId(security.GetSymbol(), out);
+    auto market = GetStringId(security.GetMarket().GetData(), out);
+    AppendRecord(Details::PackedRecord::SECURITY, out);
+    Details::AppendPackedVarint(out, symbol);
+    Details::AppendPackedVarint(out, market);
+    Details::AppendPackedVarint(out,
+      static_cast<std::uint16_t>(security.GetCountry()));
+    return m_securities.emplace(security,
+      SecurityEntry{m_securities.size(), 0}).first->second;
+  }
+
+  inline void PackedMarketDataEncoder::AppendTimestamp(
+      boost::posix_time::ptime timestamp, std::string& out) {
+    if(timestamp.is_special()) {
+      auto code = [&] {
+        if(timestamp.is_neg_infinity()) {
+          return 1;
+        } else if(timestamp.is_pos_infinity()) {
+          return 2;
+        }
+        return 0;
+      }();
+      Details::AppendPackedVarint(out, (code << 1) | 1);
+      return;
+    }
+    auto value = (timestamp - boost::posix_time::ptime(
+      boost::gregorian::date(1970, 1, 1))).total_microseconds();
+    Details::AppendPackedVarint(out,
+      Details::PackedZigZag(value - m_timestamp) << 1);
+    m_timestamp = value;
+  }
+
+  inline void PackedMarketDataEncoder::AppendRecord(
+      Details::PackedRecord record, std::string& out) {
+    out.push_back(static_cast<char>(record));
+  }
+
+  inline void PackedMarketDataEncoder::AppendSide(Side side,
+      std::string& out) {
+    Details::AppendPackedVarint(out,
+      static_cast<std::uint64_t>(static_cast<int>(side) + 1));
+  }
+
+  inline void PackedMarketDataEncoder::AppendPrice(Money price,
+      std::int64_t& reference, std::string& out) {
+    auto integer = std::int64_t();
+    if(!Details::ToPackedInteger(static_cast<Quantity>(price), integer)) {
+      Details::AppendPackedVarint(out, 1);
+      Details::AppendPackedRaw(out, static_cast<Quantity>(price));
+      return;
+    }
+    Details::AppendPackedVarint(out,
+      Details::PackedZigZag(integer - reference) << 1);
+    reference = integer;
+  }
+
+  inline void PackedMarketDataEncoder::AppendQuantity(Quantity quantity,
+      std::string& out) {
+    auto integer = std::int64_t();
+    if(!Details::ToPackedInteger(quantity, integer)) {
+      Details::AppendPackedVarint(out, 2);
+      Details::AppendPackedRaw(out, quantity);
+    } else if(integer % Quantity::MULTIPLIER == 0) {
+      Details::AppendPackedVarint(out,
+        Details::PackedZigZag(integer / Quantity::MULTIPLIER) << 2);
+    } else {
+      Details::AppendPackedVarint(out,
+        (Details::PackedZigZag(integer) << 2) | 1);
+    }
+  }
+
+  inline PackedMarketDataDecoder::PackedMarketDataDecoder()
+    : m_timestamp(0) {}
+
+  inline std::vector<MarketDataFeedMessage> PackedMarketDataDecoder::Decode(
+      const std::string& data) {
+    auto messages = std::vector<MarketDataFeedMessage>();
+    Decode(data, messages);
+    return messages;
+  }
+
+  inline void PackedMarketDataDecoder::Decode(const std::string& data,
+      std::vector<MarketDataFeedMessage>& messages) {
+    auto cursor = data.data();
+    auto end = data.data() + data.size();
+    while(cursor != end) {
+      auto record = static_cast<Details::PackedRecord>(*cursor);
+      ++cursor;
+      if(record == Details::PackedRecord::STRING) {
+        auto size = Details::ReadPackedVarint(cursor, end);
+        if(static_cast<std::uint64_t>(end - cursor) < size) {
+          BOOST_THROW_EXCEPTION(Beam::Serialization::SerializationException(
+            "Malformed packed market data."));
+        }
+        m_strings.emplace_back(cursor, size);
+        cursor += size;
+      } else if(record == Details::PackedRecord::SECURITY) {
+        auto& symbol = ReadString(cursor, end);
+        auto& market = ReadString(cursor, end);
+        auto country = CountryCode(
+          static_cast<std::uint16_t>(Details::ReadPackedVarint(cursor, end)));
+        m_securities.push_back(
+          SecurityEntry{Security(symbol, market.c_str(), country), 0});
+      } else if(record == Details::PackedRecord::BBO_QUOTE) {
+        auto& security = ReadSecurity(cursor, end);
+        auto bboQuote = BboQuote();
+        bboQuote.m_bid.m_price = ReadPrice(security.m_price, cursor, end);
+        bboQuote.m_bid.m_size = ReadQuantity(cursor, end);
+        bboQuote.m_bid.m_side = ReadSide(cursor, end);
+        bboQuote.m_ask.m_price = ReadPrice(security.m_price, cursor, end);
+        bboQuote.m_ask.m_size = ReadQuantity(cursor, end);
+        bboQuote.m_ask.m_side = ReadSide(cursor, end);
+        bboQuote.m_timestamp = ReadTimestamp(cursor, end);
+        messages.push_back(SecurityBboQuote(std::move(bboQuote),
+          security.m_security));
+      } else if(record == Details::PackedRecord::BOOK_QUOTE) {
+        auto& security = ReadSecurity(cursor, end);
+        auto bookQuote = BookQuote();
+        bookQuote.m_mpid = ReadString(cursor, end);
+        bookQuote.m_isPrimaryMpid = Details::ReadPackedVarint(cursor, end) != 0;
+        bookQuote.m_market = ReadString(cursor, end).c_str();
+        bookQuote.m_quote.m_price = ReadPrice(security.m_price, cursor, end);
+        bookQuote.m_quote.m_size = ReadQuantity(cursor, end);
+        bookQuote.m_quote.m_side = ReadSide(cursor, end);
+        bookQuote.m_timestamp = ReadTimestamp(cursor, end);
+        messages.push_back(SecurityBookQuote(std::move(bookQuote),
+          security.m_security));
+      } else if(record == Details::PackedRecord::MARKET_QUOTE) {
+        auto& security = ReadSecurity(cursor, end);
+        auto marketQuote = MarketQuote();
+        marketQuote.m_market = ReadString(cursor, end).c_str();
+        marketQuote.m_bid.m_price = ReadPrice(security.m_price, cursor, end);
+        marketQuote.m_bid.m_size = ReadQuantity(cursor, end);
+        marketQuote.m_bid.m_side = ReadSide(cursor, end);
+        marketQuote.m_ask.m_price = ReadPrice(security.m_price, cursor, end);
+        marketQuote.m_ask.m_size = ReadQuantity(cursor, end);
+        marketQuote.m_ask.m_side = ReadSide(cursor, end);
+        marketQuote.m_timestamp = ReadTimestamp(cursor, end);
+        messages.push_back(SecurityMarketQuote(std::move(marketQuote),
+          security.m_security));
+      } else if(record == Details::PackedRecord::TIME_AND_SALE) {
+        auto& security = ReadSecurity(cursor, end);
+        auto timeAndSale = TimeAndSale();
+        timeAndSale.m_price = ReadPrice(security.m_price, cursor, end);
+        timeAndSale.m_size = ReadQuantity(cursor, end);
+        timeAndSale.m_condition.m_type = Details::ReadPackedEnum(cursor, end,
+          {TimeAndSale::Condition::Type::NONE,
+            TimeAndSale::Condition::Type::REGULAR,
+            TimeAndSale::Condition::Type::OPEN,
+            TimeAndSale::Condition::Type::CLOSE});
+        timeAndSale.m_condition.m_code = ReadString(cursor, end);
+        timeAndSale.m_marketCenter = ReadString(cursor, end);
+        timeAndSale.m_timestamp = ReadTimestamp(cursor, end);
+        messages.push_back(SecurityTimeAndSale(std::move(timeAndSale),
+          security.m_security));
+      } else if(record == Details::PackedRecord::ORDER_IMBALANCE) {
+        auto market = MarketCode(ReadString(cursor, end).c_str());
+        auto& security = ReadSecurity(cursor, end);
+        auto orderImbalance = OrderImbalance();
+        orderImbalance.m_security = security.m_security;
+        orderImbalance.m_side = ReadSide(cursor, end);
+        orderImbalance.m_size = ReadQuantity(cursor, end);
+        orderImbalance.m_referencePrice =
+          ReadPrice(security.m_price, cursor, end);
+        orderImbalance.m_timestamp = ReadTimestamp(cursor, end);
+        messages.push_back(MarketOrderImbalance(std::move(orderImbalance),
+          market));
+      } else {
+        BOOST_THROW_EXCEPTION(Beam::Serialization::SerializationException(
+          "Malformed packed market data."));
+      }
+    }
+  }
+
+  inline const std::string& PackedMarketDataDecoder::ReadString(
+      const char*& cursor, const char* end) {
+    auto id = Details::ReadPackedVarint(cursor, end);
+    if(id >= m_strings.size()) {
+      BOOST_THROW_EXCEPTION(Beam::Serialization::SerializationException(
+        "Malformed packed market data."));
+    }
+    return m_strings[id];
+  }
+
+  inline PackedMarketDataDecoder::SecurityEntry&
+      PackedMarketDataDecoder::ReadSecurity(const char*& cursor,
+        const char* end) {
+    auto id = Details::ReadPackedVarint(cursor, end);
+    if(id >= m_securities.size()) {
+      BOOST_THROW_EXCEPTION(Beam::Serialization::SerializationException(
+        "Malformed packed market data."));
+    }
+    return m_securities[id];
+  }
+
+  inline boost::posix_time::ptime PackedMarketDataDecoder::ReadTimestamp(
+      const char*& cursor, const char* end) {
+    auto encoding = Details::ReadPackedVarint(cursor, end);
+    if((encoding & 1) != 0) {
+      auto code = encoding >> 1;
+      if(code == 0) {
+        return boost::posix_time::not_a_date_time;
+      } else if(code == 1) {
+        return boost::posix_time::neg_infin;
+      } else if(code == 2) {
+        return boost::posix_time::pos_infin;
+      }
+      BOOST_THROW_EXCEPTION(Beam::Serialization::SerializationException(
+        "Malformed packed market data."));
+    }
+    m_timestamp += Details::PackedUnZigZag(encoding >> 1);
+    return boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1)) +
+      boost::posix_time::microseconds(m_timestamp);
+  }
+
+  inline Side PackedMarketDataDecoder::ReadSide(const char*& cursor,
+      const char* end) {
+    return Details::ReadPackedEnum(cursor, end,
+      {Side::NONE, Side::ASK, Side::BID});
+  }
+
+  inline Money PackedMarketDataDecoder::ReadPrice(std::int64_t& reference,
+      const char*& cursor, const char* end) {
+    auto encoding = Details::ReadPackedVarint(cursor, end);
+    if((encoding & 1) != 0) {
+      return Money(Details::ReadPackedRaw(cursor, end));
+    }
+    reference += Details::PackedUnZigZag(encoding >> 1);
+    return Money(Quantity::FromRepresentation(
+      static_cast<Quantity::Representation>(reference)));
+  }
+
+  inline Quantity PackedMarketDataDecoder::ReadQuantity(const char*& cursor,
+      const char* end) {
+    auto encoding = Details::ReadPackedVarint(cursor, end);
+    auto tag = encoding & 3;
+    if(tag == 0) {
+      return Quantity::FromRepresentation(static_cast<Quantity::Representation>(
+        Details::PackedUnZigZag(encoding >> 2) * Quantity::MULTIPLIER));
+    } else if(tag == 1) {
+      return Quantity::FromRepresentation(static_cast<Quantity::Representation>(
+        Details::PackedUnZigZag(encoding >> 2)));
+    }
+    return Details::ReadPackedRaw(cursor, end);
+  }
+}
+
+#endif
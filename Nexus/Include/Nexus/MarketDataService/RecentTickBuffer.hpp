@@ -0,0 +1,161 @@
+#ifndef NEXUS_MARKET_DATA_RECENT_TICK_BUFFER_HPP
+#define NEXUS_MARKET_DATA_RECENT_TICK_BUFFER_HPP
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include <Beam/Queries/Evaluator.hpp>
+#include <Beam/Queries/FilteredQuery.hpp>
+#include <Beam/Queries/SequencedValue.hpp>
+#include <Beam/Queries/SnapshotLimit.hpp>
+#include <boost/optional/optional.hpp>
+#include "Nexus/MarketDataService/HistoricalDataStoreUtilities.hpp"
+#include "Nexus/MarketDataService/MarketDataService.hpp"
+
+namespace Nexus::MarketDataService {
+
+  /**
+   * Keeps a fixed number of the most recently published values of a single
+   * index in a ring, so that queries for recent history can be answered
+   * without going to a HistoricalDataStore.
+   * @param <T> The type of value stored.
+   */
+  template<typename T>
+  class RecentTickBuffer {
+    public:
+
+      /** The type of value stored. */
+      using Type = T;
+
+      /** The type of sequenced value stored. */
+      using SequencedType = Beam::Queries::SequencedValue<Type>;
+
+      /**
+       * Constructs an empty RecentTickBuffer.
+       * @param capacity The maximum number of values to keep, a capacity of
+       *        zero disables the buffer.
+       */
+      explicit RecentTickBuffer(int capacity);
+
+      /** Returns the maximum number of values kept. */
+      int GetCapacity() const;
+
+      /** Returns the number of values currently kept. */
+      int GetSize() const;
+
+      /**
+       * Appends a value, evicting the oldest value if the buffer is full.
+       * Values must be pushed in the order they are sequenced.
+       * @param value The value to append.
+       */
+      void Push(const SequencedType& value);
+
+      /**
+       * Loads the values matching a query.
+       * The query can only be answered when no value outside of this buffer
+       * could be part of its result, that is when the snapshot limit is
+       * reached or a value before the start of the query's range is found.
+       * @param query The query to load.
+       * @param filter The query's translated filter.
+       * @return The values matching the <i>query</i>, or <code>none</code> iff
+       *         the query reaches past the oldest value kept.
+       */
+      template<typename Query>
+      boost::optional<std::vector<SequencedType>> Load(const Query& query,
+        Beam::Queries::Evaluator& filter) const;
+
+    private:
+      std::vector<SequencedType> m_values;
+      std::size_t m_capacity;
+      std::size_t m_head;
+
+      const SequencedType& Get(std::size_t index) const;
+  };
+
+  template<typename T>
+  RecentTickBuffer<T>::RecentTickBuffer(int capacity)
+    : m_capacity(static_cast<std::size_t>(std::max(0, capacity))),
+      m_head(0) {}
+
+  template<typename T>
+  int RecentTickBuffer<T>::GetCapacity() const {
+    return static_cast<int>(m_capacity);
+  }
+
+  template<typename T>
+  int RecentTickBuffer<T>::GetSize() const {
+    return static_cast<int>(m_values.size());
+  }
+
+  template<typename T>
+  void RecentTickBuffer<T>::Push(const SequencedType& value) {
+    if(m_values.size() < m_capacity) {
+      m_values.push_back(value);
+    } else if(m_capacity != 0) {
+      m_values[m_head] = value;
+      m_head = (m_head + 1) % m_capacity;
+    }
+  }
+
+  template<typename T>
+  template<typename Query>
+  boost::optional<std::vector<typename RecentTickBuffer<T>::SequencedType>>
+      RecentTickBuffer<T>::Load(const Query& query,
+        Beam::Queries::Evaluator& filter) const {
+    const auto& range = query.GetRange();
+    const auto& limit = query.GetSnapshotLimit();
+    auto matches = std::vector<SequencedType>();
+    if(limit.GetSize() <= 0) {
+      return matches;
+    }
+    if(m_values.empty()) {
+      return boost::none;
+    }
+    auto isBeforeStart = [&] (const SequencedType& value) {
+      return !Details::IsAfterStart(range.GetStart(), value.GetSequence(),
+        value.GetValue().m_timestamp);
+    };
+    auto test = [&] (const SequencedType& value) {
+      return Details::IsBeforeEnd(range.GetEnd(), value.GetSequence(),
+        value.GetValue().m_timestamp) &&
+        Beam::Queries::TestFilter(filter, value.GetValue());
+    };
+    auto isFull = [&] {
+      return static_cast<int>(matches.size()) >= limit.GetSize();
+    };
+    if(limit.GetType() == Beam::Queries::SnapshotLimit::Type::HEAD) {
+      if(!isBeforeStart(Get(0))) {
+        return boost::none;
+      }
+      for(auto i = std::size_t(1); i != m_values.size() && !isFull(); ++i) {
+        auto& value = Get(i);
+        if(!isBeforeStart(value) && test(value)) {
+          matches.push_back(value);
+        }
+      }
+      return matches;
+    }
+    for(auto i = m_values.size(); i != 0; --i) {
+      auto& value = Get(i - 1);
+      if(isBeforeStart(value)) {
+        std::reverse(matches.begin(), matches.end());
+        return matches;
+      }
+      if(test(value)) {
+        matches.push_back(value);
+        if(isFull()) {
+          std::reverse(matches.begin(), matches.end());
+          return matches;
+        }
+      }
+    }
+    return boost::none;
+  }
+
+  template<typename T>
+  const typename RecentTickBuffer<T>::SequencedType&
+      RecentTickBuffer<T>::Get(std::size_t index) const {
+    return m_values[(m_head + index) % m_values.size()];
+  }
+}
+
+#endif
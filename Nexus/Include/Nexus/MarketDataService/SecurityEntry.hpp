@@ -1,15 +1,20 @@
 #ifndef NEXUS_MARKET_DATA_SECURITY_ENTRY_HPP
 #define NEXUS_MARKET_DATA_SECURITY_ENTRY_HPP
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 #include <Beam/Queries/Sequencer.hpp>
-#include <Beam/Utilities/Algorithm.hpp>
 #include <boost/optional/optional.hpp>
 #include "Nexus/Definitions/DefaultMarketDatabase.hpp"
 #include "Nexus/Definitions/DefaultTimeZoneDatabase.hpp"
 #include "Nexus/Definitions/SecurityTechnicals.hpp"
 #include "Nexus/MarketDataService/MarketDataService.hpp"
+#include "Nexus/MarketDataService/RecentTickBuffer.hpp"
 #include "Nexus/MarketDataService/SecurityMarketDataQuery.hpp"
+#include "Nexus/MarketDataService/SecuritySearchIndex.hpp"
 #include "Nexus/MarketDataService/SecuritySnapshot.hpp"
 #include "Nexus/TechnicalAnalysis/StandardSecurityQueries.hpp"
 
@@ -44,12 +49,34 @@ namespace Nexus::MarketDataService {
       SecurityEntry(Security security, Money closePrice,
         const InitialSequences& initialSequences);
 
+      /**
+       * Constructs a SecurityEntry.
+       * @param security The Security represented.
+       * @param closePrice The closing price.
+       * @param initialSequences The initial Sequences to use.
+       * @param recentTickCount The number of recently published values of each
+       *        type to keep in memory.
+       */
+      SecurityEntry(Security security, Money closePrice,
+        const InitialSequences& initialSequences, int recentTickCount);
+
       /** Returns the Security. */
       const Security& GetSecurity() const;
 
       /** Sets the Security. */
       void SetSecurity(const Security& security);
 
+      /**
+       * Returns the Security's Ranking in a SecuritySearchIndex, or
+       * <code>nullptr</code> if none has been set.
+       */
+      const std::shared_ptr<SecuritySearchIndex::Ranking>&
+        GetSearchRanking() const;
+
+      /** Sets the Security's Ranking in a SecuritySearchIndex. */
+      void SetSearchRanking(
+        std::shared_ptr<SecuritySearchIndex::Ranking> ranking);
+
       /** Returns the most recently published BboQuote. */
       const SequencedSecurityBboQuote& GetBboQuote() const;
 
@@ -92,6 +119,27 @@ namespace Nexus::MarketDataService {
       /** Returns the SecurityTechnicals. */
       const SecurityTechnicals& GetSecurityTechnicals() const;
 
+      /** Returns the Sequences to assign to the next published values. */
+      InitialSequences GetNextSequences() const;
+
+      /**
+       * Returns the most recent closing price, that is the last price traded
+       * on the Security's market center.
+       */
+      Money GetLastClosePrice() const;
+
+      /** Returns the most recently published BboQuotes. */
+      const RecentTickBuffer<BboQuote>& GetRecentBboQuotes() const;
+
+      /** Returns the most recently published MarketQuotes. */
+      const RecentTickBuffer<MarketQuote>& GetRecentMarketQuotes() const;
+
+      /** Returns the most recently published BookQuotes. */
+      const RecentTickBuffer<BookQuote>& GetRecentBookQuotes() const;
+
+      /** Returns the most recently published TimeAndSales. */
+      const RecentTickBuffer<TimeAndSale>& GetRecentTimeAndSales() const;
+
       /**
        * Returns the Security's current snapshot.
        * @return The real-time snapshot of the <i>security</i>.
@@ -106,12 +154,17 @@ namespace Nexus::MarketDataService {
 
     private:
       struct BookQuoteEntry {
-        SequencedSecurityBookQuote m_quote;
+        Money m_price;
+        Quantity m_size;
+        std::uint32_t m_mpid;
+        bool m_isPrimaryMpid;
+        MarketCode m_market;
+        boost::posix_time::ptime m_timestamp;
+        Beam::Queries::Sequence m_sequence;
         int m_sourceId;
-
-        BookQuoteEntry(const SequencedSecurityBookQuote& quote, int sourceId);
       };
       Security m_security;
+      std::shared_ptr<SecuritySearchIndex::Ranking> m_searchRanking;
       Beam::Queries::Sequencer m_bboSequencer;
       Beam::Queries::Sequencer m_marketQuoteSequencer;
       Beam::Queries::Sequencer m_bookQuoteSequencer;
@@ -126,9 +179,18 @@ namespace Nexus::MarketDataService {
         m_marketQuotes;
       std::vector<BookQuoteEntry> m_askBook;
       std::vector<BookQuoteEntry> m_bidBook;
+      std::vector<std::string> m_mpids;
+      std::unordered_map<std::string, std::uint32_t> m_mpidIds;
+      RecentTickBuffer<BboQuote> m_recentBboQuotes;
+      RecentTickBuffer<MarketQuote> m_recentMarketQuotes;
+      RecentTickBuffer<BookQuote> m_recentBookQuotes;
+      RecentTickBuffer<TimeAndSale> m_recentTimeAndSales;
 
       SecurityEntry(const SecurityEntry&) = delete;
       SecurityEntry& operator =(const SecurityEntry&) = delete;
+      std::uint32_t InternMpid(const std::string& mpid);
+      SequencedSecurityBookQuote MakeBookQuote(const BookQuoteEntry& entry,
+        Side side) const;
   };
 
   /**
@@ -188,20 +250,23 @@ namespace Nexus::MarketDataService {
     return initialSequences;
   }
 
-  inline SecurityEntry::BookQuoteEntry::BookQuoteEntry(
-    const SequencedSecurityBookQuote& quote, int sourceId)
-    : m_quote(quote),
-      m_sourceId(sourceId) {}
+  inline SecurityEntry::SecurityEntry(Security security, Money closePrice,
+    const InitialSequences& initialSequences)
+    : SecurityEntry(std::move(security), closePrice, initialSequences, 0) {}
 
   inline SecurityEntry::SecurityEntry(Security security, Money closePrice,
-      const InitialSequences& initialSequences)
+      const InitialSequences& initialSequences, int recentTickCount)
       : m_security(std::move(security)),
         m_bboSequencer(initialSequences.m_nextBboQuoteSequence),
         m_marketQuoteSequencer(initialSequences.m_nextMarketQuoteSequence),
         m_bookQuoteSequencer(initialSequences.m_nextBookQuoteSequence),
         m_timeAndSaleSequencer(initialSequences.m_nextTimeAndSaleSequence),
         m_marketCenter(TechnicalAnalysis::GetDefaultMarketCenter(
-          m_security.GetMarket())) {
+          m_security.GetMarket())),
+        m_recentBboQuotes(recentTickCount),
+        m_recentMarketQuotes(recentTickCount),
+        m_recentBookQuotes(recentTickCount),
+        m_recentTimeAndSales(recentTickCount) {
     m_technicals.m_close = closePrice;
   }
 
@@ -213,6 +278,16 @@ namespace Nexus::MarketDataService {
     m_security = security;
   }
 
+  inline const std::shared_ptr<SecuritySearchIndex::Ranking>&
+      SecurityEntry::GetSearchRanking() const {
+    return m_searchRanking;
+  }
+
+  inline void SecurityEntry::SetSearchRanking(
+      std::shared_ptr<SecuritySearchIndex::Ranking> ranking) {
+    m_searchRanking = std::move(ranking);
+  }
+
   inline const SequencedSecurityBboQuote& SecurityEntry::GetBboQuote() const {
     return m_bboQuote;
   }
@@ -248,6 +323,8 @@ namespace Nexus::MarketDataService {
     }
     auto value = m_bboSequencer.MakeSequencedValue(bboQuote, m_security);
     m_bboQuote = value;
+    m_recentBboQuotes.Push(
+      Beam::Queries::SequencedValue(value->GetValue(), value.GetSequence()));
     return value;
   }
 
@@ -257,51 +334,54 @@ namespace Nexus::MarketDataService {
     auto value = m_marketQuoteSequencer.MakeSequencedValue(marketQuote,
       m_security);
     m_marketQuotes[marketQuote.m_market] = value;
+    m_recentMarketQuotes.Push(
+      Beam::Queries::SequencedValue(value->GetValue(), value.GetSequence()));
     return value;
   }
 
   inline boost::optional<SequencedSecurityBookQuote>
       SecurityEntry::UpdateBookQuote(const BookQuote& delta, int sourceId) {
     auto book = Pick(delta.m_quote.m_side, &m_askBook, &m_bidBook);
-    auto entryIterator = Beam::LinearLowerBound(book->begin(), book->end(),
-      delta, [] (const auto& lhs, const auto& rhs) {
-        return BookQuoteListingComparator(**lhs.m_quote, rhs);
-      });
-    if(entryIterator == book->end()) {
+    auto isListedBefore = [&] (const BookQuoteEntry& entry) {
+      if(entry.m_price != delta.m_quote.m_price) {
+        if(delta.m_quote.m_side == Side::ASK) {
+          return entry.m_price < delta.m_quote.m_price;
+        }
+        return entry.m_price > delta.m_quote.m_price;
+      }
+      return m_mpids[entry.m_mpid] < delta.m_mpid;
+    };
+    auto entryIterator = std::partition_point(book->begin(), book->end(),
+      isListedBefore);
+    auto isMatch = entryIterator != book->end() &&
+      entryIterator->m_price == delta.m_quote.m_price &&
+      m_mpids[entryIterator->m_mpid] == delta.m_mpid;
+    if(!isMatch) {
       if(delta.m_quote.m_size <= 0) {
         return boost::none;
       }
-      auto value = m_bookQuoteSequencer.MakeSequencedValue(delta, m_security);
-      book->emplace_back(std::move(value), sourceId);
-      entryIterator = book->end() - 1;
-    } else {
-      auto& entry = *entryIterator;
-      if((*entry.m_quote)->m_quote.m_price != delta.m_quote.m_price ||
-          (*entry.m_quote)->m_mpid != delta.m_mpid) {
-        if(delta.m_quote.m_size <= 0) {
-          return boost::none;
-        }
-        if((*entry.m_quote)->m_quote.m_size == 0) {
-          auto value = m_bookQuoteSequencer.MakeSequencedValue(delta,
-            m_security);
-          auto quoteEntry = BookQuoteEntry(std::move(value), sourceId);
-          entry = quoteEntry;
-        } else {
-          auto value = m_bookQuoteSequencer.MakeSequencedValue(delta,
-            m_security);
-          entryIterator = book->emplace(entryIterator, std::move(value),
-            sourceId);
-        }
+      auto entry = BookQuoteEntry{delta.m_quote.m_price, delta.m_quote.m_size,
+        InternMpid(delta.m_mpid), delta.m_isPrimaryMpid, delta.m_market,
+        delta.m_timestamp,
+        m_bookQuoteSequencer.IncrementNextSequence(delta.m_timestamp),
+        sourceId};
+      if(entryIterator != book->end() && entryIterator->m_size == 0) {
+        *entryIterator = entry;
       } else {
-        (*entry.m_quote)->m_quote.m_size = std::max<Quantity>(0,
-          (*entry.m_quote)->m_quote.m_size + delta.m_quote.m_size);
-        (*entry.m_quote)->m_timestamp = delta.m_timestamp;
-        entry.m_quote.GetSequence() =
-          m_bookQuoteSequencer.IncrementNextSequence(delta.m_timestamp);
-        entry.m_sourceId = sourceId;
+        entryIterator = book->insert(entryIterator, entry);
       }
+    } else {
+      auto& entry = *entryIterator;
+      entry.m_size = std::max<Quantity>(0, entry.m_size + delta.m_quote.m_size);
+      entry.m_timestamp = delta.m_timestamp;
+      entry.m_sequence =
+        m_bookQuoteSequencer.IncrementNextSequence(delta.m_timestamp);
+      entry.m_sourceId = sourceId;
     }
-    return entryIterator->m_quote;
+    auto value = MakeBookQuote(*entryIterator, delta.m_quote.m_side);
+    m_recentBookQuotes.Push(
+      Beam::Queries::SequencedValue(value->GetValue(), value.GetSequence()));
+    return value;
   }
 
   inline boost::optional<SequencedSecurityTimeAndSale>
@@ -325,6 +405,8 @@ namespace Nexus::MarketDataService {
     auto value = m_timeAndSaleSequencer.MakeSequencedValue(
       timeAndSale, m_security);
     m_timeAndSale = value;
+    m_recentTimeAndSales.Push(
+      Beam::Queries::SequencedValue(value->GetValue(), value.GetSequence()));
     return value;
   }
 
@@ -333,6 +415,45 @@ namespace Nexus::MarketDataService {
     return m_technicals;
   }
 
+  inline SecurityEntry::InitialSequences
+      SecurityEntry::GetNextSequences() const {
+    auto sequences = InitialSequences();
+    sequences.m_nextBboQuoteSequence = m_bboSequencer.GetNextSequence();
+    sequences.m_nextBookQuoteSequence = m_bookQuoteSequencer.GetNextSequence();
+    sequences.m_nextMarketQuoteSequence =
+      m_marketQuoteSequencer.GetNextSequence();
+    sequences.m_nextTimeAndSaleSequence =
+      m_timeAndSaleSequencer.GetNextSequence();
+    return sequences;
+  }
+
+  inline Money SecurityEntry::GetLastClosePrice() const {
+    if(m_nextClose != Money::ZERO) {
+      return m_nextClose;
+    }
+    return m_technicals.m_close;
+  }
+
+  inline const RecentTickBuffer<BboQuote>&
+      SecurityEntry::GetRecentBboQuotes() const {
+    return m_recentBboQuotes;
+  }
+
+  inline const RecentTickBuffer<MarketQuote>&
+      SecurityEntry::GetRecentMarketQuotes() const {
+    return m_recentMarketQuotes;
+  }
+
+  inline const RecentTickBuffer<BookQuote>&
+      SecurityEntry::GetRecentBookQuotes() const {
+    return m_recentBookQuotes;
+  }
+
+  inline const RecentTickBuffer<TimeAndSale>&
+      SecurityEntry::GetRecentTimeAndSales() const {
+    return m_recentTimeAndSales;
+  }
+
   inline boost::optional<SecuritySnapshot> SecurityEntry::LoadSnapshot() const {
     if(m_security.GetMarket().IsEmpty()) {
       return boost::none;
@@ -343,13 +464,13 @@ namespace Nexus::MarketDataService {
     snapshot.m_marketQuotes.insert(m_marketQuotes.begin(),
       m_marketQuotes.end());
     for(auto& entry : m_askBook) {
-      if((*entry.m_quote)->m_quote.m_size > 0) {
-        snapshot.m_askBook.push_back(entry.m_quote);
+      if(entry.m_size > 0) {
+        snapshot.m_askBook.push_back(MakeBookQuote(entry, Side::ASK));
       }
     }
     for(auto& entry : m_bidBook) {
-      if((*entry.m_quote)->m_quote.m_size > 0) {
-        snapshot.m_bidBook.push_back(entry.m_quote);
+      if(entry.m_size > 0) {
+        snapshot.m_bidBook.push_back(MakeBookQuote(entry, Side::BID));
       }
     }
     return snapshot;
@@ -367,6 +488,25 @@ namespace Nexus::MarketDataService {
       });
     m_bidBook.erase(bidRange, m_bidBook.end());
   }
+
+  inline std::uint32_t SecurityEntry::InternMpid(const std::string& mpid) {
+    auto i = m_mpidIds.find(mpid);
+    if(i != m_mpidIds.end()) {
+      return i->second;
+    }
+    auto id = static_cast<std::uint32_t>(m_mpids.size());
+    m_mpids.push_back(mpid);
+    m_mpidIds.insert(std::pair(mpid, id));
+    return id;
+  }
+
+  inline SequencedSecurityBookQuote SecurityEntry::MakeBookQuote(
+      const BookQuoteEntry& entry, Side side) const {
+    return SequencedSecurityBookQuote(SecurityBookQuote(
+      BookQuote(m_mpids[entry.m_mpid], entry.m_isPrimaryMpid, entry.m_market,
+        Quote(entry.m_price, entry.m_size, side), entry.m_timestamp),
+      m_security), entry.m_sequence);
+  }
 }
 
 #endif
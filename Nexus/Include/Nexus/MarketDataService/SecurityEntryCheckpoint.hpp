@@ -0,0 +1,126 @@
+#ifndef NEXUS_MARKET_DATA_SECURITY_ENTRY_CHECKPOINT_HPP
+#define NEXUS_MARKET_DATA_SECURITY_ENTRY_CHECKPOINT_HPP
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <Beam/IO/SharedBuffer.hpp>
+#include <Beam/Serialization/BinaryReceiver.hpp>
+#include <Beam/Serialization/BinarySender.hpp>
+#include <Beam/Serialization/ShuttleVector.hpp>
+#include <boost/throw_exception.hpp>
+#include "Nexus/Definitions/Money.hpp"
+#include "Nexus/Definitions/Security.hpp"
+#include "Nexus/MarketDataService/MarketDataService.hpp"
+#include "Nexus/MarketDataService/SecurityEntry.hpp"
+
+namespace Nexus::MarketDataService {
+
+  /**
+   * Stores the state needed to construct a SecurityEntry without querying a
+   * HistoricalDataStore.
+   */
+  struct SecurityEntryCheckpoint {
+
+    /** The Security the entry was published under. */
+    Security m_security;
+
+    /** The closing price. */
+    Money m_closePrice;
+
+    /** The Sequences to assign to the next published values. */
+    SecurityEntry::InitialSequences m_initialSequences;
+  };
+}
+
+namespace Beam::Serialization {
+  template<>
+  struct Shuttle<Nexus::MarketDataService::SecurityEntryCheckpoint> {
+    template<typename Shuttler>
+    void operator ()(Shuttler& shuttle,
+        Nexus::MarketDataService::SecurityEntryCheckpoint& value,
+        unsigned int version) {
+      shuttle.Shuttle("security", value.m_security);
+      shuttle.Shuttle("close_price", value.m_closePrice);
+      shuttle.Shuttle("next_bbo_quote_sequence",
+        value.m_initialSequences.m_nextBboQuoteSequence);
+      shuttle.Shuttle("next_book_quote_sequence",
+        value.m_initialSequences.m_nextBookQuoteSequence);
+      shuttle.Shuttle("next_market_quote_sequence",
+        value.m_initialSequences.m_nextMarketQuoteSequence);
+      shuttle.Shuttle("next_time_and_sale_sequence",
+        value.m_initialSequences.m_nextTimeAndSaleSequence);
+    }
+  };
+}
+
+namespace Nexus::MarketDataService {
+
+  /**
+   * Loads and removes a file of SecurityEntryCheckpoints. The file is removed
+   * so that a checkpoint is never applied after the data it summarizes may
+   * have been extended by a later session.
+   * @param path The path of the file to load.
+   * @return The checkpoints stored in the file, or an empty list if the file
+   *         does not exist or could not be read.
+   */
+  inline std::vector<SecurityEntryCheckpoint> LoadSecurityEntryCheckpoints(
+      const std::filesystem::path& path) {
+    auto checkpoints = std::vector<SecurityEntryCheckpoint>();
+    auto contents = std::string();
+    {
+      auto file = std::ifstream(path, std::ios::binary);
+      if(!file) {
+        return checkpoints;
+      }
+      contents.assign(std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>());
+    }
+    auto error = std::error_code();
+    std::filesystem::remove(path, error);
+    if(error) {
+      return checkpoints;
+    }
+    auto buffer = Beam::IO::SharedBuffer();
+    buffer.Append(contents.data(), contents.size());
+    auto receiver = Beam::Serialization::BinaryReceiver<
+      Beam::IO::SharedBuffer>();
+    receiver.SetSource(Beam::Ref(buffer));
+    try {
+      receiver.Shuttle(checkpoints);
+    } catch(const Beam::Serialization::SerializationException&) {
+      checkpoints.clear();
+    }
+    return checkpoints;
+  }
+
+  /**
+   * Stores a list of SecurityEntryCheckpoints to a file, replacing any
+   * existing file.
+   * @param path The path of the file to store.
+   * @param checkpoints The checkpoints to store.
+   */
+  inline void StoreSecurityEntryCheckpoints(const std::filesystem::path& path,
+      const std::vector<SecurityEntryCheckpoint>& checkpoints) {
+    auto buffer = Beam::IO::SharedBuffer();
+    auto sender = Beam::Serialization::BinarySender<Beam::IO::SharedBuffer>();
+    sender.SetSink(Beam::Ref(buffer));
+    sender.Shuttle(checkpoints);
+    auto staging = path;
+    staging += ".tmp";
+    {
+      auto file = std::ofstream(staging, std::ios::binary | std::ios::trunc);
+      file.write(buffer.GetData(), buffer.GetSize());
+      if(!file) {
+        BOOST_THROW_EXCEPTION(std::runtime_error(
+          "Unable to store security entry checkpoints."));
+      }
+    }
+    std::filesystem::rename(staging, path);
+  }
+}
+
+#endif
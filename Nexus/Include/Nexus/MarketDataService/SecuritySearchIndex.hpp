@@ -0,0 +1,257 @@
+#ifndef NEXUS_SECURITY_SEARCH_INDEX_HPP
+#define NEXUS_SECURITY_SEARCH_INDEX_HPP
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <Beam/Collections/SynchronizedMap.hpp>
+#include <Beam/Threading/Mutex.hpp>
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/thread/locks.hpp>
+#include "Nexus/Definitions/SecurityInfo.hpp"
+#include "Nexus/MarketDataService/MarketDataService.hpp"
+
+namespace Nexus::MarketDataService {
+
+  /**
+   * Indexes SecurityInfo by symbol and name for prefix searches. Searches read
+   * an immutable snapshot of the index and don't wait on additions, which
+   * publish a new snapshot that shares all unmodified keys with the previous
+   * one. The snapshot pointer is read with std::atomic_load, which may itself
+   * use a short internal lock, but only for as long as it takes to copy the
+   * pointer. Only Securities that currently have a quote are matched, and
+   * matches are ranked by daily volume. A Security's Ranking is kept across
+   * replacements of its SecurityInfo, so publishers may hold onto it and
+   * update it without any lookup.
+   */
+  class SecuritySearchIndex {
+    public:
+
+      /** Stores the attributes used to rank a Security's matches. */
+      struct Ranking {
+
+        /** Whether the Security has a quote. */
+        std::atomic_bool m_hasQuote;
+
+        /** The Security's volume. */
+        std::atomic<double> m_volume;
+
+        /** Constructs a Ranking without a quote or volume. */
+        Ranking();
+      };
+
+      /** Constructs an empty SecuritySearchIndex. */
+      SecuritySearchIndex();
+
+      /**
+       * Returns <code>true</code> iff a Security has been added.
+       * @param security The Security to test.
+       */
+      bool Contains(const Security& security);
+
+      /**
+       * Returns the Ranking of a Security.
+       * @param security The Security to find.
+       * @return The <i>security</i>'s Ranking or <code>nullptr</code> if it
+       *         hasn't been added.
+       */
+      std::shared_ptr<Ranking> FindRanking(const Security& security);
+
+      /**
+       * Adds or replaces a SecurityInfo, indexed by its Security's string
+       * representation and by its name.
+       * @param info The SecurityInfo to add.
+       * @return The Ranking of the <i>info</i>'s Security.
+       */
+      std::shared_ptr<Ranking> Add(const SecurityInfo& info);
+
+      /**
+       * Sets whether a Security has a quote, Securities without a quote are
+       * excluded from searches.
+       * @param security The Security to update.
+       * @param hasQuote Whether the <i>security</i> has a quote.
+       */
+      void SetHasQuote(const Security& security, bool hasQuote);
+
+      /**
+       * Sets the volume used to rank a Security.
+       * @param security The Security to update.
+       * @param volume The <i>security</i>'s volume.
+       */
+      void SetVolume(const Security& security, Quantity volume);
+
+      /**
+       * Returns the highest ranked SecurityInfo's matching a prefix.
+       * @param prefix The case insensitive prefix to search for.
+       * @param maxCount The maximum number of matches to return.
+       * @return The matches ordered from highest to lowest volume.
+       */
+      std::vector<SecurityInfo> Search(const std::string& prefix,
+        std::size_t maxCount) const;
+
+    private:
+      struct Listing {
+        SecurityInfo m_info;
+        std::shared_ptr<Ranking> m_ranking;
+        std::atomic_bool m_isReplaced;
+
+        Listing(SecurityInfo info, std::shared_ptr<Ranking> ranking);
+      };
+      using Key = std::pair<std::string, std::shared_ptr<Listing>>;
+      using Keys = std::vector<Key>;
+      struct Snapshot {
+        std::shared_ptr<const Keys> m_base;
+        Keys m_delta;
+      };
+      static constexpr auto MAX_DELTA_SIZE = std::size_t(1024);
+      Beam::Threading::Mutex m_mutex;
+      std::shared_ptr<const Snapshot> m_snapshot;
+      Beam::SynchronizedUnorderedMap<Security, std::shared_ptr<Listing>>
+        m_listings;
+
+      SecuritySearchIndex(const SecuritySearchIndex&) = delete;
+      SecuritySearchIndex& operator =(const SecuritySearchIndex&) = delete;
+      static bool KeyComparator(const Key& lhs, const Key& rhs);
+      static void Insert(Keys& keys, Key key);
+  };
+
+  inline SecuritySearchIndex::Ranking::Ranking()
+    : m_hasQuote(false),
+      m_volume(0) {}
+
+  inline SecuritySearchIndex::Listing::Listing(SecurityInfo info,
+    std::shared_ptr<Ranking> ranking)
+    : m_info(std::move(info)),
+      m_ranking(std::move(ranking)),
+      m_isReplaced(false) {}
+
+  inline SecuritySearchIndex::SecuritySearchIndex()
+    : m_snapshot(std::make_shared<Snapshot>(
+        Snapshot{std::make_shared<Keys>(), {}})) {}
+
+  inline bool SecuritySearchIndex::Contains(const Security& security) {
+    return m_listings.Contains(security);
+  }
+
+  inline std::shared_ptr<SecuritySearchIndex::Ranking>
+      SecuritySearchIndex::FindRanking(const Security& security) {
+    if(auto listing = m_listings.FindValue(security)) {
+      return (*listing)->m_ranking;
+    }
+    return nullptr;
+  }
+
+  inline std::shared_ptr<SecuritySearchIndex::Ranking>
+      SecuritySearchIndex::Add(const SecurityInfo& info) {
+    auto symbolKey = ToString(info.m_security);
+    auto nameKey = boost::to_upper_copy(info.m_name);
+    auto lock = boost::lock_guard(m_mutex);
+    auto current = std::atomic_load(&m_snapshot);
+    auto snapshot = std::make_shared<Snapshot>(*current);
+    auto listing = std::shared_ptr<Listing>();
+    if(auto previous = m_listings.FindValue(info.m_security)) {
+      listing = std::make_shared<Listing>(info, (*previous)->m_ranking);
+      (*previous)->m_isReplaced = true;
+    } else {
+      listing = std::make_shared<Listing>(info, std::make_shared<Ranking>());
+    }
+    m_listings.Update(info.m_security, listing);
+    Insert(snapshot->m_delta, Key(symbolKey, listing));
+    if(!nameKey.empty() && nameKey != symbolKey) {
+      Insert(snapshot->m_delta, Key(std::move(nameKey), listing));
+    }
+    if(snapshot->m_delta.size() >= MAX_DELTA_SIZE) {
+      auto base = std::make_shared<Keys>();
+      base->reserve(snapshot->m_base->size() + snapshot->m_delta.size());
+      auto isCurrent = [] (const Key& key) {
+        return !key.second->m_isReplaced;
+      };
+      std::copy_if(snapshot->m_base->begin(), snapshot->m_base->end(),
+        std::back_inserter(*base), isCurrent);
+      auto middle = base->size();
+      std::copy_if(snapshot->m_delta.begin(), snapshot->m_delta.end(),
+        std::back_inserter(*base), isCurrent);
+      std::inplace_merge(base->begin(), base->begin() + middle, base->end(),
+        &KeyComparator);
+      snapshot->m_base = std::move(base);
+      snapshot->m_delta.clear();
+    }
+    std::atomic_store(&m_snapshot,
+      std::shared_ptr<const Snapshot>(std::move(snapshot)));
+    return listing->m_ranking;
+  }
+
+  inline void SecuritySearchIndex::SetHasQuote(const Security& security,
+      bool hasQuote) {
+    if(auto ranking = FindRanking(security)) {
+      ranking->m_hasQuote = hasQuote;
+    }
+  }
+
+  inline void SecuritySearchIndex::SetVolume(const Security& security,
+      Quantity volume) {
+    if(auto ranking = FindRanking(security)) {
+      ranking->m_volume = static_cast<double>(volume);
+    }
+  }
+
+  inline std::vector<SecurityInfo> SecuritySearchIndex::Search(
+      const std::string& prefix, std::size_t maxCount) const {
+    if(maxCount == 0) {
+      return {};
+    }
+    auto snapshot = std::atomic_load(&m_snapshot);
+    auto key = Key(boost::to_upper_copy(prefix), nullptr);
+    auto matches = std::vector<std::pair<double, const Listing*>>();
+    auto search = [&] (const Keys& keys) {
+      auto i = std::lower_bound(keys.begin(), keys.end(), key, &KeyComparator);
+      for(; i != keys.end() && i->first.compare(0, key.first.size(),
+          key.first) == 0; ++i) {
+        auto& listing = *i->second;
+        if(listing.m_isReplaced || !listing.m_ranking->m_hasQuote) {
+          continue;
+        }
+        auto volume = listing.m_ranking->m_volume.load();
+        if(matches.size() == maxCount && volume <= matches.back().first) {
+          continue;
+        }
+        if(std::find_if(matches.begin(), matches.end(), [&] (auto& match) {
+            return match.second == &listing;
+          }) != matches.end()) {
+          continue;
+        }
+        auto position = std::upper_bound(matches.begin(), matches.end(),
+          volume, [] (double volume, const auto& match) {
+            return volume > match.first;
+          });
+        matches.insert(position, std::pair(volume, &listing));
+        if(matches.size() > maxCount) {
+          matches.pop_back();
+        }
+      }
+    };
+    search(*snapshot->m_base);
+    search(snapshot->m_delta);
+    auto result = std::vector<SecurityInfo>();
+    result.reserve(matches.size());
+    for(auto& match : matches) {
+      result.push_back(match.second->m_info);
+    }
+    return result;
+  }
+
+  inline bool SecuritySearchIndex::KeyComparator(const Key& lhs,
+      const Key& rhs) {
+    return lhs.first < rhs.first;
+  }
+
+  inline void SecuritySearchIndex::Insert(Keys& keys, Key key) {
+    auto position = std::upper_bound(keys.begin(), keys.end(), key,
+      &KeyComparator);
+    keys.insert(position, std::move(key));
+  }
+}
+
+#endif
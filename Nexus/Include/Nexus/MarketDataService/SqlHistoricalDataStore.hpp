@@ -1,11 +1,21 @@
 #ifndef NEXUS_SQL_HISTORICAL_DATA_STORE_HPP
 #define NEXUS_SQL_HISTORICAL_DATA_STORE_HPP
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
 #include <functional>
+#include <ostream>
 #include <thread>
+#include <type_traits>
+#include <vector>
 #include <Beam/IO/OpenState.hpp>
 #include <Beam/Queries/SqlDataStore.hpp>
+#include <Beam/Routines/RoutineHandlerGroup.hpp>
 #include <Beam/Sql/DatabaseConnectionPool.hpp>
 #include <Beam/Threading/Sync.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/throw_exception.hpp>
 #include "Nexus/MarketDataService/HistoricalDataStore.hpp"
 #include "Nexus/MarketDataService/HistoricalDataStoreException.hpp"
@@ -15,6 +25,40 @@
 
 namespace Nexus::MarketDataService {
 
+  /** Reports the state of an SqlHistoricalDataStore's writers. */
+  struct SqlHistoricalDataStoreMetrics {
+
+    /** The number of writer connections, each serving one lane. */
+    int m_writerCount;
+
+    /** The number of rows submitted for storage but not yet committed. */
+    std::int64_t m_queueDepth;
+
+    /** The total number of rows committed. */
+    std::int64_t m_rowCount;
+
+    /** The total number of batches committed. */
+    std::int64_t m_batchCount;
+
+    /** The largest batch size currently in use by any table. */
+    int m_batchSize;
+
+    /** The time taken to commit the most recent batch. */
+    boost::posix_time::time_duration m_lastCommitLatency;
+
+    /** The longest time taken to commit a batch. */
+    boost::posix_time::time_duration m_maxCommitLatency;
+  };
+
+  inline std::ostream& operator <<(std::ostream& out,
+      const SqlHistoricalDataStoreMetrics& value) {
+    return out << "(writers: " << value.m_writerCount << " queue_depth: " <<
+      value.m_queueDepth << " rows: " << value.m_rowCount << " batches: " <<
+      value.m_batchCount << " batch_size: " << value.m_batchSize <<
+      " last_commit: " << value.m_lastCommitLatency << " max_commit: " <<
+      value.m_maxCommitLatency << ")";
+  }
+
   /**
    * Stores historical market data in an SQL database.
    * @param <C> The type of SQL connection.
@@ -35,6 +79,16 @@ namespace Nexus::MarketDataService {
        */
       explicit SqlHistoricalDataStore(ConnectionBuilder connectionBuilder);
 
+      /**
+       * Constructs an SqlHistoricalDataStore.
+       * @param connectionBuilder The callable used to build SQL connections.
+       * @param writerCount The number of writer connections. Batches larger
+       *        than a table's batch size are split by index across this many
+       *        lanes and committed in parallel.
+       */
+      SqlHistoricalDataStore(ConnectionBuilder connectionBuilder,
+        int writerCount);
+
       ~SqlHistoricalDataStore();
 
       std::vector<SecurityInfo> LoadSecurityInfo(
@@ -78,12 +132,31 @@ namespace Nexus::MarketDataService {
 
       void Store(const std::vector<SequencedSecurityTimeAndSale>& timeAndSales);
 
+      /** Returns a snapshot of the writers' back-pressure metrics. */
+      SqlHistoricalDataStoreMetrics GetMetrics() const;
+
       void Close();
 
     private:
       template<typename V, typename I>
       using DataStore = Beam::Queries::SqlDataStore<Connection, V, I,
         Queries::SqlTranslator>;
+      static constexpr auto MIN_BATCH_SIZE = 100;
+      static constexpr auto INITIAL_BATCH_SIZE = 1000;
+      static constexpr auto MAX_BATCH_SIZE = 20000;
+      static constexpr auto TARGET_COMMIT_LATENCY =
+        std::chrono::milliseconds(100);
+      int m_writerCount;
+      std::atomic<std::int64_t> m_queueDepth;
+      std::atomic<std::int64_t> m_rowCount;
+      std::atomic<std::int64_t> m_batchCount;
+      std::atomic<std::int64_t> m_lastCommitLatency;
+      std::atomic<std::int64_t> m_maxCommitLatency;
+      std::atomic<int> m_orderImbalanceBatchSize;
+      std::atomic<int> m_bboQuoteBatchSize;
+      std::atomic<int> m_marketQuoteBatchSize;
+      std::atomic<int> m_bookQuoteBatchSize;
+      std::atomic<int> m_timeAndSaleBatchSize;
       Beam::DatabaseConnectionPool<Connection> m_readerPool;
       Beam::DatabaseConnectionPool<Connection> m_writerPool;
       DataStore<Viper::Row<OrderImbalance>, Viper::Row<MarketCode>>
@@ -100,17 +173,41 @@ namespace Nexus::MarketDataService {
       SqlHistoricalDataStore(const SqlHistoricalDataStore&) = delete;
       SqlHistoricalDataStore& operator =(
         const SqlHistoricalDataStore&) = delete;
+      template<typename D, typename T>
+      void Write(D& dataStore, std::atomic<int>& batchSize,
+        const std::vector<T>& values);
+      template<typename D, typename T>
+      void WriteLane(D& dataStore, std::atomic<int>& batchSize,
+        const std::vector<T>& values);
+      void RecordCommit(std::atomic<int>& batchSize, int count,
+        std::chrono::steady_clock::duration latency);
   };
 
   template<typename C>
   SqlHistoricalDataStore<C>::SqlHistoricalDataStore(
-      ConnectionBuilder connectionBuilder)
-      : m_readerPool(std::thread::hardware_concurrency(), [&] {
+    ConnectionBuilder connectionBuilder)
+    : SqlHistoricalDataStore(std::move(connectionBuilder), 1) {}
+
+  template<typename C>
+  SqlHistoricalDataStore<C>::SqlHistoricalDataStore(
+      ConnectionBuilder connectionBuilder, int writerCount)
+      : m_writerCount(std::max(1, writerCount)),
+        m_queueDepth(0),
+        m_rowCount(0),
+        m_batchCount(0),
+        m_lastCommitLatency(0),
+        m_maxCommitLatency(0),
+        m_orderImbalanceBatchSize(INITIAL_BATCH_SIZE),
+        m_bboQuoteBatchSize(INITIAL_BATCH_SIZE),
+        m_marketQuoteBatchSize(INITIAL_BATCH_SIZE),
+        m_bookQuoteBatchSize(INITIAL_BATCH_SIZE),
+        m_timeAndSaleBatchSize(INITIAL_BATCH_SIZE),
+        m_readerPool(std::thread::hardware_concurrency(), [&] {
           auto connection = std::make_unique<Connection>(connectionBuilder());
           connection->open();
           return connection;
         }),
-        m_writerPool(1, [&] {
+        m_writerPool(m_writerCount, [&] {
           auto connection = std::make_unique<Connection>(connectionBuilder());
           connection->open();
           return connection;
@@ -254,7 +351,8 @@ namespace Nexus::MarketDataService {
   template<typename C>
   void SqlHistoricalDataStore<C>::Store(
       const std::vector<SequencedMarketOrderImbalance>& orderImbalances) {
-    m_orderImbalanceDataStore.Store(orderImbalances);
+    Write(m_orderImbalanceDataStore, m_orderImbalanceBatchSize,
+      orderImbalances);
   }
 
   template<typename C>
@@ -266,7 +364,7 @@ namespace Nexus::MarketDataService {
   template<typename C>
   void SqlHistoricalDataStore<C>::Store(
       const std::vector<SequencedSecurityBboQuote>& bboQuotes) {
-    m_bboQuoteDataStore.Store(bboQuotes);
+    Write(m_bboQuoteDataStore, m_bboQuoteBatchSize, bboQuotes);
   }
 
   template<typename C>
@@ -278,7 +376,7 @@ namespace Nexus::MarketDataService {
   template<typename C>
   void SqlHistoricalDataStore<C>::Store(
       const std::vector<SequencedSecurityMarketQuote>& marketQuotes) {
-    m_marketQuoteDataStore.Store(marketQuotes);
+    Write(m_marketQuoteDataStore, m_marketQuoteBatchSize, marketQuotes);
   }
 
   template<typename C>
@@ -290,7 +388,7 @@ namespace Nexus::MarketDataService {
   template<typename C>
   void SqlHistoricalDataStore<C>::Store(
       const std::vector<SequencedSecurityBookQuote>& bookQuotes) {
-    m_bookQuoteDataStore.Store(bookQuotes);
+    Write(m_bookQuoteDataStore, m_bookQuoteBatchSize, bookQuotes);
   }
 
   template<typename C>
@@ -302,7 +400,7 @@ namespace Nexus::MarketDataService {
   template<typename C>
   void SqlHistoricalDataStore<C>::Store(
       const std::vector<SequencedSecurityTimeAndSale>& timeAndSales) {
-    m_timeAndSaleDataStore.Store(timeAndSales);
+    Write(m_timeAndSaleDataStore, m_timeAndSaleBatchSize, timeAndSales);
   }
 
   template<typename C>
@@ -319,6 +417,110 @@ namespace Nexus::MarketDataService {
     m_readerPool.Close();
     m_openState.Close();
   }
+
+  template<typename C>
+  SqlHistoricalDataStoreMetrics SqlHistoricalDataStore<C>::GetMetrics() const {
+    auto metrics = SqlHistoricalDataStoreMetrics();
+    metrics.m_writerCount = m_writerCount;
+    metrics.m_queueDepth = m_queueDepth.load();
+    metrics.m_rowCount = m_rowCount.load();
+    metrics.m_batchCount = m_batchCount.load();
+    metrics.m_batchSize = std::max({m_orderImbalanceBatchSize.load(),
+      m_bboQuoteBatchSize.load(), m_marketQuoteBatchSize.load(),
+      m_bookQuoteBatchSize.load(), m_timeAndSaleBatchSize.load()});
+    metrics.m_lastCommitLatency = boost::posix_time::microseconds(
+      m_lastCommitLatency.load());
+    metrics.m_maxCommitLatency = boost::posix_time::microseconds(
+      m_maxCommitLatency.load());
+    return metrics;
+  }
+
+  template<typename C>
+  template<typename D, typename T>
+  void SqlHistoricalDataStore<C>::Write(D& dataStore,
+      std::atomic<int>& batchSize, const std::vector<T>& values) {
+    if(values.empty()) {
+      return;
+    }
+    m_queueDepth += static_cast<std::int64_t>(values.size());
+    if(m_writerCount == 1 ||
+        static_cast<int>(values.size()) <= batchSize.load()) {
+      WriteLane(dataStore, batchSize, values);
+      return;
+    }
+    auto lanes = std::vector<std::vector<T>>(m_writerCount);
+    for(auto& value : values) {
+      auto& index = value.GetValue().GetIndex();
+      auto lane = std::hash<std::decay_t<decltype(index)>>()(index) %
+        m_writerCount;
+      lanes[lane].push_back(value);
+    }
+    auto errors = std::vector<std::exception_ptr>(m_writerCount);
+    auto routines = Beam::Routines::RoutineHandlerGroup();
+    for(auto i = 0; i != m_writerCount; ++i) {
+      if(lanes[i].empty()) {
+        continue;
+      }
+      routines.Spawn([&, i] {
+        try {
+          WriteLane(dataStore, batchSize, lanes[i]);
+        } catch(const std::exception&) {
+          errors[i] = std::current_exception();
+        }
+      });
+    }
+    routines.Wait();
+    for(auto& error : errors) {
+      if(error) {
+        std::rethrow_exception(error);
+      }
+    }
+  }
+
+  template<typename C>
+  template<typename D, typename T>
+  void SqlHistoricalDataStore<C>::WriteLane(D& dataStore,
+      std::atomic<int>& batchSize, const std::vector<T>& values) {
+    auto size = static_cast<int>(values.size());
+    auto position = 0;
+    while(position != size) {
+      auto count = std::min(size - position, batchSize.load());
+      auto start = std::chrono::steady_clock::now();
+      try {
+        if(count == size) {
+          dataStore.Store(values);
+        } else {
+          dataStore.Store(std::vector<T>(values.begin() + position,
+            values.begin() + position + count));
+        }
+      } catch(const std::exception&) {
+        m_queueDepth -= size - position;
+        throw;
+      }
+      RecordCommit(batchSize, count, std::chrono::steady_clock::now() - start);
+      position += count;
+    }
+  }
+
+  template<typename C>
+  void SqlHistoricalDataStore<C>::RecordCommit(std::atomic<int>& batchSize,
+      int count, std::chrono::steady_clock::duration latency) {
+    m_queueDepth -= count;
+    m_rowCount += count;
+    ++m_batchCount;
+    auto microseconds = static_cast<std::int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+    m_lastCommitLatency = microseconds;
+    auto maxLatency = m_maxCommitLatency.load();
+    while(microseconds > maxLatency &&
+        !m_maxCommitLatency.compare_exchange_weak(maxLatency, microseconds)) {}
+    auto size = batchSize.load();
+    if(latency > TARGET_COMMIT_LATENCY) {
+      batchSize = std::max(MIN_BATCH_SIZE, size / 2);
+    } else if(latency < TARGET_COMMIT_LATENCY / 2 && count >= size) {
+      batchSize = std::min(MAX_BATCH_SIZE, size + size / 4);
+    }
+  }
 }
 
 #endif
@@ -3,13 +3,13 @@
 #include <memory>
 #include <type_traits>
 #include <Beam/Collections/SynchronizedMap.hpp>
-#include <Beam/Queues/StateQueue.hpp>
 #include <Beam/Pointers/LocalPtr.hpp>
 #include <Beam/Threading/Mutex.hpp>
 #include <Beam/Threading/Sync.hpp>
 #include <boost/optional/optional.hpp>
 #include "Nexus/Definitions/BboQuote.hpp"
 #include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/MarketDataService/BboQuoteCache.hpp"
 #include "Nexus/OrderExecutionService/OrderExecutionService.hpp"
 #include "Nexus/OrderExecutionService/OrderSubmissionCheck.hpp"
 #include "Nexus/OrderExecutionService/OrderSubmissionCheckException.hpp"
@@ -32,6 +32,10 @@ namespace Nexus::OrderExecutionService {
        */
       using MarketDataClient = Beam::GetTryDereferenceType<C>;
 
+      /** The type of BboQuoteCache used to price Orders. */
+      using BboQuoteCache =
+        MarketDataService::BboQuoteCache<MarketDataClient*>;
+
       /**
        * Constructs a BoardLotCheck.
        * @param marketDataClient Initializes the MarketDataClient.
@@ -40,12 +44,26 @@ namespace Nexus::OrderExecutionService {
       BoardLotCheck(CF&& marketDataClient, const MarketDatabase& marketDatabase,
         const boost::local_time::tz_database& timeZoneDatabase);
 
+      /**
+       * Constructs a BoardLotCheck pricing Orders off of a shared
+       * BboQuoteCache.
+       * @param marketDataClient Initializes the MarketDataClient.
+       * @param bboQuotes The BboQuoteCache used to price Orders.
+       */
+      template<typename CF>
+      BoardLotCheck(CF&& marketDataClient, const MarketDatabase& marketDatabase,
+        const boost::local_time::tz_database& timeZoneDatabase,
+        std::shared_ptr<BboQuoteCache> bboQuotes);
+
       void Submit(const OrderInfo& orderInfo) override;
 
+      std::string GetName() const override;
+
     private:
       struct ClosingEntry {
         boost::posix_time::ptime m_lastUpdate;
         boost::optional<Money> m_closingPrice;
+        boost::optional<typename BboQuoteCache::Handle> m_bboQuote;
 
         ClosingEntry();
       };
@@ -55,8 +73,7 @@ namespace Nexus::OrderExecutionService {
       Beam::SynchronizedUnorderedMap<Security,
         Beam::Threading::Sync<ClosingEntry, Beam::Threading::Mutex>>
           m_closingEntries;
-      Beam::SynchronizedUnorderedMap<Security,
-        std::shared_ptr<Beam::StateQueue<BboQuote>>> m_bboQuotes;
+      std::shared_ptr<BboQuoteCache> m_bboQuotes;
 
       Money LoadPrice(const Security& security,
         boost::posix_time::ptime timestamp);
@@ -75,6 +92,17 @@ namespace Nexus::OrderExecutionService {
       timeZoneDatabase);
   }
 
+  template<typename MarketDataClient>
+  auto MakeBoardLotCheck(MarketDataClient&& marketDataClient,
+      const MarketDatabase& marketDatabase,
+      const boost::local_time::tz_database& timeZoneDatabase,
+      std::shared_ptr<typename BoardLotCheck<
+        std::decay_t<MarketDataClient>>::BboQuoteCache> bboQuotes) {
+    return std::make_unique<BoardLotCheck<std::decay_t<MarketDataClient>>>(
+      std::forward<MarketDataClient>(marketDataClient), marketDatabase,
+      timeZoneDatabase, std::move(bboQuotes));
+  }
+
   template<typename C>
   template<typename CF>
   BoardLotCheck<C>::BoardLotCheck(CF&& marketDataClient,
@@ -82,7 +110,19 @@ namespace Nexus::OrderExecutionService {
     const boost::local_time::tz_database& timeZoneDatabase)
     : m_marketDataClient(std::forward<CF>(marketDataClient)),
       m_marketDatabase(marketDatabase),
-      m_timeZoneDatabase(timeZoneDatabase) {}
+      m_timeZoneDatabase(timeZoneDatabase),
+      m_bboQuotes(std::make_shared<BboQuoteCache>(&*m_marketDataClient)) {}
+
+  template<typename C>
+  template<typename CF>
+  BoardLotCheck<C>::BoardLotCheck(CF&& marketDataClient,
+    const MarketDatabase& marketDatabase,
+    const boost::local_time::tz_database& timeZoneDatabase,
+    std::shared_ptr<BboQuoteCache> bboQuotes)
+    : m_marketDataClient(std::forward<CF>(marketDataClient)),
+      m_marketDatabase(marketDatabase),
+      m_timeZoneDatabase(timeZoneDatabase),
+      m_bboQuotes(std::move(bboQuotes)) {}
 
   template<typename C>
   void BoardLotCheck<C>::Submit(const OrderInfo& orderInfo) {
@@ -112,11 +152,21 @@ namespace Nexus::OrderExecutionService {
     }
   }
 
+  template<typename C>
+  std::string BoardLotCheck<C>::GetName() const {
+    return "board_lot";
+  }
+
   template<typename C>
   Money BoardLotCheck<C>::LoadPrice(const Security& security,
       boost::posix_time::ptime timestamp) {
     auto& closingEntry = m_closingEntries.Get(security);
+    auto bboQuote = typename BboQuoteCache::Handle();
     auto closingPrice = Beam::Threading::With(closingEntry, [&] (auto& entry) {
+      if(!entry.m_bboQuote) {
+        entry.m_bboQuote = m_bboQuotes->GetHandle(security);
+      }
+      bboQuote = *entry.m_bboQuote;
       if(timestamp - entry.m_lastUpdate > boost::posix_time::hours(1)) {
         if(auto close = TechnicalAnalysis::LoadPreviousClose(
             *m_marketDataClient, security, timestamp, m_marketDatabase,
@@ -130,21 +180,14 @@ namespace Nexus::OrderExecutionService {
     if(closingPrice) {
       return *closingPrice;
     }
-    auto publisher = m_bboQuotes.GetOrInsert(security, [&] {
-      auto publisher = std::make_shared<Beam::StateQueue<BboQuote>>();
-      MarketDataService::QueryRealTimeWithSnapshot(security,
-        *m_marketDataClient, publisher);
-      return publisher;
-    });
     try {
-      auto effectiveClosingPrice = publisher->Peek().m_bid.m_price;
+      auto effectiveClosingPrice = m_bboQuotes->Load(bboQuote).m_bid.m_price;
       return Beam::Threading::With(closingEntry, [&] (auto& entry) {
         entry.m_closingPrice = effectiveClosingPrice;
         entry.m_lastUpdate = timestamp;
         return effectiveClosingPrice;
       });
     } catch(const Beam::PipeBrokenException&) {
-      m_bboQuotes.Erase(security);
       BOOST_THROW_EXCEPTION(OrderSubmissionCheckException(
         "No BBO quote available."));
     }
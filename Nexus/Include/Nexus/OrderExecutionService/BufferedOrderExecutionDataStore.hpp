@@ -0,0 +1,393 @@
+#ifndef NEXUS_BUFFERED_ORDER_EXECUTION_DATA_STORE_HPP
+#define NEXUS_BUFFERED_ORDER_EXECUTION_DATA_STORE_HPP
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <memory>
+#include <vector>
+#include <Beam/IO/OpenState.hpp>
+#include <Beam/Pointers/Dereference.hpp>
+#include <Beam/Pointers/LocalPtr.hpp>
+#include <Beam/Routines/RoutineHandler.hpp>
+#include <Beam/Threading/ConditionVariable.hpp>
+#include <Beam/Threading/LiveTimer.hpp>
+#include <Beam/Threading/Mutex.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/optional/optional.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/throw_exception.hpp>
+#include "Nexus/OrderExecutionService/AccountQuery.hpp"
+#include "Nexus/OrderExecutionService/OrderExecutionDataStoreException.hpp"
+#include "Nexus/OrderExecutionService/OrderExecutionService.hpp"
+#include "Nexus/OrderExecutionService/OrderRecord.hpp"
+
+namespace Nexus::OrderExecutionService {
+namespace Details {
+  template<typename D, typename T, typename = void>
+  struct HasBatchStore : std::false_type {};
+
+  template<typename D, typename T>
+  struct HasBatchStore<D, T, std::void_t<decltype(std::declval<D&>().Store(
+    std::declval<const std::vector<T>&>()))>> : std::true_type {};
+}
+
+  /**
+   * Wraps an OrderExecutionDataStore so that stores are committed in batches
+   * by a background routine rather than by the caller. Loads wait for the
+   * buffered stores of the account or order being loaded to be committed so
+   * that reads always observe prior writes. If a commit fails, the failed
+   * stores remain buffered and are retried with an exponential backoff, stores
+   * continue to be accepted in the meantime. While the most recent commit has
+   * failed, loads waiting on buffered stores throw that failure.
+   * @param <D> The type of OrderExecutionDataStore to commit to.
+   */
+  template<typename D>
+  class BufferedOrderExecutionDataStore {
+    public:
+
+      /** The type of OrderExecutionDataStore to commit to. */
+      using OrderExecutionDataStore = Beam::GetTryDereferenceType<D>;
+
+      /** The number of times the retry delay may double. */
+      static constexpr auto MAX_RETRY_DOUBLINGS = 6;
+
+      /** Returns the default delay before retrying a failed commit. */
+      static boost::posix_time::time_duration GetDefaultRetryDelay();
+
+      /**
+       * Constructs a BufferedOrderExecutionDataStore.
+       * @param dataStore Initializes the data store to commit to.
+       */
+      template<typename DF>
+      explicit BufferedOrderExecutionDataStore(DF&& dataStore);
+
+      /**
+       * Constructs a BufferedOrderExecutionDataStore.
+       * @param dataStore Initializes the data store to commit to.
+       * @param retryDelay The delay before retrying a failed commit, doubled
+       *        after each consecutive failure.
+       */
+      template<typename DF>
+      BufferedOrderExecutionDataStore(DF&& dataStore,
+        boost::posix_time::time_duration retryDelay);
+
+      ~BufferedOrderExecutionDataStore();
+
+      boost::optional<SequencedAccountOrderRecord> LoadOrder(OrderId id);
+
+      std::vector<SequencedOrderRecord> LoadOrderSubmissions(
+        const AccountQuery& query);
+
+      std::vector<SequencedExecutionReport> LoadExecutionReports(
+        const AccountQuery& query);
+
+      void Store(const SequencedAccountOrderInfo& orderInfo);
+
+      void Store(const SequencedAccountExecutionReport& executionReport);
+
+      /**
+       * Waits until every buffered store has been committed, retrying failed
+       * commits for as long as the data store is open.
+       * @throws The exception raised by the last failed commit if the data
+       *         store is closed before every store is committed.
+       */
+      void Flush();
+
+      /**
+       * Makes a final attempt to commit all buffered stores and closes the
+       * underlying data store.
+       * @throws The exception raised by a failed final commit.
+       */
+      void Close();
+
+    private:
+      Beam::GetOptionalLocalPtr<D> m_dataStore;
+      boost::posix_time::time_duration m_retryDelay;
+      Beam::Threading::Mutex m_mutex;
+      std::vector<SequencedAccountOrderInfo> m_orderInfo;
+      std::vector<SequencedAccountExecutionReport> m_executionReports;
+      std::uint64_t m_storeCount;
+      std::uint64_t m_commitCount;
+      std::unordered_map<Beam::ServiceLocator::DirectoryEntry, std::uint64_t>
+        m_accountStoreCounts;
+      std::unordered_map<OrderId, std::uint64_t> m_orderStoreCounts;
+      bool m_isClosing;
+      bool m_isCommitStopped;
+      std::exception_ptr m_exception;
+      std::shared_ptr<Beam::Threading::LiveTimer> m_retryTimer;
+      Beam::Threading::ConditionVariable m_isPendingCondition;
+      Beam::Threading::ConditionVariable m_isCommittedCondition;
+      Beam::Routines::RoutineHandler m_commitRoutine;
+      Beam::IO::OpenState m_openState;
+
+      BufferedOrderExecutionDataStore(
+        const BufferedOrderExecutionDataStore&) = delete;
+      BufferedOrderExecutionDataStore& operator =(
+        const BufferedOrderExecutionDataStore&) = delete;
+      void Buffer(const Beam::ServiceLocator::DirectoryEntry& account,
+        OrderId id);
+      void Wait(boost::unique_lock<Beam::Threading::Mutex>& lock,
+        std::uint64_t storeCount, bool isRetrying);
+      template<typename K>
+      void Wait(const std::unordered_map<K, std::uint64_t>& storeCounts,
+        const K& key);
+      template<typename T>
+      void Commit(std::vector<T>& values);
+      template<typename T>
+      void Requeue(std::vector<T>& values, std::vector<T>& buffer);
+      void CommitLoop();
+  };
+
+  template<typename D>
+  BufferedOrderExecutionDataStore(D&&) ->
+    BufferedOrderExecutionDataStore<std::remove_reference_t<D>>;
+
+  template<typename D>
+  boost::posix_time::time_duration
+      BufferedOrderExecutionDataStore<D>::GetDefaultRetryDelay() {
+    return boost::posix_time::milliseconds(100);
+  }
+
+  template<typename D>
+  template<typename DF>
+  BufferedOrderExecutionDataStore<D>::BufferedOrderExecutionDataStore(
+    DF&& dataStore)
+    : BufferedOrderExecutionDataStore(std::forward<DF>(dataStore),
+        GetDefaultRetryDelay()) {}
+
+  template<typename D>
+  template<typename DF>
+  BufferedOrderExecutionDataStore<D>::BufferedOrderExecutionDataStore(
+    DF&& dataStore, boost::posix_time::time_duration retryDelay)
+    : m_dataStore(std::forward<DF>(dataStore)),
+      m_retryDelay(retryDelay),
+      m_storeCount(0),
+      m_commitCount(0),
+      m_isClosing(false),
+      m_isCommitStopped(false) {
+    m_commitRoutine = Beam::Routines::Spawn([=] {
+      CommitLoop();
+    });
+  }
+
+  template<typename D>
+  BufferedOrderExecutionDataStore<D>::~BufferedOrderExecutionDataStore() {
+    try {
+      Close();
+    } catch(const std::exception&) {}
+  }
+
+  template<typename D>
+  boost::optional<SequencedAccountOrderRecord>
+      BufferedOrderExecutionDataStore<D>::LoadOrder(OrderId id) {
+    Wait(m_orderStoreCounts, id);
+    return m_dataStore->LoadOrder(id);
+  }
+
+  template<typename D>
+  std::vector<SequencedOrderRecord>
+      BufferedOrderExecutionDataStore<D>::LoadOrderSubmissions(
+        const AccountQuery& query) {
+    Wait(m_accountStoreCounts, query.GetIndex());
+    return m_dataStore->LoadOrderSubmissions(query);
+  }
+
+  template<typename D>
+  std::vector<SequencedExecutionReport>
+      BufferedOrderExecutionDataStore<D>::LoadExecutionReports(
+        const AccountQuery& query) {
+    Wait(m_accountStoreCounts, query.GetIndex());
+    return m_dataStore->LoadExecutionReports(query);
+  }
+
+  template<typename D>
+  void BufferedOrderExecutionDataStore<D>::Store(
+      const SequencedAccountOrderInfo& orderInfo) {
+    auto lock = boost::lock_guard(m_mutex);
+    m_orderInfo.push_back(orderInfo);
+    Buffer(orderInfo->GetIndex(), (*orderInfo)->m_orderId);
+  }
+
+  template<typename D>
+  void BufferedOrderExecutionDataStore<D>::Store(
+      const SequencedAccountExecutionReport& executionReport) {
+    auto lock = boost::lock_guard(m_mutex);
+    m_executionReports.push_back(executionReport);
+    Buffer(executionReport->GetIndex(), (*executionReport)->m_id);
+  }
+
+  template<typename D>
+  void BufferedOrderExecutionDataStore<D>::Flush() {
+    auto lock = boost::unique_lock(m_mutex);
+    Wait(lock, m_storeCount, true);
+  }
+
+  template<typename D>
+  void BufferedOrderExecutionDataStore<D>::Close() {
+    if(m_openState.SetClosing()) {
+      return;
+    }
+    {
+      auto lock = boost::lock_guard(m_mutex);
+      m_isClosing = true;
+      if(m_retryTimer) {
+        m_retryTimer->Cancel();
+      }
+      m_isPendingCondition.notify_one();
+    }
+    m_commitRoutine.Wait();
+    m_dataStore->Close();
+    m_openState.Close();
+    auto lock = boost::lock_guard(m_mutex);
+    if(m_exception) {
+      std::rethrow_exception(m_exception);
+    }
+  }
+
+  template<typename D>
+  void BufferedOrderExecutionDataStore<D>::Buffer(
+      const Beam::ServiceLocator::DirectoryEntry& account, OrderId id) {
+    ++m_storeCount;
+    m_accountStoreCounts[account] = m_storeCount;
+    m_orderStoreCounts[id] = m_storeCount;
+    m_isPendingCondition.notify_one();
+  }
+
+  template<typename D>
+  void BufferedOrderExecutionDataStore<D>::Wait(
+      boost::unique_lock<Beam::Threading::Mutex>& lock,
+      std::uint64_t storeCount, bool isRetrying) {
+    while(m_commitCount < storeCount && !m_isCommitStopped &&
+        (isRetrying || !m_exception)) {
+      m_isCommittedCondition.wait(lock);
+    }
+    if(m_commitCount < storeCount) {
+      if(m_exception) {
+        std::rethrow_exception(m_exception);
+      }
+      BOOST_THROW_EXCEPTION(OrderExecutionDataStoreException(
+        "Data store closed."));
+    }
+  }
+
+  template<typename D>
+  template<typename K>
+  void BufferedOrderExecutionDataStore<D>::Wait(
+      const std::unordered_map<K, std::uint64_t>& storeCounts, const K& key) {
+    auto lock = boost::unique_lock(m_mutex);
+    auto storeCount = storeCounts.find(key);
+    if(storeCount != storeCounts.end()) {
+      Wait(lock, storeCount->second, false);
+    }
+  }
+
+  template<typename D>
+  template<typename T>
+  void BufferedOrderExecutionDataStore<D>::Commit(std::vector<T>& values) {
+    if(values.empty()) {
+      return;
+    }
+    if constexpr(Details::HasBatchStore<OrderExecutionDataStore, T>::value) {
+      m_dataStore->Store(values);
+      values.clear();
+    } else {
+      auto i = values.begin();
+      try {
+        for(; i != values.end(); ++i) {
+          m_dataStore->Store(*i);
+        }
+      } catch(const std::exception&) {
+        values.erase(values.begin(), i);
+        throw;
+      }
+      values.clear();
+    }
+  }
+
+  template<typename D>
+  template<typename T>
+  void BufferedOrderExecutionDataStore<D>::Requeue(std::vector<T>& values,
+      std::vector<T>& buffer) {
+    buffer.insert(buffer.begin(), std::make_move_iterator(values.begin()),
+      std::make_move_iterator(values.end()));
+    values.clear();
+  }
+
+  template<typename D>
+  void BufferedOrderExecutionDataStore<D>::CommitLoop() {
+    auto orderInfo = std::vector<SequencedAccountOrderInfo>();
+    auto executionReports = std::vector<SequencedAccountExecutionReport>();
+    auto failureCount = 0;
+    while(true) {
+      auto storeCount = std::uint64_t(0);
+      {
+        auto lock = boost::unique_lock(m_mutex);
+        while(m_commitCount == m_storeCount && !m_isClosing) {
+          m_isPendingCondition.wait(lock);
+        }
+        if(m_commitCount == m_storeCount) {
+          m_isCommitStopped = true;
+          m_isCommittedCondition.notify_all();
+          return;
+        }
+        orderInfo.swap(m_orderInfo);
+        executionReports.swap(m_executionReports);
+        storeCount = m_storeCount;
+      }
+      try {
+        Commit(orderInfo);
+        Commit(executionReports);
+      } catch(const std::exception&) {
+        auto retryTimer = std::shared_ptr<Beam::Threading::LiveTimer>();
+        {
+          auto lock = boost::lock_guard(m_mutex);
+          m_exception = std::current_exception();
+          Requeue(orderInfo, m_orderInfo);
+          Requeue(executionReports, m_executionReports);
+          if(m_isClosing) {
+            m_isCommitStopped = true;
+            m_isCommittedCondition.notify_all();
+            return;
+          }
+          m_isCommittedCondition.notify_all();
+          retryTimer = std::make_shared<Beam::Threading::LiveTimer>(
+            m_retryDelay * (1 << std::min(failureCount, MAX_RETRY_DOUBLINGS)));
+          m_retryTimer = retryTimer;
+          retryTimer->Start();
+        }
+        ++failureCount;
+        retryTimer->Wait();
+        auto lock = boost::lock_guard(m_mutex);
+        m_retryTimer = nullptr;
+        continue;
+      }
+      failureCount = 0;
+      auto lock = boost::lock_guard(m_mutex);
+      m_exception = nullptr;
+      m_commitCount = storeCount;
+      for(auto i = m_accountStoreCounts.begin();
+          i != m_accountStoreCounts.end();) {
+        if(i->second <= m_commitCount) {
+          i = m_accountStoreCounts.erase(i);
+        } else {
+          ++i;
+        }
+      }
+      for(auto i = m_orderStoreCounts.begin();
+          i != m_orderStoreCounts.end();) {
+        if(i->second <= m_commitCount) {
+          i = m_orderStoreCounts.erase(i);
+        } else {
+          ++i;
+        }
+      }
+      m_isCommittedCondition.notify_all();
+    }
+  }
+}
+
+#endif
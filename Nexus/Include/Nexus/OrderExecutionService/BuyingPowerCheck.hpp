@@ -1,5 +1,6 @@
 #ifndef NEXUS_BUYING_POWER_CHECK_HPP
 #define NEXUS_BUYING_POWER_CHECK_HPP
+#include <memory>
 #include <vector>
 #include <Beam/Collections/SynchronizedMap.hpp>
 #include <Beam/Queues/MultiQueueWriter.hpp>
@@ -10,7 +11,7 @@
 #include "Nexus/Definitions/BboQuote.hpp"
 #include "Nexus/Definitions/ExchangeRateTable.hpp"
 #include "Nexus/Definitions/Security.hpp"
-#include "Nexus/MarketDataService/SecurityMarketDataQuery.hpp"
+#include "Nexus/MarketDataService/BboQuoteCache.hpp"
 #include "Nexus/OrderExecutionService/ExecutionReport.hpp"
 #include "Nexus/OrderExecutionService/Order.hpp"
 #include "Nexus/OrderExecutionService/OrderSubmissionCheck.hpp"
@@ -38,6 +39,10 @@ namespace Nexus::OrderExecutionService {
        */
       using MarketDataClient = Beam::GetTryDereferenceType<M>;
 
+      /** The type of BboQuoteCache used to price Orders. */
+      using BboQuoteCache =
+        MarketDataService::BboQuoteCache<MarketDataClient*>;
+
       /**
        * Constructs a BuyingPowerCheck.
        * @param exchangeRates The list of ExchangeRates.
@@ -48,12 +53,29 @@ namespace Nexus::OrderExecutionService {
       BuyingPowerCheck(const std::vector<ExchangeRate>& exchangeRates,
         AF&& administrationClient, MF&& marketDataClient);
 
+      /**
+       * Constructs a BuyingPowerCheck pricing Orders off of a shared
+       * BboQuoteCache.
+       * @param exchangeRates The list of ExchangeRates.
+       * @param administrationClient Initializes the AdministrationClient.
+       * @param marketDataClient Initializes the MarketDataClient.
+       * @param bboQuotes The BboQuoteCache used to price Orders.
+       */
+      template<typename AF, typename MF>
+      BuyingPowerCheck(const std::vector<ExchangeRate>& exchangeRates,
+        AF&& administrationClient, MF&& marketDataClient,
+        std::shared_ptr<BboQuoteCache> bboQuotes);
+
       void Submit(const OrderInfo& orderInfo) override;
 
       void Add(const Order& order) override;
 
       void Reject(const OrderInfo& orderInfo) override;
 
+      bool IsStateful() const override;
+
+      std::string GetName() const override;
+
     private:
       struct BuyingPowerEntry {
         Beam::Threading::Sync<Accounting::BuyingPowerModel> m_buyingPowerModel;
@@ -61,6 +83,8 @@ namespace Nexus::OrderExecutionService {
           m_riskParametersQueue;
         Beam::MultiQueueWriter<ExecutionReport> m_executionReportQueue;
         Beam::SynchronizedUnorderedMap<OrderId, CurrencyId> m_currencies;
+        Beam::SynchronizedUnorderedMap<Security,
+          typename BboQuoteCache::Handle> m_bboQuotes;
 
         BuyingPowerEntry();
       };
@@ -69,11 +93,12 @@ namespace Nexus::OrderExecutionService {
       Beam::GetOptionalLocalPtr<M> m_marketDataClient;
       Beam::SynchronizedUnorderedMap<Beam::ServiceLocator::DirectoryEntry,
         std::shared_ptr<BuyingPowerEntry>> m_buyingPowerEntries;
-      Beam::SynchronizedUnorderedMap<Security,
-        std::shared_ptr<Beam::StateQueue<BboQuote>>> m_bboQuotes;
+      std::shared_ptr<BboQuoteCache> m_bboQuotes;
 
-      BboQuote LoadBboQuote(const Security& security);
-      Money GetExpectedPrice(const OrderFields& orderFields);
+      BboQuote LoadBboQuote(BuyingPowerEntry& buyingPowerEntry,
+        const Security& security);
+      Money GetExpectedPrice(BuyingPowerEntry& buyingPowerEntry,
+        const OrderFields& orderFields);
       BuyingPowerEntry& LoadBuyingPowerEntry(
         const Beam::ServiceLocator::DirectoryEntry& account);
   };
@@ -89,7 +114,21 @@ namespace Nexus::OrderExecutionService {
       const std::vector<ExchangeRate>& exchangeRates, AF&& administrationClient,
       MF&& marketDataClient)
       : m_administrationClient(std::forward<AF>(administrationClient)),
-        m_marketDataClient(std::forward<MF>(marketDataClient)) {
+        m_marketDataClient(std::forward<MF>(marketDataClient)),
+        m_bboQuotes(std::make_shared<BboQuoteCache>(&*m_marketDataClient)) {
+    for(auto& exchangeRate : exchangeRates) {
+      m_exchangeRates.Add(exchangeRate);
+    }
+  }
+
+  template<typename A, typename M>
+  template<typename AF, typename MF>
+  BuyingPowerCheck<A, M>::BuyingPowerCheck(
+      const std::vector<ExchangeRate>& exchangeRates, AF&& administrationClient,
+      MF&& marketDataClient, std::shared_ptr<BboQuoteCache> bboQuotes)
+      : m_administrationClient(std::forward<AF>(administrationClient)),
+        m_marketDataClient(std::forward<MF>(marketDataClient)),
+        m_bboQuotes(std::move(bboQuotes)) {
     for(auto& exchangeRate : exchangeRates) {
       m_exchangeRates.Add(exchangeRate);
     }
@@ -98,8 +137,8 @@ namespace Nexus::OrderExecutionService {
   template<typename A, typename M>
   void BuyingPowerCheck<A, M>::Submit(const OrderInfo& orderInfo) {
     auto& fields = orderInfo.m_fields;
-    auto price = GetExpectedPrice(fields);
     auto& buyingPowerEntry = LoadBuyingPowerEntry(fields.m_account);
+    auto price = GetExpectedPrice(buyingPowerEntry, fields);
     Beam::Threading::With(buyingPowerEntry.m_buyingPowerModel,
       [&] (auto& buyingPowerModel) {
         auto riskParameters = buyingPowerEntry.m_riskParametersQueue->Peek();
@@ -148,7 +187,7 @@ namespace Nexus::OrderExecutionService {
       order.GetInfo().m_fields.m_account);
     auto price = [&] {
       try {
-        return GetExpectedPrice(order.GetInfo().m_fields);
+        return GetExpectedPrice(buyingPowerEntry, order.GetInfo().m_fields);
       } catch(const std::exception&) {
         if(order.GetInfo().m_fields.m_type == OrderType::LIMIT) {
           return order.GetInfo().m_fields.m_price;
@@ -199,17 +238,24 @@ namespace Nexus::OrderExecutionService {
   }
 
   template<typename A, typename M>
-  BboQuote BuyingPowerCheck<A, M>::LoadBboQuote(const Security& security) {
-    auto publisher = m_bboQuotes.GetOrInsert(security, [&] {
-      auto publisher = std::make_shared<Beam::StateQueue<BboQuote>>();
-      MarketDataService::QueryRealTimeWithSnapshot(security,
-        *m_marketDataClient, publisher);
-      return publisher;
+  bool BuyingPowerCheck<A, M>::IsStateful() const {
+    return true;
+  }
+
+  template<typename A, typename M>
+  std::string BuyingPowerCheck<A, M>::GetName() const {
+    return "buying_power";
+  }
+
+  template<typename A, typename M>
+  BboQuote BuyingPowerCheck<A, M>::LoadBboQuote(
+      BuyingPowerEntry& buyingPowerEntry, const Security& security) {
+    auto bboQuote = buyingPowerEntry.m_bboQuotes.GetOrInsert(security, [&] {
+      return m_bboQuotes->GetHandle(security);
     });
     try {
-      return publisher->Peek();
+      return m_bboQuotes->Load(bboQuote);
     } catch(const Beam::PipeBrokenException&) {
-      m_bboQuotes.Erase(security);
       BOOST_THROW_EXCEPTION(OrderSubmissionCheckException(
         "No BBO quote available."));
     }
@@ -217,8 +263,8 @@ namespace Nexus::OrderExecutionService {
 
   template<typename A, typename M>
   Money BuyingPowerCheck<A, M>::GetExpectedPrice(
-      const OrderFields& orderFields) {
-    auto bbo = LoadBboQuote(orderFields.m_security);
+      BuyingPowerEntry& buyingPowerEntry, const OrderFields& orderFields) {
+    auto bbo = LoadBboQuote(buyingPowerEntry, orderFields.m_security);
     if(orderFields.m_type == OrderType::LIMIT) {
       if(orderFields.m_price <= Money::ZERO) {
         BOOST_THROW_EXCEPTION(OrderSubmissionCheckException("Invalid price."));
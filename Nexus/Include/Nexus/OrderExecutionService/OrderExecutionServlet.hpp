@@ -1,12 +1,23 @@
 #ifndef NEXUS_ORDER_EXECUTION_SERVLET_HPP
 #define NEXUS_ORDER_EXECUTION_SERVLET_HPP
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <thread>
 #include <Beam/Collections/SynchronizedMap.hpp>
 #include <Beam/Collections/SynchronizedSet.hpp>
 #include <Beam/Pointers/LocalPtr.hpp>
 #include <Beam/Queries/IndexedSubscriptions.hpp>
 #include <Beam/Queues/RoutineTaskQueue.hpp>
+#include <Beam/Routines/Async.hpp>
+#include <Beam/Routines/RoutineHandler.hpp>
+#include <Beam/Routines/RoutineHandlerGroup.hpp>
 #include <Beam/Serialization/JsonSender.hpp>
+#include <Beam/Threading/Mutex.hpp>
 #include <Beam/Threading/Sync.hpp>
 #include <Beam/Utilities/ReportException.hpp>
 #include <boost/functional/factory.hpp>
@@ -17,9 +28,11 @@
 #include "Nexus/Definitions/Destination.hpp"
 #include "Nexus/Definitions/Market.hpp"
 #include "Nexus/OrderExecutionService/AccountQuery.hpp"
+#include "Nexus/OrderExecutionService/BufferedOrderExecutionDataStore.hpp"
 #include "Nexus/OrderExecutionService/Order.hpp"
 #include "Nexus/OrderExecutionService/OrderExecutionServices.hpp"
 #include "Nexus/OrderExecutionService/OrderExecutionSession.hpp"
+#include "Nexus/OrderExecutionService/OrderSubmissionCursor.hpp"
 #include "Nexus/OrderExecutionService/OrderSubmissionRegistry.hpp"
 #include "Nexus/OrderExecutionService/PrimitiveOrder.hpp"
 #include "Nexus/OrderExecutionService/StandardQueries.hpp"
@@ -29,7 +42,15 @@
 namespace Nexus::OrderExecutionService {
 
   /**
-   * Implements the servlet handling order submissions and cancellations.
+   * Implements the servlet handling order submissions and cancellations. The
+   * trading session is recovered in the background once constructed, requests
+   * involving an account that has not yet been recovered wait for it.
+   * Cancels and updates are keyed by order id, so they are queued until the
+   * whole session is recovered, without blocking the client that sent them,
+   * and dropped if that client disconnects first.
+   * ExecutionReports are processed on task queues partitioned by account so
+   * that accounts are handled in parallel while each account's reports remain
+   * ordered, and they are committed to the data store in batches.
    * @param <C> The container instantiating this servlet.
    * @param <T> The type of TimeClient used for timestamps.
    * @param <S> The type of ServiceLocatorClient used.
@@ -98,6 +119,17 @@ namespace Nexus::OrderExecutionService {
     private:
       using SyncShortingModel = Beam::Threading::Sync<
         Accounting::ShortingModel>;
+      struct DeferredRequest {
+        ServiceProtocolClient* m_client;
+        std::function<void ()> m_request;
+      };
+      struct RecoveryMetrics {
+        std::atomic<std::int64_t> m_orderCount;
+        std::atomic<std::int64_t> m_loadTime;
+        std::atomic<std::int64_t> m_replayTime;
+
+        RecoveryMetrics();
+      };
       boost::posix_time::ptime m_sessionStartTime;
       MarketDatabase m_marketDatabase;
       DestinationDatabase m_destinationDatabase;
@@ -107,6 +139,8 @@ namespace Nexus::OrderExecutionService {
       Beam::GetOptionalLocalPtr<A> m_administrationClient;
       Beam::GetOptionalLocalPtr<O> m_driver;
       Beam::GetOptionalLocalPtr<D> m_dataStore;
+      BufferedOrderExecutionDataStore<OrderExecutionDataStore*>
+        m_bufferedDataStore;
       OrderSubmissionRegistry m_registry;
       Beam::Queries::IndexedSubscriptions<OrderRecord,
         Beam::ServiceLocator::DirectoryEntry, ServiceProtocolClient>
@@ -121,14 +155,28 @@ namespace Nexus::OrderExecutionService {
       Beam::SynchronizedUnorderedMap<Beam::ServiceLocator::DirectoryEntry,
         std::shared_ptr<SyncShortingModel>> m_shortingModels;
       Beam::SynchronizedUnorderedSet<OrderId> m_liveOrders;
+      Beam::SynchronizedUnorderedMap<Beam::ServiceLocator::DirectoryEntry,
+        std::shared_ptr<Beam::Routines::Async<void>>> m_accountRecoveries;
+      Beam::Threading::Sync<boost::optional<std::vector<DeferredRequest>>,
+        Beam::Threading::Mutex> m_deferredRequests;
       Beam::IO::OpenState m_openState;
-      Beam::RoutineTaskQueue m_tasks;
+      std::vector<std::unique_ptr<Beam::RoutineTaskQueue>> m_tasks;
+      Beam::Routines::RoutineHandler m_recoveryRoutine;
 
       OrderExecutionServlet(const OrderExecutionServlet&) = delete;
       OrderExecutionServlet& operator =(
         const OrderExecutionServlet&) = delete;
-      void Recover(const Beam::ServiceLocator::DirectoryEntry& account);
-      void RecoverTradingSession();
+      void Recover(const Beam::ServiceLocator::DirectoryEntry& account,
+        RecoveryMetrics& metrics);
+      void Recover(const Beam::ServiceLocator::DirectoryEntry& account,
+        const SequencedOrderRecord& orderRecord);
+      void RecoverTradingSession(
+        const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts);
+      void WaitForRecovery(const Beam::ServiceLocator::DirectoryEntry& account);
+      void DeferUntilRecovered(ServiceProtocolClient& client,
+        std::function<void ()> request);
+      Beam::RoutineTaskQueue& GetTasks(
+        const Beam::ServiceLocator::DirectoryEntry& account);
       void OnExecutionReport(const ExecutionReport& executionReport,
         const Beam::ServiceLocator::DirectoryEntry& account,
         SyncShortingModel& shortingModel);
@@ -143,7 +191,8 @@ namespace Nexus::OrderExecutionService {
       void OnNewOrderSingleRequest(Beam::Services::RequestToken<
         ServiceProtocolClient, NewOrderSingleService>& request,
         const OrderFields& requestFields);
-      void OnUpdateOrderRequest(ServiceProtocolClient& client, OrderId orderId,
+      void OnUpdateOrderRequest(Beam::Services::RequestToken<
+        ServiceProtocolClient, UpdateOrderService>& request, OrderId orderId,
         const ExecutionReport& executionReport);
       void OnCancelOrder(ServiceProtocolClient& client, OrderId orderId);
   };
@@ -175,13 +224,25 @@ namespace Nexus::OrderExecutionService {
         m_uidClient(std::forward<UF>(uidClient)),
         m_administrationClient(std::forward<AF>(administrationClient)),
         m_driver(std::forward<OF>(driver)),
-        m_dataStore(std::forward<DF>(dataStore)) {
+        m_dataStore(std::forward<DF>(dataStore)),
+        m_bufferedDataStore(&*m_dataStore) {
     try {
+      auto taskCount = std::max(1U, std::thread::hardware_concurrency());
+      for(auto i = 0U; i != taskCount; ++i) {
+        m_tasks.push_back(std::make_unique<Beam::RoutineTaskQueue>());
+      }
       auto accounts = m_serviceLocatorClient->LoadAllAccounts();
       for(auto& account : accounts) {
         m_registry.AddAccount(account);
+        m_accountRecoveries.GetOrInsert(account,
+          boost::factory<std::shared_ptr<Beam::Routines::Async<void>>>());
       }
-      RecoverTradingSession();
+      Beam::Threading::With(m_deferredRequests, [] (auto& requests) {
+        requests.emplace();
+      });
+      m_recoveryRoutine = Beam::Routines::Spawn([=] {
+        RecoverTradingSession(accounts);
+      });
     } catch(const std::exception&) {
       Close();
       BOOST_RETHROW;
@@ -207,7 +268,7 @@ namespace Nexus::OrderExecutionService {
     NewOrderSingleService::AddRequestSlot(Beam::Store(slots), std::bind(
       &OrderExecutionServlet::OnNewOrderSingleRequest, this,
       std::placeholders::_1, std::placeholders::_2));
-    UpdateOrderService::AddSlot(Beam::Store(slots), std::bind(
+    UpdateOrderService::AddRequestSlot(Beam::Store(slots), std::bind(
       &OrderExecutionServlet::OnUpdateOrderRequest, this,
       std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
     Beam::Services::AddMessageSlot<CancelOrderMessage>(Beam::Store(slots),
@@ -241,6 +302,14 @@ namespace Nexus::OrderExecutionService {
     typename O, typename D>
   void OrderExecutionServlet<C, T, S, U, A, O, D>::HandleClientClosed(
       ServiceProtocolClient& client) {
+    Beam::Threading::With(m_deferredRequests, [&] (auto& requests) {
+      if(requests) {
+        requests->erase(std::remove_if(requests->begin(), requests->end(),
+          [&] (const auto& request) {
+            return request.m_client == &client;
+          }), requests->end());
+      }
+    });
     m_executionReportSubscriptions.RemoveAll(client);
     m_orderSubscriptions.RemoveAll(client);
     m_submissionSubscriptions.RemoveAll(client);
@@ -252,89 +321,224 @@ namespace Nexus::OrderExecutionService {
     if(m_openState.SetClosing()) {
       return;
     }
-    m_tasks.Break();
-    m_tasks.Wait();
-    m_dataStore->Close();
+    m_recoveryRoutine.Wait();
+    for(auto& tasks : m_tasks) {
+      tasks->Break();
+    }
+    for(auto& tasks : m_tasks) {
+      tasks->Wait();
+    }
+    try {
+      m_bufferedDataStore.Close();
+    } catch(const std::exception&) {
+      std::cout << BEAM_REPORT_CURRENT_EXCEPTION() << std::flush;
+    }
     m_driver->Close();
     m_shortingModels.Clear();
     m_openState.Close();
   }
 
+  template<typename C, typename T, typename S, typename U, typename A,
+    typename O, typename D>
+  OrderExecutionServlet<C, T, S, U, A, O, D>::RecoveryMetrics::
+    RecoveryMetrics()
+    : m_orderCount(0),
+      m_loadTime(0),
+      m_replayTime(0) {}
+
   template<typename C, typename T, typename S, typename U, typename A,
     typename O, typename D>
   void OrderExecutionServlet<C, T, S, U, A, O, D>::Recover(
-      const Beam::ServiceLocator::DirectoryEntry& account) {
+      const Beam::ServiceLocator::DirectoryEntry& account,
+      RecoveryMetrics& metrics) {
+    auto elapsed = [] (auto start) {
+      return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    };
+    auto loadStart = std::chrono::steady_clock::now();
+    auto liveOrders = m_bufferedDataStore.LoadOrderSubmissions(
+      MakeLiveOrdersQuery(account));
+    metrics.m_loadTime += elapsed(loadStart);
     auto recoveryQuery = AccountQuery();
     recoveryQuery.SetIndex(account);
     recoveryQuery.SetRange(m_sessionStartTime, Beam::Queries::Sequence::Last());
     recoveryQuery.SetSnapshotLimit(Beam::Queries::SnapshotLimit::Unlimited());
-    auto sessionOrders = m_dataStore->LoadOrderSubmissions(recoveryQuery);
-    auto liveOrders = m_dataStore->LoadOrderSubmissions(
-      MakeLiveOrdersQuery(account));
-    auto orders = std::vector<SequencedOrderRecord>();
-    std::set_union(sessionOrders.begin(), sessionOrders.end(),
-      liveOrders.begin(), liveOrders.end(), std::back_inserter(orders),
-      Beam::Queries::SequenceComparator());
-    for(auto& orderRecord : orders) {
-      auto& syncShortingModel = m_shortingModels.GetOrInsert(
-        orderRecord->m_info.m_fields.m_account,
-        boost::factory<std::shared_ptr<SyncShortingModel>>());
-      syncShortingModel->With([&] (auto& shortingModel) {
-        shortingModel.Submit(orderRecord->m_info.m_orderId,
-          orderRecord->m_info.m_fields);
-        for(auto& executionReport : orderRecord->m_executionReports) {
-          shortingModel.Update(executionReport);
+    auto sessionOrders = OrderSubmissionCursor(&m_bufferedDataStore,
+      std::move(recoveryQuery));
+    auto liveOrder = liveOrders.begin();
+    while(true) {
+      loadStart = std::chrono::steady_clock::now();
+      auto page = sessionOrders.Next();
+      metrics.m_loadTime += elapsed(loadStart);
+      if(page.empty()) {
+        break;
+      }
+      auto replayStart = std::chrono::steady_clock::now();
+      for(auto& orderRecord : page) {
+        while(liveOrder != liveOrders.end() &&
+            liveOrder->GetSequence() < orderRecord.GetSequence()) {
+          Recover(account, *liveOrder);
+          ++liveOrder;
+          ++metrics.m_orderCount;
         }
-      });
-      m_liveOrders.Insert(orderRecord->m_info.m_orderId);
-      auto order = static_cast<const Order*>(nullptr);
+        if(liveOrder != liveOrders.end() &&
+            liveOrder->GetSequence() == orderRecord.GetSequence()) {
+          ++liveOrder;
+        }
+        Recover(account, orderRecord);
+        ++metrics.m_orderCount;
+      }
+      metrics.m_replayTime += elapsed(replayStart);
+    }
+    auto replayStart = std::chrono::steady_clock::now();
+    for(; liveOrder != liveOrders.end(); ++liveOrder) {
+      Recover(account, *liveOrder);
+      ++metrics.m_orderCount;
+    }
+    metrics.m_replayTime += elapsed(replayStart);
+  }
+
+  template<typename C, typename T, typename S, typename U, typename A,
+    typename O, typename D>
+  void OrderExecutionServlet<C, T, S, U, A, O, D>::Recover(
+      const Beam::ServiceLocator::DirectoryEntry& account,
+      const SequencedOrderRecord& orderRecord) {
+    auto& syncShortingModel = m_shortingModels.GetOrInsert(
+      orderRecord->m_info.m_fields.m_account,
+      boost::factory<std::shared_ptr<SyncShortingModel>>());
+    syncShortingModel->With([&] (auto& shortingModel) {
+      shortingModel.Submit(orderRecord->m_info.m_orderId,
+        orderRecord->m_info.m_fields);
+      for(auto& executionReport : orderRecord->m_executionReports) {
+        shortingModel.Update(executionReport);
+      }
+    });
+    m_liveOrders.Insert(orderRecord->m_info.m_orderId);
+    auto order = static_cast<const Order*>(nullptr);
+    try {
+      order = &m_driver->Recover(Beam::Queries::SequencedValue(
+        Beam::Queries::IndexedValue(*orderRecord, account),
+        orderRecord.GetSequence()));
+    } catch(const std::exception&) {
       try {
-        order = &m_driver->Recover(Beam::Queries::SequencedValue(
-          Beam::Queries::IndexedValue(*orderRecord, account),
-          orderRecord.GetSequence()));
+        std::throw_with_nested(std::runtime_error(
+          "Unable to recover order: " + boost::lexical_cast<std::string>(
+            orderRecord->m_info.m_orderId)));
       } catch(const std::exception&) {
-        try {
-          std::throw_with_nested(std::runtime_error(
-            "Unable to recover order: " + boost::lexical_cast<std::string>(
-              orderRecord->m_info.m_orderId)));
-        } catch(const std::exception&) {
-          std::cout << BEAM_REPORT_CURRENT_EXCEPTION() << std::flush;
-          continue;
+        std::cout << BEAM_REPORT_CURRENT_EXCEPTION() << std::flush;
+        return;
+      }
+    }
+    order->GetPublisher().With([&] {
+      auto existingExecutionReports =
+        boost::optional<std::vector<ExecutionReport>>();
+      auto& tasks = GetTasks(order->GetInfo().m_fields.m_account);
+      order->GetPublisher().Monitor(tasks.GetSlot<ExecutionReport>(
+        std::bind(&OrderExecutionServlet::OnExecutionReport, this,
+          std::placeholders::_1, order->GetInfo().m_fields.m_account,
+          std::ref(*syncShortingModel))),
+        Beam::Store(existingExecutionReports));
+      if(existingExecutionReports) {
+        existingExecutionReports->erase(existingExecutionReports->begin(),
+          existingExecutionReports->begin() +
+          orderRecord->m_executionReports.size());
+        for(auto& executionReport : *existingExecutionReports) {
+          tasks.Push(std::bind(&OrderExecutionServlet::OnExecutionReport,
+            this, executionReport, order->GetInfo().m_fields.m_account,
+            std::ref(*syncShortingModel)));
         }
       }
-      order->GetPublisher().With([&] {
-        auto existingExecutionReports =
-          boost::optional<std::vector<ExecutionReport>>();
-        order->GetPublisher().Monitor(m_tasks.GetSlot<ExecutionReport>(
-          std::bind(&OrderExecutionServlet::OnExecutionReport, this,
-            std::placeholders::_1, order->GetInfo().m_fields.m_account,
-            std::ref(*syncShortingModel))),
-          Beam::Store(existingExecutionReports));
-        if(existingExecutionReports) {
-          existingExecutionReports->erase(existingExecutionReports->begin(),
-            existingExecutionReports->begin() +
-            orderRecord->m_executionReports.size());
-          for(auto& executionReport : *existingExecutionReports) {
-            m_tasks.Push(std::bind(&OrderExecutionServlet::OnExecutionReport,
-              this, executionReport, order->GetInfo().m_fields.m_account,
-              std::ref(*syncShortingModel)));
+    });
+  }
+
+  template<typename C, typename T, typename S, typename U, typename A,
+    typename O, typename D>
+  void OrderExecutionServlet<C, T, S, U, A, O, D>::RecoverTradingSession(
+      const std::vector<Beam::ServiceLocator::DirectoryEntry>& accounts) {
+    auto start = std::chrono::steady_clock::now();
+    auto metrics = RecoveryMetrics();
+    auto nextAccount = std::atomic<std::size_t>(0);
+    auto workerCount = std::min<std::size_t>(accounts.size(),
+      std::max(1U, std::thread::hardware_concurrency()));
+    auto routines = Beam::Routines::RoutineHandlerGroup();
+    for(auto i = std::size_t(0); i != workerCount; ++i) {
+      routines.Spawn([&] {
+        while(m_openState.IsOpen()) {
+          auto index = nextAccount++;
+          if(index >= accounts.size()) {
+            break;
+          }
+          auto& account = accounts[index];
+          try {
+            Recover(account, metrics);
+          } catch(const std::exception&) {
+            std::cout << BEAM_REPORT_CURRENT_EXCEPTION() << std::flush;
+          }
+          if(auto recovery = m_accountRecoveries.FindValue(account)) {
+            (*recovery)->GetEval().SetResult();
           }
         }
       });
     }
+    routines.Wait();
+    for(auto i = nextAccount.load(); i < accounts.size(); ++i) {
+      if(auto recovery = m_accountRecoveries.FindValue(accounts[i])) {
+        (*recovery)->GetEval().SetResult();
+      }
+    }
+    Beam::Threading::With(m_deferredRequests, [&] (auto& requests) {
+      if(m_openState.IsOpen()) {
+        for(auto& request : *requests) {
+          try {
+            request.m_request();
+          } catch(const std::exception&) {
+            std::cout << BEAM_REPORT_CURRENT_EXCEPTION() << std::flush;
+          }
+        }
+      }
+      requests = boost::none;
+    });
+    std::cout << "Trading session recovered: accounts: " << accounts.size() <<
+      " orders: " << metrics.m_orderCount << " workers: " << workerCount <<
+      " load: " << metrics.m_loadTime / 1000 << "ms replay: " <<
+      metrics.m_replayTime / 1000 << "ms total: " <<
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count() << "ms" << std::endl;
   }
 
   template<typename C, typename T, typename S, typename U, typename A,
     typename O, typename D>
-  void OrderExecutionServlet<C, T, S, U, A, O, D>::RecoverTradingSession() {
-    auto accounts = m_serviceLocatorClient->LoadAllAccounts();
-    auto routines = Beam::Routines::RoutineHandlerGroup();
-    for(auto& account : accounts) {
-      routines.Spawn([=] {
-        Recover(account);
+  void OrderExecutionServlet<C, T, S, U, A, O, D>::WaitForRecovery(
+      const Beam::ServiceLocator::DirectoryEntry& account) {
+    if(auto recovery = m_accountRecoveries.FindValue(account)) {
+      (*recovery)->Get();
+    }
+  }
+
+  template<typename C, typename T, typename S, typename U, typename A,
+    typename O, typename D>
+  void OrderExecutionServlet<C, T, S, U, A, O, D>::DeferUntilRecovered(
+      ServiceProtocolClient& client, std::function<void ()> request) {
+    auto isDeferred = Beam::Threading::With(m_deferredRequests,
+      [&] (auto& requests) {
+        if(!requests) {
+          return false;
+        }
+        requests->push_back(DeferredRequest{&client, std::move(request)});
+        return true;
       });
+    if(!isDeferred) {
+      request();
     }
-    routines.Wait();
+  }
+
+  template<typename C, typename T, typename S, typename U, typename A,
+    typename O, typename D>
+  Beam::RoutineTaskQueue& OrderExecutionServlet<C, T, S, U, A, O, D>::GetTasks(
+      const Beam::ServiceLocator::DirectoryEntry& account) {
+    auto index = std::hash<Beam::ServiceLocator::DirectoryEntry>()(account) %
+      m_tasks.size();
+    return *m_tasks[index];
   }
 
   template<typename C, typename T, typename S, typename U, typename A,
@@ -349,10 +553,10 @@ namespace Nexus::OrderExecutionService {
     try {
       m_registry.Publish(Beam::Queries::IndexedValue(executionReport, account),
         [&] {
-          return LoadInitialSequences(*m_dataStore, account);
+          return LoadInitialSequences(m_bufferedDataStore, account);
         },
         [&] (const auto& executionReport) {
-          m_dataStore->Store(executionReport);
+          m_bufferedDataStore.Store(executionReport);
           m_orderSubscriptions.Publish(executionReport,
             [&] (const auto& clients) {
               Beam::Services::BroadcastRecordMessage<OrderUpdateMessage>(
@@ -381,11 +585,12 @@ namespace Nexus::OrderExecutionService {
       Beam::Services::RequestToken<ServiceProtocolClient, LoadOrderByIdService>& 
         request, OrderId id) {
     auto& session = request.GetSession();
-    auto order = m_dataStore->LoadOrder(id);
+    auto order = m_bufferedDataStore.LoadOrder(id);
     if(!order || !session.HasOrderExecutionPermission((*order)->GetIndex())) {
       request.SetResult(boost::none);
       return;
     }
+    WaitForRecovery((*order)->GetIndex());
     if(!(**order)->m_executionReports.empty() &&
         IsTerminal((**order)->m_executionReports.back().m_status)) {
       request.SetResult(std::move(order));
@@ -399,7 +604,7 @@ namespace Nexus::OrderExecutionService {
     executionReportResult.m_queryId = m_orderSubscriptions.Initialize(
       query.GetIndex(), request.GetClient(), Beam::Queries::Range::Total(),
       Beam::Queries::Translate(Beam::Queries::ConstantExpression(true)));
-    order = m_dataStore->LoadOrder(id);
+    order = m_bufferedDataStore.LoadOrder(id);
     m_orderSubscriptions.Commit(query.GetIndex(),
       std::move(executionReportResult), [&] (auto executionReportResult) {
         auto& executionReports = (**order)->m_executionReports;
@@ -437,6 +642,7 @@ namespace Nexus::OrderExecutionService {
       request.SetResult(OrderSubmissionQueryResult());
       return;
     }
+    WaitForRecovery(revisedQuery.GetIndex());
     auto filter = Beam::Queries::Translate<Queries::EvaluatorTranslator>(
       revisedQuery.GetFilter(), Beam::Ref(m_liveOrders));
     auto submissionResult = OrderSubmissionQueryResult();
@@ -448,7 +654,7 @@ namespace Nexus::OrderExecutionService {
       revisedQuery.GetIndex(), request.GetClient(),
       Beam::Queries::Range::Total(),
       Beam::Queries::Translate(Beam::Queries::ConstantExpression(true)));
-    submissionResult.m_snapshot = m_dataStore->LoadOrderSubmissions(
+    submissionResult.m_snapshot = m_bufferedDataStore.LoadOrderSubmissions(
       revisedQuery);
     m_submissionSubscriptions.Commit(revisedQuery.GetIndex(),
       std::move(submissionResult), [&] (auto submissionResult) {
@@ -498,13 +704,15 @@ namespace Nexus::OrderExecutionService {
       request.SetResult(ExecutionReportQueryResult());
       return;
     }
+    WaitForRecovery(revisedQuery.GetIndex());
     auto filter = Beam::Queries::Translate<Queries::EvaluatorTranslator>(
       revisedQuery.GetFilter());
     auto result = ExecutionReportQueryResult();
     result.m_queryId = m_executionReportSubscriptions.Initialize(
       revisedQuery.GetIndex(), request.GetClient(), revisedQuery.GetRange(),
       std::move(filter));
-    result.m_snapshot = m_dataStore->LoadExecutionReports(revisedQuery);
+    result.m_snapshot = m_bufferedDataStore.LoadExecutionReports(
+      revisedQuery);
     m_executionReportSubscriptions.Commit(revisedQuery.GetIndex(),
       std::move(result), [&] (auto result) {
         request.SetResult(result);
@@ -544,6 +752,7 @@ namespace Nexus::OrderExecutionService {
       revisedFields->m_currency =
         m_marketDatabase.FromCode(fields->m_security.GetMarket()).m_currency;
     }
+    WaitForRecovery(fields->m_account);
     auto orderId = m_uidClient->LoadNextUid();
     auto shortingModel = m_shortingModels.GetOrInsert(fields->m_account,
       boost::factory<std::shared_ptr<SyncShortingModel>>());
@@ -579,11 +788,12 @@ namespace Nexus::OrderExecutionService {
     }
     m_registry.Publish(orderInfo,
       [&] {
-        return LoadInitialSequences(*m_dataStore, orderInfo.m_fields.m_account);
+        return LoadInitialSequences(m_bufferedDataStore,
+          orderInfo.m_fields.m_account);
       },
       [&] (const auto& orderInfo) {
         m_liveOrders.Insert((*orderInfo)->m_orderId);
-        m_dataStore->Store(orderInfo);
+        m_bufferedDataStore.Store(orderInfo);
         request.SetResult(orderInfo);
         auto orderRecord = Beam::Queries::SequencedValue(
           Beam::Queries::IndexedValue(OrderRecord(**orderInfo, {}),
@@ -597,7 +807,8 @@ namespace Nexus::OrderExecutionService {
               clients, orderRecord);
           });
       });
-    order->GetPublisher().Monitor(m_tasks.GetSlot<ExecutionReport>(
+    auto& tasks = GetTasks(orderInfo.m_fields.m_account);
+    order->GetPublisher().Monitor(tasks.GetSlot<ExecutionReport>(
       std::bind(&OrderExecutionServlet::OnExecutionReport, this,
         std::placeholders::_1, orderInfo.m_fields.m_account,
         std::ref(*shortingModel))));
@@ -606,28 +817,39 @@ namespace Nexus::OrderExecutionService {
   template<typename C, typename T, typename S, typename U, typename A,
     typename O, typename D>
   void OrderExecutionServlet<C, T, S, U, A, O, D>::OnUpdateOrderRequest(
-      ServiceProtocolClient& client, OrderId orderId,
-      const ExecutionReport& executionReport) {
-    auto& session = client.GetSession();
+      Beam::Services::RequestToken<ServiceProtocolClient, UpdateOrderService>&
+        request, OrderId orderId, const ExecutionReport& executionReport) {
+    auto& session = request.GetSession();
     if(!session.IsAdministrator()) {
       throw Beam::Services::ServiceRequestException(
         "Insufficient permissions.");
     }
     auto sanitizedExecutionReport = executionReport;
     sanitizedExecutionReport.m_id = orderId;
-    if(sanitizedExecutionReport.m_timestamp ==
-        boost::posix_time::not_a_date_time) {
-      sanitizedExecutionReport.m_timestamp = m_timeClient->GetTime();
-    }
-    m_driver->Update(session, orderId, sanitizedExecutionReport);
+    DeferUntilRecovered(request.GetClient(), [=] () mutable {
+      if(sanitizedExecutionReport.m_timestamp ==
+          boost::posix_time::not_a_date_time) {
+        sanitizedExecutionReport.m_timestamp = m_timeClient->GetTime();
+      }
+      try {
+        m_driver->Update(request.GetSession(), orderId,
+          sanitizedExecutionReport);
+      } catch(const std::exception& e) {
+        request.SetException(Beam::Services::ServiceRequestException(
+          e.what()));
+        return;
+      }
+      request.SetResult();
+    });
   }
 
   template<typename C, typename T, typename S, typename U, typename A,
     typename O, typename D>
   void OrderExecutionServlet<C, T, S, U, A, O, D>::OnCancelOrder(
       ServiceProtocolClient& client, OrderId orderId) {
-    auto& session = client.GetSession();
-    m_driver->Cancel(session, orderId);
+    DeferUntilRecovered(client, [=, &client] {
+      m_driver->Cancel(client.GetSession(), orderId);
+    });
   }
 }
 
@@ -1,5 +1,6 @@
 #ifndef NEXUS_ORDER_SUBMISSION_CHECK_HPP
 #define NEXUS_ORDER_SUBMISSION_CHECK_HPP
+#include <string>
 #include "Nexus/OrderExecutionService/OrderExecutionService.hpp"
 
 namespace Nexus::OrderExecutionService {
@@ -27,6 +28,16 @@ namespace Nexus::OrderExecutionService {
        */
       virtual void Reject(const OrderInfo& orderInfo);
 
+      /**
+       * Returns <code>true</code> iff a successful submission reserves state
+       * that must be released by Reject, such checks are performed one at a
+       * time after all other checks pass.
+       */
+      virtual bool IsStateful() const;
+
+      /** Returns the name used to report this check's metrics. */
+      virtual std::string GetName() const;
+
     protected:
 
       /** Constructs an OrderSubmissionCheck. */
@@ -40,6 +51,14 @@ namespace Nexus::OrderExecutionService {
   inline void OrderSubmissionCheck::Add(const Order& order) {}
 
   inline void OrderSubmissionCheck::Reject(const OrderInfo& orderInfo) {}
+
+  inline bool OrderSubmissionCheck::IsStateful() const {
+    return false;
+  }
+
+  inline std::string OrderSubmissionCheck::GetName() const {
+    return "order_submission_check";
+  }
 }
 
 #endif
@@ -1,18 +1,28 @@
 #ifndef NEXUS_ORDER_SUBMISSION_CHECK_DRIVER_HPP
 #define NEXUS_ORDER_SUBMISSION_CHECK_DRIVER_HPP
+#include <chrono>
+#include <string>
 #include <vector>
 #include <Beam/IO/OpenState.hpp>
 #include <Beam/Pointers/LocalPtr.hpp>
+#include <Beam/Routines/RoutineHandlerGroup.hpp>
 #include <Beam/Threading/Sync.hpp>
+#include <boost/optional/optional.hpp>
 #include "Nexus/OrderExecutionService/AccountQuery.hpp"
 #include "Nexus/OrderExecutionService/OrderExecutionService.hpp"
 #include "Nexus/OrderExecutionService/OrderSubmissionCheck.hpp"
 #include "Nexus/OrderExecutionService/OrderSubmissionCheckException.hpp"
+#include "Nexus/OrderExecutionService/OrderSubmissionCheckMetrics.hpp"
 
 namespace Nexus::OrderExecutionService {
 
   /**
-   * Performs a series of checks on an Order submission.
+   * Performs a series of checks on an Order submission. Checks that aren't
+   * stateful are performed concurrently, and only once they all pass are the
+   * stateful checks performed, in order, stopping at the first that fails.
+   * A rejection reports the first failing check that isn't stateful in the
+   * order the checks were given, otherwise the failing stateful check, and
+   * every check that passed is told of the rejection.
    * @param <D> The type of OrderExecutionDriver to send the submission to if
    *        all checks pass.
    */
@@ -49,26 +59,45 @@ namespace Nexus::OrderExecutionService {
       void Update(const OrderExecutionSession& session, OrderId orderId,
         const ExecutionReport& executionReport);
 
+      /** Returns a snapshot of the latency of each check. */
+      OrderSubmissionCheckMetrics GetMetrics() const;
+
       void Close();
 
     private:
       Beam::GetOptionalLocalPtr<D> m_orderExecutionDriver;
       Beam::Threading::Sync<std::vector<std::unique_ptr<Order>>> m_orders;
       std::vector<std::unique_ptr<OrderSubmissionCheck>> m_checks;
+      std::vector<std::size_t> m_concurrentChecks;
+      std::vector<std::size_t> m_statefulChecks;
+      Details::LatencyRecorder m_submissionLatency;
+      std::vector<Details::LatencyRecorder> m_checkLatencies;
       Beam::IO::OpenState m_openState;
 
       OrderSubmissionCheckDriver(const OrderSubmissionCheckDriver&) = delete;
       OrderSubmissionCheckDriver& operator =(
         const OrderSubmissionCheckDriver&) = delete;
+
+      boost::optional<std::string> Check(std::size_t index,
+        const OrderInfo& orderInfo);
   };
 
   template<typename D>
   template<typename DF>
   OrderSubmissionCheckDriver<D>::OrderSubmissionCheckDriver(
-    DF&& orderExecutionDriver,
-    std::vector<std::unique_ptr<OrderSubmissionCheck>> orderSubmissionChecks)
-    : m_orderExecutionDriver(std::forward<DF>(orderExecutionDriver)),
-      m_checks(std::move(orderSubmissionChecks)) {}
+      DF&& orderExecutionDriver,
+      std::vector<std::unique_ptr<OrderSubmissionCheck>> orderSubmissionChecks)
+      : m_orderExecutionDriver(std::forward<DF>(orderExecutionDriver)),
+        m_checks(std::move(orderSubmissionChecks)),
+        m_checkLatencies(m_checks.size()) {
+    for(auto i = std::size_t(0); i != m_checks.size(); ++i) {
+      if(m_checks[i]->IsStateful()) {
+        m_statefulChecks.push_back(i);
+      } else {
+        m_concurrentChecks.push_back(i);
+      }
+    }
+  }
 
   template<typename D>
   OrderSubmissionCheckDriver<D>::~OrderSubmissionCheckDriver() {
@@ -88,17 +117,47 @@ namespace Nexus::OrderExecutionService {
   template<typename D>
   const Order& OrderSubmissionCheckDriver<D>::Submit(
       const OrderInfo& orderInfo) {
-    auto submissionIterator = m_checks.begin();
-    try {
-      while(submissionIterator != m_checks.end()) {
-        (*submissionIterator)->Submit(orderInfo);
-        ++submissionIterator;
+    auto start = std::chrono::steady_clock::now();
+    auto rejections =
+      std::vector<boost::optional<std::string>>(m_checks.size());
+    if(m_concurrentChecks.size() > 1) {
+      auto routines = Beam::Routines::RoutineHandlerGroup();
+      for(auto i : m_concurrentChecks) {
+        routines.Spawn([&, i] {
+          rejections[i] = Check(i, orderInfo);
+        });
       }
-    } catch(const std::exception& e) {
-      for(auto i = m_checks.begin(); i != submissionIterator; ++i) {
-        (*i)->Reject(orderInfo);
+      routines.Wait();
+    } else {
+      for(auto i : m_concurrentChecks) {
+        rejections[i] = Check(i, orderInfo);
+      }
+    }
+    auto passedChecks = std::vector<std::size_t>();
+    auto rejection = boost::optional<std::string>();
+    for(auto i : m_concurrentChecks) {
+      if(!rejections[i]) {
+        passedChecks.push_back(i);
+      } else if(!rejection) {
+        rejection = std::move(rejections[i]);
       }
-      auto order = MakeRejectedOrder(orderInfo, e.what());
+    }
+    if(!rejection) {
+      for(auto i : m_statefulChecks) {
+        rejection = Check(i, orderInfo);
+        if(rejection) {
+          break;
+        }
+        passedChecks.push_back(i);
+      }
+    }
+    m_submissionLatency.Record(std::chrono::steady_clock::now() - start,
+      rejection.is_initialized());
+    if(rejection) {
+      for(auto i : passedChecks) {
+        m_checks[i]->Reject(orderInfo);
+      }
+      auto order = MakeRejectedOrder(orderInfo, *rejection);
       auto result = order.get();
       Beam::Threading::With(m_orders, [&] (auto& orders) {
         orders.emplace_back(std::move(order));
@@ -125,10 +184,37 @@ namespace Nexus::OrderExecutionService {
     return m_orderExecutionDriver->Update(session, orderId, executionReport);
   }
 
+  template<typename D>
+  OrderSubmissionCheckMetrics OrderSubmissionCheckDriver<D>::GetMetrics()
+      const {
+    auto metrics = OrderSubmissionCheckMetrics();
+    metrics.m_submission = m_submissionLatency.Load();
+    for(auto& latency : m_checkLatencies) {
+      metrics.m_checks.push_back(latency.Load());
+    }
+    return metrics;
+  }
+
   template<typename D>
   void OrderSubmissionCheckDriver<D>::Close() {
     m_openState.Close();
   }
+
+  template<typename D>
+  boost::optional<std::string> OrderSubmissionCheckDriver<D>::Check(
+      std::size_t index, const OrderInfo& orderInfo) {
+    auto start = std::chrono::steady_clock::now();
+    try {
+      m_checks[index]->Submit(orderInfo);
+    } catch(const std::exception& e) {
+      m_checkLatencies[index].Record(std::chrono::steady_clock::now() - start,
+        true);
+      return std::string(e.what());
+    }
+    m_checkLatencies[index].Record(std::chrono::steady_clock::now() - start,
+      false);
+    return boost::none;
+  }
 }
 
 #endif
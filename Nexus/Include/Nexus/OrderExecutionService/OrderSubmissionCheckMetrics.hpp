@@ -0,0 +1,154 @@
+#ifndef NEXUS_ORDER_SUBMISSION_CHECK_METRICS_HPP
+#define NEXUS_ORDER_SUBMISSION_CHECK_METRICS_HPP
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include "Nexus/OrderExecutionService/OrderExecutionService.hpp"
+
+namespace Nexus::OrderExecutionService {
+
+  /**
+   * Reports the distribution of the time taken to perform an Order submission
+   * check. Latencies are counted in buckets whose upper bounds double, the
+   * first bucket counting latencies under a microsecond and the last counting
+   * everything beyond the second to last.
+   */
+  struct OrderSubmissionCheckLatency {
+
+    /** The number of buckets in the histogram. */
+    static constexpr auto BUCKET_COUNT = 24;
+
+    /** The number of submissions checked. */
+    std::int64_t m_count;
+
+    /** The number of submissions rejected. */
+    std::int64_t m_rejectionCount;
+
+    /** The total time spent checking submissions. */
+    boost::posix_time::time_duration m_totalLatency;
+
+    /** The longest time taken to check a submission. */
+    boost::posix_time::time_duration m_maxLatency;
+
+    /**
+     * The number of submissions in each bucket, bucket <i>i</i> counting
+     * latencies under 2<sup>i</sup> microseconds.
+     */
+    std::array<std::int64_t, BUCKET_COUNT> m_buckets;
+  };
+
+  /** Reports the latencies of an OrderSubmissionCheckDriver. */
+  struct OrderSubmissionCheckMetrics {
+
+    /** The latency of all checks performed on a submission. */
+    OrderSubmissionCheckLatency m_submission;
+
+    /** The latency of each check, in the order the checks were given. */
+    std::vector<OrderSubmissionCheckLatency> m_checks;
+  };
+
+  /**
+   * Returns an upper bound on a percentile of an OrderSubmissionCheckLatency.
+   * @param latency The latency to measure.
+   * @param percentile The percentile to measure, between 0 and 1.
+   * @return The upper bound of the bucket containing the <i>percentile</i>.
+   */
+  inline boost::posix_time::time_duration GetPercentile(
+      const OrderSubmissionCheckLatency& latency, double percentile) {
+    auto threshold = static_cast<std::int64_t>(percentile * latency.m_count);
+    auto count = std::int64_t(0);
+    for(auto i = 0; i != OrderSubmissionCheckLatency::BUCKET_COUNT - 1; ++i) {
+      count += latency.m_buckets[i];
+      if(count > threshold) {
+        return std::min(boost::posix_time::microseconds(std::int64_t(1) << i),
+          latency.m_maxLatency);
+      }
+    }
+    return latency.m_maxLatency;
+  }
+
+  inline std::ostream& operator <<(std::ostream& out,
+      const OrderSubmissionCheckLatency& value) {
+    auto mean = [&] {
+      if(value.m_count == 0) {
+        return boost::posix_time::time_duration();
+      }
+      return boost::posix_time::microseconds(
+        value.m_totalLatency.total_microseconds() / value.m_count);
+    }();
+    return out << "(count: " << value.m_count << " rejections: " <<
+      value.m_rejectionCount << " mean: " << mean << " p50: " <<
+      GetPercentile(value, 0.5) << " p99: " << GetPercentile(value, 0.99) <<
+      " max: " << value.m_maxLatency << ")";
+  }
+
+namespace Details {
+  class LatencyRecorder {
+    public:
+      LatencyRecorder();
+
+      void Record(std::chrono::steady_clock::duration latency,
+        bool isRejected);
+
+      OrderSubmissionCheckLatency Load() const;
+
+    private:
+      std::atomic<std::int64_t> m_count;
+      std::atomic<std::int64_t> m_rejectionCount;
+      std::atomic<std::int64_t> m_totalLatency;
+      std::atomic<std::int64_t> m_maxLatency;
+      std::array<std::atomic<std::int64_t>,
+        OrderSubmissionCheckLatency::BUCKET_COUNT> m_buckets;
+  };
+
+  inline LatencyRecorder::LatencyRecorder()
+      : m_count(0),
+        m_rejectionCount(0),
+        m_totalLatency(0),
+        m_maxLatency(0) {
+    for(auto& bucket : m_buckets) {
+      bucket = 0;
+    }
+  }
+
+  inline void LatencyRecorder::Record(
+      std::chrono::steady_clock::duration latency, bool isRejected) {
+    auto microseconds = static_cast<std::int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+    ++m_count;
+    if(isRejected) {
+      ++m_rejectionCount;
+    }
+    m_totalLatency += microseconds;
+    auto maxLatency = m_maxLatency.load();
+    while(microseconds > maxLatency &&
+        !m_maxLatency.compare_exchange_weak(maxLatency, microseconds)) {}
+    auto bucket = 0;
+    while(bucket != OrderSubmissionCheckLatency::BUCKET_COUNT - 1 &&
+        microseconds >= (std::int64_t(1) << bucket)) {
+      ++bucket;
+    }
+    ++m_buckets[bucket];
+  }
+
+  inline OrderSubmissionCheckLatency LatencyRecorder::Load() const {
+    auto latency = OrderSubmissionCheckLatency();
+    latency.m_count = m_count.load();
+    latency.m_rejectionCount = m_rejectionCount.load();
+    latency.m_totalLatency =
+      boost::posix_time::microseconds(m_totalLatency.load());
+    latency.m_maxLatency = boost::posix_time::microseconds(m_maxLatency.load());
+    for(auto i = 0; i != OrderSubmissionCheckLatency::BUCKET_COUNT; ++i) {
+      latency.m_buckets[i] = m_buckets[i].load();
+    }
+    return latency;
+  }
+}
+}
+
+#endif
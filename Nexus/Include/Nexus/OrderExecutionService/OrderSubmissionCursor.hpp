@@ -0,0 +1,120 @@
+#ifndef NEXUS_ORDER_SUBMISSION_CURSOR_HPP
+#define NEXUS_ORDER_SUBMISSION_CURSOR_HPP
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+#include <Beam/Pointers/Dereference.hpp>
+#include <Beam/Pointers/LocalPtr.hpp>
+#include <Beam/Queries/Sequence.hpp>
+#include <Beam/Queries/SnapshotLimit.hpp>
+#include "Nexus/OrderExecutionService/AccountQuery.hpp"
+#include "Nexus/OrderExecutionService/OrderExecutionService.hpp"
+#include "Nexus/OrderExecutionService/OrderRecord.hpp"
+
+namespace Nexus::OrderExecutionService {
+
+  /**
+   * Loads the OrderRecords matching an AccountQuery one page at a time so
+   * that large result sets are never materialized all at once.
+   * @param <D> The type of OrderExecutionDataStore to load from.
+   */
+  template<typename D>
+  class OrderSubmissionCursor {
+    public:
+
+      /** The type of OrderExecutionDataStore to load from. */
+      using OrderExecutionDataStore = Beam::GetTryDereferenceType<D>;
+
+      /** The default number of records loaded per page. */
+      static constexpr auto DEFAULT_PAGE_SIZE = 1000;
+
+      /**
+       * Constructs an OrderSubmissionCursor with the default page size.
+       * @param dataStore Initializes the data store to load from.
+       * @param query The query to page through.
+       */
+      template<typename DF>
+      OrderSubmissionCursor(DF&& dataStore, AccountQuery query);
+
+      /**
+       * Constructs an OrderSubmissionCursor.
+       * @param dataStore Initializes the data store to load from.
+       * @param query The query to page through.
+       * @param pageSize The maximum number of records loaded per page.
+       */
+      template<typename DF>
+      OrderSubmissionCursor(DF&& dataStore, AccountQuery query, int pageSize);
+
+      /**
+       * Loads the next page of records in sequence order. Queries anchored
+       * at the tail are bounded by their snapshot limit and are returned as a
+       * single page.
+       * @return The next page, or an empty list once the query is exhausted.
+       */
+      std::vector<SequencedOrderRecord> Next();
+
+    private:
+      Beam::GetOptionalLocalPtr<D> m_dataStore;
+      AccountQuery m_query;
+      int m_pageSize;
+      int m_remaining;
+      bool m_isExhausted;
+
+      OrderSubmissionCursor(const OrderSubmissionCursor&) = delete;
+      OrderSubmissionCursor& operator =(const OrderSubmissionCursor&) = delete;
+  };
+
+  template<typename D>
+  OrderSubmissionCursor(D&&, AccountQuery) ->
+    OrderSubmissionCursor<std::remove_reference_t<D>>;
+
+  template<typename D>
+  OrderSubmissionCursor(D&&, AccountQuery, int) ->
+    OrderSubmissionCursor<std::remove_reference_t<D>>;
+
+  template<typename D>
+  template<typename DF>
+  OrderSubmissionCursor<D>::OrderSubmissionCursor(DF&& dataStore,
+    AccountQuery query)
+    : OrderSubmissionCursor(std::forward<DF>(dataStore), std::move(query),
+        DEFAULT_PAGE_SIZE) {}
+
+  template<typename D>
+  template<typename DF>
+  OrderSubmissionCursor<D>::OrderSubmissionCursor(DF&& dataStore,
+    AccountQuery query, int pageSize)
+    : m_dataStore(std::forward<DF>(dataStore)),
+      m_query(std::move(query)),
+      m_pageSize(std::max(1, pageSize)),
+      m_remaining(m_query.GetSnapshotLimit().GetSize()),
+      m_isExhausted(m_remaining <= 0) {}
+
+  template<typename D>
+  std::vector<SequencedOrderRecord> OrderSubmissionCursor<D>::Next() {
+    if(m_isExhausted) {
+      return {};
+    }
+    if(m_query.GetSnapshotLimit().GetType() ==
+        Beam::Queries::SnapshotLimit::Type::TAIL) {
+      m_isExhausted = true;
+      return m_dataStore->LoadOrderSubmissions(m_query);
+    }
+    auto size = std::min(m_pageSize, m_remaining);
+    auto pageQuery = m_query;
+    pageQuery.SetSnapshotLimit(Beam::Queries::SnapshotLimit::FromHead(size));
+    auto page = m_dataStore->LoadOrderSubmissions(pageQuery);
+    if(static_cast<int>(page.size()) > size) {
+      page.erase(page.begin() + size, page.end());
+    }
+    m_remaining -= static_cast<int>(page.size());
+    if(static_cast<int>(page.size()) < size || m_remaining == 0) {
+      m_isExhausted = true;
+    } else {
+      m_query.SetRange(Beam::Queries::Increment(page.back().GetSequence()),
+        m_query.GetRange().GetEnd());
+    }
+    return page;
+  }
+}
+
+#endif
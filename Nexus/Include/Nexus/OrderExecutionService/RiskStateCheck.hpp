@@ -35,6 +35,8 @@ namespace Nexus::OrderExecutionService {
 
       void Add(const Order& order) override;
 
+      std::string GetName() const override;
+
     private:
       struct AccountEntry {
         Beam::Threading::Sync<Accounting::PositionOrderBook>
@@ -92,6 +94,11 @@ namespace Nexus::OrderExecutionService {
       });
   }
 
+  template<typename C>
+  std::string RiskStateCheck<C>::GetName() const {
+    return "risk_state";
+  }
+
   template<typename C>
   typename RiskStateCheck<C>::AccountEntry& RiskStateCheck<C>::LoadAccountEntry(
       const Beam::ServiceLocator::DirectoryEntry& account) {
@@ -1,7 +1,10 @@
 #ifndef NEXUS_SQL_ORDER_EXECUTION_DATA_STORE_HPP
 #define NEXUS_SQL_ORDER_EXECUTION_DATA_STORE_HPP
+#include <algorithm>
 #include <functional>
+#include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 #include <Beam/IO/OpenState.hpp>
 #include <Beam/Queries/SqlDataStore.hpp>
@@ -87,6 +90,7 @@ namespace Nexus::OrderExecutionService {
       using IsLiveDataStore = Beam::Queries::SqlDataStore<Connection,
         Viper::Row<OrderInfo>, Viper::Row<Beam::ServiceLocator::DirectoryEntry>,
         Translator<IsLive>>;
+      static constexpr auto RECORD_PAGE_SIZE = 500;
       Beam::KeyValueCache<unsigned int, Beam::ServiceLocator::DirectoryEntry,
         Beam::Threading::Mutex> m_accountEntries;
       Beam::DatabaseConnectionPool<Connection> m_readerPool;
@@ -105,7 +109,8 @@ namespace Nexus::OrderExecutionService {
       SqlOrderExecutionDataStore(const SqlOrderExecutionDataStore&) = delete;
       SqlOrderExecutionDataStore& operator =(
         const SqlOrderExecutionDataStore&) = delete;
-      SequencedOrderRecord LoadRecord(SequencedOrderInfo info);
+      std::vector<SequencedOrderRecord> LoadRecords(
+        std::vector<SequencedOrderInfo> orderInfo);
   };
 
   /**
@@ -205,7 +210,8 @@ namespace Nexus::OrderExecutionService {
     if(orders.empty()) {
       return boost::none;
     }
-    auto record = LoadRecord(std::move(orders.front()));
+    orders.resize(1);
+    auto record = std::move(LoadRecords(std::move(orders)).front());
     return Beam::Queries::SequencedValue(Beam::Queries::IndexedValue(
       std::move(*record), record->m_info.m_fields.m_account),
       record.GetSequence());
@@ -228,11 +234,7 @@ namespace Nexus::OrderExecutionService {
         return m_submissionsDataStore.Load(query);
       }
     }();
-    auto orderRecords = std::vector<SequencedOrderRecord>();
-    for(auto& order : orderInfo) {
-      orderRecords.push_back(LoadRecord(std::move(order)));
-    }
-    return orderRecords;
+    return LoadRecords(std::move(orderInfo));
   }
 
   template<typename C>
@@ -312,21 +314,49 @@ namespace Nexus::OrderExecutionService {
   }
 
   template<typename C>
-  SequencedOrderRecord SqlOrderExecutionDataStore<C>::LoadRecord(
-      SequencedOrderInfo info) {
-    info->m_fields.m_account =
-      m_accountEntries.Load(info->m_fields.m_account.m_id);
-    info->m_submissionAccount =
-      m_accountEntries.Load(info->m_submissionAccount.m_id);
-    auto sequencedExecutionReports = m_executionReportsDataStore.Load(
-      Viper::sym("order_id") == info->m_orderId);
-    auto executionReports = std::vector<ExecutionReport>();
-    for(auto& executionReport : sequencedExecutionReports) {
-      executionReports.push_back(std::move(*executionReport));
+  std::vector<SequencedOrderRecord> SqlOrderExecutionDataStore<C>::
+      LoadRecords(std::vector<SequencedOrderInfo> orderInfo) {
+    auto records = std::vector<SequencedOrderRecord>();
+    records.reserve(orderInfo.size());
+    auto executionReports =
+      std::unordered_map<OrderId, std::vector<ExecutionReport>>();
+    auto page = orderInfo.begin();
+    while(page != orderInfo.end()) {
+      auto pageEnd = page + std::min<std::ptrdiff_t>(RECORD_PAGE_SIZE,
+        orderInfo.end() - page);
+      auto ids = std::string("order_id IN (");
+      for(auto i = page; i != pageEnd; ++i) {
+        if(i != page) {
+          ids += ',';
+        }
+        ids += std::to_string((*i)->m_orderId);
+      }
+      ids += ')';
+      executionReports.clear();
+      auto sequencedExecutionReports = m_executionReportsDataStore.Load(
+        Viper::Expression(std::make_shared<Viper::LiteralExpression>(
+          std::move(ids))));
+      for(auto& executionReport : sequencedExecutionReports) {
+        executionReports[executionReport->m_id].push_back(
+          std::move(*executionReport));
+      }
+      for(; page != pageEnd; ++page) {
+        auto& info = *page;
+        info->m_fields.m_account =
+          m_accountEntries.Load(info->m_fields.m_account.m_id);
+        info->m_submissionAccount =
+          m_accountEntries.Load(info->m_submissionAccount.m_id);
+        auto reports = std::vector<ExecutionReport>();
+        auto entry = executionReports.find(info->m_orderId);
+        if(entry != executionReports.end()) {
+          reports = std::move(entry->second);
+        }
+        auto sequence = info.GetSequence();
+        records.push_back(Beam::Queries::SequencedValue(
+          OrderRecord(std::move(*info), std::move(reports)), sequence));
+      }
     }
-    auto sequence = info.GetSequence();
-    return Beam::Queries::SequencedValue(
-      OrderRecord(std::move(*info), std::move(executionReports)), sequence);
+    return records;
   }
 
   template<typename C>
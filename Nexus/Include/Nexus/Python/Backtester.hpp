@@ -22,11 +22,35 @@ namespace Nexus::Python {
    */
   void ExportBacktesterEventHandler(pybind11::module& module);
 
+  /**
+   * Exports the BacktesterMarketDataMetrics struct.
+   * @param module The module to export to.
+   */
+  void ExportBacktesterMarketDataMetrics(pybind11::module& module);
+
+  /**
+   * Exports the BacktesterMarketDataService class.
+   * @param module The module to export to.
+   */
+  void ExportBacktesterMarketDataService(pybind11::module& module);
+
   /**
    * Exports the BacktesterServiceClients class.
    * @param module The module to export to.
    */
   void ExportBacktesterServiceClients(pybind11::module& module);
+
+  /**
+   * Exports the BacktesterTimeWindow class.
+   * @param module The module to export to.
+   */
+  void ExportBacktesterTimeWindow(pybind11::module& module);
+
+  /**
+   * Exports the RunParallelBacktests functions.
+   * @param module The module to export to.
+   */
+  void ExportParallelBacktester(pybind11::module& module);
 }
 
 #endif
@@ -1,8 +1,10 @@
 #ifndef NEXUS_PYTHON_MARKET_DATA_SERVICE_HPP
 #define NEXUS_PYTHON_MARKET_DATA_SERVICE_HPP
 #include <type_traits>
+#include <Beam/Python/GilRelease.hpp>
 #include <pybind11/pybind11.h>
 #include "Nexus/MarketDataService/HistoricalDataStoreBox.hpp"
+#include "Nexus/MarketDataService/MarketDataColumns.hpp"
 #include "Nexus/MarketDataService/MarketDataClientBox.hpp"
 #include "Nexus/MarketDataService/MarketDataFeedClientBox.hpp"
 #include "Nexus/Python/DllExport.hpp"
@@ -75,6 +77,21 @@ namespace Nexus::Python {
    */
   void ExportSqliteHistoricalDataStore(pybind11::module& module);
 
+  /**
+   * Converts BboQuoteColumns into a dictionary of NumPy arrays keyed by field
+   * name. The arrays take ownership of the columns rather than copying them.
+   * @param columns The columns to convert.
+   */
+  pybind11::dict ToNumPy(MarketDataService::BboQuoteColumns columns);
+
+  /**
+   * Converts TimeAndSaleColumns into a dictionary of NumPy arrays keyed by
+   * field name. The arrays take ownership of the columns rather than copying
+   * them.
+   * @param columns The columns to convert.
+   */
+  pybind11::dict ToNumPy(MarketDataService::TimeAndSaleColumns columns);
+
   /**
    * Exports an HistoricalDataStore class.
    * @param <DataStore> The type of HistoricalDataStore to export.
@@ -93,6 +110,24 @@ namespace Nexus::Python {
       def("load_book_quotes", &DataStore::LoadBookQuotes).
       def("load_market_quotes", &DataStore::LoadMarketQuotes).
       def("load_time_and_sales", &DataStore::LoadTimeAndSales).
+      def("load_bbo_quote_columns", [] (DataStore& self,
+          const MarketDataService::SecurityMarketDataQuery& query) {
+        auto bboQuotes = self.LoadBboQuotes(query);
+        auto columns = [&] {
+          auto release = Beam::Python::GilRelease();
+          return MarketDataService::MakeBboQuoteColumns(bboQuotes);
+        }();
+        return ToNumPy(std::move(columns));
+      }).
+      def("load_time_and_sale_columns", [] (DataStore& self,
+          const MarketDataService::SecurityMarketDataQuery& query) {
+        auto timeAndSales = self.LoadTimeAndSales(query);
+        auto columns = [&] {
+          auto release = Beam::Python::GilRelease();
+          return MarketDataService::MakeTimeAndSaleColumns(timeAndSales);
+        }();
+        return ToNumPy(std::move(columns));
+      }).
       def("store", static_cast<void (DataStore::*)(const SecurityInfo&)>(
         &DataStore::Store)).
       def("store", static_cast<void (DataStore::*)(
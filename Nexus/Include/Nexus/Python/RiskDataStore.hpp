@@ -32,6 +32,9 @@ namespace Nexus::RiskService {
       void Store(const Beam::ServiceLocator::DirectoryEntry& account,
         const InventorySnapshot& snapshot) override;
 
+      void Append(const Beam::ServiceLocator::DirectoryEntry& account,
+        const InventorySnapshotDelta& delta) override;
+
       void Close() override;
 
     private:
@@ -75,6 +78,14 @@ namespace Nexus::RiskService {
     return m_dataStore->Store(account, snapshot);
   }
 
+  template<typename D>
+  void ToPythonRiskDataStore<D>::Append(
+      const Beam::ServiceLocator::DirectoryEntry& account,
+      const InventorySnapshotDelta& delta) {
+    auto release = Beam::Python::GilRelease();
+    return m_dataStore->Append(account, delta);
+  }
+
   template<typename D>
   void ToPythonRiskDataStore<D>::Close() {
     auto release = Beam::Python::GilRelease();
@@ -1,6 +1,8 @@
 #ifndef NEXUS_INVENTORY_SNAPSHOT_HPP
 #define NEXUS_INVENTORY_SNAPSHOT_HPP
+#include <algorithm>
 #include <tuple>
+#include <unordered_set>
 #include <vector>
 #include <Beam/Queries/Sequence.hpp>
 #include <Beam/Queues/Queue.hpp>
@@ -34,6 +36,72 @@ namespace Nexus::RiskService {
     bool operator !=(const InventorySnapshot& snapshot) const;
   };
 
+  /** Stores the changes made to an InventorySnapshot. */
+  struct InventorySnapshotDelta {
+
+    /**
+     * The inventories that changed, replacing any inventory with the same
+     * key. An empty inventory removes its position.
+     */
+    std::vector<RiskInventory> m_inventories;
+
+    /** The sequence that the updated snapshot is valid for (inclusive). */
+    Beam::Queries::Sequence m_sequence;
+
+    /** The list of Order ids newly excluded from the snapshot. */
+    std::vector<OrderExecutionService::OrderId> m_excludedOrders;
+
+    /** The list of Order ids no longer excluded from the snapshot. */
+    std::vector<OrderExecutionService::OrderId> m_includedOrders;
+
+    /** Tests if two deltas have identical structure. */
+    bool operator ==(const InventorySnapshotDelta& delta) const;
+
+    /** Tests if two deltas have different structures. */
+    bool operator !=(const InventorySnapshotDelta& delta) const;
+  };
+
+  /**
+   * Applies an InventorySnapshotDelta to an InventorySnapshot.
+   * @param snapshot The snapshot to update.
+   * @param delta The changes to apply to the <i>snapshot</i>.
+   * @return A copy of the <i>snapshot</i> with the <i>delta</i> applied.
+   */
+  inline InventorySnapshot Apply(InventorySnapshot snapshot,
+      const InventorySnapshotDelta& delta) {
+    for(auto& inventory : delta.m_inventories) {
+      auto i = std::find_if(snapshot.m_inventories.begin(),
+        snapshot.m_inventories.end(), [&] (const auto& existing) {
+          return existing.m_position.m_key == inventory.m_position.m_key;
+        });
+      if(i == snapshot.m_inventories.end()) {
+        snapshot.m_inventories.push_back(inventory);
+      } else {
+        *i = inventory;
+      }
+    }
+    snapshot.m_sequence = delta.m_sequence;
+    if(!delta.m_includedOrders.empty()) {
+      auto includedOrders = std::unordered_set<OrderExecutionService::OrderId>(
+        delta.m_includedOrders.begin(), delta.m_includedOrders.end());
+      snapshot.m_excludedOrders.erase(std::remove_if(
+        snapshot.m_excludedOrders.begin(), snapshot.m_excludedOrders.end(),
+        [&] (auto id) {
+          return includedOrders.count(id) != 0;
+        }), snapshot.m_excludedOrders.end());
+    }
+    if(!delta.m_excludedOrders.empty()) {
+      auto excludedOrders = std::unordered_set<OrderExecutionService::OrderId>(
+        snapshot.m_excludedOrders.begin(), snapshot.m_excludedOrders.end());
+      for(auto id : delta.m_excludedOrders) {
+        if(excludedOrders.insert(id).second) {
+          snapshot.m_excludedOrders.push_back(id);
+        }
+      }
+    }
+    return snapshot;
+  }
+
   /**
    * Returns a RiskPortfolio from an InventorySnapshot.
    * @param snapshot The InventorySnapshot used to build the portfolio.
@@ -82,6 +150,19 @@ namespace Nexus::RiskService {
       const InventorySnapshot& snapshot) const {
     return !(*this == snapshot);
   }
+
+  inline bool InventorySnapshotDelta::operator ==(
+      const InventorySnapshotDelta& delta) const {
+    return m_inventories == delta.m_inventories &&
+      m_sequence == delta.m_sequence &&
+      m_excludedOrders == delta.m_excludedOrders &&
+      m_includedOrders == delta.m_includedOrders;
+  }
+
+  inline bool InventorySnapshotDelta::operator !=(
+      const InventorySnapshotDelta& delta) const {
+    return !(*this == delta);
+  }
 }
 
 namespace Beam::Serialization {
@@ -95,6 +176,19 @@ namespace Beam::Serialization {
       shuttle.Shuttle("excluded_orders", value.m_excludedOrders);
     }
   };
+
+  template<>
+  struct Shuttle<Nexus::RiskService::InventorySnapshotDelta> {
+    template<typename Shuttler>
+    void operator ()(Shuttler& shuttle,
+        Nexus::RiskService::InventorySnapshotDelta& value,
+        unsigned int version) {
+      shuttle.Shuttle("inventories", value.m_inventories);
+      shuttle.Shuttle("sequence", value.m_sequence);
+      shuttle.Shuttle("excluded_orders", value.m_excludedOrders);
+      shuttle.Shuttle("included_orders", value.m_includedOrders);
+    }
+  };
 }
 
 #endif
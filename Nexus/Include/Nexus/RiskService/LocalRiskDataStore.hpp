@@ -1,5 +1,6 @@
 #ifndef NEXUS_LOCAL_RISK_DATA_STORE_HPP
 #define NEXUS_LOCAL_RISK_DATA_STORE_HPP
+#include <vector>
 #include <Beam/Collections/SynchronizedMap.hpp>
 #include <boost/noncopyable.hpp>
 #include "Nexus/RiskService/RiskDataStore.hpp"
@@ -15,26 +16,54 @@ namespace Nexus::RiskService {
       void Store(const Beam::ServiceLocator::DirectoryEntry& account,
         const InventorySnapshot& snapshot);
 
+      void Append(const Beam::ServiceLocator::DirectoryEntry& account,
+        const InventorySnapshotDelta& delta);
+
       void Close();
 
     private:
+      struct Entry {
+        InventorySnapshot m_snapshot;
+        std::vector<InventorySnapshotDelta> m_deltas;
+      };
       Beam::SynchronizedUnorderedMap<Beam::ServiceLocator::DirectoryEntry,
-        InventorySnapshot> m_snapshots;
+        Entry> m_snapshots;
   };
 
   inline InventorySnapshot LocalRiskDataStore::LoadInventorySnapshot(
       const Beam::ServiceLocator::DirectoryEntry& account) {
-    auto snapshot = m_snapshots.Find(account);
-    if(snapshot) {
-      return *snapshot;
+    auto entry = m_snapshots.Find(account);
+    if(!entry) {
+      return InventorySnapshot();
+    }
+    auto snapshot = std::move(entry->m_snapshot);
+    for(auto& delta : entry->m_deltas) {
+      snapshot = Apply(std::move(snapshot), delta);
     }
-    return InventorySnapshot();
+    return Strip(std::move(snapshot));
   }
 
   inline void LocalRiskDataStore::Store(
       const Beam::ServiceLocator::DirectoryEntry& account,
       const InventorySnapshot& snapshot) {
-    m_snapshots.Update(account, Strip(snapshot));
+    m_snapshots.Update(account, Entry{Strip(snapshot), {}});
+  }
+
+  inline void LocalRiskDataStore::Append(
+      const Beam::ServiceLocator::DirectoryEntry& account,
+      const InventorySnapshotDelta& delta) {
+    m_snapshots.With([&] (auto& snapshots) {
+      auto& entry = snapshots[account];
+      entry.m_deltas.push_back(delta);
+      if(static_cast<int>(entry.m_deltas.size()) >=
+          INVENTORY_SNAPSHOT_COMPACTION_THRESHOLD) {
+        for(auto& pendingDelta : entry.m_deltas) {
+          entry.m_snapshot = Apply(std::move(entry.m_snapshot), pendingDelta);
+        }
+        entry.m_snapshot = Strip(std::move(entry.m_snapshot));
+        entry.m_deltas.clear();
+      }
+    });
   }
 
   inline void LocalRiskDataStore::Close() {}
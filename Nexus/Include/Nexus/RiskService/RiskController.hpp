@@ -110,6 +110,9 @@ namespace Nexus::RiskService {
       RiskPortfolio m_snapshotPortfolio;
       Beam::Queries::Sequence m_snapshotSequence;
       std::unordered_set<OrderExecutionService::OrderId> m_excludedOrders;
+      std::unordered_set<OrderExecutionService::OrderId>
+        m_unstoredExcludedOrders;
+      bool m_isSnapshotStale;
       Beam::RoutineTaskQueue m_tasks;
 
       RiskController(const RiskController&) = delete;
@@ -153,7 +156,8 @@ namespace Nexus::RiskService {
         m_orderExecutionClient(std::forward<OF>(orderExecutionClient)),
         m_transitionTimer(std::forward<RF>(transitionTimer)),
         m_dataStore(std::forward<DF>(dataStore)),
-        m_snapshotPortfolio(markets) {
+        m_snapshotPortfolio(markets),
+        m_isSnapshotStale(false) {
     auto lock = std::lock_guard(m_mutex);
     auto [portfolio, sequence, excludedOrders] = MakePortfolio(
       std::move(markets));
@@ -215,23 +219,45 @@ namespace Nexus::RiskService {
     typename D>
   void RiskController<A, M, O, R, T, D>::UpdateSnapshot(
       const OrderExecutionService::Order& order) {
+    auto hasUpdate = false;
     if(auto executionReports = order.GetPublisher().GetSnapshot()) {
       for(auto& executionReport : *executionReports) {
-        m_snapshotPortfolio.Update(order.GetInfo().m_fields, executionReport);
+        hasUpdate |= m_snapshotPortfolio.Update(order.GetInfo().m_fields,
+          executionReport);
       }
     }
     m_excludedOrders.erase(order.GetInfo().m_orderId);
-    auto snapshot = InventorySnapshot();
-    for(auto& inventory :
-        m_snapshotPortfolio.GetBookkeeper().GetInventoryRange()) {
-      snapshot.m_inventories.push_back(inventory);
-    }
-    snapshot.m_sequence = m_snapshotSequence;
-    snapshot.m_excludedOrders.insert(snapshot.m_excludedOrders.end(),
-      m_excludedOrders.begin(), m_excludedOrders.end());
     try {
-      m_dataStore->Store(m_account, snapshot);
+      if(m_isSnapshotStale) {
+        auto snapshot = InventorySnapshot();
+        for(auto& inventory :
+            m_snapshotPortfolio.GetBookkeeper().GetInventoryRange()) {
+          snapshot.m_inventories.push_back(inventory);
+        }
+        snapshot.m_sequence = m_snapshotSequence;
+        snapshot.m_excludedOrders.insert(snapshot.m_excludedOrders.end(),
+          m_excludedOrders.begin(), m_excludedOrders.end());
+        m_dataStore->Store(m_account, snapshot);
+      } else {
+        auto delta = InventorySnapshotDelta();
+        if(hasUpdate) {
+          delta.m_inventories.push_back(
+            m_snapshotPortfolio.GetBookkeeper().GetInventory(
+              order.GetInfo().m_fields.m_security,
+              order.GetInfo().m_fields.m_currency));
+        }
+        delta.m_sequence = m_snapshotSequence;
+        if(m_unstoredExcludedOrders.erase(order.GetInfo().m_orderId) == 0) {
+          delta.m_includedOrders.push_back(order.GetInfo().m_orderId);
+        }
+        delta.m_excludedOrders.insert(delta.m_excludedOrders.end(),
+          m_unstoredExcludedOrders.begin(), m_unstoredExcludedOrders.end());
+        m_dataStore->Append(m_account, delta);
+      }
+      m_unstoredExcludedOrders.clear();
+      m_isSnapshotStale = false;
     } catch(const std::exception&) {
+      m_isSnapshotStale = true;
       std::cerr << "Snapshot update failed for account:\n\t" <<
         "Account: " << m_account << "\n\t" <<
         BEAM_REPORT_CURRENT_EXCEPTION() << std::endl;
@@ -243,14 +269,18 @@ namespace Nexus::RiskService {
   std::tuple<RiskPortfolio, Beam::Queries::Sequence,
       std::vector<const OrderExecutionService::Order*>>
       RiskController<A, M, O, R, T, D>::MakePortfolio(MarketDatabase markets) {
+    auto snapshot = m_dataStore->LoadInventorySnapshot(m_account);
     auto [portfolio, sequence, excludedOrders] = RiskService::MakePortfolio(
-      m_dataStore->LoadInventorySnapshot(m_account), m_account,
-      std::move(markets), *m_orderExecutionClient);
+      snapshot, m_account, std::move(markets), *m_orderExecutionClient);
     m_snapshotPortfolio = portfolio;
     m_snapshotSequence = sequence;
     std::transform(excludedOrders.begin(), excludedOrders.end(),
       std::inserter(m_excludedOrders, m_excludedOrders.end()),
       [] (const auto& order) { return order->GetInfo().m_orderId; });
+    m_unstoredExcludedOrders = m_excludedOrders;
+    for(auto id : snapshot.m_excludedOrders) {
+      m_unstoredExcludedOrders.erase(id);
+    }
     for(auto& order : excludedOrders) {
       order->GetPublisher().Monitor(
         m_tasks.GetSlot<OrderExecutionService::ExecutionReport>(
@@ -311,6 +341,7 @@ namespace Nexus::RiskService {
     m_transitionModel->Add(**order);
     m_snapshotSequence = std::max(m_snapshotSequence, order.GetSequence());
     m_excludedOrders.insert((*order)->GetInfo().m_orderId);
+    m_unstoredExcludedOrders.insert((*order)->GetInfo().m_orderId);
     (*order)->GetPublisher().Monitor(
       m_tasks.GetSlot<OrderExecutionService::ExecutionReport>(
         std::bind(&RiskController::OnExecutionReport, this, std::ref(**order),
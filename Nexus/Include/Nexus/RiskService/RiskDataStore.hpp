@@ -7,6 +7,12 @@
 
 namespace Nexus::RiskService {
 
+  /**
+   * The number of InventorySnapshotDeltas appended to an account's snapshot
+   * before a RiskDataStore compacts them into a new snapshot.
+   */
+  constexpr auto INVENTORY_SNAPSHOT_COMPACTION_THRESHOLD = 100;
+
   /** Concept used to specify the data store used by the RiskServlet. */
   struct RiskDataStore : Beam::Concept<RiskDataStore> {
 
@@ -26,6 +32,15 @@ namespace Nexus::RiskService {
     void Store(const Beam::ServiceLocator::DirectoryEntry& account,
       const InventorySnapshot& snapshot);
 
+    /**
+     * Appends changes to an account's InventorySnapshot, the changes are
+     * reflected in all subsequent loads of the snapshot.
+     * @param account The account whose snapshot changed.
+     * @param delta The changes to the <i>account</i>'s snapshot.
+     */
+    void Append(const Beam::ServiceLocator::DirectoryEntry& account,
+      const InventorySnapshotDelta& delta);
+
     void Close();
   };
 
@@ -18,73 +18,79 @@ namespace Nexus::RiskService {
     RiskInventory m_inventory;
   };
 
-  /** Returns a row representing a InventoryEntry. */
-  inline const auto& GetInventoryEntriesRow() {
-    static auto ROW = Viper::Row<InventoryEntry>().
-      add_column("account", &InventoryEntry::m_account).
-      extend(Viper::Row<RiskInventory>().
-        extend(Viper::Row<RiskPosition>().
-          extend(Viper::Row<RiskPosition::Key>().
-            extend(Viper::Row<Security>().
-              add_column("symbol", Viper::varchar(16),
-                [] (auto& row) {
-                  return row.GetSymbol();
-                },
-                [] (auto& row, auto column) {
-                  row = Security(std::move(column), row.GetMarket(),
-                    row.GetCountry());
-                }).
-              add_column("market", Viper::varchar(16),
-                [] (auto& row) {
-                  return row.GetMarket();
-                },
-                [] (auto& row, auto column) {
-                  row = Security(row.GetSymbol(), column, row.GetCountry());
-                }).
-              add_column("country",
-                [] (auto& row) {
-                  return row.GetCountry();
-                },
-                [] (auto& row, auto column) {
-                  row = Security(row.GetSymbol(), row.GetMarket(), column);
-                }),
-              [] (auto& entry) -> auto& {
-                return entry.m_index;
+  /** Returns a row representing a RiskInventory. */
+  inline const auto& GetRiskInventoryRow() {
+    static auto ROW = Viper::Row<RiskInventory>().
+      extend(Viper::Row<RiskPosition>().
+        extend(Viper::Row<RiskPosition::Key>().
+          extend(Viper::Row<Security>().
+            add_column("symbol", Viper::varchar(16),
+              [] (auto& row) {
+                return row.GetSymbol();
+              },
+              [] (auto& row, auto column) {
+                row = Security(std::move(column), row.GetMarket(),
+                  row.GetCountry());
               }).
-            add_column("currency",
-              [] (auto& entry) -> auto& {
-                return entry.m_currency;
+            add_column("market", Viper::varchar(16),
+              [] (auto& row) {
+                return row.GetMarket();
+              },
+              [] (auto& row, auto column) {
+                row = Security(row.GetSymbol(), column, row.GetCountry());
+              }).
+            add_column("country",
+              [] (auto& row) {
+                return row.GetCountry();
+              },
+              [] (auto& row, auto column) {
+                row = Security(row.GetSymbol(), row.GetMarket(), column);
               }),
             [] (auto& entry) -> auto& {
-              return entry.m_key;
-            }).
-          add_column("quantity",
-            [] (auto& entry) -> auto& {
-              return entry.m_quantity;
+              return entry.m_index;
             }).
-          add_column("cost_basis",
+          add_column("currency",
             [] (auto& entry) -> auto& {
-              return entry.m_costBasis;
+              return entry.m_currency;
             }),
           [] (auto& entry) -> auto& {
-            return entry.m_position;
+            return entry.m_key;
           }).
-        add_column("gross_profit_and_loss",
+        add_column("quantity",
           [] (auto& entry) -> auto& {
-            return entry.m_grossProfitAndLoss;
+            return entry.m_quantity;
           }).
-        add_column("fees",
+        add_column("cost_basis",
           [] (auto& entry) -> auto& {
-            return entry.m_fees;
-          }).
-        add_column("volume",
-          [] (auto& entry) -> auto& {
-            return entry.m_volume;
-          }).
-        add_column("transaction_count",
-          [] (auto& entry) -> auto& {
-            return entry.m_transactionCount;
-          }), &InventoryEntry::m_inventory).
+            return entry.m_costBasis;
+          }),
+        [] (auto& entry) -> auto& {
+          return entry.m_position;
+        }).
+      add_column("gross_profit_and_loss",
+        [] (auto& entry) -> auto& {
+          return entry.m_grossProfitAndLoss;
+        }).
+      add_column("fees",
+        [] (auto& entry) -> auto& {
+          return entry.m_fees;
+        }).
+      add_column("volume",
+        [] (auto& entry) -> auto& {
+          return entry.m_volume;
+        }).
+      add_column("transaction_count",
+        [] (auto& entry) -> auto& {
+          return entry.m_transactionCount;
+        });
+    return ROW;
+  }
+
+  /** Returns a row representing a InventoryEntry. */
+  inline const auto& GetInventoryEntriesRow() {
+    static auto ROW = Viper::Row<InventoryEntry>().
+      add_column("account", &InventoryEntry::m_account).
+      extend(GetRiskInventoryRow(), &InventoryEntry::m_inventory).
       add_index("account", "account");
     return ROW;
   }
@@ -142,6 +148,75 @@ namespace Nexus::RiskService {
       return InventoryExcludedOrderId{account.m_id, id};
     };
   }
+
+  /** Stores the sequence of an InventorySnapshotDelta. */
+  struct InventoryDeltaSequence {
+
+    /** The account the delta belongs to. */
+    std::uint32_t m_account;
+
+    /** The delta's position in the account's list of deltas. */
+    int m_revision;
+
+    /** The sequence the delta is valid for. */
+    Beam::Queries::Sequence m_sequence;
+  };
+
+  /** Returns a row representing an InventoryDeltaSequence. */
+  inline const auto& GetInventoryDeltaSequencesRow() {
+    static auto ROW = Viper::Row<InventoryDeltaSequence>().
+      add_column("account", &InventoryDeltaSequence::m_account).
+      add_column("revision", &InventoryDeltaSequence::m_revision).
+      add_column("sequence", &InventoryDeltaSequence::m_sequence).
+      add_index("account", "account");
+    return ROW;
+  }
+
+  /** Stores an inventory changed by an InventorySnapshotDelta. */
+  struct InventoryDeltaEntry {
+
+    /** The account the delta belongs to. */
+    std::uint32_t m_account;
+
+    /** The delta's position in the account's list of deltas. */
+    int m_revision;
+
+    /** The changed inventory. */
+    RiskInventory m_inventory;
+  };
+
+  /** Returns a row representing an InventoryDeltaEntry. */
+  inline const auto& GetInventoryDeltaEntriesRow() {
+    static auto ROW = Viper::Row<InventoryDeltaEntry>().
+      add_column("account", &InventoryDeltaEntry::m_account).
+      add_column("revision", &InventoryDeltaEntry::m_revision).
+      extend(GetRiskInventoryRow(), &InventoryDeltaEntry::m_inventory).
+      add_index("account", "account");
+    return ROW;
+  }
+
+  /** Stores an order id excluded or included by an InventorySnapshotDelta. */
+  struct InventoryDeltaOrderId {
+
+    /** The account the delta belongs to. */
+    std::uint32_t m_account;
+
+    /** The delta's position in the account's list of deltas. */
+    int m_revision;
+
+    /** The order id. */
+    OrderExecutionService::OrderId m_id;
+  };
+
+  /** Returns a row representing an InventoryDeltaOrderId. */
+  inline const auto& GetInventoryDeltaOrdersRow() {
+    static auto ROW = Viper::Row<InventoryDeltaOrderId>().
+      add_column("account", &InventoryDeltaOrderId::m_account).
+      add_column("revision", &InventoryDeltaOrderId::m_revision).
+      add_column("id", &InventoryDeltaOrderId::m_id).
+      add_index("account", "account");
+    return ROW;
+  }
 }
 
 #endif
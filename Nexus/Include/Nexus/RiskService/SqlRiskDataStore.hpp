@@ -1,6 +1,9 @@
 #ifndef NEXUS_SQL_RISK_DATA_STORE_HPP
 #define NEXUS_SQL_RISK_DATA_STORE_HPP
+#include <map>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 #include <Beam/IO/OpenState.hpp>
 #include <Beam/Threading/Mutex.hpp>
 #include <boost/function_output_iterator.hpp>
@@ -37,15 +40,25 @@ namespace Nexus::RiskService {
       void Store(const Beam::ServiceLocator::DirectoryEntry& account,
         const InventorySnapshot& snapshot);
 
+      void Append(const Beam::ServiceLocator::DirectoryEntry& account,
+        const InventorySnapshotDelta& delta);
+
       void Close();
 
     private:
       mutable Beam::Threading::Mutex m_mutex;
       std::unique_ptr<Connection> m_connection;
+      std::unordered_map<unsigned int, int> m_revisions;
       Beam::IO::OpenState m_openState;
 
       SqlRiskDataStore(const SqlRiskDataStore&) = delete;
       SqlRiskDataStore& operator =(const SqlRiskDataStore&) = delete;
+      InventorySnapshot Load(
+        const Beam::ServiceLocator::DirectoryEntry& account);
+      int LoadRevision(const Beam::ServiceLocator::DirectoryEntry& account);
+      void Erase(const Beam::ServiceLocator::DirectoryEntry& account);
+      void Insert(const Beam::ServiceLocator::DirectoryEntry& account,
+        const InventorySnapshot& snapshot);
   };
 
   template<typename C>
@@ -59,6 +72,14 @@ namespace Nexus::RiskService {
         GetInventorySequencesRow(), "inventory_sequences"));
       m_connection->execute(Viper::create_if_not_exists(
         GetInventoryExcludedOrdersRow(), "inventory_excluded_orders"));
+      m_connection->execute(Viper::create_if_not_exists(
+        GetInventoryDeltaSequencesRow(), "inventory_delta_sequences"));
+      m_connection->execute(Viper::create_if_not_exists(
+        GetInventoryDeltaEntriesRow(), "inventory_delta_entries"));
+      m_connection->execute(Viper::create_if_not_exists(
+        GetInventoryDeltaOrdersRow(), "inventory_delta_excluded_orders"));
+      m_connection->execute(Viper::create_if_not_exists(
+        GetInventoryDeltaOrdersRow(), "inventory_delta_included_orders"));
     } catch(const std::exception&) {
       Close();
       BOOST_RETHROW;
@@ -76,19 +97,7 @@ namespace Nexus::RiskService {
     auto snapshot = InventorySnapshot();
     auto lock = std::lock_guard(m_mutex);
     Viper::transaction(*m_connection, [&] {
-      m_connection->execute(Viper::select(GetInventoryEntriesRow(),
-        "inventory_entries", Viper::sym("account") == account.m_id,
-        boost::make_function_output_iterator([&] (const auto& row) {
-          snapshot.m_inventories.push_back(std::move(row.m_inventory));
-        })));
-      m_connection->execute(Viper::select(
-        Viper::Row<Beam::Queries::Sequence>("sequence"), "inventory_sequences",
-        Viper::sym("account") == account.m_id, &snapshot.m_sequence));
-      m_connection->execute(Viper::select(GetInventoryExcludedOrdersRow(),
-        "inventory_excluded_orders", Viper::sym("account") == account.m_id,
-        boost::make_function_output_iterator([&] (const auto& row) {
-          snapshot.m_excludedOrders.push_back(row.m_id);
-        })));
+      snapshot = Load(account);
     });
     return snapshot;
   }
@@ -99,32 +108,65 @@ namespace Nexus::RiskService {
       const InventorySnapshot& snapshot) {
     auto strippedSnapshot = Strip(snapshot);
     auto lock = std::lock_guard(m_mutex);
-    Viper::transaction(*m_connection, [&] {
-      m_connection->execute(Viper::erase("inventory_entries",
-        Viper::sym("account") == account.m_id));
-      m_connection->execute(Viper::erase("inventory_sequences",
-        Viper::sym("account") == account.m_id));
-      m_connection->execute(Viper::erase("inventory_excluded_orders",
-        Viper::sym("account") == account.m_id));
-      m_connection->execute(Viper::insert(GetInventoryEntriesRow(),
-        "inventory_entries", boost::iterators::make_transform_iterator(
-        strippedSnapshot.m_inventories.begin(),
-        ConvertInventorySnapshotInventories(account)),
-        boost::iterators::make_transform_iterator(
-        strippedSnapshot.m_inventories.end(),
-        ConvertInventorySnapshotInventories(account))));
-      auto sequence = InventorySequence{account.m_id,
-        strippedSnapshot.m_sequence};
-      m_connection->execute(Viper::insert(GetInventorySequencesRow(),
-        "inventory_sequences", &sequence));
-      m_connection->execute(Viper::insert(GetInventoryExcludedOrdersRow(),
-        "inventory_excluded_orders", boost::iterators::make_transform_iterator(
-        strippedSnapshot.m_excludedOrders.begin(),
-        ConvertInventoryExcludedOrders(account)),
-        boost::iterators::make_transform_iterator(
-        strippedSnapshot.m_excludedOrders.end(), ConvertInventoryExcludedOrders(
-        account))));
-    });
+    try {
+      Viper::transaction(*m_connection, [&] {
+        Erase(account);
+        Insert(account, strippedSnapshot);
+      });
+    } catch(const std::exception&) {
+      m_revisions.erase(account.m_id);
+      throw;
+    }
+    m_revisions[account.m_id] = 0;
+  }
+
+  template<typename C>
+  void SqlRiskDataStore<C>::Append(
+      const Beam::ServiceLocator::DirectoryEntry& account,
+      const InventorySnapshotDelta& delta) {
+    auto lock = std::lock_guard(m_mutex);
+    auto nextRevision = 0;
+    try {
+      Viper::transaction(*m_connection, [&] {
+        auto revision = LoadRevision(account);
+        if(revision + 1 >= INVENTORY_SNAPSHOT_COMPACTION_THRESHOLD) {
+          auto snapshot = Strip(Apply(Load(account), delta));
+          Erase(account);
+          Insert(account, snapshot);
+          nextRevision = 0;
+          return;
+        }
+        nextRevision = revision + 1;
+        auto sequence = InventoryDeltaSequence{account.m_id, revision,
+          delta.m_sequence};
+        m_connection->execute(Viper::insert(GetInventoryDeltaSequencesRow(),
+          "inventory_delta_sequences", &sequence));
+        auto entries = std::vector<InventoryDeltaEntry>();
+        for(auto& inventory : delta.m_inventories) {
+          entries.push_back({account.m_id, revision, inventory});
+        }
+        m_connection->execute(Viper::insert(GetInventoryDeltaEntriesRow(),
+          "inventory_delta_entries", entries.begin(), entries.end()));
+        auto excludedOrders = std::vector<InventoryDeltaOrderId>();
+        for(auto id : delta.m_excludedOrders) {
+          excludedOrders.push_back({account.m_id, revision, id});
+        }
+        m_connection->execute(Viper::insert(GetInventoryDeltaOrdersRow(),
+          "inventory_delta_excluded_orders", excludedOrders.begin(),
+          excludedOrders.end()));
+        auto includedOrders = std::vector<InventoryDeltaOrderId>();
+        for(auto id : delta.m_includedOrders) {
+          includedOrders.push_back({account.m_id, revision, id});
+        }
+        m_connection->execute(Viper::insert(GetInventoryDeltaOrdersRow(),
+          "inventory_delta_included_orders", includedOrders.begin(),
+          includedOrders.end()));
+      });
+    } catch(const std::exception&) {
+      m_revisions.erase(account.m_id);
+      throw;
+    }
+    m_revisions[account.m_id] = nextRevision;
   }
 
   template<typename C>
@@ -135,6 +177,102 @@ namespace Nexus::RiskService {
     m_connection->close();
     m_openState.Close();
   }
+
+  template<typename C>
+  InventorySnapshot SqlRiskDataStore<C>::Load(
+      const Beam::ServiceLocator::DirectoryEntry& account) {
+    auto snapshot = InventorySnapshot();
+    m_connection->execute(Viper::select(GetInventoryEntriesRow(),
+      "inventory_entries", Viper::sym("account") == account.m_id,
+      boost::make_function_output_iterator([&] (const auto& row) {
+        snapshot.m_inventories.push_back(std::move(row.m_inventory));
+      })));
+    m_connection->execute(Viper::select(
+      Viper::Row<Beam::Queries::Sequence>("sequence"), "inventory_sequences",
+      Viper::sym("account") == account.m_id, &snapshot.m_sequence));
+    m_connection->execute(Viper::select(GetInventoryExcludedOrdersRow(),
+      "inventory_excluded_orders", Viper::sym("account") == account.m_id,
+      boost::make_function_output_iterator([&] (const auto& row) {
+        snapshot.m_excludedOrders.push_back(row.m_id);
+      })));
+    auto deltas = std::map<int, InventorySnapshotDelta>();
+    m_connection->execute(Viper::select(GetInventoryDeltaSequencesRow(),
+      "inventory_delta_sequences", Viper::sym("account") == account.m_id,
+      boost::make_function_output_iterator([&] (const auto& row) {
+        deltas[row.m_revision].m_sequence = row.m_sequence;
+      })));
+    if(deltas.empty()) {
+      return snapshot;
+    }
+    m_connection->execute(Viper::select(GetInventoryDeltaEntriesRow(),
+      "inventory_delta_entries", Viper::sym("account") == account.m_id,
+      boost::make_function_output_iterator([&] (const auto& row) {
+        deltas[row.m_revision].m_inventories.push_back(row.m_inventory);
+      })));
+    m_connection->execute(Viper::select(GetInventoryDeltaOrdersRow(),
+      "inventory_delta_excluded_orders", Viper::sym("account") == account.m_id,
+      boost::make_function_output_iterator([&] (const auto& row) {
+        deltas[row.m_revision].m_excludedOrders.push_back(row.m_id);
+      })));
+    m_connection->execute(Viper::select(GetInventoryDeltaOrdersRow(),
+      "inventory_delta_included_orders", Viper::sym("account") == account.m_id,
+      boost::make_function_output_iterator([&] (const auto& row) {
+        deltas[row.m_revision].m_includedOrders.push_back(row.m_id);
+      })));
+    for(auto& delta : deltas) {
+      snapshot = Apply(std::move(snapshot), delta.second);
+    }
+    return Strip(std::move(snapshot));
+  }
+
+  template<typename C>
+  int SqlRiskDataStore<C>::LoadRevision(
+      const Beam::ServiceLocator::DirectoryEntry& account) {
+    auto revision = m_revisions.find(account.m_id);
+    if(revision != m_revisions.end()) {
+      return revision->second;
+    }
+    auto revisions = std::vector<int>();
+    m_connection->execute(Viper::select(Viper::Row<int>("revision"),
+      "inventory_delta_sequences", Viper::sym("account") == account.m_id,
+      std::back_inserter(revisions)));
+    return static_cast<int>(revisions.size());
+  }
+
+  template<typename C>
+  void SqlRiskDataStore<C>::Erase(
+      const Beam::ServiceLocator::DirectoryEntry& account) {
+    for(auto& table : {"inventory_entries", "inventory_sequences",
+        "inventory_excluded_orders", "inventory_delta_sequences",
+        "inventory_delta_entries", "inventory_delta_excluded_orders",
+        "inventory_delta_included_orders"}) {
+      m_connection->execute(Viper::erase(table,
+        Viper::sym("account") == account.m_id));
+    }
+  }
+
+  template<typename C>
+  void SqlRiskDataStore<C>::Insert(
+      const Beam::ServiceLocator::DirectoryEntry& account,
+      const InventorySnapshot& snapshot) {
+    m_connection->execute(Viper::insert(GetInventoryEntriesRow(),
+      "inventory_entries", boost::iterators::make_transform_iterator(
+      snapshot.m_inventories.begin(),
+      ConvertInventorySnapshotInventories(account)),
+      boost::iterators::make_transform_iterator(
+      snapshot.m_inventories.end(),
+      ConvertInventorySnapshotInventories(account))));
+    auto sequence = InventorySequence{account.m_id, snapshot.m_sequence};
+    m_connection->execute(Viper::insert(GetInventorySequencesRow(),
+      "inventory_sequences", &sequence));
+    m_connection->execute(Viper::insert(GetInventoryExcludedOrdersRow(),
+      "inventory_excluded_orders", boost::iterators::make_transform_iterator(
+      snapshot.m_excludedOrders.begin(),
+      ConvertInventoryExcludedOrders(account)),
+      boost::iterators::make_transform_iterator(
+      snapshot.m_excludedOrders.end(), ConvertInventoryExcludedOrders(
+      account))));
+  }
 }
 
 #endif
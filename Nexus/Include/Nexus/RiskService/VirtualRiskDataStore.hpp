@@ -18,6 +18,9 @@ namespace Nexus::RiskService {
       virtual void Store(const Beam::ServiceLocator::DirectoryEntry& account,
         const InventorySnapshot& snapshot) = 0;
 
+      virtual void Append(const Beam::ServiceLocator::DirectoryEntry& account,
+        const InventorySnapshotDelta& delta) = 0;
+
       virtual void Close() = 0;
 
     protected:
@@ -50,6 +53,9 @@ namespace Nexus::RiskService {
       void Store(const Beam::ServiceLocator::DirectoryEntry& account,
         const InventorySnapshot& snapshot) override;
 
+      void Append(const Beam::ServiceLocator::DirectoryEntry& account,
+        const InventorySnapshotDelta& delta) override;
+
       void Close() override;
 
     private:
@@ -85,6 +91,13 @@ namespace Nexus::RiskService {
     return m_dataStore->Store(account, snapshot);
   }
 
+  template<typename D>
+  void WrapperRiskDataStore<D>::Append(
+      const Beam::ServiceLocator::DirectoryEntry& account,
+      const InventorySnapshotDelta& delta) {
+    return m_dataStore->Append(account, delta);
+  }
+
   template<typename D>
   void WrapperRiskDataStore<D>::Close() {
     m_dataStore->Close();
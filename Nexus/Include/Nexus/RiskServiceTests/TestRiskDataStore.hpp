@@ -43,9 +43,23 @@ namespace Nexus::RiskService::Tests {
         Beam::Routines::Eval<void> m_result;
       };
 
+      /** Stores a call to the Append method. */
+      struct AppendInventorySnapshotDeltaOperation {
+
+        /** Stores the account argument. */
+        const Beam::ServiceLocator::DirectoryEntry* m_account;
+
+        /** Stores the delta argument. */
+        const InventorySnapshotDelta* m_delta;
+
+        /** The result to return to the caller. */
+        Beam::Routines::Eval<void> m_result;
+      };
+
       /** A variant over all method calls. */
       using Operation = boost::variant<CloseOperation,
-        LoadInventorySnapshotOperation, StoreInventorySnapshotOperation>;
+        LoadInventorySnapshotOperation, StoreInventorySnapshotOperation,
+        AppendInventorySnapshotDeltaOperation>;
 
       /** Constructs a TestRiskDataStore. */
       TestRiskDataStore() = default;
@@ -61,6 +75,9 @@ namespace Nexus::RiskService::Tests {
       void Store(const Beam::ServiceLocator::DirectoryEntry& account,
         const InventorySnapshot& snapshot);
 
+      void Append(const Beam::ServiceLocator::DirectoryEntry& account,
+        const InventorySnapshotDelta& delta);
+
       void Close();
 
     private:
@@ -98,6 +115,18 @@ namespace Nexus::RiskService::Tests {
     result.Get();
   }
 
+  inline void TestRiskDataStore::Append(
+      const Beam::ServiceLocator::DirectoryEntry& account,
+      const InventorySnapshotDelta& delta) {
+    m_openState.EnsureOpen();
+    auto result = Beam::Routines::Async<void>();
+    auto operation = std::make_shared<Operation>(
+      AppendInventorySnapshotDeltaOperation{&account, &delta,
+        result.GetEval()});
+    m_publisher.Push(operation);
+    result.Get();
+  }
+
   inline void TestRiskDataStore::Close() {
     if(m_openState.SetClosing()) {
       return;
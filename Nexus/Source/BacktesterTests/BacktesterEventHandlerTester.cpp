@@ -0,0 +1,198 @@
+#include <chrono>
+#include <functional>
+#include <Beam/Queues/CallbackQueueWriter.hpp>
+#include <Beam/Queues/Queue.hpp>
+#include <Beam/Routines/RoutineHandler.hpp>
+#include <doctest/doctest.h>
+#include "Nexus/Backtester/BacktesterEventHandler.hpp"
+#include "Nexus/Backtester/BacktesterTimer.hpp"
+
+using namespace Beam;
+using namespace Beam::Routines;
+using namespace Beam::Threading;
+using namespace boost;
+using namespace boost::posix_time;
+using namespace Nexus;
+
+namespace {
+  class RecordingEvent : public BacktesterEvent {
+    public:
+      RecordingEvent(ptime timestamp, int id, bool isPassive,
+        std::vector<int>& ids)
+        : RecordingEvent(timestamp, id, isPassive, ids, {}) {}
+
+      RecordingEvent(ptime timestamp, int id, bool isPassive,
+          std::vector<int>& ids, std::function<void ()> action)
+        : BacktesterEvent(timestamp),
+          m_id(id),
+          m_isPassive(isPassive),
+          m_ids(&ids),
+          m_action(std::move(action)) {}
+
+      bool IsPassive() const override {
+        return m_isPassive;
+      }
+
+      void Execute() override {
+        m_ids->push_back(m_id);
+        if(m_action) {
+          m_action();
+        }
+      }
+
+    private:
+      int m_id;
+      bool m_isPassive;
+      std::vector<int>* m_ids;
+      std::function<void ()> m_action;
+  };
+
+  class CountingEvent : public BacktesterEvent {
+    public:
+      CountingEvent(ptime timestamp, bool isPassive, int& count)
+        : BacktesterEvent(timestamp),
+          m_isPassive(isPassive),
+          m_count(&count) {}
+
+      bool IsPassive() const override {
+        return m_isPassive;
+      }
+
+      void Execute() override {
+        ++*m_count;
+      }
+
+    private:
+      bool m_isPassive;
+      int* m_count;
+  };
+}
+
+TEST_SUITE("BacktesterEventHandler") {
+  TEST_CASE("ordering") {
+    auto startTime = time_from_string("2016-05-06 00:00:00");
+    auto eventHandler = BacktesterEventHandler(startTime);
+    auto ids = std::vector<int>();
+    auto events = std::vector<std::shared_ptr<BacktesterEvent>>();
+    events.push_back(std::make_shared<RecordingEvent>(
+      startTime + seconds(2), 1, true, ids));
+    events.push_back(std::make_shared<RecordingEvent>(
+      startTime + seconds(1), 2, true, ids));
+    events.push_back(std::make_shared<RecordingEvent>(
+      startTime + seconds(2), 3, true, ids));
+    eventHandler.Add(std::move(events));
+    auto lastEvent = std::make_shared<RecordingEvent>(startTime + seconds(2),
+      4, false, ids);
+    eventHandler.Add(std::make_shared<RecordingEvent>(startTime + seconds(1),
+      5, true, ids));
+    eventHandler.Add(lastEvent);
+    lastEvent->Wait();
+    REQUIRE(ids == std::vector{2, 5, 1, 3, 4});
+    REQUIRE(eventHandler.GetTime() == startTime + seconds(2));
+  }
+
+  TEST_CASE("timer_at_current_time") {
+    auto startTime = time_from_string("2016-05-06 00:00:00");
+    auto eventHandler = BacktesterEventHandler(startTime);
+    auto timer = BacktesterTimer(seconds(0), Ref(eventHandler));
+    auto ids = std::vector<int>();
+    timer.GetPublisher().Monitor(MakeCallbackQueueWriter<Timer::Result>(
+      [&] (Timer::Result result) {
+        if(result == Timer::Result::EXPIRED) {
+          ids.push_back(0);
+        }
+      }));
+    auto events = std::vector<std::shared_ptr<BacktesterEvent>>();
+    events.push_back(std::make_shared<RecordingEvent>(
+      startTime + seconds(1), 1, false, ids, [&] {
+        timer.Start();
+      }));
+    events.push_back(std::make_shared<RecordingEvent>(
+      startTime + seconds(1), 2, true, ids));
+    events.push_back(std::make_shared<RecordingEvent>(
+      startTime + seconds(1), 3, false, ids));
+    auto lastEvent = std::make_shared<RecordingEvent>(startTime + seconds(2),
+      4, false, ids);
+    events.push_back(lastEvent);
+    eventHandler.Add(std::move(events));
+    lastEvent->Wait();
+    REQUIRE(ids == std::vector{1, 2, 3, 0, 4});
+  }
+
+  TEST_CASE("close_while_busy") {
+    auto startTime = time_from_string("2016-05-06 00:00:00");
+    auto eventHandler = BacktesterEventHandler(startTime);
+    auto ids = std::vector<int>();
+    auto entered = Queue<bool>();
+    auto gate = Queue<bool>();
+    auto events = std::vector<std::shared_ptr<BacktesterEvent>>();
+    events.push_back(std::make_shared<RecordingEvent>(
+      startTime + seconds(1), 1, false, ids, [&] {
+        entered.Push(true);
+        gate.Pop();
+      }));
+    events.push_back(std::make_shared<RecordingEvent>(
+      startTime + seconds(2), 2, false, ids));
+    events.push_back(std::make_shared<RecordingEvent>(
+      startTime + seconds(3), 3, false, ids));
+    eventHandler.Add(std::move(events));
+    entered.Pop();
+    auto closeRoutine = RoutineHandler(Spawn([&] {
+      gate.Push(true);
+      eventHandler.Close();
+    }));
+    closeRoutine.Wait();
+    REQUIRE(ids == std::vector{1});
+  }
+
+  TEST_CASE("spawned_routines") {
+    auto startTime = time_from_string("2016-05-06 00:00:00");
+    auto eventHandler = BacktesterEventHandler(startTime);
+    auto ids = std::vector<int>();
+    auto gate = Queue<bool>();
+    auto events = std::vector<std::shared_ptr<BacktesterEvent>>();
+    events.push_back(std::make_shared<RecordingEvent>(
+      startTime + seconds(1), 1, false, ids, [&] {
+        eventHandler.Spawn([&] {
+          gate.Pop();
+          ids.push_back(2);
+        });
+        gate.Push(true);
+      }));
+    auto lastEvent = std::make_shared<RecordingEvent>(startTime + seconds(2),
+      3, false, ids);
+    events.push_back(lastEvent);
+    eventHandler.Add(std::move(events));
+    lastEvent->Wait();
+    REQUIRE(ids == std::vector{1, 2, 3});
+  }
+
+  TEST_CASE("throughput_benchmark" * doctest::skip()) {
+    const auto RUN_COUNT = 1000;
+    const auto RUN_SIZE = 10000;
+    auto startTime = time_from_string("2016-05-06 00:00:00");
+    auto eventHandler = BacktesterEventHandler(startTime);
+    auto count = 0;
+    auto runs = std::vector<std::vector<std::shared_ptr<BacktesterEvent>>>();
+    for(auto i = 0; i != RUN_COUNT; ++i) {
+      auto& run = runs.emplace_back();
+      for(auto j = 0; j != RUN_SIZE; ++j) {
+        run.push_back(std::make_shared<CountingEvent>(
+          startTime + microseconds(j * RUN_COUNT + i), true, count));
+      }
+    }
+    auto lastEvent = std::make_shared<CountingEvent>(
+      startTime + hours(1), false, count);
+    auto start = std::chrono::steady_clock::now();
+    for(auto& run : runs) {
+      eventHandler.Add(std::move(run));
+    }
+    eventHandler.Add(lastEvent);
+    lastEvent->Wait();
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+    REQUIRE(count == RUN_COUNT * RUN_SIZE + 1);
+    MESSAGE("Events: " << count << ", events per second: " <<
+      static_cast<std::int64_t>(count * 1E9 / elapsed.count()));
+  }
+}
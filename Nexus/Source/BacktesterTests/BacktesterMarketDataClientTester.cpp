@@ -62,6 +62,8 @@ TEST_SUITE("BacktesterMarketDataClient") {
       queryCompleteCondition.wait(lock);
     }
     REQUIRE(*testSucceeded);
+    auto metrics = backtesterEnvironment.GetMarketDataService().GetMetrics();
+    REQUIRE(metrics.m_loadCount >= 1);
   }
 
   TEST_CASE("historical_query") {
@@ -0,0 +1,140 @@
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include <Beam/Queues/Queue.hpp>
+#include <doctest/doctest.h>
+#include "Nexus/Backtester/MarketDataPrefetcher.hpp"
+#include "Nexus/MarketDataService/ColumnarHistoricalDataStore.hpp"
+#include "Nexus/MarketDataService/LocalHistoricalDataStore.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+using namespace boost;
+using namespace boost::posix_time;
+using namespace Nexus;
+using namespace Nexus::MarketDataService;
+
+namespace {
+  const auto SECURITY = Security("A", DefaultMarkets::NASDAQ(),
+    DefaultCountries::US());
+
+  struct ColumnarDirectory {
+    std::filesystem::path m_path;
+
+    ColumnarDirectory() {
+      static auto count = 0;
+      m_path = std::filesystem::temp_directory_path() /
+        ("nexus_prefetcher_" + std::to_string(
+          std::chrono::steady_clock::now().time_since_epoch().count()) + "_" +
+          std::to_string(++count));
+      std::filesystem::remove_all(m_path);
+    }
+
+    ~ColumnarDirectory() {
+      auto error = std::error_code();
+      std::filesystem::remove_all(m_path, error);
+    }
+  };
+
+  struct RecordingDataStore : LocalHistoricalDataStore {
+    std::shared_ptr<Queue<int>> m_loads = std::make_shared<Queue<int>>();
+    std::atomic_int m_loadCount{0};
+    int m_failedLoad = -1;
+
+    std::vector<SequencedBboQuote> LoadBboQuotes(
+        const SecurityMarketDataQuery& query) {
+      auto load = ++m_loadCount;
+      m_loads->Push(load);
+      if(load == m_failedLoad) {
+        throw std::runtime_error("Load failed.");
+      }
+      return LocalHistoricalDataStore::LoadBboQuotes(query);
+    }
+  };
+
+  template<typename DataStore>
+  void StoreBboQuotes(DataStore& dataStore, int count) {
+    auto timestamp = time_from_string("2020-05-12 10:00:00");
+    for(auto i = 0; i != count; ++i) {
+      dataStore.Store(SequencedSecurityBboQuote(SecurityBboQuote(BboQuote(
+        Quote(Money::ONE, 100 + i, Side::BID),
+        Quote(Money::ONE + Money::CENT, 100, Side::ASK),
+        timestamp + seconds(i)), SECURITY), Beam::Queries::Sequence(i + 1)));
+    }
+  }
+
+  std::vector<int> GetChunkSizes(MarketDataPrefetcher<BboQuote>& prefetcher) {
+    auto sizes = std::vector<int>();
+    while(true) {
+      auto chunk = prefetcher.Next();
+      if(chunk.empty()) {
+        return sizes;
+      }
+      sizes.push_back(static_cast<int>(chunk.size()));
+    }
+  }
+}
+
+TEST_SUITE("MarketDataPrefetcher") {
+  TEST_CASE("columnar_completion") {
+    auto directory = ColumnarDirectory();
+    auto dataStore = ColumnarHistoricalDataStore(directory.m_path, 2);
+    StoreBboQuotes(dataStore, 5);
+    dataStore.Flush();
+    auto prefetcher = MarketDataPrefetcher<BboQuote>(
+      HistoricalDataStoreBox(&dataStore), SECURITY,
+      Beam::Queries::Sequence::First(), Beam::Queries::Sequence::Last(), 2,
+      1);
+    REQUIRE(GetChunkSizes(prefetcher) == std::vector{2, 2, 1});
+    REQUIRE(prefetcher.IsReady());
+    REQUIRE(prefetcher.Next().empty());
+    prefetcher.Close();
+    dataStore.Close();
+  }
+
+  TEST_CASE("close_while_blocked") {
+    auto dataStore = RecordingDataStore();
+    StoreBboQuotes(dataStore, 5);
+    auto prefetcher = MarketDataPrefetcher<BboQuote>(
+      HistoricalDataStoreBox(&dataStore), SECURITY,
+      Beam::Queries::Sequence::First(), Beam::Queries::Sequence::Last(), 1,
+      2);
+    REQUIRE(dataStore.m_loads->Pop() == 1);
+    REQUIRE(dataStore.m_loads->Pop() == 2);
+    prefetcher.Close();
+    REQUIRE(dataStore.m_loadCount == 2);
+  }
+
+  TEST_CASE("bounded_buffer") {
+    auto dataStore = RecordingDataStore();
+    StoreBboQuotes(dataStore, 5);
+    auto prefetcher = MarketDataPrefetcher<BboQuote>(
+      HistoricalDataStoreBox(&dataStore), SECURITY,
+      Beam::Queries::Sequence::First(), Beam::Queries::Sequence::Last(), 1,
+      2);
+    for(auto i = 1; i <= 5; ++i) {
+      REQUIRE(dataStore.m_loads->Pop() == i);
+      auto chunk = prefetcher.Next();
+      REQUIRE(chunk.size() == 1);
+      REQUIRE(chunk.front().GetSequence() == Beam::Queries::Sequence(i));
+      REQUIRE(dataStore.m_loadCount <= i + 2);
+    }
+    REQUIRE(prefetcher.Next().empty());
+    REQUIRE(dataStore.m_loadCount == 6);
+  }
+
+  TEST_CASE("load_failure") {
+    auto dataStore = RecordingDataStore();
+    dataStore.m_failedLoad = 2;
+    StoreBboQuotes(dataStore, 5);
+    auto prefetcher = MarketDataPrefetcher<BboQuote>(
+      HistoricalDataStoreBox(&dataStore), SECURITY,
+      Beam::Queries::Sequence::First(), Beam::Queries::Sequence::Last(), 1,
+      4);
+    REQUIRE(prefetcher.Next().size() == 1);
+    REQUIRE_THROWS_AS(prefetcher.Next(), std::runtime_error);
+    REQUIRE_THROWS_AS(prefetcher.Next(), std::runtime_error);
+    REQUIRE(dataStore.m_loadCount == 2);
+  }
+}
@@ -0,0 +1,176 @@
+#include <array>
+#include <mutex>
+#include <Beam/Queues/Queue.hpp>
+#include <doctest/doctest.h>
+#include "Nexus/Backtester/BacktesterEnvironment.hpp"
+#include "Nexus/Backtester/BacktesterEventHandler.hpp"
+#include "Nexus/Backtester/BacktesterTimeWindow.hpp"
+#include "Nexus/Backtester/ParallelBacktester.hpp"
+#include "Nexus/MarketDataService/LocalHistoricalDataStore.hpp"
+#include "Nexus/ServiceClients/TestServiceClients.hpp"
+
+using namespace Beam;
+using namespace boost;
+using namespace boost::posix_time;
+using namespace Nexus;
+using namespace Nexus::MarketDataService;
+
+namespace {
+  class WindowEvent : public BacktesterEvent {
+    public:
+      WindowEvent(ptime timestamp, std::mutex& mutex,
+        std::vector<ptime>& timestamps)
+        : BacktesterEvent(timestamp),
+          m_mutex(&mutex),
+          m_timestamps(&timestamps) {}
+
+      void Execute() override {
+        auto lock = std::lock_guard(*m_mutex);
+        m_timestamps->push_back(GetTimestamp());
+      }
+
+    private:
+      std::mutex* m_mutex;
+      std::vector<ptime>* m_timestamps;
+  };
+
+  class RendezvousEvent : public BacktesterEvent {
+    public:
+      RendezvousEvent(ptime timestamp, int value, Queue<int>& outbound,
+        Queue<int>& inbound)
+        : BacktesterEvent(timestamp),
+          m_value(value),
+          m_outbound(&outbound),
+          m_inbound(&inbound) {}
+
+      void Execute() override {
+        m_outbound->Push(m_value);
+        m_inbound->Pop();
+      }
+
+    private:
+      int m_value;
+      Queue<int>* m_outbound;
+      Queue<int>* m_inbound;
+  };
+}
+
+TEST_SUITE("ParallelBacktester") {
+  TEST_CASE("ordered_results") {
+    auto results = RunParallelBacktests(8, [] (int partition) {
+      return 10 * partition;
+    }, 3);
+    REQUIRE(results == std::vector{0, 10, 20, 30, 40, 50, 60, 70});
+  }
+
+  TEST_CASE("failure") {
+    REQUIRE_THROWS_AS(RunParallelBacktests(4, [] (int partition) {
+      if(partition == 2) {
+        throw std::runtime_error("Failed.");
+      }
+      return partition;
+    }, 2), std::runtime_error);
+  }
+
+  TEST_CASE("invalid_thread_count") {
+    auto startTime = time_from_string("2016-05-06 00:00:00");
+    REQUIRE_THROWS_AS(RunParallelBacktests(2, [] (int partition) {
+      return partition;
+    }, 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(RunParallelBacktests(startTime, seconds(10), 3,
+      [] (int partition,
+          const std::shared_ptr<BacktesterTimeWindow::Participant>&) {
+        return partition;
+      }, 2), std::invalid_argument);
+  }
+
+  TEST_CASE("time_window") {
+    auto startTime = time_from_string("2016-05-06 00:00:00");
+    auto window = std::shared_ptr<BacktesterTimeWindow>();
+    auto results = RunParallelBacktests(startTime, seconds(10), 2,
+      [&] (int partition,
+          const std::shared_ptr<BacktesterTimeWindow::Participant>&
+            participant) {
+        if(partition == 0) {
+          window = participant->GetWindow();
+        }
+        auto timestamp = startTime + seconds(25 + partition);
+        participant->Advance(timestamp);
+        return timestamp < participant->GetWindow()->GetWindowEnd();
+      });
+    REQUIRE(results == std::vector{true, true});
+    REQUIRE(window->GetWindowEnd() == startTime + seconds(30));
+  }
+
+  TEST_CASE("failed_participant") {
+    auto startTime = time_from_string("2016-05-06 00:00:00");
+    REQUIRE_THROWS_AS(RunParallelBacktests(startTime, seconds(10), 2,
+      [&] (int partition,
+          const std::shared_ptr<BacktesterTimeWindow::Participant>&
+            participant) {
+        if(partition == 0) {
+          throw std::runtime_error("Failed.");
+        }
+        participant->Advance(startTime + seconds(25));
+        return partition;
+      }), std::runtime_error);
+  }
+
+  TEST_CASE("shared_event_handlers") {
+    auto startTime = time_from_string("2016-05-06 00:00:00");
+    auto offsets = std::vector<std::vector<int>>{{1, 15, 35}, {5, 25}};
+    auto mutex = std::mutex();
+    auto timestamps = std::vector<ptime>();
+    RunParallelBacktests(startTime, seconds(10), 2,
+      [&] (int partition,
+          const std::shared_ptr<BacktesterTimeWindow::Participant>&
+            participant) {
+        auto eventHandler = BacktesterEventHandler(startTime, pos_infin,
+          participant);
+        auto events = std::vector<std::shared_ptr<BacktesterEvent>>();
+        for(auto offset : offsets[partition]) {
+          events.push_back(std::make_shared<WindowEvent>(
+            startTime + seconds(offset), mutex, timestamps));
+        }
+        auto lastEvent = events.back();
+        eventHandler.Add(std::move(events));
+        lastEvent->Wait();
+        eventHandler.Close();
+        return partition;
+      });
+    REQUIRE(timestamps.size() == 5);
+    for(auto i = std::size_t(1); i < timestamps.size(); ++i) {
+      REQUIRE((timestamps[i - 1] - startTime).total_seconds() / 10 <=
+        (timestamps[i] - startTime).total_seconds() / 10);
+    }
+  }
+
+  TEST_CASE("concurrent_environments") {
+    const auto EVENT_COUNT = 100;
+    auto startTime = time_from_string("2016-05-06 00:00:00");
+    auto queues = std::array<Queue<int>, 2>();
+    auto results = RunParallelBacktests(2, [&] (int partition) {
+      auto dataStore = LocalHistoricalDataStore();
+      auto testEnvironment = TestEnvironment(
+        HistoricalDataStoreBox(&dataStore));
+      auto environment = BacktesterEnvironment(startTime,
+        ServiceClientsBox(std::in_place_type<TestServiceClients>,
+          Ref(testEnvironment)));
+      auto events = std::vector<std::shared_ptr<BacktesterEvent>>();
+      for(auto i = 0; i != EVENT_COUNT; ++i) {
+        events.push_back(std::make_shared<RendezvousEvent>(
+          startTime + seconds(i + 1), i, queues[partition],
+          queues[1 - partition]));
+      }
+      auto lastEvent = events.back();
+      environment.GetEventHandler().Add(std::move(events));
+      lastEvent->Wait();
+      auto time = environment.GetEventHandler().GetTime();
+      environment.Close();
+      testEnvironment.Close();
+      return time;
+    }, 2);
+    REQUIRE(results == std::vector{startTime + seconds(EVENT_COUNT),
+      startTime + seconds(EVENT_COUNT)});
+  }
+}
@@ -1,3 +1,5 @@
+#include <chrono>
+#include <vector>
 #include <boost/lexical_cast.hpp>
 #include <boost/optional/optional_io.hpp>
 #include <doctest/doctest.h>
@@ -7,6 +9,27 @@ using namespace Beam;
 using namespace boost;
 using namespace Nexus;
 
+namespace {
+  const auto BENCHMARK_ITERATIONS = 1000000;
+
+  template<typename F>
+  void Benchmark(const char* name, F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    for(auto i = 0; i < BENCHMARK_ITERATIONS; ++i) {
+      f(i);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+#ifdef NEXUS_FIXED_POINT_QUANTITY
+    auto backend = "fixed-point";
+#else
+    auto backend = "floating-point";
+#endif
+    MESSAGE(name << " (" << backend << "): " <<
+      elapsed.count() / BENCHMARK_ITERATIONS << " ns per operation");
+  }
+}
+
 TEST_SUITE("Quantity") {
   TEST_CASE("to_string") {
     REQUIRE(lexical_cast<std::string>(Quantity(0)) == "0");
@@ -125,4 +148,124 @@ TEST_SUITE("Quantity") {
     REQUIRE(Round(Quantity(73), -2) == Quantity(100));
     REQUIRE(Round(Quantity(73), -2) == Quantity(100));
   }
+
+  TEST_CASE("multiply_divide") {
+    REQUIRE(*Quantity::FromValue("1.5") * *Quantity::FromValue("1.5") ==
+      Quantity::FromValue("2.25"));
+    REQUIRE(Quantity(-4) * *Quantity::FromValue("0.25") == Quantity(-1));
+    REQUIRE(Quantity(9) / Quantity(4) == Quantity::FromValue("2.25"));
+    REQUIRE(Quantity(-9) / Quantity(4) == Quantity::FromValue("-2.25"));
+  }
+
+  TEST_CASE("numeric_limits") {
+    using Limits = std::numeric_limits<Quantity>;
+    REQUIRE(Limits::is_specialized);
+    REQUIRE(Limits::has_infinity);
+    REQUIRE(Limits::has_quiet_NaN);
+    REQUIRE(Limits::infinity() > Limits::max());
+    REQUIRE(-Limits::infinity() < Limits::lowest());
+    REQUIRE(Limits::lowest() < Quantity(0));
+    REQUIRE(Limits::max() > Quantity(std::int64_t(1000000000000)));
+    REQUIRE(Limits::min() > Quantity(0));
+    REQUIRE(Limits::epsilon() > Quantity(0));
+    REQUIRE(Limits::quiet_NaN() != Quantity(0));
+    REQUIRE(Limits::quiet_NaN() != Limits::infinity());
+    REQUIRE(Limits::quiet_NaN() != -Limits::infinity());
+  }
+
+#ifdef NEXUS_FIXED_POINT_QUANTITY
+  TEST_CASE("fixed_point_round") {
+    auto value = *Quantity::FromValue("1.234567");
+    REQUIRE(Round(value, 6) == value);
+    REQUIRE(Round(value, 8) == value);
+    REQUIRE(Round(value, 5) == Quantity::FromValue("1.23457"));
+    REQUIRE(Round(*Quantity::FromValue("-1.234565"), 5) ==
+      Quantity::FromValue("-1.23456"));
+    REQUIRE(Floor(value, 6) == value);
+    REQUIRE(Floor(*Quantity::FromValue("-0.000001"), 5) ==
+      Quantity::FromValue("-0.00001"));
+  }
+
+  TEST_CASE("fixed_point_from_value") {
+    REQUIRE(Quantity::FromValue("1.2345675") ==
+      Quantity::FromValue("1.234568"));
+    REQUIRE(Quantity::FromValue("1.2345674") ==
+      Quantity::FromValue("1.234567"));
+    REQUIRE(Quantity::FromValue("-1.2345675") ==
+      Quantity::FromValue("-1.234568"));
+    REQUIRE(Quantity::FromValue("0.00000049") == Quantity(0));
+    REQUIRE(Quantity::FromValue("12.5")->GetRepresentation() == 12500000);
+  }
+
+  TEST_CASE("fixed_point_multiply_divide") {
+    auto unit = Quantity::FromRepresentation(1);
+    REQUIRE(unit * *Quantity::FromValue("0.5") == unit);
+    REQUIRE(-unit * *Quantity::FromValue("0.5") == -unit);
+    REQUIRE(unit * *Quantity::FromValue("0.4") == Quantity(0));
+    REQUIRE(Quantity(1) / Quantity(3) == Quantity::FromValue("0.333333"));
+    REQUIRE(Quantity(2) / Quantity(3) == Quantity::FromValue("0.666667"));
+    REQUIRE(Quantity(-2) / Quantity(3) == Quantity::FromValue("-0.666667"));
+  }
+
+  TEST_CASE("fixed_point_overflow") {
+    auto large = Quantity(std::int64_t(3037000));
+    REQUIRE(large * large == Quantity(std::int64_t(9223369000000)));
+    REQUIRE(Quantity(std::int64_t(9000000000000)) / Quantity(3) ==
+      Quantity(std::int64_t(3000000000000)));
+    auto divisor = Quantity(std::int64_t(3000000000000));
+    REQUIRE(Quantity(std::int64_t(1000000000000)) / divisor ==
+      Quantity::FromValue("0.333333"));
+    REQUIRE(Quantity(std::int64_t(2000000000000)) / divisor ==
+      Quantity::FromValue("0.666667"));
+  }
+
+  TEST_CASE("fixed_point_numeric_limits") {
+    using Limits = std::numeric_limits<Quantity>;
+    REQUIRE(Limits::min() == Quantity::FromRepresentation(1));
+    REQUIRE(Limits::epsilon() == Quantity::FromRepresentation(1));
+    REQUIRE(Limits::lowest() == -Limits::max());
+    REQUIRE(Limits::quiet_NaN() < -Limits::infinity());
+  }
+#endif
+
+  TEST_CASE("arithmetic_benchmark" * doctest::skip()) {
+    auto price = *Quantity::FromValue("12.345");
+    auto total = Quantity(0);
+    Benchmark("multiply_add", [&] (auto i) {
+      total += price * Quantity(i % 100);
+    });
+    Benchmark("divide", [&] (auto i) {
+      total += price / Quantity(i % 100 + 1);
+    });
+    Benchmark("round", [&] (auto i) {
+      total += Round(price * Quantity(i % 100), 2);
+    });
+    Benchmark("compare", [&] (auto i) {
+      if(Quantity(i) < total) {
+        total -= price;
+      }
+    });
+    REQUIRE(total != Quantity(0));
+  }
+
+  TEST_CASE("from_value_benchmark" * doctest::skip()) {
+    auto values = std::vector<std::string>();
+    for(auto i = 0; i < 100; ++i) {
+      values.push_back(std::to_string(i) + "." + std::to_string(i * 37 % 1000));
+    }
+    auto total = Quantity(0);
+    Benchmark("from_value", [&] (auto i) {
+      total += *Quantity::FromValue(values[i % values.size()]);
+    });
+    REQUIRE(total != Quantity(0));
+  }
+
+  TEST_CASE("to_string_benchmark" * doctest::skip()) {
+    auto price = *Quantity::FromValue("12.345");
+    auto length = std::size_t(0);
+    Benchmark("to_string", [&] (auto i) {
+      length += lexical_cast<std::string>(price + Quantity(i % 100)).size();
+    });
+    REQUIRE(length != 0);
+  }
 }
@@ -0,0 +1,45 @@
+#include <Beam/IO/SharedBuffer.hpp>
+#include <Beam/Serialization/BinaryReceiver.hpp>
+#include <Beam/Serialization/BinarySender.hpp>
+#include <doctest/doctest.h>
+#include "Nexus/Definitions/DefaultCountryDatabase.hpp"
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/Definitions/Security.hpp"
+
+using namespace Beam;
+using namespace Beam::IO;
+using namespace Beam::Serialization;
+using namespace Nexus;
+
+TEST_SUITE("Security") {
+  TEST_CASE("hash") {
+    auto a = Security("ABX", DefaultMarkets::TSX(), DefaultCountries::CA());
+    auto b = Security("ABX", DefaultCountries::CA());
+    auto c = Security("ABX", DefaultMarkets::NYSE(), DefaultCountries::US());
+    REQUIRE(a == b);
+    REQUIRE(std::hash<Security>()(a) == std::hash<Security>()(b));
+    REQUIRE(a != c);
+    REQUIRE(std::hash<Security>()(Security()) ==
+      std::hash<Security>()(Security("", CountryCode::NONE)));
+    auto securities = SecurityUnorderedSet();
+    securities.insert(a);
+    REQUIRE(securities.count(b) == 1);
+    REQUIRE(securities.count(c) == 0);
+  }
+
+  TEST_CASE("shuttle") {
+    auto security = Security("ABX", DefaultMarkets::TSX(),
+      DefaultCountries::CA());
+    auto buffer = SharedBuffer();
+    auto sender = BinarySender<SharedBuffer>();
+    sender.SetSink(Ref(buffer));
+    sender.Shuttle(security);
+    auto receiver = BinaryReceiver<SharedBuffer>();
+    receiver.SetSource(Ref(buffer));
+    auto received = Security();
+    receiver.Shuttle(received);
+    REQUIRE(PreciseEqualTo(received, security));
+    REQUIRE(std::hash<Security>()(received) ==
+      std::hash<Security>()(security));
+  }
+}
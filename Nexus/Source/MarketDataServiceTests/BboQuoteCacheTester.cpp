@@ -0,0 +1,106 @@
+#include <atomic>
+#include <type_traits>
+#include <Beam/Queues/CallbackQueueWriter.hpp>
+#include <Beam/Queues/Queue.hpp>
+#include <Beam/Queues/ScopedQueueWriter.hpp>
+#include <doctest/doctest.h>
+#include "Nexus/MarketDataService/BboQuoteCache.hpp"
+#include "Nexus/ServiceClients/TestEnvironment.hpp"
+#include "Nexus/ServiceClients/TestServiceClients.hpp"
+
+using namespace Beam;
+using namespace Nexus;
+using namespace Nexus::MarketDataService;
+
+namespace {
+  const auto TST = Security("TST", DefaultMarkets::NYSE(),
+    DefaultCountries::US());
+
+  struct SubscriptionMonitor {
+    std::atomic_int m_snapshotCount = 0;
+    Queue<std::shared_ptr<ScopedQueueWriter<BboQuote>>> m_subscriptions;
+  };
+
+  struct MonitoredMarketDataClient {
+    MarketDataClientBox m_client;
+    SubscriptionMonitor* m_monitor;
+
+    template<typename Query, typename Queue>
+    void QueryBboQuotes(const Query& query, Queue queue) {
+      if constexpr(std::is_same_v<Queue, ScopedQueueWriter<BboQuote>>) {
+        auto subscription =
+          std::make_shared<ScopedQueueWriter<BboQuote>>(std::move(queue));
+        m_monitor->m_subscriptions.Push(subscription);
+        m_client.QueryBboQuotes(query, MakeCallbackQueueWriter<BboQuote>(
+          [=] (const BboQuote& bboQuote) {
+            subscription->Push(bboQuote);
+          }));
+      } else {
+        ++m_monitor->m_snapshotCount;
+        m_client.QueryBboQuotes(query, std::move(queue));
+      }
+    }
+  };
+
+  struct Fixture {
+    TestEnvironment m_environment;
+    TestServiceClients m_serviceClients;
+    SubscriptionMonitor m_monitor;
+    MonitoredMarketDataClient m_marketDataClient;
+
+    Fixture()
+      : m_serviceClients(Ref(m_environment)),
+        m_marketDataClient{m_serviceClients.GetMarketDataClient(),
+          &m_monitor} {}
+  };
+}
+
+TEST_SUITE("BboQuoteCache") {
+  TEST_CASE_FIXTURE(Fixture, "load") {
+    m_environment.UpdateBboPrice(TST, Money::ONE, Money::ONE + Money::CENT);
+    auto cache = BboQuoteCache(&m_serviceClients.GetMarketDataClient());
+    auto handle = cache.GetHandle(TST);
+    REQUIRE(handle.GetSecurity() == TST);
+    auto bboQuote = cache.Load(handle);
+    REQUIRE(bboQuote.m_bid.m_price == Money::ONE);
+    REQUIRE(bboQuote.m_ask.m_price == Money::ONE + Money::CENT);
+    auto cachedQuote = cache.Find(handle);
+    REQUIRE(cachedQuote.is_initialized());
+    REQUIRE(cachedQuote->m_bid.m_price == Money::ONE);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "watch_list") {
+    m_environment.UpdateBboPrice(TST, Money::ONE, Money::ONE + Money::CENT);
+    auto cache = BboQuoteCache(&m_serviceClients.GetMarketDataClient(),
+      std::vector{TST});
+    REQUIRE(cache.Load(TST).m_bid.m_price == Money::ONE);
+    REQUIRE(cache.Find(cache.GetHandle(TST)).is_initialized());
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "shared_subscription") {
+    m_environment.UpdateBboPrice(TST, Money::ONE, Money::ONE + Money::CENT);
+    auto cache = BboQuoteCache(&m_marketDataClient);
+    auto handleA = cache.GetHandle(TST);
+    auto handleB = cache.GetHandle(TST);
+    REQUIRE(cache.Load(handleA).m_bid.m_price == Money::ONE);
+    REQUIRE(cache.Load(handleB).m_bid.m_price == Money::ONE);
+    REQUIRE(cache.Load(TST).m_bid.m_price == Money::ONE);
+    REQUIRE(m_monitor.m_snapshotCount == 1);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "resubscribe") {
+    m_environment.UpdateBboPrice(TST, Money::ONE, Money::ONE + Money::CENT);
+    auto cache = BboQuoteCache(&m_marketDataClient);
+    auto handle = cache.GetHandle(TST);
+    REQUIRE(cache.Load(handle).m_bid.m_price == Money::ONE);
+    m_monitor.m_subscriptions.Pop()->Break();
+    REQUIRE(!cache.Find(handle).is_initialized());
+    m_environment.UpdateBboPrice(TST, 2 * Money::ONE,
+      2 * Money::ONE + Money::CENT);
+    REQUIRE(cache.Load(handle).m_bid.m_price == 2 * Money::ONE);
+    REQUIRE(m_monitor.m_snapshotCount == 2);
+    auto cachedQuote = cache.Find(cache.GetHandle(TST));
+    REQUIRE(cachedQuote.is_initialized());
+    REQUIRE(cachedQuote->m_bid.m_price == 2 * Money::ONE);
+  }
+}
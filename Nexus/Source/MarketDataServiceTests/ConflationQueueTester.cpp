@@ -0,0 +1,102 @@
+#include <doctest/doctest.h>
+#include "Nexus/Definitions/DefaultCountryDatabase.hpp"
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/MarketDataService/ConflationQueue.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+using namespace boost;
+using namespace boost::posix_time;
+using namespace Nexus;
+using namespace Nexus::MarketDataService;
+
+namespace {
+  const auto SECURITY_A = Security("TST", DefaultMarkets::NYSE(),
+    DefaultCountries::US());
+  const auto SECURITY_B = Security("ABC", DefaultMarkets::NYSE(),
+    DefaultCountries::US());
+
+  auto MakeBboQuote(const Security& security, Money bid,
+      Beam::Queries::Sequence sequence) {
+    return SequencedValue(IndexedValue(
+      BboQuote(Quote(bid, 100, Side::BID), Quote(bid + Money::CENT, 100,
+        Side::ASK), not_a_date_time), security), sequence);
+  }
+
+  auto MakeBookQuote(const Security& security, Money price, Quantity size,
+      Beam::Queries::Sequence sequence) {
+    return SequencedValue(IndexedValue(BookQuote("TST", false,
+      DefaultMarkets::NYSE(), Quote(price, size, Side::BID),
+      not_a_date_time), security), sequence);
+  }
+
+  auto PopBboQuote(ConflationQueue& queue) {
+    auto update = queue.Pop();
+    REQUIRE(update.is_initialized());
+    return get<SequencedSecurityBboQuote>(*update);
+  }
+}
+
+TEST_SUITE("ConflationQueue") {
+  TEST_CASE("below_threshold") {
+    auto queue = ConflationQueue(10);
+    queue.Push(MakeBboQuote(SECURITY_A, Money::ONE, Sequence(1)));
+    queue.Push(MakeBboQuote(SECURITY_A, 2 * Money::ONE, Sequence(2)));
+    REQUIRE(queue.GetSize() == 2);
+    REQUIRE(!queue.IsConflating());
+    REQUIRE(PopBboQuote(queue).GetSequence() == Sequence(1));
+    REQUIRE(PopBboQuote(queue).GetSequence() == Sequence(2));
+    REQUIRE(!queue.Pop().is_initialized());
+  }
+
+  TEST_CASE("conflate_bbo_quotes") {
+    auto queue = ConflationQueue(2);
+    queue.Push(MakeBboQuote(SECURITY_A, Money::ONE, Sequence(1)));
+    queue.Push(MakeBboQuote(SECURITY_B, Money::ONE, Sequence(2)));
+    queue.Push(MakeBboQuote(SECURITY_A, 2 * Money::ONE, Sequence(3)));
+    queue.Push(MakeBboQuote(SECURITY_A, 3 * Money::ONE, Sequence(4)));
+    REQUIRE(queue.GetSize() == 2);
+    REQUIRE(queue.IsConflating());
+    auto first = PopBboQuote(queue);
+    REQUIRE(first->GetIndex() == SECURITY_B);
+    REQUIRE(!queue.IsConflating());
+    auto second = PopBboQuote(queue);
+    REQUIRE(second->GetIndex() == SECURITY_A);
+    REQUIRE(second.GetSequence() == Sequence(4));
+    REQUIRE(!queue.Pop().is_initialized());
+  }
+
+  TEST_CASE("conflate_book_quote_levels") {
+    auto queue = ConflationQueue(2);
+    queue.Push(MakeBookQuote(SECURITY_A, Money::ONE, 100, Sequence(1)));
+    queue.Push(MakeBookQuote(SECURITY_A, 2 * Money::ONE, 100, Sequence(2)));
+    queue.Push(MakeBookQuote(SECURITY_A, Money::ONE, 0, Sequence(3)));
+    REQUIRE(queue.GetSize() == 2);
+    auto first = get<SequencedSecurityBookQuote>(*queue.Pop());
+    REQUIRE(first.GetSequence() == Sequence(2));
+    auto second = get<SequencedSecurityBookQuote>(*queue.Pop());
+    REQUIRE(second.GetSequence() == Sequence(3));
+    REQUIRE(second->GetValue().m_quote.m_size == 0);
+  }
+
+  TEST_CASE("remove_security") {
+    auto queue = ConflationQueue(2);
+    queue.Push(MakeBboQuote(SECURITY_A, Money::ONE, Sequence(1)));
+    queue.Push(MakeBookQuote(SECURITY_A, Money::ONE, 100, Sequence(2)));
+    queue.Push(MakeBboQuote(SECURITY_B, Money::ONE, Sequence(3)));
+    queue.Push(MakeBboQuote(SECURITY_A, 2 * Money::ONE, Sequence(4)));
+    REQUIRE(queue.IsConflating());
+    auto bboQuotes = queue.RemoveBboQuotes(SECURITY_A);
+    REQUIRE(bboQuotes.size() == 1);
+    REQUIRE(bboQuotes[0].GetSequence() == Sequence(4));
+    REQUIRE(queue.GetSize() == 2);
+    auto bookQuotes = queue.RemoveBookQuotes(SECURITY_A);
+    REQUIRE(bookQuotes.size() == 1);
+    REQUIRE(queue.GetSize() == 1);
+    REQUIRE(!queue.IsConflating());
+    REQUIRE(PopBboQuote(queue)->GetIndex() == SECURITY_B);
+    REQUIRE(!queue.Pop().is_initialized());
+    queue.Push(MakeBboQuote(SECURITY_A, 3 * Money::ONE, Sequence(5)));
+    REQUIRE(PopBboQuote(queue).GetSequence() == Sequence(5));
+  }
+}
@@ -1,6 +1,10 @@
+#include <chrono>
+#include <filesystem>
+#include <mutex>
 #include <Beam/TimeService/IncrementalTimeClient.hpp>
 #include <doctest/doctest.h>
 #include <Viper/Sqlite3/Connection.hpp>
+#include "Nexus/MarketDataService/ColumnarHistoricalDataStore.hpp"
 #include "Nexus/MarketDataService/LocalHistoricalDataStore.hpp"
 #include "Nexus/MarketDataService/SqlHistoricalDataStore.hpp"
 
@@ -38,6 +42,54 @@ namespace {
     }
   };
 
+  /**
+   * Serializes statements across connections, SQLite's shared cache admits
+   * only one writer at a time.
+   */
+  class SerializedSqliteConnection : public Viper::Sqlite3::Connection {
+    public:
+      using Viper::Sqlite3::Connection::Connection;
+
+      template<typename... Args>
+      decltype(auto) execute(Args&&... args) {
+        static auto mutex = std::recursive_mutex();
+        auto lock = std::lock_guard(mutex);
+        return Viper::Sqlite3::Connection::execute(
+          std::forward<Args>(args)...);
+      }
+  };
+
+  struct ColumnarDirectory {
+    std::filesystem::path m_path;
+
+    ColumnarDirectory() {
+      static auto count = 0;
+      m_path = std::filesystem::temp_directory_path() /
+        ("nexus_columnar_" + std::to_string(
+          std::chrono::steady_clock::now().time_since_epoch().count()) + "_" +
+          std::to_string(++count));
+      std::filesystem::remove_all(m_path);
+    }
+
+    ~ColumnarDirectory() {
+      auto error = std::error_code();
+      std::filesystem::remove_all(m_path, error);
+    }
+  };
+
+  struct TemporaryColumnarHistoricalDataStore : private ColumnarDirectory,
+      ColumnarHistoricalDataStore {
+    TemporaryColumnarHistoricalDataStore()
+      : ColumnarHistoricalDataStore(m_path, 2) {}
+  };
+
+  template<>
+  struct SpecializedMakeDataStore<TemporaryColumnarHistoricalDataStore> {
+    auto operator ()() const {
+      return TemporaryColumnarHistoricalDataStore();
+    }
+  };
+
   template<typename T>
   auto MakeDataStore() {
     return SpecializedMakeDataStore<T>()();
@@ -72,7 +124,8 @@ namespace {
 
 TEST_SUITE("HistoricalDataStore") {
   TEST_CASE_TEMPLATE("store_and_load_bbo_quote", T, LocalHistoricalDataStore,
-      SqlHistoricalDataStore<Viper::Sqlite3::Connection>) {
+      SqlHistoricalDataStore<Viper::Sqlite3::Connection>,
+      TemporaryColumnarHistoricalDataStore) {
     auto dataStore = MakeDataStore<T>();
     auto sequence = Beam::Queries::Sequence(5);
     auto timeClient = IncrementalTimeClient();
@@ -115,7 +168,8 @@ TEST_SUITE("HistoricalDataStore") {
   }
 
   TEST_CASE_TEMPLATE("query_security_info_head", T, LocalHistoricalDataStore,
-      SqlHistoricalDataStore<Viper::Sqlite3::Connection>) {
+      SqlHistoricalDataStore<Viper::Sqlite3::Connection>,
+      TemporaryColumnarHistoricalDataStore) {
     auto dataStore = MakeDataStore<T>();
     auto infoA = SecurityInfo(SECURITY_A, "Alpha", "Finance", 100);
     auto infoB = SecurityInfo(SECURITY_B, "Beta", "Technology", 100);
@@ -147,7 +201,8 @@ TEST_SUITE("HistoricalDataStore") {
   }
 
   TEST_CASE_TEMPLATE("query_security_info_tail", T, LocalHistoricalDataStore,
-      SqlHistoricalDataStore<Viper::Sqlite3::Connection>) {
+      SqlHistoricalDataStore<Viper::Sqlite3::Connection>,
+      TemporaryColumnarHistoricalDataStore) {
     auto dataStore = MakeDataStore<T>();
     auto infoA = SecurityInfo(SECURITY_A, "Alpha", "Finance", 100);
     auto infoB = SecurityInfo(SECURITY_B, "Beta", "Technology", 100);
@@ -176,4 +231,218 @@ TEST_SUITE("HistoricalDataStore") {
     REQUIRE(matchesC[0] == infoB);
     REQUIRE(matchesC[1] == infoC);
   }
+
+  TEST_CASE("columnar_reopen") {
+    auto temporaryDirectory = ColumnarDirectory();
+    auto& directory = temporaryDirectory.m_path;
+    auto timeClient = IncrementalTimeClient();
+    auto sequence = Beam::Queries::Sequence(5);
+    auto quotes = std::vector<SequencedSecurityBboQuote>();
+    auto info = SecurityInfo(SECURITY_A, "Alpha", "Finance", 100);
+    {
+      auto dataStore = ColumnarHistoricalDataStore(directory, 2);
+      dataStore.Store(info);
+      auto price = Money::ONE;
+      for(auto i = 0; i != 5; ++i) {
+        quotes.push_back(StoreBboQuote(dataStore, price, 100 * (i + 1),
+          price + Money::CENT, 100, timeClient.GetTime(), sequence));
+        price += Money::CENT;
+        sequence = Increment(sequence);
+      }
+      TestBboQuoteQuery(dataStore, Beam::Queries::Range::Total(),
+        SnapshotLimit::Unlimited(), quotes);
+      dataStore.Close();
+    }
+    auto dataStore = ColumnarHistoricalDataStore(directory, 2);
+    TestBboQuoteQuery(dataStore, Beam::Queries::Range::Total(),
+      SnapshotLimit::Unlimited(), quotes);
+    TestBboQuoteQuery(dataStore, Beam::Queries::Range(
+      quotes[1].GetSequence(), quotes[3].GetSequence()),
+      SnapshotLimit::Unlimited(), {quotes[1], quotes[2], quotes[3]});
+    TestBboQuoteQuery(dataStore, Beam::Queries::Range(
+      quotes[2].GetValue().GetValue().m_timestamp,
+      Beam::Queries::Sequence::Last()),
+      SnapshotLimit::FromTail(2), {quotes[3], quotes[4]});
+    auto marketlessQuery = SecurityMarketDataQuery();
+    marketlessQuery.SetIndex(Security("A", DefaultCountries::US()));
+    marketlessQuery.SetRange(Beam::Queries::Range::Total());
+    marketlessQuery.SetSnapshotLimit(SnapshotLimit::Unlimited());
+    REQUIRE(dataStore.LoadBboQuotes(marketlessQuery) ==
+      std::vector<SequencedBboQuote>(quotes.begin(), quotes.end()));
+    auto query = SecurityInfoQuery();
+    query.SetIndex(SECURITY_A);
+    query.SetSnapshotLimit(SnapshotLimit::Unlimited());
+    auto matches = dataStore.LoadSecurityInfo(query);
+    REQUIRE(matches.size() == 1);
+    REQUIRE(matches[0] == info);
+    dataStore.Close();
+  }
+
+  TEST_CASE("columnar_market_data_types") {
+    auto directory = ColumnarDirectory();
+    auto timeClient = IncrementalTimeClient();
+    auto imbalances = std::vector<SequencedOrderImbalance>();
+    auto bookQuotes = std::vector<SequencedBookQuote>();
+    auto marketQuotes = std::vector<SequencedMarketQuote>();
+    auto timeAndSales = std::vector<SequencedTimeAndSale>();
+    {
+      auto dataStore = ColumnarHistoricalDataStore(directory.m_path, 2);
+      auto price = Money::ONE;
+      for(auto i = 0; i != 3; ++i) {
+        auto sequence = Beam::Queries::Sequence(10 + i);
+        auto imbalance = OrderImbalance(SECURITY_A, Side::BID, 100 * (i + 1),
+          price, timeClient.GetTime());
+        dataStore.Store(SequencedMarketOrderImbalance(MarketOrderImbalance(
+          imbalance, DefaultMarkets::NASDAQ()), sequence));
+        imbalances.emplace_back(imbalance, sequence);
+        auto bookQuote = BookQuote("MPID" + std::to_string(i), i == 0,
+          DefaultMarkets::NYSE(), Quote(price, 100, Side::ASK),
+          timeClient.GetTime());
+        dataStore.Store(SequencedSecurityBookQuote(SecurityBookQuote(
+          bookQuote, SECURITY_A), sequence));
+        bookQuotes.emplace_back(bookQuote, sequence);
+        auto marketQuote = MarketQuote(DefaultMarkets::TSX(),
+          Quote(price, 100, Side::BID),
+          Quote(price + Money::CENT, 200, Side::ASK), timeClient.GetTime());
+        dataStore.Store(SequencedSecurityMarketQuote(SecurityMarketQuote(
+          marketQuote, SECURITY_A), sequence));
+        marketQuotes.emplace_back(marketQuote, sequence);
+        auto timeAndSale = TimeAndSale(timeClient.GetTime(), price, 300,
+          TimeAndSale::Condition(TimeAndSale::Condition::Type::CLOSE,
+          "@" + std::to_string(i)), "XNAS");
+        dataStore.Store(SequencedSecurityTimeAndSale(SecurityTimeAndSale(
+          timeAndSale, SECURITY_A), sequence));
+        timeAndSales.emplace_back(timeAndSale, sequence);
+        price += Money::CENT;
+      }
+      dataStore.Close();
+    }
+    auto dataStore = ColumnarHistoricalDataStore(directory.m_path, 2);
+    auto marketQuery = MarketWideDataQuery();
+    marketQuery.SetIndex(DefaultMarkets::NASDAQ());
+    marketQuery.SetRange(Beam::Queries::Range::Total());
+    marketQuery.SetSnapshotLimit(SnapshotLimit::Unlimited());
+    REQUIRE(dataStore.LoadOrderImbalances(marketQuery) == imbalances);
+    auto securityQuery = SecurityMarketDataQuery();
+    securityQuery.SetIndex(SECURITY_A);
+    securityQuery.SetRange(Beam::Queries::Range::Total());
+    securityQuery.SetSnapshotLimit(SnapshotLimit::Unlimited());
+    REQUIRE(dataStore.LoadBookQuotes(securityQuery) == bookQuotes);
+    REQUIRE(dataStore.LoadMarketQuotes(securityQuery) == marketQuotes);
+    REQUIRE(dataStore.LoadTimeAndSales(securityQuery) == timeAndSales);
+    dataStore.Close();
+  }
+
+  TEST_CASE("columnar_out_of_order") {
+    auto directory = ColumnarDirectory();
+    auto dataStore = ColumnarHistoricalDataStore(directory.m_path, 3);
+    auto timestamp = time_from_string("2024-03-01 10:00:00");
+    auto quote = [&] (int sequence, Quantity size) {
+      return SequencedSecurityBboQuote(SecurityBboQuote(BboQuote(
+        Quote(Money::ONE, size, Side::BID),
+        Quote(Money::ONE + Money::CENT, size, Side::ASK),
+        timestamp + seconds(sequence)), SECURITY_A),
+        Beam::Queries::Sequence(sequence));
+    };
+    dataStore.Store(quote(3, 100));
+    dataStore.Store(quote(1, 100));
+    dataStore.Store(quote(3, 300));
+    dataStore.Store(quote(2, 200));
+    TestBboQuoteQuery(dataStore, Beam::Queries::Range::Total(),
+      SnapshotLimit::Unlimited(), {quote(1, 100), quote(2, 200),
+      quote(3, 300)});
+    dataStore.Store(quote(2, 900));
+    dataStore.Store(quote(4, 400));
+    TestBboQuoteQuery(dataStore, Beam::Queries::Range::Total(),
+      SnapshotLimit::Unlimited(), {quote(1, 100), quote(2, 200),
+      quote(3, 300), quote(4, 400)});
+    dataStore.Close();
+  }
+
+  TEST_CASE("columnar_pending_limit") {
+    auto directory = ColumnarDirectory();
+    auto dataStore = ColumnarHistoricalDataStore(directory.m_path, 100, 3,
+      hours(1));
+    auto timeClient = IncrementalTimeClient();
+    auto quotes = std::vector<SequencedSecurityBboQuote>();
+    for(auto& security : {SECURITY_A, SECURITY_B, SECURITY_C}) {
+      auto quote = SequencedSecurityBboQuote(SecurityBboQuote(BboQuote(
+        Quote(Money::ONE, 100, Side::BID),
+        Quote(Money::ONE + Money::CENT, 100, Side::ASK), timeClient.GetTime()),
+        security), Beam::Queries::Sequence(1));
+      dataStore.Store(quote);
+      quotes.push_back(quote);
+    }
+    auto reader = ColumnarHistoricalDataStore(directory.m_path, 100);
+    for(auto& quote : quotes) {
+      auto query = SecurityMarketDataQuery();
+      query.SetIndex(quote.GetValue().GetIndex());
+      query.SetRange(Beam::Queries::Range::Total());
+      query.SetSnapshotLimit(SnapshotLimit::Unlimited());
+      auto matches = reader.LoadBboQuotes(query);
+      REQUIRE(matches.size() == 1);
+      REQUIRE(matches[0] == SequencedBboQuote(quote));
+    }
+    reader.Close();
+    dataStore.Close();
+  }
+
+  TEST_CASE("sql_batched_store") {
+    auto dataStore =
+      MakeDataStore<SqlHistoricalDataStore<Viper::Sqlite3::Connection>>();
+    auto timeClient = IncrementalTimeClient();
+    auto sequence = Beam::Queries::Sequence(5);
+    auto quotes = std::vector<SequencedSecurityBboQuote>();
+    for(auto i = 0; i != 2500; ++i) {
+      quotes.push_back(SequencedSecurityBboQuote(SecurityBboQuote(BboQuote(
+        Quote(Money::ONE, 100, Side::BID),
+        Quote(Money::ONE + Money::CENT, 100, Side::ASK), timeClient.GetTime()),
+        SECURITY_A), sequence));
+      sequence = Increment(sequence);
+    }
+    dataStore.Store(quotes);
+    TestBboQuoteQuery(dataStore, Beam::Queries::Range::Total(),
+      SnapshotLimit::Unlimited(), quotes);
+    auto metrics = dataStore.GetMetrics();
+    REQUIRE(metrics.m_writerCount == 1);
+    REQUIRE(metrics.m_queueDepth == 0);
+    REQUIRE(metrics.m_rowCount == 2500);
+    REQUIRE(metrics.m_batchCount >= 2);
+  }
+
+  TEST_CASE("sql_writer_lanes") {
+    auto dataStore = SqlHistoricalDataStore<SerializedSqliteConnection>([] {
+      return SerializedSqliteConnection("file:lanes?mode=memory&cache=shared");
+    }, 4);
+    auto timeClient = IncrementalTimeClient();
+    auto securities = std::vector{SECURITY_A, SECURITY_B, SECURITY_C};
+    auto expected = std::vector<std::vector<SequencedBboQuote>>(
+      securities.size());
+    auto quotes = std::vector<SequencedSecurityBboQuote>();
+    auto sequence = Beam::Queries::Sequence(5);
+    for(auto i = 0; i != 1500; ++i) {
+      for(auto j = std::size_t(0); j != securities.size(); ++j) {
+        auto quote = BboQuote(Quote(Money::ONE, 100 + i, Side::BID),
+          Quote(Money::ONE + Money::CENT, 100, Side::ASK),
+          timeClient.GetTime());
+        quotes.push_back(SequencedSecurityBboQuote(
+          SecurityBboQuote(quote, securities[j]), sequence));
+        expected[j].push_back(SequencedBboQuote(quote, sequence));
+      }
+      sequence = Increment(sequence);
+    }
+    dataStore.Store(quotes);
+    for(auto j = std::size_t(0); j != securities.size(); ++j) {
+      auto query = SecurityMarketDataQuery();
+      query.SetIndex(securities[j]);
+      query.SetRange(Beam::Queries::Range::Total());
+      query.SetSnapshotLimit(SnapshotLimit::Unlimited());
+      REQUIRE(dataStore.LoadBboQuotes(query) == expected[j]);
+    }
+    auto metrics = dataStore.GetMetrics();
+    REQUIRE(metrics.m_writerCount == 4);
+    REQUIRE(metrics.m_queueDepth == 0);
+    REQUIRE(metrics.m_rowCount == 4500);
+    REQUIRE(metrics.m_batchCount >= 3);
+  }
 }
@@ -1,3 +1,4 @@
+#include <tuple>
 #include <Beam/Queues/Queue.hpp>
 #include <Beam/ServicesTests/ServicesTests.hpp>
 #include <boost/any.hpp>
@@ -40,12 +41,18 @@ namespace {
     std::shared_ptr<TestServerConnection> m_serverConnection;
     TestServiceProtocolServer m_server;
     std::shared_ptr<Queue<std::vector<any>>> m_requestQueue;
+    std::shared_ptr<Queue<std::tuple<
+      TestServiceProtocolServer::ServiceProtocolClient*, Security, bool>>>
+        m_conflationQueue;
 
     Fixture()
       : m_serverConnection(std::make_shared<TestServerConnection>()),
         m_server(m_serverConnection, factory<std::unique_ptr<TriggerTimer>>(),
           NullSlot(), NullSlot()),
-        m_requestQueue(std::make_shared<Queue<std::vector<any>>>()) {
+        m_requestQueue(std::make_shared<Queue<std::vector<any>>>()),
+        m_conflationQueue(std::make_shared<Queue<std::tuple<
+          TestServiceProtocolServer::ServiceProtocolClient*, Security,
+          bool>>>()) {
       Nexus::Queries::RegisterQueryTypes(
         Store(m_server.GetSlots().GetRegistry()));
       RegisterMarketDataRegistryServices(Store(m_server.GetSlots()));
@@ -53,6 +60,12 @@ namespace {
       QueryBboQuotesService::AddRequestSlot(Store(m_server.GetSlots()),
         std::bind(&Fixture::OnQuerySecurityBboQuotes, this,
         std::placeholders::_1, std::placeholders::_2));
+      AddMessageSlot<ConflateBboQuoteQueryMessage>(Store(m_server.GetSlots()),
+        [=] (TestServiceProtocolServer::ServiceProtocolClient& client,
+            const Security& security, bool isConflated) {
+          m_conflationQueue->Push(
+            std::tuple(&client, security, isConflated));
+        });
     }
 
     template<typename T>
@@ -108,4 +121,20 @@ TEST_SUITE("MarketDataClient") {
     auto updatedBbo = bboQuotes->Pop();
     REQUIRE(updatedBbo == bbo);
   }
+
+  TEST_CASE_FIXTURE(Fixture, "bbo_quote_conflation") {
+    auto client = MakeClient();
+    REQUIRE(!client->m_client.IsConflated());
+    client->m_client.SetBboQuoteConflation(SECURITY_A, true);
+    auto conflation = m_conflationQueue->Pop();
+    REQUIRE(std::get<1>(conflation) == SECURITY_A);
+    REQUIRE(std::get<2>(conflation));
+    SendRecordMessage<ConflationMessage>(*std::get<0>(conflation), true);
+    FlushPendingRoutines();
+    REQUIRE(client->m_client.IsConflated());
+    client->m_client.SetBboQuoteConflation(SECURITY_A, false);
+    conflation = m_conflationQueue->Pop();
+    REQUIRE(std::get<1>(conflation) == SECURITY_A);
+    REQUIRE(!std::get<2>(conflation));
+  }
 }
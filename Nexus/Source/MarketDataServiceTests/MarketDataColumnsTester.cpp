@@ -0,0 +1,44 @@
+#include <limits>
+#include <doctest/doctest.h>
+#include "Nexus/MarketDataService/MarketDataColumns.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+using namespace boost;
+using namespace boost::posix_time;
+using namespace Nexus;
+using namespace Nexus::MarketDataService;
+
+TEST_SUITE("MarketDataColumns") {
+  TEST_CASE("bbo_quote_columns") {
+    auto timestamp = ptime(gregorian::date(1970, 1, 1), seconds(1));
+    auto bboQuotes = std::vector<SequencedBboQuote>();
+    bboQuotes.emplace_back(BboQuote(Quote(Money::ONE, 100, Side::BID),
+      Quote(2 * Money::ONE, 200, Side::ASK), timestamp), Sequence(5));
+    bboQuotes.emplace_back(BboQuote(Quote(3 * Money::ONE, 1, Side::BID),
+      Quote(Money::ONE, 2, Side::ASK), not_a_date_time), Sequence(6));
+    auto columns = MakeBboQuoteColumns(bboQuotes);
+    REQUIRE(columns.m_sequences == std::vector<std::uint64_t>{5, 6});
+    REQUIRE(columns.m_timestamps == std::vector<std::int64_t>{1000000,
+      std::numeric_limits<std::int64_t>::min()});
+    REQUIRE(columns.m_bidPrices == std::vector{1.0, 3.0});
+    REQUIRE(columns.m_bidSizes == std::vector{100.0, 1.0});
+    REQUIRE(columns.m_askPrices == std::vector{2.0, 1.0});
+    REQUIRE(columns.m_askSizes == std::vector{200.0, 2.0});
+  }
+
+  TEST_CASE("time_and_sale_columns") {
+    auto timeAndSales = std::vector<SequencedTimeAndSale>();
+    for(auto& marketCenter : {"TSE", "CDX", "TSE"}) {
+      timeAndSales.emplace_back(TimeAndSale(not_a_date_time, Money::ONE, 100,
+        TimeAndSale::Condition(), marketCenter),
+        Sequence(timeAndSales.size() + 1));
+    }
+    auto columns = MakeTimeAndSaleColumns(timeAndSales);
+    REQUIRE(columns.m_sequences == std::vector<std::uint64_t>{1, 2, 3});
+    REQUIRE(columns.m_prices == std::vector{1.0, 1.0, 1.0});
+    REQUIRE(columns.m_marketCenters == std::vector<std::int32_t>{0, 1, 0});
+    REQUIRE(columns.m_marketCenterNames ==
+      std::vector<std::string>{"TSE", "CDX"});
+  }
+}
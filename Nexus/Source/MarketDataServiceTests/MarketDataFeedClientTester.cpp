@@ -1,6 +1,9 @@
+#include <chrono>
+#include <tuple>
 #include <Beam/IO/LocalClientChannel.hpp>
 #include <Beam/IO/LocalServerConnection.hpp>
 #include <Beam/IO/SharedBuffer.hpp>
+#include <Beam/Queues/Queue.hpp>
 #include <Beam/Serialization/BinaryReceiver.hpp>
 #include <Beam/Serialization/BinarySender.hpp>
 #include <Beam/Services/ServiceProtocolClient.hpp>
@@ -39,17 +42,35 @@ namespace {
       TriggerTimer*, MessageProtocol<TestClientChannel,
       BinarySender<SharedBuffer>, NullEncoder>, TriggerTimer>;
 
+    std::shared_ptr<TestServerConnection> m_serverConnection;
     boost::optional<TestServiceProtocolServer> m_server;
+    std::shared_ptr<Queue<std::tuple<
+      TestServiceProtocolServer::ServiceProtocolClient*, int>>>
+        m_packedRequests;
     Beam::Threading::TriggerTimer m_samplingTimer;
     boost::optional<TestMarketDataFeedClient> m_client;
 
-    Fixture() {
-      auto serverConnection = std::make_shared<TestServerConnection>();
-      m_server.emplace(serverConnection,
+    Fixture()
+        : m_serverConnection(std::make_shared<TestServerConnection>()),
+          m_packedRequests(std::make_shared<Queue<std::tuple<
+            TestServiceProtocolServer::ServiceProtocolClient*, int>>>()) {
+      m_server.emplace(m_serverConnection,
         factory<std::unique_ptr<TriggerTimer>>(), NullSlot(), NullSlot());
-      m_client.emplace(Initialize("test", *serverConnection),
-        NullAuthenticator(), &m_samplingTimer, Initialize());
       RegisterMarketDataFeedMessages(Store(m_server->GetSlots()));
+      AddMessageSlot<RequestPackedMarketDataFeedMessage>(
+        Store(m_server->GetSlots()),
+        [=] (TestServiceProtocolServer::ServiceProtocolClient& client,
+            int version) {
+          m_packedRequests->Push(std::tuple(&client, version));
+        });
+      m_client.emplace(Initialize("test", *m_serverConnection),
+        NullAuthenticator(), &m_samplingTimer, Initialize());
+    }
+
+    void ConnectPacked() {
+      m_client.reset();
+      m_client.emplace(Initialize("test", *m_serverConnection),
+        NullAuthenticator(), &m_samplingTimer, Initialize(), true);
     }
   };
 }
@@ -94,4 +115,95 @@ TEST_SUITE("MarketDataFeedClient") {
     m_samplingTimer.Trigger();
     sentMessages.Get();
   }
+
+  TEST_CASE_FIXTURE(Fixture, "book_quote_sampling") {
+    auto sentMessages = Async<void>();
+    auto security = Security("TST", DefaultMarkets::NYSE(),
+      DefaultCountries::US());
+    auto timestamp = second_clock::universal_time();
+    AddMessageSlot<SendMarketDataFeedMessages>(Store(m_server->GetSlots()),
+      [&] (auto& client, auto& messages) {
+        REQUIRE(messages.size() == 2);
+        auto ask = boost::get<SecurityBookQuote>(messages[0]);
+        REQUIRE(ask.GetIndex() == security);
+        REQUIRE(ask->m_mpid == "ABC");
+        REQUIRE(ask->m_quote ==
+          Quote(2 * Money::CENT, 200, Side::ASK));
+        auto bid = boost::get<SecurityBookQuote>(messages[1]);
+        REQUIRE(bid->m_mpid == "ABC");
+        REQUIRE(bid->m_quote == Quote(Money::CENT, 300, Side::BID));
+        sentMessages.GetEval().SetResult();
+      });
+    m_client->Publish(SecurityBookQuote(BookQuote("ABC", false,
+      DefaultMarkets::NYSE(), Quote(Money::CENT, 100, Side::BID), timestamp),
+      security));
+    m_client->Publish(SecurityBookQuote(BookQuote("ABC", false,
+      DefaultMarkets::NYSE(), Quote(Money::CENT, 300, Side::BID), timestamp),
+      security));
+    m_client->Publish(SecurityBookQuote(BookQuote("ABC", false,
+      DefaultMarkets::NYSE(), Quote(2 * Money::CENT, 200, Side::ASK),
+      timestamp), security));
+    m_client->Publish(SecurityBookQuote(BookQuote("XYZ", false,
+      DefaultMarkets::NYSE(), Quote(2 * Money::CENT, 100, Side::ASK),
+      timestamp), security));
+    m_client->Publish(SecurityBookQuote(BookQuote("XYZ", false,
+      DefaultMarkets::NYSE(), Quote(2 * Money::CENT, 0, Side::ASK),
+      timestamp), security));
+    m_samplingTimer.Trigger();
+    sentMessages.Get();
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "packed_encoding") {
+    auto sentMessages = Async<void>();
+    auto security = Security("TST", DefaultMarkets::NYSE(),
+      DefaultCountries::US());
+    auto bbo = SecurityBboQuote(BboQuote(Quote(Money::CENT, 100, Side::BID),
+      Quote(2 * Money::CENT, 100, Side::ASK), second_clock::universal_time()),
+      security);
+    AddMessageSlot<SendPackedMarketDataFeedMessages>(
+      Store(m_server->GetSlots()), [&] (auto& client, auto& messages) {
+        auto decoder = PackedMarketDataDecoder();
+        auto decodedMessages = decoder.Decode(messages);
+        REQUIRE(decodedMessages.size() == 1);
+        REQUIRE(boost::get<SecurityBboQuote>(decodedMessages.front()) == bbo);
+        sentMessages.GetEval().SetResult();
+      });
+    ConnectPacked();
+    auto request = m_packedRequests->Pop();
+    REQUIRE(std::get<1>(request) == PackedMarketDataEncoder::VERSION);
+    SendRecordMessage<AcceptPackedMarketDataFeedMessage>(
+      *std::get<0>(request), PackedMarketDataEncoder::VERSION);
+    FlushPendingRoutines();
+    m_client->Publish(bbo);
+    m_samplingTimer.Trigger();
+    sentMessages.Get();
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "book_quote_replay_benchmark" * doctest::skip()) {
+    const auto UPDATES = 1000000;
+    auto securities = std::vector<Security>();
+    for(auto i = 0; i < 100; ++i) {
+      securities.push_back(Security("S" + std::to_string(i),
+        DefaultMarkets::NASDAQ(), DefaultCountries::US()));
+    }
+    auto mpids = std::vector<std::string>{"NSDQ", "ARCA", "EDGX", "BATS"};
+    auto timestamp = second_clock::universal_time();
+    auto quotes = std::vector<SecurityBookQuote>();
+    for(auto i = 0; i < UPDATES; ++i) {
+      quotes.push_back(SecurityBookQuote(BookQuote(mpids[i % mpids.size()],
+        false, DefaultMarkets::NASDAQ(), Quote(Money::ONE + (i % 50) *
+        Money::CENT, 100 * (i % 7), i % 2 == 0 ? Side::BID : Side::ASK),
+        timestamp), securities[i % securities.size()]));
+    }
+    AddMessageSlot<SendMarketDataFeedMessages>(Store(m_server->GetSlots()),
+      [&] (auto& client, auto& messages) {});
+    auto start = std::chrono::steady_clock::now();
+    for(auto& quote : quotes) {
+      m_client->Publish(quote);
+    }
+    m_samplingTimer.Trigger();
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+    MESSAGE("ns per book quote: " << elapsed.count() / UPDATES);
+  }
 }
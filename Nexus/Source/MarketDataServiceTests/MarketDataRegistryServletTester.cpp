@@ -1,6 +1,9 @@
+#include <memory>
+#include <vector>
 #include <Beam/ServiceLocator/SessionAuthenticator.hpp>
 #include <Beam/ServiceLocatorTests/ServiceLocatorTestEnvironment.hpp>
 #include <Beam/ServicesTests/ServicesTests.hpp>
+#include <boost/chrono/thread_clock.hpp>
 #include <boost/optional/optional.hpp>
 #include <doctest/doctest.h>
 #include "Nexus/AdministrationService/AdministrationClientBox.hpp"
@@ -38,6 +41,7 @@ namespace {
     AdministrationServiceTestEnvironment m_administrationEnvironment;
     MarketDataRegistry m_registry;
     boost::optional<TestServletContainer::Servlet::Servlet> m_registryServlet;
+    std::shared_ptr<TestServerConnection> m_serverConnection;
     boost::optional<TestServletContainer> m_container;
     boost::optional<TestServiceProtocolClient> m_protocolClient;
 
@@ -48,11 +52,11 @@ namespace {
         m_serviceLocatorEnvironment.MakeClient();
       m_registryServlet.emplace(m_administrationEnvironment.MakeClient(
         servletServiceLocatorClient), &m_registry, Initialize());
-      auto serverConnection = std::make_shared<TestServerConnection>();
+      m_serverConnection = std::make_shared<TestServerConnection>();
       m_container.emplace(Initialize(std::move(servletServiceLocatorClient),
-        &*m_registryServlet), serverConnection,
+        &*m_registryServlet), m_serverConnection,
         factory<std::unique_ptr<TriggerTimer>>());
-      m_protocolClient.emplace(Initialize("test", *serverConnection),
+      m_protocolClient.emplace(Initialize("test", *m_serverConnection),
         Initialize());
       Nexus::Queries::RegisterQueryTypes(
         Store(m_protocolClient->GetSlots().GetRegistry()));
@@ -211,4 +215,43 @@ TEST_SUITE("MarketDataRegistryServlet") {
       REQUIRE(*snapshot.m_snapshot[0] == *bboQuote);
     }
   }
+
+  TEST_CASE_FIXTURE(Fixture, "broadcast_benchmark" * doctest::skip()) {
+    const auto UPDATES = 1000;
+    auto query = SecurityMarketDataQuery();
+    query.SetIndex(SECURITY_A);
+    query.SetRange(Range::RealTime());
+    auto serviceLocatorClient =
+      m_serviceLocatorEnvironment.MakeClient("client", "");
+    auto subscribers =
+      std::vector<std::unique_ptr<TestServiceProtocolClient>>();
+    auto price = Money::ONE;
+    for(auto subscriberCount : {1, 10, 100, 1000}) {
+      while(static_cast<int>(subscribers.size()) < subscriberCount) {
+        auto subscriber = std::make_unique<TestServiceProtocolClient>(
+          Initialize("test", *m_serverConnection), Initialize());
+        Nexus::Queries::RegisterQueryTypes(
+          Store(subscriber->GetSlots().GetRegistry()));
+        RegisterMarketDataRegistryServices(Store(subscriber->GetSlots()));
+        RegisterMarketDataRegistryMessages(Store(subscriber->GetSlots()));
+        auto authenticator = SessionAuthenticator(serviceLocatorClient);
+        authenticator(*subscriber);
+        subscriber->SendRequest<QueryBboQuotesService>(query);
+        subscribers.push_back(std::move(subscriber));
+      }
+      auto start = boost::chrono::thread_clock::now();
+      for(auto i = 0; i < UPDATES; ++i) {
+        price += Money::CENT;
+        m_registryServlet->PublishBboQuote(SecurityBboQuote(
+          BboQuote(Quote(price, 100, Side::BID),
+          Quote(price + Money::CENT, 100, Side::ASK),
+          second_clock::universal_time()), SECURITY_A), 1);
+      }
+      auto elapsed = boost::chrono::duration_cast<boost::chrono::nanoseconds>(
+        boost::chrono::thread_clock::now() - start);
+      MESSAGE("Subscribers: " << subscriberCount << ", CPU ns per message: " <<
+        elapsed.count() / UPDATES << ", CPU ns per delivery: " <<
+        elapsed.count() / (UPDATES * subscriberCount));
+    }
+  }
 }
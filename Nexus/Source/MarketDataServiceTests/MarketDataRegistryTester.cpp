@@ -1,6 +1,12 @@
+#include <chrono>
+#include <filesystem>
 #include <doctest/doctest.h>
+#include "Nexus/MarketDataService/LocalHistoricalDataStore.hpp"
 #include "Nexus/MarketDataService/MarketDataRegistry.hpp"
 
+using namespace Beam;
+using namespace boost;
+using namespace boost::posix_time;
 using namespace Nexus;
 using namespace Nexus::MarketDataService;
 
@@ -8,4 +14,82 @@ TEST_SUITE("MarketDataRegistry") {
   TEST_CASE("publish_bbo_quote") {
     auto registry = MarketDataRegistry();
   }
+
+  TEST_CASE("sharded_publish") {
+    auto registry = MarketDataRegistry(4);
+    REQUIRE(registry.GetShardCount() == 4);
+    auto dataStore = LocalHistoricalDataStore();
+    auto securities = std::vector<Security>();
+    for(auto i = 0; i < 32; ++i) {
+      securities.push_back(Security("S" + std::to_string(i),
+        DefaultMarkets::NYSE(), DefaultCountries::US()));
+    }
+    auto shards = std::unordered_set<int>();
+    for(auto& security : securities) {
+      auto shard = registry.GetShard(security);
+      REQUIRE(shard >= 0);
+      REQUIRE(shard < registry.GetShardCount());
+      REQUIRE(registry.GetShard(security) == shard);
+      shards.insert(shard);
+      auto bboQuote = BboQuote(Quote(Money::ONE, 100, Side::BID),
+        Quote(2 * Money::ONE, 100, Side::ASK), ptime(
+          gregorian::date(2020, 1, 1), seconds(1)));
+      auto publishCount = 0;
+      registry.PublishBboQuote(SecurityBboQuote(bboQuote, security), 0,
+        dataStore, [&] (const auto& quote) {
+          REQUIRE((*quote)->GetIndex() == security);
+          ++publishCount;
+        });
+      REQUIRE(publishCount == 1);
+    }
+    REQUIRE(shards.size() > 1);
+    for(auto& security : securities) {
+      auto snapshot = registry.FindSnapshot(security);
+      REQUIRE(snapshot.is_initialized());
+      REQUIRE(snapshot->m_bboQuote->m_ask.m_price == 2 * Money::ONE);
+    }
+    REQUIRE(!registry.FindSnapshot(Security("S32", DefaultMarkets::NYSE(),
+      DefaultCountries::US())).is_initialized());
+  }
+
+  TEST_CASE("checkpoint") {
+    auto security = Security("TST", DefaultMarkets::NYSE(),
+      DefaultCountries::US());
+    auto info = SecurityInfo(security, "Test", "", 100);
+    auto marketCenter = std::string(DefaultMarkets::NYSE().GetData());
+    auto timestamp = ptime(gregorian::date(2020, 1, 1), seconds(1));
+    auto dataStore = LocalHistoricalDataStore();
+    auto registry = MarketDataRegistry(1);
+    registry.Add(info);
+    auto lastSequence = Beam::Queries::Sequence();
+    registry.PublishTimeAndSale(SecurityTimeAndSale(TimeAndSale(timestamp,
+      2 * Money::ONE, 100, TimeAndSale::Condition(), marketCenter), security),
+      0, dataStore, [&] (const auto& timeAndSale) {
+        lastSequence = timeAndSale.GetSequence();
+      });
+    auto path = std::filesystem::temp_directory_path() /
+      ("nexus_checkpoints_" + std::to_string(
+        std::chrono::steady_clock::now().time_since_epoch().count()) +
+        ".dat");
+    StoreSecurityEntryCheckpoints(path, registry.MakeCheckpoints());
+    auto checkpoints = LoadSecurityEntryCheckpoints(path);
+    REQUIRE(!std::filesystem::exists(path));
+    REQUIRE(checkpoints.size() == 1);
+    REQUIRE(checkpoints.front().m_security == security);
+    REQUIRE(checkpoints.front().m_security.GetMarket() ==
+      DefaultMarkets::NYSE());
+    REQUIRE(checkpoints.front().m_closePrice == 2 * Money::ONE);
+    auto preloadedRegistry = MarketDataRegistry(1);
+    preloadedRegistry.Add(info);
+    preloadedRegistry.Preload(checkpoints);
+    auto technicals = preloadedRegistry.FindSecurityTechnicals(security);
+    REQUIRE(technicals.is_initialized());
+    REQUIRE(technicals->m_close == 2 * Money::ONE);
+    auto emptyDataStore = LocalHistoricalDataStore();
+    preloadedRegistry.PublishTimeAndSale(SecurityTimeAndSale(TimeAndSale(
+      timestamp, Money::ONE, 100, TimeAndSale::Condition(), marketCenter),
+      security), 0, emptyDataStore, [&] (const auto& timeAndSale) {
+        REQUIRE(timeAndSale.GetSequence() > lastSequence);
+      });
+  }
 }
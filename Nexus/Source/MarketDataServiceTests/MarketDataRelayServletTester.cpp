@@ -1,3 +1,6 @@
+#include <atomic>
+#include <Beam/Queues/Queue.hpp>
+#include <Beam/Routines/RoutineHandlerGroup.hpp>
 #include <Beam/ServicesTests/ServicesTests.hpp>
 #include <Beam/ServiceLocatorTests/ServiceLocatorTestEnvironment.hpp>
 #include <Beam/SignalHandling/NullSlot.hpp>
@@ -32,6 +35,7 @@ namespace {
     DefaultCountries::CA());
   const auto TST_B = Security("TST_B", DefaultMarkets::TSX(),
     DefaultCountries::CA());
+  const auto CONFLATION_THRESHOLD = std::size_t(2);
 
   using TestServletContainer =
     TestAuthenticatedServiceProtocolServletContainer<
@@ -39,7 +43,71 @@ namespace {
   using TestMarketDataClient =
     MarketDataClient<TestServiceProtocolClientBuilder>;
 
+  struct SnapshotMonitor {
+    std::atomic_int m_loadCount = 0;
+    std::atomic_bool m_isGated = false;
+    Queue<bool> m_entered;
+    Queue<bool> m_gate;
+  };
+
+  struct CountingMarketDataClient {
+    MarketDataClientBox m_client;
+    SnapshotMonitor* m_monitor;
+
+    template<typename Query, typename Queue>
+    void QueryOrderImbalances(const Query& query, Queue queue) {
+      m_client.QueryOrderImbalances(query, std::move(queue));
+    }
+
+    template<typename Query, typename Queue>
+    void QueryBboQuotes(const Query& query, Queue queue) {
+      m_client.QueryBboQuotes(query, std::move(queue));
+    }
+
+    template<typename Query, typename Queue>
+    void QueryBookQuotes(const Query& query, Queue queue) {
+      m_client.QueryBookQuotes(query, std::move(queue));
+    }
+
+    template<typename Query, typename Queue>
+    void QueryMarketQuotes(const Query& query, Queue queue) {
+      m_client.QueryMarketQuotes(query, std::move(queue));
+    }
+
+    template<typename Query, typename Queue>
+    void QueryTimeAndSales(const Query& query, Queue queue) {
+      m_client.QueryTimeAndSales(query, std::move(queue));
+    }
+
+    SecuritySnapshot LoadSecuritySnapshot(const Security& security) {
+      if(++m_monitor->m_loadCount == 1 && m_monitor->m_isGated) {
+        m_monitor->m_entered.Push(true);
+        m_monitor->m_gate.Pop();
+      }
+      return m_client.LoadSecuritySnapshot(security);
+    }
+
+    SecurityTechnicals LoadSecurityTechnicals(const Security& security) {
+      return m_client.LoadSecurityTechnicals(security);
+    }
+
+    std::vector<SecurityInfo> QuerySecurityInfo(
+        const SecurityInfoQuery& query) {
+      return m_client.QuerySecurityInfo(query);
+    }
+
+    std::vector<SecurityInfo> LoadSecurityInfoFromPrefix(
+        const std::string& prefix) {
+      return m_client.LoadSecurityInfoFromPrefix(prefix);
+    }
+
+    void Close() {
+      m_client.Close();
+    }
+  };
+
   struct Fixture {
+    SnapshotMonitor m_snapshotMonitor;
     ServiceLocatorTestEnvironment m_serviceLocatorEnvironment;
     AdministrationServiceTestEnvironment m_administrationEnvironment;
     LocalHistoricalDataStore m_dataStore;
@@ -65,11 +133,13 @@ namespace {
       m_administrationEnvironment.GetClient().StoreEntitlements(
         m_serviceLocatorEnvironment.GetRoot().GetAccount(), entitlements);
       auto marketDataClientFactory = [=] {
-        return std::make_unique<MarketDataClientBox>(MakeMarketDataClient());
+        return std::make_unique<MarketDataClientBox>(
+          CountingMarketDataClient{MakeMarketDataClient(), &m_snapshotMonitor});
       };
       m_container.emplace(Initialize(m_serviceLocatorEnvironment.GetRoot(),
         Initialize(seconds(100), marketDataClientFactory, 1, 1,
-          m_administrationEnvironment.GetClient())), m_relayServerConnection,
+          m_administrationEnvironment.GetClient(), CONFLATION_THRESHOLD)),
+        m_relayServerConnection,
         factory<std::unique_ptr<TriggerTimer>>());
     }
 
@@ -103,7 +173,28 @@ namespace {
       FlushPendingRoutines();
       return protocolClient;
     }
+
+    void PublishBboQuote(const Security& security, Money bid) {
+      m_marketDataEnvironment.GetFeedClient().Publish(SecurityBboQuote(
+        BboQuote(Quote(bid, 100, Side::BID),
+          Quote(bid + Money::CENT, 100, Side::ASK),
+          time_from_string("2021-01-01 17:57:22")), security));
+    }
   };
+
+  SequencedSecurityBboQuote ReadBboQuote(TestServiceProtocolClient& client) {
+    while(true) {
+      auto message = client.ReadMessage();
+      if(auto bboQuoteMessage = std::dynamic_pointer_cast<
+          RecordMessage<BboQuoteMessage, TestServiceProtocolClient>>(
+            message)) {
+        return bboQuoteMessage->GetRecord().bbo_quote;
+      }
+      REQUIRE(std::dynamic_pointer_cast<
+        RecordMessage<ConflationMessage, TestServiceProtocolClient>>(
+          message) != nullptr);
+    }
+  }
 }
 
 TEST_SUITE("MarketDataRelayServlet") {
@@ -204,4 +295,160 @@ TEST_SUITE("MarketDataRelayServlet") {
         updatedSecurity);
     }
   }
+
+  TEST_CASE_FIXTURE(Fixture, "cached_snapshot") {
+    auto relayClient = MakeMarketDataRelayClient("test_client");
+    relayClient->SendRequest<QueryBboQuotesService>(MakeRealTimeQuery(TST_A));
+    relayClient->SendRequest<QueryBookQuotesService>(MakeRealTimeQuery(TST_A));
+    relayClient->SendRequest<QueryMarketQuotesService>(
+      MakeRealTimeQuery(TST_A));
+    relayClient->SendRequest<QueryTimeAndSalesService>(
+      MakeRealTimeQuery(TST_A));
+    auto snapshot = relayClient->SendRequest<LoadSecuritySnapshotService>(
+      TST_A);
+    REQUIRE(m_snapshotMonitor.m_loadCount == 1);
+    auto timeAndSale = TimeAndSale(time_from_string("2021-01-01 17:57:22"),
+      Money::ONE, 100,
+      TimeAndSale::Condition(TimeAndSale::Condition::Type::REGULAR, "@"),
+      "TSE");
+    m_marketDataEnvironment.GetFeedClient().Publish(
+      SecurityTimeAndSale(timeAndSale, TST_A));
+    relayClient->ReadMessage();
+    snapshot = relayClient->SendRequest<LoadSecuritySnapshotService>(TST_A);
+    REQUIRE(*snapshot.m_timeAndSale == timeAndSale);
+    auto bookQuote = BookQuote("NSDQ", false, DefaultMarkets::NASDAQ(),
+      Quote(Money::ONE, 100, Side::BID),
+      time_from_string("2021-01-01 17:57:23"));
+    m_marketDataEnvironment.GetFeedClient().Publish(
+      SecurityBookQuote(bookQuote, TST_A));
+    relayClient->ReadMessage();
+    snapshot = relayClient->SendRequest<LoadSecuritySnapshotService>(TST_A);
+    REQUIRE(snapshot.m_bidBook.size() == 1);
+    REQUIRE(*snapshot.m_bidBook.front() == bookQuote);
+    bookQuote.m_quote.m_size = 0;
+    m_marketDataEnvironment.GetFeedClient().Publish(
+      SecurityBookQuote(bookQuote, TST_A));
+    relayClient->ReadMessage();
+    snapshot = relayClient->SendRequest<LoadSecuritySnapshotService>(TST_A);
+    REQUIRE(snapshot.m_bidBook.empty());
+    REQUIRE(m_snapshotMonitor.m_loadCount == 1);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "uncached_snapshot") {
+    auto relayClient = MakeMarketDataRelayClient("test_client");
+    relayClient->SendRequest<QueryBboQuotesService>(MakeRealTimeQuery(TST_A));
+    relayClient->SendRequest<LoadSecuritySnapshotService>(TST_A);
+    relayClient->SendRequest<LoadSecuritySnapshotService>(TST_A);
+    REQUIRE(m_snapshotMonitor.m_loadCount == 2);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "coalesced_snapshot") {
+    auto clientA = MakeMarketDataRelayClient("client_a");
+    auto clientB = MakeMarketDataRelayClient("client_b");
+    auto timeAndSale = TimeAndSale(time_from_string("2021-01-01 17:57:22"),
+      Money::ONE, 100,
+      TimeAndSale::Condition(TimeAndSale::Condition::Type::REGULAR, "@"),
+      "TSE");
+    m_marketDataEnvironment.GetFeedClient().Publish(
+      SecurityTimeAndSale(timeAndSale, TST_A));
+    FlushPendingRoutines();
+    m_snapshotMonitor.m_isGated = true;
+    auto snapshotA = SecuritySnapshot();
+    auto snapshotB = SecuritySnapshot();
+    auto routines = RoutineHandlerGroup();
+    routines.Spawn([&] {
+      snapshotA = clientA->SendRequest<LoadSecuritySnapshotService>(TST_A);
+    });
+    m_snapshotMonitor.m_entered.Pop();
+    routines.Spawn([&] {
+      snapshotB = clientB->SendRequest<LoadSecuritySnapshotService>(TST_A);
+    });
+    FlushPendingRoutines();
+    m_snapshotMonitor.m_gate.Push(true);
+    routines.Wait();
+    REQUIRE(m_snapshotMonitor.m_loadCount == 1);
+    REQUIRE(*snapshotA.m_timeAndSale == timeAndSale);
+    REQUIRE(*snapshotB.m_timeAndSale == timeAndSale);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "conflated_bbo_quotes") {
+    auto relayClient = MakeMarketDataRelayClient("test_client");
+    auto result = relayClient->SendRequest<QueryBboQuotesService>(
+      MakeRealTimeQuery(TST_A));
+    SendRecordMessage<ConflateBboQuoteQueryMessage>(*relayClient, TST_A,
+      true);
+    relayClient->SendRequest<LoadSecurityInfoFromPrefixService>(
+      std::string("TST"));
+    auto bid = Money::ONE;
+    for(auto i = 0; i != 5; ++i) {
+      bid += Money::CENT;
+      PublishBboQuote(TST_A, bid);
+    }
+    auto sequence = Beam::Queries::Sequence(0);
+    while(true) {
+      auto bboQuote = ReadBboQuote(*relayClient);
+      REQUIRE(bboQuote->GetIndex() == TST_A);
+      REQUIRE(bboQuote.GetSequence() > sequence);
+      sequence = bboQuote.GetSequence();
+      if((*bboQuote)->m_bid.m_price == bid) {
+        break;
+      }
+    }
+    SendRecordMessage<EndBboQuoteQueryMessage>(*relayClient, TST_A,
+      result.m_queryId);
+    SendRecordMessage<ConflateBboQuoteQueryMessage>(*relayClient, TST_A,
+      false);
+    relayClient->SendRequest<QueryBboQuotesService>(MakeRealTimeQuery(TST_A));
+    bid += Money::CENT;
+    PublishBboQuote(TST_A, bid);
+    REQUIRE((*ReadBboQuote(*relayClient))->m_bid.m_price == bid);
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "conflation_opt_out_order") {
+    auto relayClient = MakeMarketDataRelayClient("test_client");
+    relayClient->SendRequest<QueryBboQuotesService>(MakeRealTimeQuery(TST_A));
+    SendRecordMessage<ConflateBboQuoteQueryMessage>(*relayClient, TST_A,
+      true);
+    relayClient->SendRequest<LoadSecurityInfoFromPrefixService>(
+      std::string("TST"));
+    auto bid = Money::ONE;
+    for(auto i = std::size_t(0); i != 2 * CONFLATION_THRESHOLD; ++i) {
+      bid += Money::CENT;
+      PublishBboQuote(TST_A, bid);
+    }
+    SendRecordMessage<ConflateBboQuoteQueryMessage>(*relayClient, TST_A,
+      false);
+    relayClient->SendRequest<LoadSecurityInfoFromPrefixService>(
+      std::string("TST"));
+    bid += Money::CENT;
+    PublishBboQuote(TST_A, bid);
+    auto sequence = Beam::Queries::Sequence(0);
+    while(true) {
+      auto bboQuote = ReadBboQuote(*relayClient);
+      REQUIRE(bboQuote.GetSequence() > sequence);
+      sequence = bboQuote.GetSequence();
+      if((*bboQuote)->m_bid.m_price == bid) {
+        break;
+      }
+    }
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "conflated_client_closed") {
+    auto conflatedClient = MakeMarketDataRelayClient("conflated_client");
+    auto relayClient = MakeMarketDataRelayClient("test_client");
+    conflatedClient->SendRequest<QueryBboQuotesService>(
+      MakeRealTimeQuery(TST_A));
+    SendRecordMessage<ConflateBboQuoteQueryMessage>(*conflatedClient, TST_A,
+      true);
+    conflatedClient->SendRequest<LoadSecurityInfoFromPrefixService>(
+      std::string("TST"));
+    relayClient->SendRequest<QueryBboQuotesService>(MakeRealTimeQuery(TST_A));
+    PublishBboQuote(TST_A, Money::ONE);
+    REQUIRE(ReadBboQuote(*conflatedClient)->GetIndex() == TST_A);
+    REQUIRE(ReadBboQuote(*relayClient)->GetIndex() == TST_A);
+    conflatedClient->Close();
+    FlushPendingRoutines();
+    PublishBboQuote(TST_A, 2 * Money::ONE);
+    REQUIRE((*ReadBboQuote(*relayClient))->m_bid.m_price == 2 * Money::ONE);
+  }
 }
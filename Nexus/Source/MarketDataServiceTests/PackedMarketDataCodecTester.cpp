@@ -0,0 +1,124 @@
+#include <cstring>
+#include <doctest/doctest.h>
+#include "Nexus/Definitions/DefaultCountryDatabase.hpp"
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/MarketDataService/PackedMarketDataCodec.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+using namespace boost;
+using namespace boost::gregorian;
+using namespace boost::posix_time;
+using namespace Nexus;
+using namespace Nexus::MarketDataService;
+
+namespace {
+  const auto SECURITY_A = Security("TST", DefaultMarkets::NYSE(),
+    DefaultCountries::US());
+  const auto SECURITY_B = Security("ABC", DefaultMarkets::TSX(),
+    DefaultCountries::CA());
+
+  auto MakeMessages(ptime timestamp) {
+    auto messages = std::vector<MarketDataFeedMessage>();
+    messages.push_back(SecurityBboQuote(BboQuote(
+      Quote(Money::ONE, 100, Side::BID),
+      Quote(Money::ONE + Money::CENT, 200, Side::ASK), timestamp),
+      SECURITY_A));
+    messages.push_back(SecurityBookQuote(BookQuote("NSDQ", false,
+      DefaultMarkets::NASDAQ(), Quote(Money::ONE, 300, Side::BID),
+      timestamp + milliseconds(1)), SECURITY_A));
+    messages.push_back(SecurityMarketQuote(MarketQuote(DefaultMarkets::TSX(),
+      Quote(2 * Money::ONE, 1, Side::BID),
+      Quote(3 * Money::ONE, Quantity(0.5), Side::ASK),
+      timestamp + milliseconds(2)), SECURITY_B));
+    messages.push_back(SecurityTimeAndSale(TimeAndSale(
+      timestamp + milliseconds(3), Money::CENT, 100,
+      TimeAndSale::Condition(TimeAndSale::Condition::Type::REGULAR, "@"),
+      "TSE"), SECURITY_B));
+    messages.push_back(MarketOrderImbalance(OrderImbalance(SECURITY_A,
+      Side::ASK, 1000, Money::ONE, not_a_date_time), DefaultMarkets::NYSE()));
+    return messages;
+  }
+}
+
+TEST_SUITE("PackedMarketDataCodec") {
+  TEST_CASE("round_trip") {
+    auto encoder = PackedMarketDataEncoder();
+    auto decoder = PackedMarketDataDecoder();
+    auto timestamp = ptime(date(2024, 5, 1), time_duration(9, 30, 0));
+    for(auto i = 0; i < 2; ++i) {
+      auto messages = MakeMessages(timestamp + seconds(i));
+      auto decoded = decoder.Decode(encoder.Encode(messages));
+      REQUIRE(decoded == messages);
+    }
+  }
+
+  TEST_CASE("truncated") {
+    auto encoder = PackedMarketDataEncoder();
+    auto decoder = PackedMarketDataDecoder();
+    auto data = encoder.Encode(MakeMessages(not_a_date_time));
+    REQUIRE_THROWS_AS(decoder.Decode(data.substr(0, data.size() - 1)),
+      Serialization::SerializationException);
+  }
+
+  TEST_CASE("raw_fallback") {
+#ifdef NEXUS_FIXED_POINT_QUANTITY
+    auto representation = Quantity::Representation(1) << 61;
+#else
+    auto representation = Quantity::Representation(1.5);
+#endif
+    auto size = Quantity::FromRepresentation(representation);
+    auto messages = std::vector<MarketDataFeedMessage>();
+    messages.push_back(SecurityBboQuote(BboQuote(
+      Quote(Money(size), size, Side::BID),
+      Quote(Money::ONE, 100, Side::ASK), not_a_date_time), SECURITY_A));
+    auto encoder = PackedMarketDataEncoder();
+    auto data = encoder.Encode(messages);
+    auto raw = static_cast<double>(representation);
+    auto bits = std::uint64_t();
+    std::memcpy(&bits, &raw, sizeof(bits));
+    auto littleEndian = std::string();
+    for(auto i = 0; i != 8; ++i) {
+      littleEndian.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+    }
+    REQUIRE(data.find(littleEndian) != std::string::npos);
+    auto decoder = PackedMarketDataDecoder();
+    REQUIRE(decoder.Decode(data) == messages);
+  }
+
+  TEST_CASE("special_timestamps") {
+    auto encoder = PackedMarketDataEncoder();
+    auto decoder = PackedMarketDataDecoder();
+    auto timestamp = ptime(date(2024, 5, 1), time_duration(9, 30, 0));
+    auto messages = std::vector<MarketDataFeedMessage>();
+    for(auto special : {ptime(not_a_date_time), ptime(neg_infin),
+        ptime(pos_infin), timestamp, ptime(pos_infin),
+        timestamp + microseconds(1)}) {
+      messages.push_back(SecurityBboQuote(BboQuote(
+        Quote(Money::ONE, 100, Side::BID),
+        Quote(Money::ONE + Money::CENT, 200, Side::ASK), special),
+        SECURITY_A));
+    }
+    REQUIRE(decoder.Decode(encoder.Encode(messages)) == messages);
+  }
+
+  TEST_CASE("invalid_enum") {
+    auto encoder = PackedMarketDataEncoder();
+    auto decoder = PackedMarketDataDecoder();
+    auto messages = std::vector<MarketDataFeedMessage>();
+    messages.push_back(SecurityBboQuote(BboQuote(
+      Quote(Money::ONE, 100, static_cast<Side::Type>(5)),
+      Quote(Money::ONE + Money::CENT, 200, Side::ASK), not_a_date_time),
+      SECURITY_A));
+    REQUIRE_THROWS_AS(decoder.Decode(encoder.Encode(messages)),
+      Serialization::SerializationException);
+    messages.clear();
+    messages.push_back(SecurityTimeAndSale(TimeAndSale(not_a_date_time,
+      Money::CENT, 100, TimeAndSale::Condition(
+        static_cast<TimeAndSale::Condition::Type::Type>(7), "@"), "TSE"),
+      SECURITY_B));
+    REQUIRE_THROWS_AS(PackedMarketDataDecoder().Decode(
+      PackedMarketDataEncoder().Encode(messages)),
+      Serialization::SerializationException);
+  }
+}
@@ -0,0 +1,86 @@
+#include <doctest/doctest.h>
+#include "Nexus/Definitions/DefaultCountryDatabase.hpp"
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/MarketDataService/RecentTickBuffer.hpp"
+#include "Nexus/MarketDataService/SecurityMarketDataQuery.hpp"
+#include "Nexus/Queries/EvaluatorTranslator.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+using namespace boost;
+using namespace boost::posix_time;
+using namespace Nexus;
+using namespace Nexus::MarketDataService;
+
+namespace {
+  const auto SECURITY = Security("TST", DefaultMarkets::NYSE(),
+    DefaultCountries::US());
+
+  auto MakeTimeAndSale(int sequence) {
+    return SequencedValue(TimeAndSale(
+      ptime(gregorian::date(2024, 5, 1), seconds(sequence)), Money::ONE, 100,
+      TimeAndSale::Condition(), "NYSE"), Sequence(sequence));
+  }
+
+  auto MakeQuery(const Range& range, const SnapshotLimit& limit) {
+    auto query = SecurityMarketDataQuery();
+    query.SetIndex(SECURITY);
+    query.SetRange(range);
+    query.SetSnapshotLimit(limit);
+    return query;
+  }
+
+  auto Load(const RecentTickBuffer<TimeAndSale>& buffer,
+      const SecurityMarketDataQuery& query) {
+    auto filter = Translate<Nexus::Queries::EvaluatorTranslator>(
+      query.GetFilter());
+    return buffer.Load(query, *filter);
+  }
+}
+
+TEST_SUITE("RecentTickBuffer") {
+  TEST_CASE("tail") {
+    auto buffer = RecentTickBuffer<TimeAndSale>(4);
+    for(auto i = 1; i <= 6; ++i) {
+      buffer.Push(MakeTimeAndSale(i));
+    }
+    REQUIRE(buffer.GetSize() == 4);
+    auto result = Load(buffer, MakeQuery(Range::Historical(),
+      SnapshotLimit(SnapshotLimit::Type::TAIL, 3)));
+    REQUIRE(result.is_initialized());
+    REQUIRE(*result == std::vector{MakeTimeAndSale(4), MakeTimeAndSale(5),
+      MakeTimeAndSale(6)});
+    REQUIRE(!Load(buffer, MakeQuery(Range::Historical(),
+      SnapshotLimit(SnapshotLimit::Type::TAIL, 5))).is_initialized());
+    result = Load(buffer, MakeQuery(Range(Sequence(5), Sequence::Last()),
+      SnapshotLimit::Unlimited()));
+    REQUIRE(result.is_initialized());
+    REQUIRE(*result == std::vector{MakeTimeAndSale(5), MakeTimeAndSale(6)});
+    result = Load(buffer, MakeQuery(Range(Sequence(5), Sequence::Last()),
+      SnapshotLimit(SnapshotLimit::Type::TAIL, 10)));
+    REQUIRE(result.is_initialized());
+    REQUIRE(*result == std::vector{MakeTimeAndSale(5), MakeTimeAndSale(6)});
+  }
+
+  TEST_CASE("head") {
+    auto buffer = RecentTickBuffer<TimeAndSale>(4);
+    for(auto i = 1; i <= 6; ++i) {
+      buffer.Push(MakeTimeAndSale(i));
+    }
+    auto result = Load(buffer, MakeQuery(
+      Range(ptime(gregorian::date(2024, 5, 1), seconds(4)),
+        Sequence::Present()), SnapshotLimit(SnapshotLimit::Type::HEAD, 2)));
+    REQUIRE(result.is_initialized());
+    REQUIRE(*result == std::vector{MakeTimeAndSale(4), MakeTimeAndSale(5)});
+    REQUIRE(!Load(buffer, MakeQuery(Range(Sequence(3), Sequence::Present()),
+      SnapshotLimit::Unlimited())).is_initialized());
+  }
+
+  TEST_CASE("disabled") {
+    auto buffer = RecentTickBuffer<TimeAndSale>(0);
+    buffer.Push(MakeTimeAndSale(1));
+    REQUIRE(buffer.GetSize() == 0);
+    REQUIRE(!Load(buffer, MakeQuery(Range::Historical(),
+      SnapshotLimit(SnapshotLimit::Type::TAIL, 1))).is_initialized());
+  }
+}
@@ -1,3 +1,4 @@
+#include <chrono>
 #include <Beam/TimeService/IncrementalTimeClient.hpp>
 #include <doctest/doctest.h>
 #include "Nexus/Definitions/DefaultCountryDatabase.hpp"
@@ -163,6 +164,78 @@ TEST_SUITE("SecurityEntry") {
     TestBookQuoteSnapshot(entry, {abcAskD}, {abcBidC});
   }
 
+  TEST_CASE_FIXTURE(Fixture, "deep_book_ordering") {
+    auto entry = SecurityEntry(SECURITY_A, Money::ZERO,
+      SecurityEntry::InitialSequences());
+    auto mpids = std::vector<std::string>{"TD", "RBC", "ABC", "BMO", "CIBC"};
+    for(auto i = 0; i < 20; ++i) {
+      for(auto& mpid : mpids) {
+        entry.UpdateBookQuote(BookQuote(mpid, false, DefaultMarkets::TSX(),
+          Quote(Money::ONE + i * Money::CENT, 100, Side::BID),
+          m_timeClient.GetTime()), TEST_SOURCE);
+        entry.UpdateBookQuote(BookQuote(mpid, false, DefaultMarkets::TSX(),
+          Quote(2 * Money::ONE + i * Money::CENT, 100, Side::ASK),
+          m_timeClient.GetTime()), TEST_SOURCE);
+      }
+    }
+    entry.UpdateBookQuote(BookQuote("RBC", false, DefaultMarkets::TSX(),
+      Quote(Money::ONE + 19 * Money::CENT, -100, Side::BID),
+      m_timeClient.GetTime()), TEST_SOURCE);
+    auto snapshot = entry.LoadSnapshot();
+    REQUIRE(snapshot.is_initialized());
+    REQUIRE(snapshot->m_askBook.size() == 100);
+    REQUIRE(snapshot->m_bidBook.size() == 99);
+    REQUIRE(std::is_sorted(snapshot->m_askBook.begin(),
+      snapshot->m_askBook.end(), [] (const auto& lhs, const auto& rhs) {
+        return BookQuoteListingComparator(**lhs, **rhs);
+      }));
+    REQUIRE(std::is_sorted(snapshot->m_bidBook.begin(),
+      snapshot->m_bidBook.end(), [] (const auto& lhs, const auto& rhs) {
+        return BookQuoteListingComparator(**lhs, **rhs);
+      }));
+    REQUIRE((*snapshot->m_bidBook.front())->m_mpid == "ABC");
+    REQUIRE((*snapshot->m_bidBook.front())->m_quote.m_price ==
+      Money::ONE + 19 * Money::CENT);
+    REQUIRE((*snapshot->m_askBook.front())->m_quote.m_price == 2 * Money::ONE);
+    REQUIRE((*snapshot->m_askBook.front())->GetIndex() == SECURITY_A);
+    entry.Clear(TEST_SOURCE);
+    snapshot = entry.LoadSnapshot();
+    REQUIRE(snapshot->m_askBook.empty());
+    REQUIRE(snapshot->m_bidBook.empty());
+  }
+
+  TEST_CASE_FIXTURE(Fixture, "book_quote_replay_benchmark" * doctest::skip()) {
+    const auto LEVELS = 200;
+    const auto ROUNDS = 50;
+    auto mpids = std::vector<std::string>();
+    for(auto i = 0; i < 30; ++i) {
+      mpids.push_back("MP" + std::to_string(i));
+    }
+    auto deltas = std::vector<BookQuote>();
+    for(auto round = 0; round < ROUNDS; ++round) {
+      for(auto level = 0; level < LEVELS; ++level) {
+        auto& mpid = mpids[(round / 2 + level) % mpids.size()];
+        auto size = Quantity(round % 2 == 0 ? 100 : -100);
+        deltas.emplace_back(mpid, false, DefaultMarkets::TSX(),
+          Quote(Money::ONE + level * Money::CENT, size, Side::BID),
+          m_timeClient.GetTime());
+        deltas.emplace_back(mpid, false, DefaultMarkets::TSX(),
+          Quote(5 * Money::ONE + level * Money::CENT, size, Side::ASK),
+          m_timeClient.GetTime());
+      }
+    }
+    auto entry = SecurityEntry(SECURITY_A, Money::ZERO,
+      SecurityEntry::InitialSequences());
+    auto start = std::chrono::steady_clock::now();
+    for(auto& delta : deltas) {
+      entry.UpdateBookQuote(delta, TEST_SOURCE);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+    MESSAGE("Book updates: " << deltas.size() << ", ns per update: " <<
+      elapsed.count() / static_cast<std::int64_t>(deltas.size()));
+  }
+
   TEST_CASE_FIXTURE(Fixture, "technicals_reset") {
     auto entry = SecurityEntry(SECURITY_A, Money::CENT,
       SecurityEntry::InitialSequences());
@@ -0,0 +1,75 @@
+#include <doctest/doctest.h>
+#include "Nexus/Definitions/DefaultCountryDatabase.hpp"
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/MarketDataService/SecuritySearchIndex.hpp"
+
+using namespace Nexus;
+using namespace Nexus::MarketDataService;
+
+namespace {
+  auto MakeInfo(const std::string& symbol, const std::string& name) {
+    return SecurityInfo(Security(symbol, DefaultMarkets::NYSE(),
+      DefaultCountries::US()), name, "", 100);
+  }
+}
+
+TEST_SUITE("SecuritySearchIndex") {
+  TEST_CASE("rank_by_volume") {
+    auto index = SecuritySearchIndex();
+    auto a = MakeInfo("ABC", "Alpha");
+    auto b = MakeInfo("ABD", "Beta");
+    auto c = MakeInfo("XYZ", "Abacus");
+    for(auto& info : {a, b, c}) {
+      index.Add(info);
+    }
+    REQUIRE(index.Search("AB", 8).empty());
+    index.SetHasQuote(a.m_security, true);
+    index.SetHasQuote(b.m_security, true);
+    index.SetHasQuote(c.m_security, true);
+    index.SetVolume(a.m_security, 100);
+    index.SetVolume(b.m_security, 300);
+    index.SetVolume(c.m_security, 200);
+    auto matches = index.Search("ab", 8);
+    REQUIRE(matches == std::vector{b, c, a});
+    REQUIRE(index.Search("ab", 2) == std::vector{b, c});
+    index.SetHasQuote(c.m_security, false);
+    REQUIRE(index.Search("AB", 8) == std::vector{b, a});
+  }
+
+  TEST_CASE("replace") {
+    auto index = SecuritySearchIndex();
+    auto info = MakeInfo("ABC", "Alpha");
+    index.Add(info);
+    index.SetHasQuote(info.m_security, true);
+    info.m_name = "Omega";
+    index.Add(info);
+    REQUIRE(index.Search("AL", 8).empty());
+    REQUIRE(index.Search("OM", 8) == std::vector{info});
+  }
+
+  TEST_CASE("shared_ranking") {
+    auto index = SecuritySearchIndex();
+    auto info = MakeInfo("ABC", "Alpha");
+    auto ranking = index.Add(info);
+    REQUIRE(index.FindRanking(info.m_security) == ranking);
+    info.m_name = "Omega";
+    REQUIRE(index.Add(info) == ranking);
+    ranking->m_hasQuote = true;
+    ranking->m_volume = 100;
+    REQUIRE(index.Search("OM", 8) == std::vector{info});
+    REQUIRE(index.FindRanking(MakeInfo("XYZ", "").m_security) == nullptr);
+  }
+
+  TEST_CASE("merge") {
+    auto index = SecuritySearchIndex();
+    auto infos = std::vector<SecurityInfo>();
+    for(auto i = 0; i < 3000; ++i) {
+      infos.push_back(MakeInfo("S" + std::to_string(i), ""));
+      index.Add(infos.back());
+      index.SetHasQuote(infos.back().m_security, true);
+    }
+    index.SetVolume(infos[42].m_security, 1000);
+    auto matches = index.Search("S4", 1);
+    REQUIRE(matches == std::vector{infos[42]});
+  }
+}
@@ -0,0 +1,194 @@
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <Beam/Queues/Queue.hpp>
+#include <Beam/Routines/RoutineHandlerGroup.hpp>
+#include <doctest/doctest.h>
+#include "Nexus/OrderExecutionService/BufferedOrderExecutionDataStore.hpp"
+#include "Nexus/OrderExecutionService/LocalOrderExecutionDataStore.hpp"
+
+using namespace Beam;
+using namespace Beam::Queries;
+using namespace Beam::Routines;
+using namespace Beam::ServiceLocator;
+using namespace boost;
+using namespace boost::posix_time;
+using namespace Nexus;
+using namespace Nexus::OrderExecutionService;
+
+namespace {
+  const auto SECURITY = Security("A1", DefaultMarkets::NYSE(),
+    DefaultCountries::US());
+  const auto TIMESTAMP = time_from_string("2020-02-15 3:00:00");
+
+  struct RecordingDataStore {
+    LocalOrderExecutionDataStore m_dataStore;
+    std::vector<std::size_t> m_orderInfoBatches;
+    std::vector<std::tuple<DirectoryEntry, Beam::Queries::Sequence>> m_commits;
+    std::shared_ptr<Queue<bool>> m_commitEntered;
+    std::shared_ptr<Queue<bool>> m_commitGate;
+    std::atomic_bool m_isFailing{false};
+    std::atomic_int m_failureCount{0};
+    int m_closeCount = 0;
+
+    boost::optional<SequencedAccountOrderRecord> LoadOrder(OrderId id) {
+      return m_dataStore.LoadOrder(id);
+    }
+
+    std::vector<SequencedOrderRecord> LoadOrderSubmissions(
+        const AccountQuery& query) {
+      return m_dataStore.LoadOrderSubmissions(query);
+    }
+
+    std::vector<SequencedExecutionReport> LoadExecutionReports(
+        const AccountQuery& query) {
+      return m_dataStore.LoadExecutionReports(query);
+    }
+
+    void Store(const std::vector<SequencedAccountOrderInfo>& orderInfo) {
+      if(m_commitGate) {
+        m_commitEntered->Push(true);
+        m_commitGate->Pop();
+      }
+      Fail();
+      m_orderInfoBatches.push_back(orderInfo.size());
+      for(auto& info : orderInfo) {
+        m_commits.emplace_back(info->GetIndex(), info.GetSequence());
+      }
+      m_dataStore.Store(orderInfo);
+    }
+
+    void Store(const SequencedAccountExecutionReport& executionReport) {
+      Fail();
+      m_commits.emplace_back(executionReport->GetIndex(),
+        executionReport.GetSequence());
+      m_dataStore.Store(executionReport);
+    }
+
+    void Close() {
+      ++m_closeCount;
+    }
+
+    void Fail() {
+      if(m_isFailing || m_failureCount-- > 0) {
+        throw std::runtime_error("Store failed.");
+      }
+    }
+  };
+
+  SequencedAccountOrderInfo MakeOrderInfo(const DirectoryEntry& account,
+      OrderId id, Beam::Queries::Sequence sequence) {
+    return SequencedValue(IndexedValue(OrderInfo(
+      OrderFields::MakeLimitOrder(account, SECURITY, Side::BID, 100,
+        Money::ONE), id, false, TIMESTAMP), account), sequence);
+  }
+
+  SequencedAccountExecutionReport MakeExecutionReport(
+      const DirectoryEntry& account, OrderId id,
+      Beam::Queries::Sequence sequence) {
+    return SequencedValue(IndexedValue(
+      ExecutionReport::MakeInitialReport(id, TIMESTAMP), account), sequence);
+  }
+
+  AccountQuery MakeQuery(const DirectoryEntry& account) {
+    auto query = AccountQuery();
+    query.SetIndex(account);
+    query.SetRange(Range::Historical());
+    query.SetSnapshotLimit(SnapshotLimit::Unlimited());
+    return query;
+  }
+}
+
+TEST_SUITE("BufferedOrderExecutionDataStore") {
+  TEST_CASE("buffered_batches") {
+    auto account = DirectoryEntry::MakeAccount(12, "test1");
+    auto otherAccount = DirectoryEntry::MakeAccount(13, "test2");
+    auto recorder = RecordingDataStore();
+    recorder.m_commitEntered = std::make_shared<Queue<bool>>();
+    recorder.m_commitGate = std::make_shared<Queue<bool>>();
+    auto dataStore =
+      BufferedOrderExecutionDataStore<RecordingDataStore*>(&recorder);
+    dataStore.Store(MakeOrderInfo(account, 1, Beam::Queries::Sequence(1)));
+    recorder.m_commitEntered->Pop();
+    dataStore.Store(MakeOrderInfo(account, 2, Beam::Queries::Sequence(2)));
+    dataStore.Store(MakeOrderInfo(account, 3, Beam::Queries::Sequence(3)));
+    REQUIRE(dataStore.LoadOrderSubmissions(MakeQuery(otherAccount)).empty());
+    recorder.m_commitGate->Push(true);
+    recorder.m_commitGate->Push(true);
+    auto submissions = dataStore.LoadOrderSubmissions(MakeQuery(account));
+    REQUIRE(submissions.size() == 3);
+    REQUIRE(recorder.m_orderInfoBatches == std::vector<std::size_t>{1, 2});
+    dataStore.Close();
+  }
+
+  TEST_CASE("sharded_execution_reports") {
+    const auto ACCOUNT_COUNT = 4;
+    const auto REPORT_COUNT = 100;
+    auto recorder = RecordingDataStore();
+    auto dataStore =
+      BufferedOrderExecutionDataStore<RecordingDataStore*>(&recorder);
+    auto accounts = std::vector<DirectoryEntry>();
+    auto routines = RoutineHandlerGroup();
+    for(auto i = 0; i != ACCOUNT_COUNT; ++i) {
+      accounts.push_back(DirectoryEntry::MakeAccount(100 + i,
+        "account" + std::to_string(i)));
+      routines.Spawn([&, account = accounts.back(), id = OrderId(i + 1)] {
+        auto sequence = Beam::Queries::Sequence(1);
+        dataStore.Store(MakeOrderInfo(account, id, sequence));
+        for(auto j = 0; j != REPORT_COUNT; ++j) {
+          sequence = Beam::Queries::Increment(sequence);
+          dataStore.Store(MakeExecutionReport(account, id, sequence));
+        }
+      });
+    }
+    routines.Wait();
+    dataStore.Flush();
+    REQUIRE(recorder.m_commits.size() == ACCOUNT_COUNT * (REPORT_COUNT + 1));
+    for(auto& account : accounts) {
+      auto sequence = Beam::Queries::Sequence(0);
+      for(auto& commit : recorder.m_commits) {
+        if(std::get<0>(commit) == account) {
+          REQUIRE(std::get<1>(commit) > sequence);
+          sequence = std::get<1>(commit);
+        }
+      }
+      auto reports = dataStore.LoadExecutionReports(MakeQuery(account));
+      REQUIRE(reports.size() == REPORT_COUNT);
+    }
+    dataStore.Close();
+    REQUIRE(recorder.m_closeCount == 1);
+  }
+
+  TEST_CASE("failed_commit") {
+    auto account = DirectoryEntry::MakeAccount(12, "test1");
+    auto recorder = RecordingDataStore();
+    recorder.m_isFailing = true;
+    auto dataStore =
+      BufferedOrderExecutionDataStore<RecordingDataStore*>(&recorder);
+    dataStore.Store(MakeOrderInfo(account, 1, Beam::Queries::Sequence(1)));
+    REQUIRE_THROWS_AS(dataStore.LoadOrder(1), std::runtime_error);
+    REQUIRE_NOTHROW(dataStore.Store(
+      MakeExecutionReport(account, 1, Beam::Queries::Sequence(2))));
+    REQUIRE(recorder.m_commits.empty());
+    REQUIRE_THROWS_AS(dataStore.Close(), std::runtime_error);
+    REQUIRE(recorder.m_closeCount == 1);
+  }
+
+  TEST_CASE("retried_commit") {
+    auto account = DirectoryEntry::MakeAccount(12, "test1");
+    auto recorder = RecordingDataStore();
+    recorder.m_failureCount = 3;
+    auto dataStore = BufferedOrderExecutionDataStore<RecordingDataStore*>(
+      &recorder, milliseconds(1));
+    dataStore.Store(MakeOrderInfo(account, 1, Beam::Queries::Sequence(1)));
+    dataStore.Store(
+      MakeExecutionReport(account, 1, Beam::Queries::Sequence(2)));
+    dataStore.Flush();
+    REQUIRE(recorder.m_commits.size() == 2);
+    REQUIRE(recorder.m_failureCount < 0);
+    REQUIRE(dataStore.LoadOrder(1).is_initialized());
+    REQUIRE(dataStore.LoadExecutionReports(MakeQuery(account)).size() == 1);
+    REQUIRE_NOTHROW(dataStore.Close());
+  }
+}
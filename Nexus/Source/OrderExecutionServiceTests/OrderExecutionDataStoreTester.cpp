@@ -2,6 +2,7 @@
 #include <doctest/doctest.h>
 #include <Viper/Sqlite3/Connection.hpp>
 #include "Nexus/OrderExecutionService/LocalOrderExecutionDataStore.hpp"
+#include "Nexus/OrderExecutionService/OrderSubmissionCursor.hpp"
 #include "Nexus/OrderExecutionService/SqlOrderExecutionDataStore.hpp"
 
 using namespace Beam;
@@ -207,4 +208,41 @@ TEST_SUITE("OrderExecutionDataStore") {
       REQUIRE(liveOrders[2].GetSequence() == Beam::Queries::Sequence(500));
     }
   }
+
+  TEST_CASE_TEMPLATE("order_submission_cursor", T,
+      LocalOrderExecutionDataStore,
+      SqlOrderExecutionDataStore<Viper::Sqlite3::Connection>) {
+    auto dataStore = MakeDataStore<T>();
+    auto timestamp = time_from_string("2020-02-15 3:00:00");
+    auto expectedRecords = std::vector<SequencedOrderRecord>();
+    for(auto i = 0; i != 5; ++i) {
+      expectedRecords.push_back(StoreLiveOrder(dataStore, 100 + i, false,
+        timestamp + minutes(i), Beam::Queries::Sequence(100 * (i + 1)),
+        Beam::Queries::Sequence(100 * (i + 1))));
+    }
+    auto query = AccountQuery();
+    query.SetIndex(ACCOUNT);
+    query.SetRange(Range::Historical());
+    query.SetSnapshotLimit(SnapshotLimit::Unlimited());
+    auto cursor = OrderSubmissionCursor(&dataStore, query, 2);
+    auto records = std::vector<SequencedOrderRecord>();
+    auto pageCount = 0;
+    while(true) {
+      auto page = cursor.Next();
+      if(page.empty()) {
+        break;
+      }
+      REQUIRE(page.size() <= 2);
+      records.insert(records.end(), page.begin(), page.end());
+      ++pageCount;
+    }
+    REQUIRE(pageCount == 3);
+    REQUIRE(records.size() == expectedRecords.size());
+    for(auto i = std::size_t(0); i != records.size(); ++i) {
+      REQUIRE(records[i].GetSequence() == expectedRecords[i].GetSequence());
+      REQUIRE(records[i]->m_executionReports ==
+        expectedRecords[i]->m_executionReports);
+    }
+    REQUIRE(cursor.Next().empty());
+  }
 }
@@ -61,6 +61,9 @@ namespace {
     std::shared_ptr<Queue<PrimitiveOrder*>> m_serverOrders;
 
     Fixture()
+      : Fixture(true) {}
+
+    explicit Fixture(bool isStarted)
         : m_administrationEnvironment(MakeAdministrationServiceTestEnvironment(
             m_serviceLocatorEnvironment)) {
       m_driver = std::make_shared<MockOrderExecutionDriver>();
@@ -77,6 +80,12 @@ namespace {
       m_administrationEnvironment.MakeAdministrator(orderExecutionAccount);
       auto clientEntry = m_serviceLocatorEnvironment.GetRoot().MakeAccount(
         "client", "", DirectoryEntry::GetStarDirectory());
+      if(isStarted) {
+        Start();
+      }
+    }
+
+    void Start() {
       auto servletServiceLocatorClient = m_serviceLocatorEnvironment.MakeClient(
         "order_execution_service", "");
       m_container.emplace(Initialize(servletServiceLocatorClient,
@@ -108,6 +117,67 @@ namespace {
         serviceLocatorClient.GetAccount());
     }
   };
+
+  struct RecoveryFixture : Fixture {
+    using Operation = TestOrderExecutionDataStore::Operation;
+    using LoadOrderSubmissionsOperation =
+      TestOrderExecutionDataStore::LoadOrderSubmissionsOperation;
+    DirectoryEntry m_slowAccount;
+    std::shared_ptr<Queue<std::shared_ptr<LoadOrderSubmissionsOperation>>>
+      m_slowRecoveries;
+
+    RecoveryFixture()
+        : Fixture(false),
+          m_slowRecoveries(std::make_shared<
+            Queue<std::shared_ptr<LoadOrderSubmissionsOperation>>>()) {
+      m_slowAccount = m_serviceLocatorEnvironment.GetRoot().MakeAccount(
+        "slow", "", DirectoryEntry::GetStarDirectory());
+      auto operations = std::make_shared<Queue<std::shared_ptr<Operation>>>();
+      m_dataStore->GetPublisher().Monitor(operations);
+      m_dataStore->SetMode(TestOrderExecutionDataStore::Mode::SUPERVISED);
+      Spawn([=, dataStore = m_baseDataStore, slowAccount = m_slowAccount,
+          slowRecoveries = m_slowRecoveries] {
+        auto isHeld = false;
+        while(true) {
+          auto operation = operations->Pop();
+          if(auto load = std::dynamic_pointer_cast<
+              LoadOrderSubmissionsOperation>(operation)) {
+            if(!isHeld && load->m_query->GetIndex() == slowAccount) {
+              isHeld = true;
+              slowRecoveries->Push(load);
+            } else {
+              load->m_result.SetResult(
+                dataStore->LoadOrderSubmissions(*load->m_query));
+            }
+          } else if(auto load = std::dynamic_pointer_cast<
+              TestOrderExecutionDataStore::LoadOrderOperation>(operation)) {
+            load->m_result.SetResult(dataStore->LoadOrder(*load->m_id));
+          } else if(auto load = std::dynamic_pointer_cast<
+              TestOrderExecutionDataStore::LoadExecutionReportsOperation>(
+                operation)) {
+            load->m_result.SetResult(
+              dataStore->LoadExecutionReports(*load->m_query));
+          } else if(auto store = std::dynamic_pointer_cast<
+              TestOrderExecutionDataStore::StoreOrderInfoOperation>(
+                operation)) {
+            dataStore->Store(*store->m_orderInfo);
+            store->m_result.SetResult();
+          } else if(auto store = std::dynamic_pointer_cast<
+              TestOrderExecutionDataStore::StoreExecutionReportOperation>(
+                operation)) {
+            dataStore->Store(*store->m_executionReport);
+            store->m_result.SetResult();
+          } else if(auto close = std::dynamic_pointer_cast<
+              TestOrderExecutionDataStore::CloseOperation>(operation)) {
+            dataStore->Close();
+            close->m_result.SetResult();
+            break;
+          }
+        }
+      });
+      Start();
+    }
+  };
 }
 
 TEST_SUITE("OrderExecutionServlet") {
@@ -267,4 +337,28 @@ TEST_SUITE("OrderExecutionServlet") {
     REQUIRE((**receivedRecord)->m_executionReports.size() == 2);
     m_dataStore->SetMode(TestOrderExecutionDataStore::Mode::UNSUPERVISED);
   }
+
+  TEST_CASE_FIXTURE(RecoveryFixture, "cancel_during_recovery") {
+    auto orderFields = OrderFields::MakeLimitOrder(TST, Side::BID, 100,
+      Money::ONE);
+    auto newOrder = m_protocolClient->SendRequest<NewOrderSingleService>(
+      orderFields);
+    auto serverOrder = m_serverOrders->Pop();
+    auto serverReports = std::make_shared<Queue<ExecutionReport>>();
+    serverOrder->GetPublisher().Monitor(serverReports);
+    auto initialReport = serverReports->Pop();
+    REQUIRE(initialReport.m_status == OrderStatus::PENDING_NEW);
+    SendRecordMessage<CancelOrderMessage>(*m_protocolClient,
+      (*newOrder)->m_orderId);
+    auto order = m_protocolClient->SendRequest<LoadOrderByIdService>(
+      (*newOrder)->m_orderId);
+    REQUIRE(order.has_value());
+    REQUIRE(!serverReports->TryPop());
+    auto recovery = m_slowRecoveries->Pop();
+    REQUIRE(recovery->m_query->GetIndex() == m_slowAccount);
+    recovery->m_result.SetResult(
+      m_baseDataStore->LoadOrderSubmissions(*recovery->m_query));
+    auto cancelReport = serverReports->Pop();
+    REQUIRE(cancelReport.m_status == OrderStatus::PENDING_CANCEL);
+  }
 }
@@ -0,0 +1,242 @@
+#include <string>
+#include <Beam/Queues/Queue.hpp>
+#include <Beam/Routines/RoutineHandler.hpp>
+#include <doctest/doctest.h>
+#include "Nexus/Definitions/DefaultCountryDatabase.hpp"
+#include "Nexus/Definitions/DefaultCurrencyDatabase.hpp"
+#include "Nexus/Definitions/DefaultMarketDatabase.hpp"
+#include "Nexus/OrderExecutionService/OrderSubmissionCheckDriver.hpp"
+#include "Nexus/OrderExecutionService/PrimitiveOrder.hpp"
+
+using namespace Beam;
+using namespace Beam::Routines;
+using namespace Beam::ServiceLocator;
+using namespace boost;
+using namespace boost::posix_time;
+using namespace Nexus;
+using namespace Nexus::OrderExecutionService;
+
+namespace {
+  const auto TST = Security("TST", DefaultMarkets::NYSE(),
+    DefaultCountries::US());
+
+  struct TestDriver {
+    std::vector<std::unique_ptr<PrimitiveOrder>> m_orders;
+
+    const Order& Recover(const SequencedAccountOrderRecord& orderRecord) {
+      throw std::runtime_error("Not implemented.");
+    }
+
+    const Order& Submit(const OrderInfo& orderInfo) {
+      m_orders.push_back(std::make_unique<PrimitiveOrder>(orderInfo));
+      return *m_orders.back();
+    }
+
+    void Cancel(const OrderExecutionSession& session, OrderId orderId) {}
+
+    void Update(const OrderExecutionSession& session, OrderId orderId,
+      const ExecutionReport& executionReport) {}
+
+    void Close() {}
+  };
+
+  struct TestCheck : OrderSubmissionCheck {
+    bool m_isStateful;
+    bool m_isRejecting;
+    std::string m_name;
+    std::vector<std::string>* m_submissions;
+    int m_submissionCount;
+    int m_rejectionCount;
+    int m_addCount;
+
+    TestCheck(bool isStateful, bool isRejecting)
+      : TestCheck(isStateful, isRejecting, "Rejected.", nullptr) {}
+
+    TestCheck(bool isStateful, bool isRejecting, std::string name,
+      std::vector<std::string>* submissions)
+      : m_isStateful(isStateful),
+        m_isRejecting(isRejecting),
+        m_name(std::move(name)),
+        m_submissions(submissions),
+        m_submissionCount(0),
+        m_rejectionCount(0),
+        m_addCount(0) {}
+
+    void Submit(const OrderInfo& orderInfo) override {
+      ++m_submissionCount;
+      if(m_submissions) {
+        m_submissions->push_back(m_name);
+      }
+      if(m_isRejecting) {
+        throw OrderSubmissionCheckException(m_name);
+      }
+    }
+
+    void Add(const Order& order) override {
+      ++m_addCount;
+    }
+
+    void Reject(const OrderInfo& orderInfo) override {
+      ++m_rejectionCount;
+    }
+
+    bool IsStateful() const override {
+      return m_isStateful;
+    }
+  };
+
+  struct GatedCheck : OrderSubmissionCheck {
+    int m_id;
+    Queue<int>* m_entered;
+    Queue<bool> m_gate;
+
+    GatedCheck(int id, Queue<int>* entered)
+      : m_id(id),
+        m_entered(entered) {}
+
+    void Submit(const OrderInfo& orderInfo) override {
+      m_entered->Push(m_id);
+      m_gate.Pop();
+    }
+  };
+
+  auto MakeOrderInfo(OrderId id) {
+    return OrderInfo(OrderFields::MakeLimitOrder(
+      DirectoryEntry::GetRootAccount(), TST, DefaultCurrencies::USD(),
+      Side::BID, "NYSE", 100, Money::ONE), id,
+      ptime(gregorian::date(2024, 5, 1), seconds(0)));
+  }
+}
+
+TEST_SUITE("OrderSubmissionCheckDriver") {
+  TEST_CASE("submission") {
+    auto driver = TestDriver();
+    auto checks = std::vector<std::unique_ptr<OrderSubmissionCheck>>();
+    checks.push_back(std::make_unique<TestCheck>(true, false));
+    checks.push_back(std::make_unique<TestCheck>(false, false));
+    checks.push_back(std::make_unique<TestCheck>(false, false));
+    auto& stateful = static_cast<TestCheck&>(*checks[0]);
+    auto& readOnly = static_cast<TestCheck&>(*checks[1]);
+    auto checkDriver = OrderSubmissionCheckDriver<TestDriver*>(&driver,
+      std::move(checks));
+    auto& order = checkDriver.Submit(MakeOrderInfo(1));
+    REQUIRE(&order == driver.m_orders.back().get());
+    REQUIRE(stateful.m_submissionCount == 1);
+    REQUIRE(stateful.m_addCount == 1);
+    REQUIRE(readOnly.m_submissionCount == 1);
+    REQUIRE(readOnly.m_addCount == 1);
+    auto metrics = checkDriver.GetMetrics();
+    REQUIRE(metrics.m_submission.m_count == 1);
+    REQUIRE(metrics.m_submission.m_rejectionCount == 0);
+    REQUIRE(metrics.m_checks.size() == 3);
+    for(auto& latency : metrics.m_checks) {
+      REQUIRE(latency.m_count == 1);
+    }
+  }
+
+  TEST_CASE("rejection") {
+    auto driver = TestDriver();
+    auto checks = std::vector<std::unique_ptr<OrderSubmissionCheck>>();
+    checks.push_back(std::make_unique<TestCheck>(true, false));
+    checks.push_back(std::make_unique<TestCheck>(false, false));
+    checks.push_back(std::make_unique<TestCheck>(false, true));
+    auto& stateful = static_cast<TestCheck&>(*checks[0]);
+    auto& passing = static_cast<TestCheck&>(*checks[1]);
+    auto& rejecting = static_cast<TestCheck&>(*checks[2]);
+    auto checkDriver = OrderSubmissionCheckDriver<TestDriver*>(&driver,
+      std::move(checks));
+    auto& order = checkDriver.Submit(MakeOrderInfo(1));
+    REQUIRE(driver.m_orders.empty());
+    auto snapshot = order.GetPublisher().GetSnapshot();
+    REQUIRE(snapshot.is_initialized());
+    REQUIRE(snapshot->back().m_status == OrderStatus::REJECTED);
+    REQUIRE(snapshot->back().m_text == "Rejected.");
+    REQUIRE(stateful.m_submissionCount == 0);
+    REQUIRE(passing.m_rejectionCount == 1);
+    REQUIRE(rejecting.m_rejectionCount == 0);
+    auto metrics = checkDriver.GetMetrics();
+    REQUIRE(metrics.m_submission.m_rejectionCount == 1);
+    REQUIRE(metrics.m_checks[0].m_count == 0);
+    REQUIRE(metrics.m_checks[2].m_rejectionCount == 1);
+  }
+
+  TEST_CASE("stateful_rejection") {
+    auto driver = TestDriver();
+    auto submissions = std::vector<std::string>();
+    auto checks = std::vector<std::unique_ptr<OrderSubmissionCheck>>();
+    checks.push_back(
+      std::make_unique<TestCheck>(true, false, "first", &submissions));
+    checks.push_back(std::make_unique<TestCheck>(false, false));
+    checks.push_back(
+      std::make_unique<TestCheck>(true, true, "second", &submissions));
+    checks.push_back(std::make_unique<TestCheck>(false, false));
+    checks.push_back(
+      std::make_unique<TestCheck>(true, false, "third", &submissions));
+    auto& first = static_cast<TestCheck&>(*checks[0]);
+    auto& passingA = static_cast<TestCheck&>(*checks[1]);
+    auto& second = static_cast<TestCheck&>(*checks[2]);
+    auto& passingB = static_cast<TestCheck&>(*checks[3]);
+    auto& third = static_cast<TestCheck&>(*checks[4]);
+    auto checkDriver = OrderSubmissionCheckDriver<TestDriver*>(&driver,
+      std::move(checks));
+    auto& order = checkDriver.Submit(MakeOrderInfo(1));
+    REQUIRE(driver.m_orders.empty());
+    auto snapshot = order.GetPublisher().GetSnapshot();
+    REQUIRE(snapshot.is_initialized());
+    REQUIRE(snapshot->back().m_status == OrderStatus::REJECTED);
+    REQUIRE(snapshot->back().m_text == "second");
+    REQUIRE(submissions == std::vector<std::string>{"first", "second"});
+    REQUIRE(third.m_submissionCount == 0);
+    REQUIRE(first.m_rejectionCount == 1);
+    REQUIRE(passingA.m_rejectionCount == 1);
+    REQUIRE(passingB.m_rejectionCount == 1);
+    REQUIRE(second.m_rejectionCount == 0);
+    REQUIRE(third.m_rejectionCount == 0);
+    REQUIRE(first.m_addCount == 0);
+    REQUIRE(passingA.m_addCount == 0);
+  }
+
+  TEST_CASE("stateful_order") {
+    auto driver = TestDriver();
+    auto submissions = std::vector<std::string>();
+    auto checks = std::vector<std::unique_ptr<OrderSubmissionCheck>>();
+    checks.push_back(
+      std::make_unique<TestCheck>(true, false, "first", &submissions));
+    checks.push_back(std::make_unique<TestCheck>(false, false));
+    checks.push_back(
+      std::make_unique<TestCheck>(true, false, "second", &submissions));
+    checks.push_back(
+      std::make_unique<TestCheck>(true, false, "third", &submissions));
+    auto& third = static_cast<TestCheck&>(*checks[3]);
+    auto checkDriver = OrderSubmissionCheckDriver<TestDriver*>(&driver,
+      std::move(checks));
+    auto& order = checkDriver.Submit(MakeOrderInfo(1));
+    REQUIRE(&order == driver.m_orders.back().get());
+    REQUIRE(submissions ==
+      std::vector<std::string>{"first", "second", "third"});
+    REQUIRE(third.m_addCount == 1);
+  }
+
+  TEST_CASE("concurrent_checks") {
+    auto driver = TestDriver();
+    auto entered = Queue<int>();
+    auto checks = std::vector<std::unique_ptr<OrderSubmissionCheck>>();
+    checks.push_back(std::make_unique<GatedCheck>(1, &entered));
+    checks.push_back(std::make_unique<GatedCheck>(2, &entered));
+    auto& checkA = static_cast<GatedCheck&>(*checks[0]);
+    auto& checkB = static_cast<GatedCheck&>(*checks[1]);
+    auto checkDriver = OrderSubmissionCheckDriver<TestDriver*>(&driver,
+      std::move(checks));
+    auto submission = RoutineHandler(Spawn([&] {
+      checkDriver.Submit(MakeOrderInfo(1));
+    }));
+    auto firstEntry = entered.Pop();
+    auto secondEntry = entered.Pop();
+    REQUIRE(firstEntry + secondEntry == 3);
+    REQUIRE(driver.m_orders.empty());
+    checkA.m_gate.Push(true);
+    checkB.m_gate.Push(true);
+    submission.Wait();
+    REQUIRE(driver.m_orders.size() == 1);
+  }
+}
@@ -1,8 +1,11 @@
 #include "Nexus/Python/Backtester.hpp"
 #include <Beam/Python/Beam.hpp>
+#include <boost/lexical_cast.hpp>
 #include "Nexus/Backtester/BacktesterEnvironment.hpp"
 #include "Nexus/Backtester/BacktesterEventHandler.hpp"
 #include "Nexus/Backtester/BacktesterServiceClients.hpp"
+#include "Nexus/Backtester/BacktesterTimeWindow.hpp"
+#include "Nexus/Backtester/ParallelBacktester.hpp"
 #include "Nexus/Python/ServiceClients.hpp"
 
 using namespace Beam;
@@ -24,12 +27,37 @@ namespace {
       : ToPythonServiceClients(Ref(*environment)),
         m_environment(std::move(environment)) {}
   };
+
+  std::shared_ptr<object> MakePartitionResult(object result) {
+    return std::shared_ptr<object>(new object(std::move(result)),
+      [] (object* result) {
+        auto lock = GilLock();
+        delete result;
+      });
+  }
+
+  template<typename F>
+  list RunPythonBacktests(F&& run) {
+    auto results = [&] {
+      auto release = GilRelease();
+      return run();
+    }();
+    auto partitionResults = list();
+    for(auto& result : results) {
+      partitionResults.append(*result);
+    }
+    return partitionResults;
+  }
 }
 
 void Nexus::Python::ExportBacktester(module& module) {
   ExportBacktesterEnvironment(module);
   ExportBacktesterEventHandler(module);
+  ExportBacktesterMarketDataMetrics(module);
+  ExportBacktesterMarketDataService(module);
   ExportBacktesterServiceClients(module);
+  ExportBacktesterTimeWindow(module);
+  ExportParallelBacktester(module);
 }
 
 void Nexus::Python::ExportBacktesterEnvironment(module& module) {
@@ -37,6 +65,12 @@ void Nexus::Python::ExportBacktesterEnvironment(module& module) {
       "BacktesterEnvironment").
     def(init<ptime, ServiceClientsBox>(), call_guard<GilRelease>()).
     def(init<ptime, ptime, ServiceClientsBox>(), call_guard<GilRelease>()).
+    def(init<ptime, ptime, ServiceClientsBox,
+      std::shared_ptr<BacktesterTimeWindow::Participant>>(),
+      call_guard<GilRelease>()).
+    def(init<ptime, ptime, ServiceClientsBox, HistoricalDataStoreBox,
+      std::shared_ptr<BacktesterTimeWindow::Participant>>(),
+      call_guard<GilRelease>()).
     def("__del__",
       [] (BacktesterEnvironment& self) {
         self.Close();
@@ -86,6 +120,9 @@ void Nexus::Python::ExportBacktesterEventHandler(module& module) {
   class_<BacktesterEventHandler>(module, "BacktesterEventHandler").
     def(init<ptime>(), call_guard<GilRelease>()).
     def(init<ptime, ptime>(), call_guard<GilRelease>()).
+    def(init<ptime, ptime,
+      std::shared_ptr<BacktesterTimeWindow::Participant>>(),
+      call_guard<GilRelease>()).
     def("__del__",
       [] (BacktesterEventHandler& self) {
         self.Close();
@@ -105,8 +142,100 @@ void Nexus::Python::ExportBacktesterEventHandler(module& module) {
     def("close", &BacktesterEventHandler::Close, call_guard<GilRelease>());
 }
 
+void Nexus::Python::ExportBacktesterMarketDataMetrics(module& module) {
+  class_<BacktesterMarketDataMetrics>(module, "BacktesterMarketDataMetrics").
+    def(init()).
+    def(init<const BacktesterMarketDataMetrics&>()).
+    def_readwrite("load_count", &BacktesterMarketDataMetrics::m_loadCount).
+    def_readwrite("stall_count", &BacktesterMarketDataMetrics::m_stallCount).
+    def_readwrite("stall_time", &BacktesterMarketDataMetrics::m_stallTime).
+    def_readwrite("max_stall_time",
+      &BacktesterMarketDataMetrics::m_maxStallTime).
+    def("__str__", &lexical_cast<std::string, BacktesterMarketDataMetrics>);
+}
+
+void Nexus::Python::ExportBacktesterMarketDataService(module& module) {
+  class_<BacktesterMarketDataService>(module, "BacktesterMarketDataService").
+    def("query_order_imbalances",
+      &BacktesterMarketDataService::QueryOrderImbalances,
+      call_guard<GilRelease>()).
+    def("query_bbo_quotes", &BacktesterMarketDataService::QueryBboQuotes,
+      call_guard<GilRelease>()).
+    def("query_book_quotes", &BacktesterMarketDataService::QueryBookQuotes,
+      call_guard<GilRelease>()).
+    def("query_market_quotes",
+      &BacktesterMarketDataService::QueryMarketQuotes,
+      call_guard<GilRelease>()).
+    def("query_time_and_sales",
+      &BacktesterMarketDataService::QueryTimeAndSales,
+      call_guard<GilRelease>()).
+    def_property_readonly("metrics", &BacktesterMarketDataService::GetMetrics);
+}
+
 void Nexus::Python::ExportBacktesterServiceClients(module& module) {
   ExportServiceClients<ToPythonBacktesterServiceClients>(module,
     "BacktesterServiceClients").
     def(init<std::shared_ptr<BacktesterEnvironment>>());
 }
+
+void Nexus::Python::ExportBacktesterTimeWindow(module& module) {
+  auto outer = class_<BacktesterTimeWindow,
+    std::shared_ptr<BacktesterTimeWindow>>(module, "BacktesterTimeWindow").
+    def(init<ptime, time_duration, int>()).
+    def_property_readonly("window_end", &BacktesterTimeWindow::GetWindowEnd);
+  class_<BacktesterTimeWindow::Participant,
+      std::shared_ptr<BacktesterTimeWindow::Participant>>(outer,
+      "Participant").
+    def(init<std::shared_ptr<BacktesterTimeWindow>>()).
+    def_property_readonly("window",
+      &BacktesterTimeWindow::Participant::GetWindow).
+    def("leave", &BacktesterTimeWindow::Participant::Leave,
+      call_guard<GilRelease>());
+}
+
+void Nexus::Python::ExportParallelBacktester(module& module) {
+  module.def("run_parallel_backtests",
+    [] (int partitionCount, const object& backtest, int threadCount) {
+      return RunPythonBacktests([&] {
+        return RunParallelBacktests(partitionCount, [&] (int partition) {
+          auto lock = GilLock();
+          return MakePartitionResult(backtest(partition));
+        }, threadCount);
+      });
+    });
+  module.def("run_parallel_backtests",
+    [] (int partitionCount, const object& backtest) {
+      return RunPythonBacktests([&] {
+        return RunParallelBacktests(partitionCount, [&] (int partition) {
+          auto lock = GilLock();
+          return MakePartitionResult(backtest(partition));
+        });
+      });
+    });
+  module.def("run_parallel_backtests",
+    [] (ptime startTime, time_duration window, int partitionCount,
+        const object& backtest, int threadCount) {
+      return RunPythonBacktests([&] {
+        return RunParallelBacktests(startTime, window, partitionCount,
+          [&] (int partition,
+              const std::shared_ptr<BacktesterTimeWindow::Participant>&
+                participant) {
+            auto lock = GilLock();
+            return MakePartitionResult(backtest(partition, participant));
+          }, threadCount);
+      });
+    });
+  module.def("run_parallel_backtests",
+    [] (ptime startTime, time_duration window, int partitionCount,
+        const object& backtest) {
+      return RunPythonBacktests([&] {
+        return RunParallelBacktests(startTime, window, partitionCount,
+          [&] (int partition,
+              const std::shared_ptr<BacktesterTimeWindow::Participant>&
+                participant) {
+            auto lock = GilLock();
+            return MakePartitionResult(backtest(partition, participant));
+          });
+      });
+    });
+}
@@ -4,6 +4,7 @@
 #include <Beam/Python/Beam.hpp>
 #include <Beam/Sql/SqlConnection.hpp>
 #include <boost/throw_exception.hpp>
+#include <pybind11/numpy.h>
 #include <Viper/MySql/Connection.hpp>
 #include <Viper/Sqlite3/Connection.hpp>
 #include "Nexus/MarketDataService/ApplicationDefinitions.hpp"
@@ -37,6 +38,20 @@ namespace {
   auto marketDataClientBox = std::unique_ptr<class_<MarketDataClientBox>>();
   auto marketDataFeedClientBox =
     std::unique_ptr<class_<MarketDataFeedClientBox>>();
+
+  template<typename T>
+  array_t<T> MakeArray(std::vector<T> column) {
+    auto values = new std::vector<T>(std::move(column));
+    auto owner = capsule(values, [] (void* values) {
+      delete static_cast<std::vector<T>*>(values);
+    });
+    return array_t<T>(static_cast<pybind11::ssize_t>(values->size()),
+      values->data(), owner);
+  }
+
+  object MakeTimestampArray(std::vector<std::int64_t> column) {
+    return MakeArray(std::move(column)).attr("view")("datetime64[us]");
+  }
 }
 
 class_<HistoricalDataStoreBox>&
@@ -53,6 +68,28 @@ class_<MarketDataFeedClientBox>&
   return *marketDataFeedClientBox;
 }
 
+dict Nexus::Python::ToNumPy(BboQuoteColumns columns) {
+  auto result = dict();
+  result["sequence"] = MakeArray(std::move(columns.m_sequences));
+  result["timestamp"] = MakeTimestampArray(std::move(columns.m_timestamps));
+  result["bid_price"] = MakeArray(std::move(columns.m_bidPrices));
+  result["bid_size"] = MakeArray(std::move(columns.m_bidSizes));
+  result["ask_price"] = MakeArray(std::move(columns.m_askPrices));
+  result["ask_size"] = MakeArray(std::move(columns.m_askSizes));
+  return result;
+}
+
+dict Nexus::Python::ToNumPy(TimeAndSaleColumns columns) {
+  auto result = dict();
+  result["sequence"] = MakeArray(std::move(columns.m_sequences));
+  result["timestamp"] = MakeTimestampArray(std::move(columns.m_timestamps));
+  result["price"] = MakeArray(std::move(columns.m_prices));
+  result["size"] = MakeArray(std::move(columns.m_sizes));
+  result["market_center"] = MakeArray(std::move(columns.m_marketCenters));
+  result["market_centers"] = pybind11::cast(columns.m_marketCenterNames);
+  return result;
+}
+
 void Nexus::Python::ExportApplicationMarketDataClient(module& module) {
   using PythonApplicationMarketDataClient = ToPythonMarketDataClient<
     MarketDataClient<ZLibSessionBuilder<ServiceLocatorClientBox>>>;
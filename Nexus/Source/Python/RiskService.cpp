@@ -44,6 +44,12 @@ namespace {
         account, snapshot);
     }
 
+    void Append(const DirectoryEntry& account,
+        const InventorySnapshotDelta& delta) override {
+      PYBIND11_OVERLOAD_PURE_NAME(void, VirtualRiskDataStore, "append", Append,
+        account, delta);
+    }
+
     void Close() override {
       PYBIND11_OVERLOAD_PURE_NAME(void, VirtualRiskDataStore, "close", Close);
     }
@@ -96,6 +102,7 @@ void Nexus::Python::ExportRiskDataStore(module& module) {
     .def("load_inventory_snapshot",
       &VirtualRiskDataStore::LoadInventorySnapshot)
     .def("store", &VirtualRiskDataStore::Store)
+    .def("append", &VirtualRiskDataStore::Append)
     .def("close", &VirtualRiskDataStore::Close);
 }
 
@@ -60,6 +60,14 @@ namespace {
         RiskState::Type::ACTIVE);
       return account;
     }
+
+    void SubmitFilledOrder(const DirectoryEntry& account) {
+      m_adminClients.GetOrderExecutionClient().Submit(
+        OrderFields::MakeMarketOrder(account, TSLA, Side::BID, 100));
+      auto receivedOrder = m_orders->Pop();
+      m_environment.Accept(*receivedOrder);
+      m_environment.Fill(*receivedOrder, *Money::FromValue("1.01"), 100);
+    }
   };
 }
 
@@ -109,4 +117,60 @@ TEST_SUITE("ConsolidatedRiskController") {
     REQUIRE(state.m_key == m_accountA);
     REQUIRE(state.m_value == RiskState::Type::DISABLED);
   }
+
+  TEST_CASE_FIXTURE(Fixture, "snapshot_store_fallback") {
+    auto exchangeRates = std::vector<ExchangeRate>();
+    auto dataStore = TestRiskDataStore();
+    auto operations = std::make_shared<
+      Queue<std::shared_ptr<TestRiskDataStore::Operation>>>();
+    dataStore.GetPublisher().Monitor(operations);
+    auto accounts = std::make_shared<Queue<DirectoryEntry>>();
+    auto controller = ConsolidatedRiskController(accounts,
+      &m_adminClients.GetAdministrationClient(),
+      &m_adminClients.GetMarketDataClient(),
+      &m_adminClients.GetOrderExecutionClient(),
+      [=] {
+        return m_adminClients.MakeTimer(seconds(1));
+      },
+      &m_adminClients.GetTimeClient(), &dataStore, exchangeRates,
+      GetDefaultMarketDatabase(), GetDefaultDestinationDatabase());
+    accounts->Push(m_accountA);
+    auto operation = operations->Pop();
+    auto loadOperation = get<TestRiskDataStore::LoadInventorySnapshotOperation>(
+      &*operation);
+    REQUIRE(loadOperation);
+    loadOperation->m_result.SetResult(InventorySnapshot());
+    SubmitFilledOrder(m_accountA);
+    operation = operations->Pop();
+    auto appendOperation =
+      get<TestRiskDataStore::AppendInventorySnapshotDeltaOperation>(
+        &*operation);
+    REQUIRE(appendOperation);
+    REQUIRE(*appendOperation->m_account == m_accountA);
+    REQUIRE(appendOperation->m_delta->m_inventories.size() == 1);
+    REQUIRE(appendOperation->m_delta->m_inventories.front().
+      m_position.m_quantity == 100);
+    appendOperation->m_result.SetException(
+      std::runtime_error("Append failed."));
+    SubmitFilledOrder(m_accountA);
+    operation = operations->Pop();
+    auto storeOperation =
+      get<TestRiskDataStore::StoreInventorySnapshotOperation>(&*operation);
+    REQUIRE(storeOperation);
+    REQUIRE(*storeOperation->m_account == m_accountA);
+    REQUIRE(storeOperation->m_snapshot->m_inventories.size() == 1);
+    REQUIRE(storeOperation->m_snapshot->m_inventories.front().
+      m_position.m_quantity == 200);
+    REQUIRE(storeOperation->m_snapshot->m_excludedOrders.empty());
+    storeOperation->m_result.SetResult();
+    SubmitFilledOrder(m_accountA);
+    operation = operations->Pop();
+    appendOperation =
+      get<TestRiskDataStore::AppendInventorySnapshotDeltaOperation>(
+        &*operation);
+    REQUIRE(appendOperation);
+    REQUIRE(appendOperation->m_delta->m_inventories.front().
+      m_position.m_quantity == 300);
+    appendOperation->m_result.SetResult();
+  }
 }
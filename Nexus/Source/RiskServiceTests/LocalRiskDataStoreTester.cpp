@@ -65,4 +65,65 @@ TEST_SUITE("LocalRiskDataStore") {
     REQUIRE(storedSnapshot.m_inventories.size() == 1);
     REQUIRE(storedSnapshot.m_inventories[0] == inventories[0]);
   }
+
+  TEST_CASE("append_delta") {
+    auto dataStore = LocalRiskDataStore();
+    auto account = DirectoryEntry::MakeAccount(123, "test");
+    auto a = RiskInventory(RiskInventory::Position::Key(
+      Security("A", DefaultMarkets::NYSE(), DefaultCountries::US()),
+      DefaultCurrencies::USD()));
+    a.m_position.m_quantity = 100;
+    a.m_position.m_costBasis = 1000 * Money::ONE;
+    a.m_volume = 100;
+    a.m_transactionCount = 1;
+    auto b = RiskInventory(RiskInventory::Position::Key(
+      Security("B", DefaultMarkets::NYSE(), DefaultCountries::US()),
+      DefaultCurrencies::USD()));
+    b.m_position.m_quantity = 200;
+    b.m_position.m_costBasis = 400 * Money::ONE;
+    b.m_volume = 200;
+    b.m_transactionCount = 2;
+    dataStore.Store(account, InventorySnapshot{{a}, Sequence(10), {100, 101}});
+    auto delta = InventorySnapshotDelta();
+    delta.m_inventories.push_back(b);
+    delta.m_sequence = Sequence(12);
+    delta.m_excludedOrders.push_back(102);
+    delta.m_includedOrders.push_back(100);
+    dataStore.Append(account, delta);
+    auto snapshot = dataStore.LoadInventorySnapshot(account);
+    REQUIRE(snapshot == InventorySnapshot{{a, b}, Sequence(12), {101, 102}});
+    delta = InventorySnapshotDelta();
+    delta.m_inventories.push_back(RiskInventory(a.m_position.m_key));
+    delta.m_sequence = Sequence(15);
+    delta.m_includedOrders.push_back(101);
+    dataStore.Append(account, delta);
+    snapshot = dataStore.LoadInventorySnapshot(account);
+    REQUIRE(snapshot == InventorySnapshot{{b}, Sequence(15), {102}});
+  }
+
+  TEST_CASE("compaction") {
+    auto dataStore = LocalRiskDataStore();
+    auto account = DirectoryEntry::MakeAccount(123, "test");
+    auto inventory = RiskInventory(RiskInventory::Position::Key(
+      Security("A", DefaultMarkets::NYSE(), DefaultCountries::US()),
+      DefaultCurrencies::USD()));
+    for(auto i = 1; i <= 2 * INVENTORY_SNAPSHOT_COMPACTION_THRESHOLD + 1;
+        ++i) {
+      inventory.m_position.m_quantity = i;
+      inventory.m_position.m_costBasis = i * Money::ONE;
+      inventory.m_volume = i;
+      inventory.m_transactionCount = i;
+      auto delta = InventorySnapshotDelta();
+      delta.m_inventories.push_back(inventory);
+      delta.m_sequence = Sequence(i);
+      delta.m_excludedOrders.push_back(i);
+      if(i != 1) {
+        delta.m_includedOrders.push_back(i - 1);
+      }
+      dataStore.Append(account, delta);
+      auto snapshot = dataStore.LoadInventorySnapshot(account);
+      REQUIRE(snapshot == InventorySnapshot{{inventory}, Sequence(i),
+        {static_cast<OrderId>(i)}});
+    }
+  }
 }
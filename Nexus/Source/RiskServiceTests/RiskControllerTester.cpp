@@ -1,13 +1,16 @@
+#include <Beam/Routines/RoutineHandler.hpp>
 #include <Beam/ServicesTests/TestServices.hpp>
 #include <doctest/doctest.h>
 #include "Nexus/Definitions/DefaultDestinationDatabase.hpp"
 #include "Nexus/Definitions/DefaultMarketDatabase.hpp"
 #include "Nexus/RiskService/LocalRiskDataStore.hpp"
 #include "Nexus/RiskService/RiskController.hpp"
+#include "Nexus/RiskServiceTests/TestRiskDataStore.hpp"
 #include "Nexus/ServiceClients/TestEnvironment.hpp"
 #include "Nexus/ServiceClients/TestServiceClients.hpp"
 
 using namespace Beam;
+using namespace Beam::Routines;
 using namespace Beam::ServiceLocator;
 using namespace boost;
 using namespace boost::posix_time;
@@ -15,12 +18,20 @@ using namespace Nexus;
 using namespace Nexus::OrderExecutionService;
 using namespace Nexus::OrderExecutionService::Tests;
 using namespace Nexus::RiskService;
+using namespace Nexus::RiskService::Tests;
 
 namespace {
   auto TSLA = Security("TSLA", DefaultMarkets::NASDAQ(),
     DefaultCountries::US());
   auto XIU = Security("XIU", DefaultMarkets::TSX(), DefaultCountries::CA());
 
+  using TestRiskController = RiskController<
+    TestServiceClients::AdministrationClient*,
+    TestServiceClients::MarketDataClient*,
+    TestServiceClients::OrderExecutionClient*,
+    std::unique_ptr<TestServiceClients::Timer>,
+    TestServiceClients::TimeClient*, TestRiskDataStore*>;
+
   struct Fixture {
     TestEnvironment m_environment;
     TestServiceClients m_adminClients;
@@ -47,7 +58,24 @@ namespace {
         RiskState::Type::ACTIVE);
       m_userClients.emplace("simba", "1234", Ref(m_environment));
     }
+
+    const Order& SubmitFilledOrder() {
+      auto& order = m_userClients->GetOrderExecutionClient().Submit(
+        OrderFields::MakeMarketOrder(TSLA, Side::BID, 100));
+      auto receivedOrder = m_orders->Pop();
+      m_environment.Accept(*receivedOrder);
+      m_environment.Fill(*receivedOrder, *Money::FromValue("1.01"), 100);
+      return order;
+    }
   };
+
+  template<typename T>
+  T& Require(
+      const std::shared_ptr<TestRiskDataStore::Operation>& operation) {
+    auto result = get<T>(&*operation);
+    REQUIRE(result);
+    return *result;
+  }
 }
 
 TEST_SUITE("RiskController") {
@@ -103,4 +131,77 @@ TEST_SUITE("RiskController") {
     controller.GetPortfolioPublisher().Monitor(portfolio);
     auto update = portfolio->Pop();
   }
+
+  TEST_CASE_FIXTURE(Fixture, "snapshot_deltas") {
+    auto exchangeRates = std::vector<ExchangeRate>();
+    auto dataStore = TestRiskDataStore();
+    auto operations = std::make_shared<
+      Queue<std::shared_ptr<TestRiskDataStore::Operation>>>();
+    dataStore.GetPublisher().Monitor(operations);
+    auto controller = optional<TestRiskController>();
+    auto construction = RoutineHandler(Spawn([&] {
+      controller.emplace(m_account, &m_adminClients.GetAdministrationClient(),
+        &m_adminClients.GetMarketDataClient(),
+        &m_adminClients.GetOrderExecutionClient(),
+        m_adminClients.MakeTimer(seconds(1)),
+        &m_adminClients.GetTimeClient(), &dataStore, exchangeRates,
+        GetDefaultMarketDatabase(), GetDefaultDestinationDatabase());
+    }));
+    Require<TestRiskDataStore::LoadInventorySnapshotOperation>(
+      operations->Pop()).m_result.SetResult(InventorySnapshot());
+    construction.Wait();
+    auto& openOrder = m_userClients->GetOrderExecutionClient().Submit(
+      OrderFields::MakeLimitOrder(TSLA, Side::BID, 100, Money::ONE));
+    auto receivedOpenOrder = m_orders->Pop();
+    m_environment.Accept(*receivedOpenOrder);
+    SubmitFilledOrder();
+    auto operation = operations->Pop();
+    auto& fill =
+      Require<TestRiskDataStore::AppendInventorySnapshotDeltaOperation>(
+        operation);
+    REQUIRE(*fill.m_account == m_account);
+    REQUIRE(fill.m_delta->m_inventories.size() == 1);
+    REQUIRE(fill.m_delta->m_inventories.front().m_position.m_key.m_index ==
+      TSLA);
+    REQUIRE(
+      fill.m_delta->m_inventories.front().m_position.m_quantity == 100);
+    REQUIRE(fill.m_delta->m_excludedOrders ==
+      std::vector<OrderId>{openOrder.GetInfo().m_orderId});
+    REQUIRE(fill.m_delta->m_includedOrders.empty());
+    auto sequence = fill.m_delta->m_sequence;
+    fill.m_result.SetResult();
+    m_environment.Cancel(*receivedOpenOrder);
+    operation = operations->Pop();
+    auto& cancel =
+      Require<TestRiskDataStore::AppendInventorySnapshotDeltaOperation>(
+        operation);
+    REQUIRE(cancel.m_delta->m_inventories.empty());
+    REQUIRE(cancel.m_delta->m_excludedOrders.empty());
+    REQUIRE(cancel.m_delta->m_includedOrders ==
+      std::vector<OrderId>{openOrder.GetInfo().m_orderId});
+    cancel.m_result.SetResult();
+    SubmitFilledOrder();
+    Require<TestRiskDataStore::AppendInventorySnapshotDeltaOperation>(
+      operations->Pop()).m_result.SetException(
+        std::runtime_error("Append failed."));
+    SubmitFilledOrder();
+    operation = operations->Pop();
+    auto& store = Require<TestRiskDataStore::StoreInventorySnapshotOperation>(
+      operation);
+    REQUIRE(*store.m_account == m_account);
+    REQUIRE(store.m_snapshot->m_inventories.size() == 1);
+    REQUIRE(
+      store.m_snapshot->m_inventories.front().m_position.m_quantity == 300);
+    REQUIRE(store.m_snapshot->m_excludedOrders.empty());
+    REQUIRE(store.m_snapshot->m_sequence > sequence);
+    store.m_result.SetResult();
+    SubmitFilledOrder();
+    operation = operations->Pop();
+    auto& recovered =
+      Require<TestRiskDataStore::AppendInventorySnapshotDeltaOperation>(
+        operation);
+    REQUIRE(
+      recovered.m_delta->m_inventories.front().m_position.m_quantity == 400);
+    recovered.m_result.SetResult();
+  }
 }